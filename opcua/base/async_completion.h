@@ -63,21 +63,25 @@ class AsyncCompletion {
 
   static Awaitable<void> WaitOnState(std::shared_ptr<State> state) {
     auto executor = state->executor;
+    // Named rather than a temporary of the co_await expression: GCC 12
+    // mishandles temporaries with non-trivial destructors that live across a
+    // suspension, and this one owns a reference to `state`.
+    auto register_waiter = [state = std::move(state)](auto callback) mutable {
+      auto completion = std::make_shared<std::decay_t<decltype(callback)>>(
+          std::move(callback));
+
+      if (state->completed) {
+        (*completion)(state->error);
+        return;
+      }
+
+      state->waiters.emplace_back(
+          [completion](std::exception_ptr error) mutable {
+            (*completion)(std::move(error));
+          });
+    };
     auto [error] = co_await CallbackToAwaitable<std::exception_ptr>(
-        std::move(executor), [state = std::move(state)](auto callback) mutable {
-          auto completion = std::make_shared<std::decay_t<decltype(callback)>>(
-              std::move(callback));
-
-          if (state->completed) {
-            (*completion)(state->error);
-            return;
-          }
-
-          state->waiters.emplace_back(
-              [completion](std::exception_ptr error) mutable {
-                (*completion)(std::move(error));
-              });
-        });
+        std::move(executor), std::move(register_waiter));
 
     if (error) {
       std::rethrow_exception(error);
@@ -6,6 +6,7 @@
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/use_future.hpp>
 #include <chrono>
 #include <functional>
@@ -60,6 +61,16 @@ inline void CoSpawn(AnyExecutor executor,
   CoSpawn(std::move(executor), cancelation.weak_ptr(), std::forward<F>(fn));
 }
 
+// Runs the coroutine factory `fn` on `executor` and resumes the awaiting
+// coroutine on its own executor with the result; an exception thrown by `fn`
+// is rethrown to the awaiter. How coroutines on executors that share no state
+// (the shards of ShardedServerRuntime) hand each other work.
+template <class F>
+[[nodiscard]] auto CoSpawnAndWait(AnyExecutor executor, F&& fn) {
+  return boost::asio::co_spawn(std::move(executor), std::forward<F>(fn),
+                               boost::asio::use_awaitable);
+}
+
 template <class ExecutionContext, class F>
 auto RunAwaitable(ExecutionContext& context, F&& fn) {
   context.restart();
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "opcua/base/any_executor.h"
+#include "opcua/base/async_completion.h"
+#include "opcua/base/awaitable.h"
+
+#include <algorithm>
+#include <boost/asio/this_coro.hpp>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace opcua {
+
+// Awaits `fn(index)` for every index in [0, count) and returns the results in
+// index order. At most `max_concurrency` calls are in flight at once (0 means
+// no bound); each finished call starts the next pending one. The calls run on
+// the awaiting coroutine's executor, so `fn` needs no synchronisation of its
+// own. If any call throws, the rest still run to completion and the first
+// exception is rethrown to the awaiter.
+//
+// Example:
+//   auto values = co_await RunConcurrently<StatusOr<DataValue>>(
+//       nodes.size(), limit,
+//       [&](std::size_t index) { return ReadNode(nodes[index]); });
+template <class T, class F>
+[[nodiscard]] Awaitable<std::vector<T>> RunConcurrently(
+    std::size_t count,
+    std::size_t max_concurrency,
+    F fn) {
+  if (count == 0)
+    co_return std::vector<T>{};
+
+  AnyExecutor executor = co_await boost::asio::this_coro::executor;
+
+  struct State {
+    State(AnyExecutor executor, F fn, std::size_t count)
+        : done{std::move(executor)}, fn{std::move(fn)}, results(count) {}
+
+    base::AsyncCompletion done;
+    F fn;
+    std::vector<std::optional<T>> results;
+    std::size_t next = 0;
+    std::size_t running = 0;
+    std::exception_ptr error;
+  };
+
+  auto state = std::make_shared<State>(executor, std::move(fn), count);
+  const auto workers =
+      max_concurrency == 0 ? count : std::min(count, max_concurrency);
+  state->running = workers;
+  for (std::size_t worker = 0; worker < workers; ++worker) {
+    CoSpawn(executor, [state]() -> Awaitable<void> {
+      while (state->next < state->results.size()) {
+        const auto index = state->next++;
+        try {
+          state->results[index].emplace(co_await state->fn(index));
+        } catch (...) {
+          if (!state->error)
+            state->error = std::current_exception();
+        }
+      }
+      if (--state->running != 0)
+        co_return;
+      if (state->error)
+        state->done.Fail(state->error);
+      else
+        state->done.Complete();
+    });
+  }
+
+  co_await state->done.Wait();
+
+  std::vector<T> results;
+  results.reserve(count);
+  for (auto& result : state->results)
+    results.push_back(std::move(*result));
+  co_return results;
+}
+
+}  // namespace opcua
@@ -0,0 +1,115 @@
+#include "opcua/base/run_concurrently.h"
+
+#include "opcua/base/test/awaitable_test.h"
+#include "opcua/base/test/test_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace opcua {
+namespace {
+
+TEST(RunConcurrentlyTest, ReturnsResultsInIndexOrderWhateverOrderCallsFinish) {
+  TestExecutor executor;
+  std::vector<base::AsyncCompletion> gates;
+  for (int i = 0; i < 3; ++i)
+    gates.emplace_back(executor);
+
+  auto result = StartAwaitable(
+      executor,
+      RunConcurrently<int>(3, 0, [&](std::size_t index) -> Awaitable<int> {
+        co_await gates[index].Wait();
+        co_return static_cast<int>(index) * 10;
+      }));
+  Drain(executor);
+  ASSERT_FALSE(result->done);
+
+  for (auto gate = gates.rbegin(); gate != gates.rend(); ++gate) {
+    gate->Complete();
+    Drain(executor);
+  }
+
+  ASSERT_TRUE(result->done);
+  EXPECT_EQ(*result->value, (std::vector<int>{0, 10, 20}));
+}
+
+TEST(RunConcurrentlyTest, KeepsAtMostTheBoundInFlight) {
+  TestExecutor executor;
+  std::vector<base::AsyncCompletion> gates;
+  for (int i = 0; i < 5; ++i)
+    gates.emplace_back(executor);
+  std::vector<std::size_t> started;
+  std::size_t in_flight = 0;
+  std::size_t max_in_flight = 0;
+
+  auto result = StartAwaitable(
+      executor,
+      RunConcurrently<std::size_t>(
+          5, 2, [&](std::size_t index) -> Awaitable<std::size_t> {
+            started.push_back(index);
+            max_in_flight = std::max(max_in_flight, ++in_flight);
+            co_await gates[index].Wait();
+            --in_flight;
+            co_return index;
+          }));
+  Drain(executor);
+  EXPECT_EQ(started, (std::vector<std::size_t>{0, 1}));
+
+  // A finished call makes room for exactly one more.
+  gates[1].Complete();
+  Drain(executor);
+  EXPECT_EQ(started, (std::vector<std::size_t>{0, 1, 2}));
+
+  for (auto& gate : gates) {
+    if (!gate.completed())
+      gate.Complete();
+    Drain(executor);
+  }
+
+  ASSERT_TRUE(result->done);
+  EXPECT_EQ(max_in_flight, 2u);
+  EXPECT_EQ(*result->value, (std::vector<std::size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(RunConcurrentlyTest, RethrowsOnceEveryCallHasFinished) {
+  TestExecutor executor;
+  base::AsyncCompletion gate{executor};
+  bool slow_call_finished = false;
+
+  auto result = StartAwaitable(
+      executor,
+      RunConcurrently<int>(2, 0, [&](std::size_t index) -> Awaitable<int> {
+        if (index == 0)
+          throw std::runtime_error{"node failed"};
+        co_await gate.Wait();
+        slow_call_finished = true;
+        co_return 1;
+      }));
+  Drain(executor);
+  EXPECT_FALSE(result->done);
+
+  gate.Complete();
+  Drain(executor);
+
+  ASSERT_TRUE(result->done);
+  EXPECT_TRUE(slow_call_finished);
+  EXPECT_TRUE(result->error);
+}
+
+TEST(RunConcurrentlyTest, CompletesAtOnceWithNothingToRun) {
+  TestExecutor executor;
+  auto result = StartAwaitable(
+      executor, RunConcurrently<int>(0, 4, [](std::size_t) -> Awaitable<int> {
+        co_return 0;
+      }));
+  Drain(executor);
+
+  ASSERT_TRUE(result->done);
+  EXPECT_TRUE(result->value->empty());
+}
+
+}  // namespace
+}  // namespace opcua
@@ -14,6 +14,8 @@
 
 #include <boost/json/value.hpp>
 
+#include <initializer_list>
+#include <memory>
 #include <optional>
 #include <string>
 #include <variant>
@@ -168,6 +170,16 @@ struct DataChangeFilter {
   double deadband_value = 0;
 };
 
+// The value range an analog Variable is expected to stay within (its EURange
+// Property). OPC UA Part 8 §5.6.2 AnalogItemType,
+// https://reference.opcfoundation.org/Core/Part8/v105/docs/5.6.2
+struct EuRange {
+  bool operator==(const EuRange&) const = default;
+
+  double low = 0;
+  double high = 0;
+};
+
 // The (extensible) filter applied to a MonitoredItem. A DataChangeFilter is
 // modelled directly; event/aggregate filters are carried as encoded JSON. OPC
 // UA Part 4 §7.22 MonitoringFilter,
@@ -211,6 +223,12 @@ struct MonitoredItemCreateResult {
   double revised_sampling_interval_ms = 0;
   UInt32 revised_queue_size = 0;
   std::optional<boost::json::value> filter_result;
+  // The monitored Variable's EURange, when it has one. Not part of the wire
+  // result: a backing MonitoredItemSubscription reports it so the subscription
+  // can apply a PercentDeadband, which is a percentage of this span and is
+  // invalid on a Variable without it. OPC UA Part 4 §7.22.2 DataChangeFilter,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+  std::optional<EuRange> eu_range;
 };
 
 // One MonitoredItem to modify, as passed to ModifyMonitoredItems. OPC UA Part 4
@@ -393,6 +411,49 @@ using NotificationData = std::variant<DataChangeNotification,
                                       EventNotificationList,
                                       StatusChangeNotification>;
 
+// Immutable list of NotificationData behind a shared pointer, read like a
+// const vector. A published message is held by the retransmission queue and
+// carried by the Publish response, and again by every Republish of it; sharing
+// the list makes each of those a reference-count bump rather than a deep copy
+// of every Variant. Like SharedValue, copies that share storage compare equal
+// without walking it. An opcuapp-internal type, not an OPC UA one.
+class NotificationDataList {
+ public:
+  using value_type = NotificationData;
+  using const_iterator = std::vector<NotificationData>::const_iterator;
+  using iterator = const_iterator;
+
+  NotificationDataList() = default;
+  NotificationDataList(std::vector<NotificationData> items)
+      : items_{items.empty()
+                   ? nullptr
+                   : std::make_shared<const std::vector<NotificationData>>(
+                         std::move(items))} {}
+  NotificationDataList(std::initializer_list<NotificationData> items)
+      : NotificationDataList{std::vector<NotificationData>(items)} {}
+
+  bool empty() const { return get().empty(); }
+  std::size_t size() const { return get().size(); }
+  const NotificationData& operator[](std::size_t index) const {
+    return get()[index];
+  }
+  const NotificationData& front() const { return get().front(); }
+  const_iterator begin() const { return get().begin(); }
+  const_iterator end() const { return get().end(); }
+
+  const std::vector<NotificationData>& get() const {
+    static const std::vector<NotificationData> kEmpty;
+    return items_ ? *items_ : kEmpty;
+  }
+
+  bool operator==(const NotificationDataList& other) const {
+    return items_ == other.items_ || get() == other.get();
+  }
+
+ private:
+  std::shared_ptr<const std::vector<NotificationData>> items_;
+};
+
 // A message published to a Subscription's client, carrying a sequence number,
 // publish time and notification data. OPC UA Part 4 §7.26 NotificationMessage,
 // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.26
@@ -401,7 +462,7 @@ struct NotificationMessage {
 
   UInt32 sequence_number = 0;
   DateTime publish_time;
-  std::vector<NotificationData> notification_data;
+  NotificationDataList notification_data;
 };
 
 // Publish acknowledges NotificationMessages and requests the next one (or a
@@ -443,9 +504,9 @@ struct RepublishResponse {
 
 // RegisterNodes / UnregisterNodes use the generated, spec-conformant ua:: wire
 // types directly (OPC UA Part 4 §5.9.5 / §5.9.6). Registration is an optional
-// optimization; this server keeps no registered-node handles, so the runtime
-// echoes the requested NodeIds (RegisterNodes) or treats it as a no-op
-// (UnregisterNodes) — see session/server_runtime.cpp.
+// optimization: with ServerRuntimeContext::registered_node_namespace_index set
+// the runtime hands out per-session alias NodeIds, otherwise it echoes the
+// requested NodeIds — see session/server_runtime.cpp.
 
 // Discriminated union of every Service request body this stack dispatches. The
 // envelope follows the OPC UA Message structure. OPC UA Part 6 §6.2 Message
@@ -18,6 +18,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <span>
 #include <utility>
 #include <vector>
@@ -53,9 +54,16 @@ class FakeMonitoredItemSubscription final : public MonitoredItemSubscription {
     // Status reported for every item in an `AddItems` batch. Set to a bad
     // status to exercise the bind-failure path.
     Status add_status{StatusCode::Good};
+    // EURange reported for every item bound, as a backend does for an analog
+    // Variable.
+    std::optional<EuRange> eu_range;
 
     std::vector<AddedItem> added_items;
     std::vector<MonitoredItemId> removed_item_ids;
+    // Number of `AddItems` / `RemoveItems` calls, however many items each one
+    // carried.
+    std::size_t add_calls = 0;
+    std::size_t remove_calls = 0;
     bool closed = false;
     Status close_status{StatusCode::Good};
 
@@ -144,6 +152,7 @@ class FakeMonitoredItemSubscription final : public MonitoredItemSubscription {
 
   Awaitable<std::vector<MonitoredItemCreateResult>> AddItems(
       std::vector<MonitoredItemCreateRequest> requests) override {
+    ++state_->add_calls;
     std::vector<MonitoredItemCreateResult> results;
     results.reserve(requests.size());
     for (auto& request : requests) {
@@ -157,7 +166,8 @@ class FakeMonitoredItemSubscription final : public MonitoredItemSubscription {
            .monitored_item_id = item_id,
            .revised_sampling_interval_ms =
                request.requested_parameters.sampling_interval_ms,
-           .revised_queue_size = request.requested_parameters.queue_size});
+           .revised_queue_size = request.requested_parameters.queue_size,
+           .eu_range = state_->eu_range});
       state_->added_items.push_back(
           {.item_id = item_id, .request = std::move(request)});
     }
@@ -166,6 +176,7 @@ class FakeMonitoredItemSubscription final : public MonitoredItemSubscription {
 
   Awaitable<std::vector<Status>> RemoveItems(
       std::span<const MonitoredItemId> item_ids) override {
+    ++state_->remove_calls;
     std::vector<Status> results;
     results.reserve(item_ids.size());
     for (const auto item_id : item_ids) {
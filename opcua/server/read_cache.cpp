@@ -0,0 +1,154 @@
+#include "opcua/server/read_cache.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace opcua {
+
+std::size_t ReadCache::KeyHash::operator()(const ReadValueId& key) const {
+  return std::hash<NodeId>{}(key.node_id) * 31 +
+         static_cast<std::size_t>(key.attribute_id);
+}
+
+ReadCache::ReadCache(ReadCacheContext&& context)
+    : ReadCacheContext{std::move(context)} {}
+
+CoStatusOr<std::vector<DataValue>> ReadCache::Read(
+    const ServiceCallbacks::ReadCallback& read,
+    ServiceContext service_context,
+    std::vector<ReadValueId> inputs,
+    double max_age_ms) {
+  const auto now_time = now();
+  const auto max_age = Duration::FromMilliseconds(
+      static_cast<int64_t>(std::min(max_age_ms, 1e15)));
+
+  std::vector<DataValue> results(inputs.size());
+  // Nodes this request reads from the source, and the positions they fill.
+  auto misses = std::make_shared<std::vector<ReadValueId>>();
+  std::vector<std::size_t> miss_indices;
+  std::vector<std::shared_ptr<PendingRead>> issued;
+  // Nodes another read already has in flight.
+  std::vector<std::pair<std::size_t, std::shared_ptr<PendingRead>>> awaited;
+
+  for (std::size_t index = 0; index < inputs.size(); ++index) {
+    const auto& key = inputs[index];
+    if (max_age_ms > 0) {
+      const auto it = index_.find(key);
+      if (it != index_.end() && now_time - it->second->stored_at <= max_age) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        results[index] = it->second->value;
+        ++counters_.hits;
+        continue;
+      }
+    }
+
+    ++counters_.misses;
+    if (const auto it = in_flight_.find(key); it != in_flight_.end()) {
+      ++counters_.merged;
+      awaited.emplace_back(index, it->second);
+      continue;
+    }
+    auto pending = std::make_shared<PendingRead>(executor);
+    in_flight_.emplace(key, pending);
+    issued.push_back(std::move(pending));
+    misses->push_back(key);
+    miss_indices.push_back(index);
+  }
+
+  if (!misses->empty()) {
+    // Completes this request's pending reads and lets go of them, so the
+    // requests waiting on them resume whatever happens to this one.
+    const auto settle = [&](std::vector<DataValue> values, Status status) {
+      const auto stored_at = now();
+      for (std::size_t i = 0; i < issued.size(); ++i) {
+        auto& pending = *issued[i];
+        const auto& key = (*misses)[i];
+        if (i < values.size()) {
+          pending.value = std::move(values[i]);
+          // A Bad result says nothing about the value; the next request has
+          // to ask the source again.
+          if (!pending.invalidated && IsGood(pending.value.status_code))
+            Store(key, pending.value, stored_at);
+        } else {
+          pending.value = DataValue{
+              status ? StatusCode::Bad : status.code(), stored_at};
+        }
+        results[miss_indices[i]] = pending.value;
+        if (const auto it = in_flight_.find(key);
+            it != in_flight_.end() && it->second == issued[i]) {
+          in_flight_.erase(it);
+        }
+        pending.done.Complete();
+      }
+    };
+
+    StatusOr<std::vector<DataValue>> result{StatusCode::Bad};
+    try {
+      // Named rather than a temporary of the co_await expression: GCC 12
+      // mishandles temporaries with non-trivial destructors that live across
+      // a suspension.
+      auto call =
+          read(service_context,
+               std::shared_ptr<const std::vector<ReadValueId>>(misses));
+      result = co_await std::move(call);
+    } catch (...) {
+      settle({}, StatusCode::Bad);
+      throw;
+    }
+
+    if (!result.ok()) {
+      settle({}, result.status());
+      co_return result.status();
+    }
+    settle(std::move(*result), StatusCode::Good);
+  }
+
+  for (auto& [index, pending] : awaited) {
+    co_await pending->done.Wait();
+    results[index] = pending->value;
+  }
+  co_return results;
+}
+
+void ReadCache::Update(const ReadValueId& key, const DataValue& value) {
+  Store(key, value, now());
+}
+
+void ReadCache::Invalidate(const ReadValueId& key) {
+  if (const auto it = in_flight_.find(key); it != in_flight_.end()) {
+    it->second->invalidated = true;
+    in_flight_.erase(it);
+  }
+
+  const auto it = index_.find(key);
+  if (it == index_.end())
+    return;
+  entries_.erase(it->second);
+  index_.erase(it);
+}
+
+void ReadCache::Store(const ReadValueId& key,
+                      DataValue value,
+                      DateTime stored_at) {
+  if (max_entries == 0)
+    return;
+
+  if (const auto it = index_.find(key); it != index_.end()) {
+    it->second->value = std::move(value);
+    it->second->stored_at = stored_at;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+
+  entries_.push_front(
+      {.key = key, .value = std::move(value), .stored_at = stored_at});
+  index_.emplace(key, entries_.begin());
+  if (entries_.size() > max_entries) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+    ++counters_.evictions;
+  }
+}
+
+}  // namespace opcua
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "opcua/base/any_executor.h"
+#include "opcua/base/async_completion.h"
+#include "opcua/base/awaitable.h"
+#include "opcua/services/service_callbacks.h"
+#include "opcua/services/service_context.h"
+#include "opcua/types/co_result.h"
+#include "opcua/types/data_value.h"
+#include "opcua/types/date_time.h"
+#include "opcua/types/read_value_id.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace opcua {
+
+struct ReadCacheContext {
+  // Executor the reads run on; every call into the cache must be made on it.
+  AnyExecutor executor;
+  // Most values held. The least recently used value is dropped first.
+  std::size_t max_entries = 10000;
+  std::function<DateTime()> now = &DateTime::Now;
+};
+
+// A bounded cache of attribute values in front of ServiceCallbacks::read,
+// keyed by (NodeId, AttributeId).
+//
+// A Read is served from the cache for the nodes whose cached value is no
+// older than the request's MaxAge. MaxAge 0 always goes to the source. The
+// remaining nodes go to `read` in one call. A node that another Read is
+// already fetching is not read twice: the later request waits for that call
+// and takes its value. Values come from Read results, and from subscription
+// data changes through Update.
+//
+// OPC UA Part 4 §5.10.2 Read,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.10.2
+//
+// Values are shared between sessions and users. Enable the cache only where
+// read access does not depend on the user.
+class ReadCache : private ReadCacheContext {
+ public:
+  struct Counters {
+    // Nodes answered from the cache.
+    std::uint64_t hits = 0;
+    // Nodes that had to be read from the source, including the merged ones.
+    std::uint64_t misses = 0;
+    // Misses answered by a read another request already had in flight.
+    std::uint64_t merged = 0;
+    // Values dropped to stay within max_entries.
+    std::uint64_t evictions = 0;
+  };
+
+  explicit ReadCache(ReadCacheContext&& context);
+
+  ReadCache(const ReadCache&) = delete;
+  ReadCache& operator=(const ReadCache&) = delete;
+
+  // Same contract as `read`: one value per input, or the status that failed
+  // the request. `max_age_ms` is the Read request's MaxAge.
+  [[nodiscard]] CoStatusOr<std::vector<DataValue>> Read(
+      const ServiceCallbacks::ReadCallback& read,
+      ServiceContext service_context,
+      std::vector<ReadValueId> inputs,
+      double max_age_ms);
+
+  // Records a value known to be current, such as a subscription data change.
+  void Update(const ReadValueId& key, const DataValue& value);
+  // Drops the value of a node that was just written. A read of it already in
+  // flight still answers its requests but is not stored, and later requests
+  // read the node again instead of waiting on it.
+  void Invalidate(const ReadValueId& key);
+
+  const Counters& counters() const { return counters_; }
+  std::size_t size() const { return entries_.size(); }
+
+ private:
+  struct KeyHash {
+    std::size_t operator()(const ReadValueId& key) const;
+  };
+
+  struct Entry {
+    ReadValueId key;
+    DataValue value;
+    DateTime stored_at;
+  };
+
+  // A read in flight for one key, which later requests for it wait on.
+  struct PendingRead {
+    explicit PendingRead(AnyExecutor executor) : done{std::move(executor)} {}
+
+    base::AsyncCompletion done;
+    DataValue value;
+    // Set by Invalidate: the value may predate a write, so it is not stored.
+    bool invalidated = false;
+  };
+
+  void Store(const ReadValueId& key, DataValue value, DateTime stored_at);
+
+  // Most recently used first; `index_` points into it.
+  std::list<Entry> entries_;
+  std::unordered_map<ReadValueId, std::list<Entry>::iterator, KeyHash> index_;
+  std::unordered_map<ReadValueId, std::shared_ptr<PendingRead>, KeyHash>
+      in_flight_;
+  Counters counters_;
+};
+
+}  // namespace opcua
@@ -0,0 +1,213 @@
+#include "opcua/server/read_cache.h"
+
+#include "opcua/base/test/awaitable_test.h"
+#include "opcua/base/test/test_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace opcua {
+namespace {
+
+ReadValueId ValueOf(NumericId id) {
+  return {.node_id = NodeId{id, 2}, .attribute_id = AttributeId::Value};
+}
+
+// A ReadCache over a source that answers each node with how many nodes it has
+// read so far, so a test can tell a fresh value from a cached one. While
+// `gate_` is set the source holds its answer until the gate completes.
+class ReadCacheTest : public testing::Test {
+ protected:
+  ReadCacheTest() {
+    read_ = [this](ServiceContext,
+                   std::shared_ptr<const std::vector<ReadValueId>> inputs)
+        -> CoStatusOr<std::vector<DataValue>> {
+      ++read_calls_;
+      if (gate_.has_value())
+        co_await gate_->Wait();
+      std::vector<DataValue> values;
+      for (std::size_t i = 0; i < inputs->size(); ++i) {
+        values.push_back(
+            DataValue{Variant{static_cast<Int32>(++source_reads_)}, {}, now_,
+                      now_});
+      }
+      co_return values;
+    };
+  }
+
+  std::vector<DataValue> Read(std::vector<ReadValueId> inputs,
+                              double max_age_ms) {
+    auto result = WaitAwaitable(
+        executor_,
+        cache_.Read(read_, ServiceContext{}, std::move(inputs), max_age_ms));
+    EXPECT_TRUE(result.ok());
+    return result.ok() ? std::move(*result) : std::vector<DataValue>{};
+  }
+
+  static Int32 ValueIn(const DataValue& value) {
+    return value.value.get<Int32>();
+  }
+
+  void Advance(int64_t ms) { now_ = now_ + Duration::FromMilliseconds(ms); }
+
+  DateTime now_ = DateTime::Now();
+  TestExecutor executor_;
+  ReadCache cache_{{.executor = AnyExecutor{executor_},
+                    .max_entries = 2,
+                    .now = [this] { return now_; }}};
+  ServiceCallbacks::ReadCallback read_;
+  std::optional<base::AsyncCompletion> gate_;
+  int read_calls_ = 0;
+  int source_reads_ = 0;
+};
+
+TEST_F(ReadCacheTest, ServesValuesYoungerThanMaxAge) {
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]), 1);
+
+  Advance(500);
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]), 1);
+
+  // Older than the next request allows: read again.
+  Advance(600);
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]), 2);
+
+  EXPECT_EQ(read_calls_, 2);
+  EXPECT_EQ(cache_.counters().hits, 1u);
+  EXPECT_EQ(cache_.counters().misses, 2u);
+}
+
+// OPC UA Part 4 §5.10.2: MaxAge 0 asks for a value read from the source.
+TEST_F(ReadCacheTest, MaxAgeZeroAlwaysReadsTheSource) {
+  Read({ValueOf(1)}, 1000);
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 0)[0]), 2);
+  EXPECT_EQ(cache_.counters().hits, 0u);
+}
+
+TEST_F(ReadCacheTest, ReadsOnlyTheNodesItDoesNotHold) {
+  Read({ValueOf(1)}, 1000);
+
+  const auto values = Read({ValueOf(2), ValueOf(1)}, 1000);
+  EXPECT_EQ(ValueIn(values[0]), 2);
+  EXPECT_EQ(ValueIn(values[1]), 1);
+  EXPECT_EQ(source_reads_, 2);
+}
+
+TEST_F(ReadCacheTest, MergesConcurrentMissesForTheSameNode) {
+  gate_.emplace(executor_);
+  auto first = StartAwaitable(
+      executor_, cache_.Read(read_, ServiceContext{}, {ValueOf(1)}, 1000));
+  auto second = StartAwaitable(
+      executor_,
+      cache_.Read(read_, ServiceContext{}, {ValueOf(1), ValueOf(2)}, 1000));
+  Drain(executor_);
+  EXPECT_FALSE(first->done);
+  EXPECT_FALSE(second->done);
+
+  gate_->Complete();
+  Drain(executor_);
+
+  ASSERT_TRUE(first->done);
+  ASSERT_TRUE(second->done);
+  // One call per request, and node 1 read once between them.
+  EXPECT_EQ(read_calls_, 2);
+  EXPECT_EQ(source_reads_, 2);
+  EXPECT_EQ(ValueIn((*first->value)->at(0)), ValueIn((*second->value)->at(0)));
+  EXPECT_EQ(cache_.counters().merged, 1u);
+}
+
+TEST_F(ReadCacheTest, EvictsTheLeastRecentlyUsedValue) {
+  Read({ValueOf(1)}, 1000);
+  Read({ValueOf(2)}, 1000);
+  // Touching node 1 leaves node 2 the oldest.
+  Read({ValueOf(1)}, 1000);
+  Read({ValueOf(3)}, 1000);
+
+  EXPECT_EQ(cache_.size(), 2u);
+  EXPECT_EQ(cache_.counters().evictions, 1u);
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]), 1);
+  EXPECT_EQ(ValueIn(Read({ValueOf(2)}, 1000)[0]), 4);
+}
+
+TEST_F(ReadCacheTest, UpdatesAndInvalidationsKeepTheCacheCurrent) {
+  Read({ValueOf(1)}, 1000);
+
+  // A data change from a subscription replaces the value.
+  Advance(900);
+  cache_.Update(ValueOf(1), DataValue{Variant{Int32{42}}, {}, now_, now_});
+  Advance(900);
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]), 42);
+
+  // A write drops it.
+  cache_.Invalidate(ValueOf(1));
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]), 2);
+}
+
+TEST_F(ReadCacheTest, AFailedReadIsNotCached) {
+  read_ = [this](ServiceContext,
+                 std::shared_ptr<const std::vector<ReadValueId>>)
+      -> CoStatusOr<std::vector<DataValue>> {
+    ++read_calls_;
+    co_return StatusCode::Bad_NoCommunication;
+  };
+
+  for (int i = 0; i < 2; ++i) {
+    const auto result = WaitAwaitable(
+        executor_, cache_.Read(read_, ServiceContext{}, {ValueOf(1)}, 1000));
+    EXPECT_EQ(result.status().code(), StatusCode::Bad_NoCommunication);
+  }
+  EXPECT_EQ(read_calls_, 2);
+  EXPECT_EQ(cache_.size(), 0u);
+}
+
+TEST_F(ReadCacheTest, AFailedNodeIsNotCached) {
+  read_ = [this](ServiceContext,
+                 std::shared_ptr<const std::vector<ReadValueId>> inputs)
+      -> CoStatusOr<std::vector<DataValue>> {
+    ++read_calls_;
+    co_return std::vector<DataValue>(
+        inputs->size(), DataValue{StatusCode::Bad_NodeIdUnknown, now_});
+  };
+
+  for (int i = 0; i < 2; ++i) {
+    const auto values = Read({ValueOf(1)}, 1000);
+    ASSERT_EQ(values.size(), 1u);
+    EXPECT_EQ(values[0].status_code, StatusCode::Bad_NodeIdUnknown);
+  }
+  EXPECT_EQ(read_calls_, 2);
+  EXPECT_EQ(cache_.size(), 0u);
+}
+
+// A read issued before a write may answer with the value the write replaced.
+// It still answers the request that issued it, but it must not be cached, and
+// a request arriving after the write must not wait on it.
+TEST_F(ReadCacheTest, AReadInFlightAcrossAWriteIsNotCached) {
+  gate_.emplace(executor_);
+  auto before_write = StartAwaitable(
+      executor_, cache_.Read(read_, ServiceContext{}, {ValueOf(1)}, 1000));
+  Drain(executor_);
+
+  cache_.Invalidate(ValueOf(1));
+  auto after_write = StartAwaitable(
+      executor_, cache_.Read(read_, ServiceContext{}, {ValueOf(1)}, 1000));
+  Drain(executor_);
+  EXPECT_EQ(read_calls_, 2);
+  EXPECT_EQ(cache_.counters().merged, 0u);
+
+  gate_->Complete();
+  Drain(executor_);
+  ASSERT_TRUE(before_write->done);
+  ASSERT_TRUE(after_write->done);
+  gate_.reset();
+
+  // Only the read issued after the write is held.
+  EXPECT_EQ(cache_.size(), 1u);
+  EXPECT_EQ(ValueIn(Read({ValueOf(1)}, 1000)[0]),
+            ValueIn((*after_write->value)->at(0)));
+  EXPECT_EQ(read_calls_, 2);
+}
+
+}  // namespace
+}  // namespace opcua
@@ -2,11 +2,13 @@
 
 #include "opcua/base/boost_log.h"
 #include "opcua/base/debug_util.h"
+#include "opcua/base/run_concurrently.h"
 #include "opcua/base/time_ticks.h"
 #include "opcua/services/browse_conversion.h"
 #include "opcua/services/history_conversion.h"
 #include "opcua/services/node_attributes_conversion.h"
 #include "opcua/types/date_time.h"
+#include "opcua/types/numeric_range.h"
 
 #include <cstdint>
 #include <optional>
@@ -79,6 +81,22 @@ std::vector<DataValue> NormalizeReadResults(std::vector<DataValue> results) {
   return results;
 }
 
+// Cuts each read value down to its node's IndexRange, before the response is
+// encoded. A range that selects nothing replaces the value with its status.
+// OPC UA Part 4 §7.29 ReadValueId,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/7.29
+void ApplyIndexRanges(const std::vector<std::optional<NumericRange>>& ranges,
+                      std::vector<DataValue>& results) {
+  for (std::size_t i = 0; i < ranges.size() && i < results.size(); ++i) {
+    const auto& range = ranges[i];
+    auto& result = results[i];
+    if (!range.has_value() || IsBad(result.status_code))
+      continue;
+    if (const auto status = range->Apply(result.value); !status)
+      result = DataValue{status.code(), result.server_timestamp};
+  }
+}
+
 }  // namespace
 
 ServiceHandler::ServiceHandler(ServiceHandlerContext&& context)
@@ -140,22 +158,66 @@ Awaitable<ServiceResponse> ServiceHandler::HandleRead(
                                 StatusCode::Bad_TimestampsToReturnInvalid}}};
   }
   // The read callback keeps the hand-written ReadValueId (client/bridge
-  // vocabulary); IndexRange and DataEncoding are not modelled and are dropped.
+  // vocabulary) and reads whole values; the IndexRange is applied to its
+  // results here. DataEncoding is not modelled and is dropped. A node whose
+  // IndexRange does not parse is answered Bad_IndexRangeInvalid without being
+  // read, whatever the source would have said about it.
   auto inputs = std::make_shared<std::vector<ReadValueId>>();
   inputs->reserve(request.nodes_to_read.size());
-  for (const auto& value : request.nodes_to_read) {
+  std::vector<std::optional<NumericRange>> index_ranges;
+  std::vector<bool> invalid_ranges;
+  for (std::size_t index = 0; index < request.nodes_to_read.size(); ++index) {
+    auto& value = request.nodes_to_read[index];
+    if (!value.index_range.empty()) {
+      auto range = NumericRange::Parse(value.index_range);
+      if (!range.ok()) {
+        invalid_ranges.resize(request.nodes_to_read.size());
+        invalid_ranges[index] = true;
+        continue;
+      }
+      index_ranges.resize(request.nodes_to_read.size());
+      index_ranges[index] = std::move(*range);
+    }
     inputs->push_back(
-        {.node_id = value.node_id,
+        {.node_id = std::move(value.node_id),
          .attribute_id = static_cast<AttributeId>(value.attribute_id)});
   }
-  const auto input_count = inputs->size();
+  const auto input_count = request.nodes_to_read.size();
   const auto start_ticks = base::TimeTicks::Now();
-  auto result = co_await callbacks.read(
-      service_context,
-      std::shared_ptr<const std::vector<ReadValueId>>(std::move(inputs)));
+  // Stays empty when every range was invalid: there is nothing to read.
+  StatusOr<std::vector<DataValue>> result{std::vector<DataValue>{}};
+  if (!inputs->empty() && read_cache) {
+    // Named rather than a temporary of the co_await expression: GCC 12
+    // mishandles temporaries with non-trivial destructors that live across a
+    // suspension.
+    auto cached_read = read_cache->Read(callbacks.read, service_context,
+                                        std::move(*inputs), request.max_age);
+    result = co_await std::move(cached_read);
+  } else if (!inputs->empty()) {
+    result = co_await callbacks.read(
+        service_context,
+        std::shared_ptr<const std::vector<ReadValueId>>(std::move(inputs)));
+  }
+  if (result.ok() && !invalid_ranges.empty()) {
+    // Put the nodes that were not read back in their request positions.
+    const auto now = DateTime::Now();
+    std::vector<DataValue> merged;
+    merged.reserve(input_count);
+    auto read_value = result->begin();
+    for (std::size_t index = 0; index < input_count; ++index) {
+      if (invalid_ranges[index])
+        merged.emplace_back(StatusCode::Bad_IndexRangeInvalid, now);
+      else if (read_value != result->end())
+        merged.push_back(std::move(*read_value++));
+      else
+        break;
+    }
+    result = std::move(merged);
+  }
   auto status = result.status();
   auto results = std::move(result).value_or({});
   results = NormalizeReadResults(std::move(results));
+  ApplyIndexRanges(index_ranges, results);
   ApplyTimestampsToReturn(results, timestamps_to_return);
   const auto duration = base::TimeTicks::Now() - start_ticks;
   // The trace tag ties this record to the caller's distributed trace in
@@ -202,9 +264,19 @@ Awaitable<ServiceResponse> ServiceHandler::HandleWrite(
   }
   const auto input_count = inputs->size();
   const auto start_ticks = base::TimeTicks::Now();
+  // A cached value of a written node is stale whether or not the write took.
+  std::vector<ReadValueId> written;
+  if (read_cache) {
+    written.reserve(inputs->size());
+    for (const auto& input : *inputs)
+      written.push_back(
+          {.node_id = input.node_id, .attribute_id = input.attribute_id});
+  }
   auto result = co_await callbacks.write(
       service_context,
       std::shared_ptr<const std::vector<WriteValue>>(std::move(inputs)));
+  for (const auto& key : written)
+    read_cache->Invalidate(key);
   auto status = result.status();
   auto results = std::move(result).value_or({});
   const auto duration = base::TimeTicks::Now() - start_ticks;
@@ -310,12 +382,46 @@ Awaitable<ServiceResponse> ServiceHandler::HandleCall(
   const auto start_ticks = base::TimeTicks::Now();
   std::size_t good_count = 0;
   ua::CallResponse response;
-  response.results.reserve(request.methods_to_call.size());
   std::size_t output_count = 0;
-  for (auto& method : request.methods_to_call) {
-    auto result = co_await callbacks.call(
-        std::move(method.object_id), std::move(method.method_id),
-        std::move(method.input_arguments), service_context);
+
+  // Methods are independent operations (OPC UA Part 4 §5.11.2), so they are
+  // dispatched together rather than each waiting out the one before it: a
+  // batched backend gets the whole request, otherwise the per-method calls
+  // run concurrently up to the configured cap.
+  std::vector<StatusOr<CallResult>> results;
+  if (callbacks.call_batch) {
+    std::vector<CallMethod> methods;
+    methods.reserve(input_count);
+    for (auto& method : request.methods_to_call) {
+      methods.push_back({.object_id = std::move(method.object_id),
+                         .method_id = std::move(method.method_id),
+                         .input_arguments = std::move(method.input_arguments)});
+    }
+    // Started outside the co_await expression so the argument temporaries do
+    // not live across the suspension, which GCC 12 mishandles.
+    auto batch_call = callbacks.call_batch(service_context, std::move(methods));
+    auto batch = co_await std::move(batch_call);
+    if (!batch.ok()) {
+      response.response_header.service_result = batch.status();
+      co_return ServiceResponse{std::move(response)};
+    }
+    results = std::move(*batch);
+    // A backend answering the wrong number of methods must not shift results
+    // onto the wrong operations; the unanswered ones fail.
+    results.resize(input_count, StatusOr<CallResult>{Status{StatusCode::Bad}});
+  } else {
+    results = co_await RunConcurrently<StatusOr<CallResult>>(
+        input_count, callbacks.max_concurrent_calls,
+        [this, &request](std::size_t index) {
+          auto& method = request.methods_to_call[index];
+          return callbacks.call(
+              std::move(method.object_id), std::move(method.method_id),
+              std::move(method.input_arguments), service_context);
+        });
+  }
+
+  response.results.reserve(results.size());
+  for (auto& result : results) {
     // input_argument_results is left empty: OPC UA Part 4 §5.11.2 populates it
     // only alongside Bad_InvalidArgument, which arrives here as a StatusOr
     // error with no value to draw the per-argument detail from.
@@ -351,33 +457,60 @@ Awaitable<ServiceResponse> ServiceHandler::HandleHistoryRead(
     ua::HistoryReadRequest request) const {
   // Decode the details ExtensionObject into the managed raw/events read (the
   // callbacks keep the hand-written history vocabulary). An unsupported request
-  // (multi-node, bad details, ...) yields a service-level fault.
+  // (bad details, ...) yields a service-level fault.
   auto decoded = history_conversion::ToManaged(request);
+  const auto max_nodes =
+      decoded && decoded->is_events()
+          ? operation_limits.max_nodes_per_history_read_events
+          : operation_limits.max_nodes_per_history_read_data;
+  if (auto status =
+          ValidateOperationCount(request.nodes_to_read.size(), max_nodes)) {
+    co_return ServiceResponse{ua::HistoryReadResponse{
+        .response_header = {.service_result = *status}}};
+  }
   if (!decoded) {
     co_return ServiceResponse{ua::HistoryReadResponse{
         .response_header = {.service_result =
                                 StatusCode::Bad_HistoryOperationInvalid}}};
   }
-  if (auto* raw = std::get_if<HistoryReadRawDetails>(&decoded->details)) {
-    // OPC UA Part 11 §6.4.3 ReadRawModifiedDetails: a raw read must bound the
-    // data by a time range or continue an existing read; with neither a start
-    // nor end time and no continuation point the details are invalid.
-    // https://reference.opcfoundation.org/Core/Part11/v105/docs/6.4.3
-    if (raw->from.is_null() && raw->to.is_null() &&
-        raw->continuation_point.empty() && !raw->release_continuation_point) {
-      co_return ServiceResponse{history_conversion::ToWireRawResponse(
-          Status{StatusCode::Bad_HistoryOperationInvalid})};
-    }
-    auto result = co_await callbacks.history_read_raw(std::move(*raw));
+
+  // The callbacks serve one node each. They run concurrently, at most the
+  // node limit at a time, so a trend of many pens costs one round trip and
+  // about the time of its slowest pen rather than the sum of them all.
+  if (!decoded->is_events()) {
+    auto results = co_await RunConcurrently<StatusOr<HistoryReadRawResult>>(
+        decoded->nodes.size(), max_nodes,
+        [this,
+         &decoded](std::size_t index) -> CoStatusOr<HistoryReadRawResult> {
+          auto& raw = std::get<HistoryReadRawDetails>(decoded->nodes[index]);
+          // OPC UA Part 11 §6.4.3 ReadRawModifiedDetails: a raw read must
+          // bound the data by a time range or continue an existing read; with
+          // neither a start nor end time and no continuation point the details
+          // are invalid.
+          // https://reference.opcfoundation.org/Core/Part11/v105/docs/6.4.3
+          if (raw.from.is_null() && raw.to.is_null() &&
+              raw.continuation_point.empty() &&
+              !raw.release_continuation_point) {
+            co_return Status{StatusCode::Bad_HistoryOperationInvalid};
+          }
+          co_return co_await callbacks.history_read_raw(std::move(raw));
+        });
     co_return ServiceResponse{
-        history_conversion::ToWireRawResponse(std::move(result))};
+        history_conversion::ToWireRawResponse(std::move(results))};
   }
-  auto& events = std::get<HistoryReadEventsDetails>(decoded->details);
-  auto result = co_await callbacks.history_read_events(
-      std::move(events.node_id), events.from, events.to,
-      std::move(events.filter));
+
+  auto results = co_await RunConcurrently<StatusOr<HistoryReadEventsResult>>(
+      decoded->nodes.size(), max_nodes,
+      [this,
+       &decoded](std::size_t index) -> CoStatusOr<HistoryReadEventsResult> {
+        auto& events =
+            std::get<HistoryReadEventsDetails>(decoded->nodes[index]);
+        co_return co_await callbacks.history_read_events(
+            std::move(events.node_id), events.from, events.to,
+            std::move(events.filter));
+      });
   co_return ServiceResponse{history_conversion::ToWireEventsResponse(
-      std::move(result), decoded->event_field_paths)};
+      std::move(results), decoded->event_field_paths)};
 }
 
 Awaitable<ServiceResponse> ServiceHandler::HandleHistoryUpdate(
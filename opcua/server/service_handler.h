@@ -1,6 +1,7 @@
 #pragma once
 
 #include "opcua/base/awaitable.h"
+#include "opcua/server/read_cache.h"
 #include "opcua/services/operation_limits.h"
 #include "opcua/services/service_callbacks.h"
 #include "opcua/services/service_context.h"
@@ -17,6 +18,9 @@ struct ServiceHandlerContext {
   // authorization checks — not just the user id.
   ServiceContext service_context;
   OperationLimits operation_limits;
+  // Optional. Reads go through it, honouring their MaxAge, and Writes drop
+  // what they wrote from it. Outlives the handler.
+  ReadCache* read_cache = nullptr;
 };
 
 class ServiceHandler : private ServiceHandlerContext {
@@ -1,3 +1,4 @@
+#include "opcua/base/async_completion.h"
 #include "opcua/base/test/awaitable_test.h"
 #include "opcua/base/test/test_executor.h"
 #include "opcua/server/service_handler.h"
@@ -6,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include <initializer_list>
 #include <utility>
 #include <vector>
 
@@ -126,5 +128,186 @@ TEST(ServiceHandlerCallTest, BatchedResultsStayAlignedAcrossAFailure) {
             (NodeId{3, 2}));
 }
 
+ua::CallRequest MethodsOnOneObject(std::initializer_list<NumericId> ids) {
+  ua::CallRequest request;
+  for (NumericId id : ids) {
+    request.methods_to_call.push_back(ua::CallMethodRequest{
+        .object_id = NodeId{9, 2}, .method_id = NodeId{id, 2}});
+  }
+  return request;
+}
+
+// Uncapped, the methods of one request are in flight together — a batch of
+// slow device commands costs about one command, not their sum — and still
+// answer in request order whatever order they finish in.
+TEST(ServiceHandlerCallTest, MethodsOfOneRequestRunConcurrently) {
+  TestExecutor executor;
+  std::vector<base::AsyncCompletion> releases;
+  for (int i = 0; i < 3; ++i)
+    releases.emplace_back(executor);
+  std::vector<NodeId> started;
+
+  ServiceCallbacks callbacks;
+  callbacks.max_concurrent_calls = 0;
+  callbacks.call = [&](NodeId, NodeId method_id, std::vector<Variant>,
+                       ServiceContext) -> CoStatusOr<CallResult> {
+    started.push_back(method_id);
+    co_await releases[started.size() - 1].Wait();
+    co_return CallResult{{Variant{method_id}}};
+  };
+
+  const auto handler = MakeHandler(std::move(callbacks));
+  auto result = StartAwaitable(executor,
+                               handler.Handle(MethodsOnOneObject({1, 2, 3})));
+  Drain(executor);
+  EXPECT_EQ(started.size(), 3u);
+  EXPECT_FALSE(result->done);
+
+  for (auto release = releases.rbegin(); release != releases.rend();
+       ++release) {
+    release->Complete();
+    Drain(executor);
+  }
+
+  ASSERT_TRUE(result->done);
+  const auto* call_response = std::get_if<ua::CallResponse>(&*result->value);
+  ASSERT_NE(call_response, nullptr);
+  ASSERT_EQ(call_response->results.size(), 3u);
+  for (NumericId id : {1, 2, 3}) {
+    const auto& outputs = call_response->results[id - 1].output_arguments;
+    ASSERT_EQ(outputs.size(), 1u);
+    EXPECT_EQ(outputs[0].get<NodeId>(), (NodeId{id, 2}));
+  }
+}
+
+// max_concurrent_calls caps the methods in flight; each one finishing starts
+// the next.
+TEST(ServiceHandlerCallTest, ConcurrentCallsStayWithinTheCap) {
+  TestExecutor executor;
+  std::vector<base::AsyncCompletion> releases;
+  for (int i = 0; i < 4; ++i)
+    releases.emplace_back(executor);
+  std::size_t started = 0;
+
+  ServiceCallbacks callbacks;
+  callbacks.max_concurrent_calls = 2;
+  callbacks.call = [&](NodeId, NodeId, std::vector<Variant>,
+                       ServiceContext) -> CoStatusOr<CallResult> {
+    co_await releases[started++].Wait();
+    co_return CallResult{};
+  };
+
+  const auto handler = MakeHandler(std::move(callbacks));
+  auto result = StartAwaitable(
+      executor, handler.Handle(MethodsOnOneObject({1, 2, 3, 4})));
+  Drain(executor);
+  EXPECT_EQ(started, 2u);
+
+  releases[0].Complete();
+  Drain(executor);
+  EXPECT_EQ(started, 3u);
+
+  for (auto& release : releases) {
+    if (!release.completed())
+      release.Complete();
+    Drain(executor);
+  }
+  ASSERT_TRUE(result->done);
+  EXPECT_EQ(started, 4u);
+}
+
+// By default a `call` never runs alongside itself: the next method starts only
+// once the one before it has answered.
+TEST(ServiceHandlerCallTest, MethodsRunOneAfterAnotherByDefault) {
+  TestExecutor executor;
+  std::vector<base::AsyncCompletion> releases;
+  for (int i = 0; i < 2; ++i)
+    releases.emplace_back(executor);
+  std::size_t started = 0;
+
+  ServiceCallbacks callbacks;
+  callbacks.call = [&](NodeId, NodeId, std::vector<Variant>,
+                       ServiceContext) -> CoStatusOr<CallResult> {
+    co_await releases[started++].Wait();
+    co_return CallResult{};
+  };
+
+  const auto handler = MakeHandler(std::move(callbacks));
+  auto result =
+      StartAwaitable(executor, handler.Handle(MethodsOnOneObject({1, 2})));
+  Drain(executor);
+  EXPECT_EQ(started, 1u);
+
+  releases[0].Complete();
+  Drain(executor);
+  EXPECT_EQ(started, 2u);
+
+  releases[1].Complete();
+  Drain(executor);
+  ASSERT_TRUE(result->done);
+}
+
+// A batched callback gets every method of the request in one call, and its
+// per-method results land on their operations.
+TEST(ServiceHandlerCallTest, BatchCallbackReceivesTheWholeRequest) {
+  std::vector<CallMethod> seen_methods;
+  ServiceCallbacks callbacks;
+  callbacks.call = [](NodeId, NodeId, std::vector<Variant>,
+                      ServiceContext) -> CoStatusOr<CallResult> {
+    ADD_FAILURE() << "the batched callback takes precedence";
+    co_return CallResult{};
+  };
+  callbacks.call_batch = [&](ServiceContext, std::vector<CallMethod> methods)
+      -> CoStatusOr<std::vector<StatusOr<CallResult>>> {
+    seen_methods = methods;
+    std::vector<StatusOr<CallResult>> results;
+    for (const auto& method : methods) {
+      if (method.method_id == NodeId{2, 2})
+        results.emplace_back(Status{StatusCode::Bad_MethodInvalid});
+      else
+        results.emplace_back(CallResult{{Variant{method.method_id}}});
+    }
+    co_return results;
+  };
+
+  TestExecutor executor;
+  auto response =
+      WaitAwaitable(executor, MakeHandler(std::move(callbacks))
+                                  .Handle(MethodsOnOneObject({1, 2, 3})));
+
+  ASSERT_EQ(seen_methods.size(), 3u);
+  EXPECT_EQ(seen_methods[0].object_id, (NodeId{9, 2}));
+  EXPECT_EQ(seen_methods[2].method_id, (NodeId{3, 2}));
+  const auto* call_response = std::get_if<ua::CallResponse>(&response);
+  ASSERT_NE(call_response, nullptr);
+  ASSERT_EQ(call_response->results.size(), 3u);
+  EXPECT_TRUE(call_response->results[0].status_code.good());
+  EXPECT_EQ(call_response->results[1].status_code.code(),
+            StatusCode::Bad_MethodInvalid);
+  ASSERT_EQ(call_response->results[2].output_arguments.size(), 1u);
+  EXPECT_EQ(call_response->results[2].output_arguments[0].get<NodeId>(),
+            (NodeId{3, 2}));
+}
+
+// A batched callback that fails outright fails the service, not each method.
+TEST(ServiceHandlerCallTest, AFailedBatchFailsTheService) {
+  ServiceCallbacks callbacks;
+  callbacks.call_batch = [](ServiceContext, std::vector<CallMethod>)
+      -> CoStatusOr<std::vector<StatusOr<CallResult>>> {
+    co_return Status{StatusCode::Bad_NoCommunication};
+  };
+
+  TestExecutor executor;
+  auto response =
+      WaitAwaitable(executor, MakeHandler(std::move(callbacks))
+                                  .Handle(MethodsOnOneObject({1, 2})));
+
+  const auto* call_response = std::get_if<ua::CallResponse>(&response);
+  ASSERT_NE(call_response, nullptr);
+  EXPECT_EQ(call_response->response_header.service_result.code(),
+            StatusCode::Bad_NoCommunication);
+  EXPECT_TRUE(call_response->results.empty());
+}
+
 }  // namespace
 }  // namespace opcua
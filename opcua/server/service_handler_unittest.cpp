@@ -1,9 +1,11 @@
 #include "opcua/server/service_handler.h"
 
+#include "opcua/base/async_completion.h"
 #include "opcua/base/test/awaitable_test.h"
 #include "opcua/base/test/test_executor.h"
 #include "opcua/services/service_context.h"
 #include "opcua/types/co_result.h"
+#include "opcua/ua/ua_extension_object_any.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -158,6 +160,95 @@ TEST(ServiceHandlerTest, AReadOperationFailureLeavesTheServiceCallGood) {
             0x80340000u);
 }
 
+// The backend reads whole values and the handler cuts them down to each
+// node's IndexRange before the response is encoded.
+TEST(ServiceHandlerTest, ReadSlicesEachValueToItsIndexRange) {
+  ServiceCallbacks callbacks;
+  callbacks.read = [](ServiceContext,
+                      std::shared_ptr<const std::vector<ReadValueId>> inputs)
+      -> CoStatusOr<std::vector<DataValue>> {
+    std::vector<DataValue> values{
+        DataValue{std::vector<Double>{1.0, 2.0, 3.0, 4.0}, {}, {}, {}},
+        DataValue{String{"Pump"}, {}, {}, {}},
+        DataValue{Int32{5}, {}, {}, {}},
+        DataValue{Int32{5}, {}, {}, {}}};
+    values.resize(inputs->size());
+    co_return values;
+  };
+
+  ua::ReadRequest request;
+  for (const auto* index_range : {"2:9", "1:2", "0", "1:x"}) {
+    request.nodes_to_read.push_back(
+        {.node_id = NumericNode(1),
+         .attribute_id = static_cast<UInt32>(AttributeId::Value),
+         .index_range = index_range});
+  }
+
+  TestExecutor executor;
+  const auto response = WaitAwaitable(
+      executor, MakeHandler(std::move(callbacks)).Handle(request));
+
+  const auto* read_response = std::get_if<ua::ReadResponse>(&response);
+  ASSERT_NE(read_response, nullptr);
+  ASSERT_EQ(read_response->results.size(), 4u);
+  EXPECT_EQ(read_response->results[0].value.get<std::vector<Double>>(),
+            (std::vector<Double>{3.0, 4.0}));
+  EXPECT_EQ(read_response->results[1].value, Variant{String{"um"}});
+  EXPECT_EQ(read_response->results[2].status_code,
+            StatusCode::Bad_IndexRangeNoData);
+  EXPECT_EQ(read_response->results[3].status_code,
+            StatusCode::Bad_IndexRangeInvalid);
+}
+
+// A malformed IndexRange is the request's fault, not the node's: it is
+// answered Bad_IndexRangeInvalid without reaching the backend, so a Bad status
+// the backend would have reported for the node cannot hide it.
+TEST(ServiceHandlerTest, ReadRejectsMalformedIndexRangesBeforeReading) {
+  std::vector<ReadValueId> read_inputs;
+  ServiceCallbacks callbacks;
+  callbacks.read = [&](ServiceContext,
+                       std::shared_ptr<const std::vector<ReadValueId>> inputs)
+      -> CoStatusOr<std::vector<DataValue>> {
+    read_inputs.insert(read_inputs.end(), inputs->begin(), inputs->end());
+    co_return std::vector<DataValue>(
+        inputs->size(), DataValue{StatusCode::Bad_NodeIdUnknown, {}});
+  };
+
+  ua::ReadRequest request;
+  for (NumericId id : {1, 2}) {
+    request.nodes_to_read.push_back(
+        {.node_id = NumericNode(id),
+         .attribute_id = static_cast<UInt32>(AttributeId::Value),
+         .index_range = id == 1 ? "1:x" : ""});
+  }
+
+  TestExecutor executor;
+  const auto handler = MakeHandler(std::move(callbacks));
+  const auto response = WaitAwaitable(executor, handler.Handle(request));
+
+  const auto* read_response = std::get_if<ua::ReadResponse>(&response);
+  ASSERT_NE(read_response, nullptr);
+  EXPECT_EQ(read_response->response_header.service_result.code(),
+            StatusCode::Good);
+  ASSERT_EQ(read_response->results.size(), 2u);
+  EXPECT_EQ(read_response->results[0].status_code,
+            StatusCode::Bad_IndexRangeInvalid);
+  EXPECT_TRUE(IsBad(read_response->results[1].status_code));
+  ASSERT_EQ(read_inputs.size(), 1u);
+  EXPECT_EQ(read_inputs[0].node_id, NumericNode(2));
+
+  // With every range malformed there is nothing to read at all.
+  read_inputs.clear();
+  request.nodes_to_read.pop_back();
+  const auto rejected = WaitAwaitable(executor, handler.Handle(request));
+  const auto* rejected_response = std::get_if<ua::ReadResponse>(&rejected);
+  ASSERT_NE(rejected_response, nullptr);
+  ASSERT_EQ(rejected_response->results.size(), 1u);
+  EXPECT_EQ(rejected_response->results[0].status_code,
+            StatusCode::Bad_IndexRangeInvalid);
+  EXPECT_TRUE(read_inputs.empty());
+}
+
 // Node-management mutations answer per operation. The runtime contract pins
 // this for AddNodes; the three remaining mutations need their own coverage
 // because each has a separate response-building path, and DeleteReferences
@@ -237,5 +328,90 @@ TEST(ServiceHandlerTest, NodeMutationsPropagatePerOperationStatuses) {
   EXPECT_TRUE(delete_references->results.empty());
 }
 
+// A multi-node HistoryRead hands every node to its own callback, all of them
+// in flight together, and maps the results back in request order.
+TEST(ServiceHandlerTest, HistoryReadRunsEveryNodeConcurrently) {
+  TestExecutor executor;
+  base::AsyncCompletion release{executor};
+  std::vector<NodeId> started;
+
+  ServiceCallbacks callbacks;
+  callbacks.history_read_raw =
+      [&](HistoryReadRawDetails details) -> CoStatusOr<HistoryReadRawResult> {
+    started.push_back(details.node_id);
+    co_await release.Wait();
+    if (details.node_id == NumericNode(2))
+      co_return Status{StatusCode::Bad_NodeIdUnknown};
+    co_return HistoryReadRawResult{.values = {DataValue{
+        Variant{static_cast<double>(details.node_id.numeric_id())}, {},
+        DateTime{}, DateTime{}}}};
+  };
+
+  const auto start = DateTime::Now();
+  const auto handler = MakeHandler(std::move(callbacks));
+  auto result = StartAwaitable(
+      executor,
+      handler.Handle(ua::HistoryReadRequest{
+          .history_read_details =
+              ua::ToExtensionObject(ua::ReadRawModifiedDetails{
+                  .start_time = start,
+                  .end_time = start + Duration::FromSeconds(60)}),
+          .nodes_to_read = {{.node_id = NumericNode(1)},
+                            {.node_id = NumericNode(2)},
+                            {.node_id = NumericNode(3)}}}));
+  Drain(executor);
+  EXPECT_THAT(started,
+              ElementsAre(NumericNode(1), NumericNode(2), NumericNode(3)));
+  EXPECT_FALSE(result->done);
+
+  release.Complete();
+  Drain(executor);
+  ASSERT_TRUE(result->done);
+  const auto* history = std::get_if<ua::HistoryReadResponse>(&*result->value);
+  ASSERT_NE(history, nullptr);
+  ASSERT_EQ(history->results.size(), 3u);
+  EXPECT_EQ(history->results[0].status_code.code(), StatusCode::Good);
+  EXPECT_EQ(history->results[1].status_code.code(),
+            StatusCode::Bad_NodeIdUnknown);
+  EXPECT_EQ(history->results[2].status_code.code(), StatusCode::Good);
+  ua::HistoryData data;
+  ASSERT_TRUE(
+      ua::FromAnyExtensionObject(history->results[2].history_data, data));
+  ASSERT_EQ(data.data_values.size(), 1u);
+  EXPECT_EQ(data.data_values[0].value, Variant{3.0});
+}
+
+// The node count is held to the data or event limit, whichever the details
+// select.
+TEST(ServiceHandlerTest, HistoryReadRejectsMoreNodesThanTheLimit) {
+  ServiceCallbacks callbacks;
+  callbacks.history_read_raw =
+      [](HistoryReadRawDetails) -> CoStatusOr<HistoryReadRawResult> {
+    ADD_FAILURE() << "no node should be read";
+    co_return HistoryReadRawResult{};
+  };
+  const ServiceHandler handler{ServiceHandlerContext{
+      .callbacks = std::move(callbacks),
+      .operation_limits = {.max_nodes_per_history_read_data = 1}}};
+
+  const auto start = DateTime::Now();
+  TestExecutor executor;
+  const auto response = WaitAwaitable(
+      executor,
+      handler.Handle(ua::HistoryReadRequest{
+          .history_read_details =
+              ua::ToExtensionObject(ua::ReadRawModifiedDetails{
+                  .start_time = start,
+                  .end_time = start + Duration::FromSeconds(60)}),
+          .nodes_to_read = {{.node_id = NumericNode(1)},
+                            {.node_id = NumericNode(2)}}}));
+
+  const auto* history = std::get_if<ua::HistoryReadResponse>(&response);
+  ASSERT_NE(history, nullptr);
+  EXPECT_EQ(history->response_header.service_result.code(),
+            StatusCode::Bad_TooManyOperations);
+  EXPECT_TRUE(history->results.empty());
+}
+
 }  // namespace
 }  // namespace opcua
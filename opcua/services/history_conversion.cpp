@@ -146,107 +146,143 @@ ua::EventFilter ToUaEventFilter(
 
 std::optional<DecodedHistoryRead> ToManaged(
     const ua::HistoryReadRequest& wire) {
-  // This server's HistoryRead supports exactly one node per request.
-  if (wire.nodes_to_read.size() != 1)
+  if (wire.nodes_to_read.empty())
     return std::nullopt;
   const auto timestamps = static_cast<std::uint32_t>(wire.timestamps_to_return);
   if (timestamps > static_cast<std::uint32_t>(ua::TimestampsToReturn::Neither))
     return std::nullopt;
-  const auto& node = wire.nodes_to_read[0];
-  // IndexRange / DataEncoding are not modelled and must be empty.
-  if (!node.index_range.empty() || !node.data_encoding.name().empty() ||
-      node.data_encoding.namespace_index() != 0)
-    return std::nullopt;
+  for (const auto& node : wire.nodes_to_read) {
+    // IndexRange / DataEncoding are not modelled and must be empty.
+    if (!node.index_range.empty() || !node.data_encoding.name().empty() ||
+        node.data_encoding.namespace_index() != 0)
+      return std::nullopt;
+  }
+
+  DecodedHistoryRead decoded;
+  decoded.nodes.reserve(wire.nodes_to_read.size());
 
   ua::ReadRawModifiedDetails raw;
   if (FromAnyExtensionObject(wire.history_read_details, raw)) {
     // Modified reads and bound returns are unsupported.
     if (raw.is_read_modified || raw.return_bounds)
       return std::nullopt;
-    HistoryReadRawDetails details;
-    details.node_id = node.node_id;
-    details.from = raw.start_time;
-    details.to = raw.end_time;
-    details.max_count = raw.num_values_per_node;
-    details.release_continuation_point = wire.release_continuation_points;
-    details.continuation_point = node.continuation_point;
-    return DecodedHistoryRead{.details = std::move(details)};
+    for (const auto& node : wire.nodes_to_read) {
+      HistoryReadRawDetails details;
+      details.node_id = node.node_id;
+      details.from = raw.start_time;
+      details.to = raw.end_time;
+      details.max_count = raw.num_values_per_node;
+      details.release_continuation_point = wire.release_continuation_points;
+      details.continuation_point = node.continuation_point;
+      decoded.nodes.push_back(std::move(details));
+    }
+    return decoded;
   }
 
   // Aggregated (processed) read: the aggregate rides HistoryReadRawDetails'
   // AggregateFilter. OPC UA Part 11 §6.5 ReadProcessedDetails.
   ua::ReadProcessedDetails processed;
   if (FromAnyExtensionObject(wire.history_read_details, processed)) {
-    HistoryReadRawDetails details;
-    details.node_id = node.node_id;
-    details.from = processed.start_time;
-    details.to = processed.end_time;
-    details.release_continuation_point = wire.release_continuation_points;
-    details.continuation_point = node.continuation_point;
-    details.aggregation.start_time = processed.start_time;
-    details.aggregation.interval =
-        Duration::FromMillisecondsD(processed.processing_interval);
-    if (!processed.aggregate_type.empty())
-      details.aggregation.aggregate_type = processed.aggregate_type.front();
-    return DecodedHistoryRead{.details = std::move(details)};
+    for (const auto& node : wire.nodes_to_read) {
+      HistoryReadRawDetails details;
+      details.node_id = node.node_id;
+      details.from = processed.start_time;
+      details.to = processed.end_time;
+      details.release_continuation_point = wire.release_continuation_points;
+      details.continuation_point = node.continuation_point;
+      details.aggregation.start_time = processed.start_time;
+      details.aggregation.interval =
+          Duration::FromMillisecondsD(processed.processing_interval);
+      if (!processed.aggregate_type.empty())
+        details.aggregation.aggregate_type = processed.aggregate_type.front();
+      decoded.nodes.push_back(std::move(details));
+    }
+    return decoded;
   }
 
   ua::ReadEventDetails events;
   if (FromAnyExtensionObject(wire.history_read_details, events)) {
-    if (wire.release_continuation_points || !node.continuation_point.empty())
+    if (wire.release_continuation_points)
       return std::nullopt;
-    HistoryReadEventsDetails details;
-    details.node_id = node.node_id;
-    details.from = events.start_time;
-    details.to = events.end_time;
     std::vector<std::vector<std::string>> field_paths;
-    details.filter = ToManagedEventFilter(events.filter, field_paths);
-    field_paths = NormalizeEventFieldPaths(std::move(field_paths));
-    return DecodedHistoryRead{.details = std::move(details),
-                              .event_field_paths = std::move(field_paths)};
+    const auto filter = ToManagedEventFilter(events.filter, field_paths);
+    for (const auto& node : wire.nodes_to_read) {
+      if (!node.continuation_point.empty())
+        return std::nullopt;
+      HistoryReadEventsDetails details;
+      details.node_id = node.node_id;
+      details.from = events.start_time;
+      details.to = events.end_time;
+      details.filter = filter;
+      decoded.nodes.push_back(std::move(details));
+    }
+    decoded.event_field_paths =
+        NormalizeEventFieldPaths(std::move(field_paths));
+    return decoded;
   }
 
   return std::nullopt;
 }
 
 ua::HistoryReadResponse ToWireRawResponse(
-    const StatusOr<HistoryReadRawResult>& result) {
-  ua::HistoryReadResult wire_result;
-  wire_result.status_code = result.status();
-  if (result.ok()) {
-    ua::HistoryData data;
-    data.data_values = result->values;
-    wire_result.continuation_point = result->continuation_point;
-    wire_result.history_data = ua::ToExtensionObject(data);
-  }
+    std::vector<StatusOr<HistoryReadRawResult>> results) {
   ua::HistoryReadResponse response;
-  response.results.push_back(std::move(wire_result));
+  response.results.reserve(results.size());
+  for (auto& result : results) {
+    ua::HistoryReadResult wire_result;
+    wire_result.status_code = result.status();
+    if (result.ok()) {
+      ua::HistoryData data;
+      data.data_values = std::move(result->values);
+      wire_result.continuation_point = std::move(result->continuation_point);
+      wire_result.history_data = ua::ToExtensionObject(data);
+    }
+    response.results.push_back(std::move(wire_result));
+  }
   return response;
 }
 
+ua::HistoryReadResponse ToWireRawResponse(
+    const StatusOr<HistoryReadRawResult>& result) {
+  std::vector<StatusOr<HistoryReadRawResult>> results;
+  results.push_back(result);
+  return ToWireRawResponse(std::move(results));
+}
+
 ua::HistoryReadResponse ToWireEventsResponse(
-    const StatusOr<HistoryReadEventsResult>& result,
+    std::vector<StatusOr<HistoryReadEventsResult>> results,
     std::span<const std::vector<std::string>> field_paths) {
-  ua::HistoryReadResult wire_result;
-  wire_result.status_code = result.status();
-  if (result.ok()) {
-    const auto paths =
-        NormalizeEventFieldPaths(std::vector<std::vector<std::string>>(
-            field_paths.begin(), field_paths.end()));
-    ua::HistoryEvent history_event;
-    history_event.events.reserve(result->events.size());
-    for (const auto& event : result->events) {
-      ua::HistoryEventFieldList list;
-      list.event_fields = ProjectEventFields(paths, std::any{event});
-      history_event.events.push_back(std::move(list));
+  const auto paths =
+      NormalizeEventFieldPaths(std::vector<std::vector<std::string>>(
+          field_paths.begin(), field_paths.end()));
+  ua::HistoryReadResponse response;
+  response.results.reserve(results.size());
+  for (const auto& result : results) {
+    ua::HistoryReadResult wire_result;
+    wire_result.status_code = result.status();
+    if (result.ok()) {
+      ua::HistoryEvent history_event;
+      history_event.events.reserve(result->events.size());
+      for (const auto& event : result->events) {
+        ua::HistoryEventFieldList list;
+        list.event_fields = ProjectEventFields(paths, std::any{event});
+        history_event.events.push_back(std::move(list));
+      }
+      wire_result.history_data = ua::ToExtensionObject(history_event);
     }
-    wire_result.history_data = ua::ToExtensionObject(history_event);
+    response.results.push_back(std::move(wire_result));
   }
-  ua::HistoryReadResponse response;
-  response.results.push_back(std::move(wire_result));
   return response;
 }
 
+ua::HistoryReadResponse ToWireEventsResponse(
+    const StatusOr<HistoryReadEventsResult>& result,
+    std::span<const std::vector<std::string>> field_paths) {
+  std::vector<StatusOr<HistoryReadEventsResult>> results;
+  results.push_back(result);
+  return ToWireEventsResponse(std::move(results), field_paths);
+}
+
 ua::HistoryReadRequest ToWireRawRequest(const HistoryReadRawDetails& details) {
   ua::HistoryReadRequest request;
   if (details.aggregation.is_null()) {
@@ -32,25 +32,40 @@ namespace opcua::history_conversion {
 using HistoryUpdateDetails =
     std::variant<UpdateDataDetails, UpdateEventDetails>;
 
-// A decoded HistoryRead request: either a raw/aggregated read or an event read.
-// For an event read, event_field_paths carries the select-clause browse paths
-// needed to project the response events.
+// A decoded HistoryRead request: either a raw/aggregated read or an event read,
+// with one details entry per nodesToRead element, in request order. The wire
+// request carries a single HistoryReadDetails, so every entry holds the same
+// alternative. For an event read, event_field_paths carries the select-clause
+// browse paths needed to project the response events.
 struct DecodedHistoryRead {
-  std::variant<HistoryReadRawDetails, HistoryReadEventsDetails> details;
+  using Details = std::variant<HistoryReadRawDetails, HistoryReadEventsDetails>;
+
+  bool is_events() const {
+    return !nodes.empty() &&
+           std::holds_alternative<HistoryReadEventsDetails>(nodes.front());
+  }
+
+  std::vector<Details> nodes;
   std::vector<std::vector<std::string>> event_field_paths;
 };
 
 // Decodes ua::HistoryReadRequest into the managed read. Returns nullopt when
-// the request is unsupported (not exactly one node, invalid TimestampsToReturn,
-// an unknown details type, or a malformed / non-conformant details body) so the
-// handler can answer the appropriate Bad_ status.
+// the request is unsupported (no nodes, invalid TimestampsToReturn, an unknown
+// details type, or a malformed / non-conformant details body) so the handler
+// can answer the appropriate Bad_ status.
 std::optional<DecodedHistoryRead> ToManaged(const ua::HistoryReadRequest& wire);
 
-// Builds a single-result ua::HistoryReadResponse (service_result stays Good;
-// the per-node status rides HistoryReadResult.status_code) from a managed
-// result.
+// Builds a ua::HistoryReadResponse with one result per managed result, in
+// order (service_result stays Good; the per-node status rides
+// HistoryReadResult.status_code). The single-result forms serve the one-node
+// reads the client issues.
+ua::HistoryReadResponse ToWireRawResponse(
+    std::vector<StatusOr<HistoryReadRawResult>> results);
 ua::HistoryReadResponse ToWireRawResponse(
     const StatusOr<HistoryReadRawResult>& result);
+ua::HistoryReadResponse ToWireEventsResponse(
+    std::vector<StatusOr<HistoryReadEventsResult>> results,
+    std::span<const std::vector<std::string>> field_paths);
 ua::HistoryReadResponse ToWireEventsResponse(
     const StatusOr<HistoryReadEventsResult>& result,
     std::span<const std::vector<std::string>> field_paths);
@@ -8,6 +8,15 @@
 
 namespace opcua {
 
+// One method of a Call request, as handed to the batched call callback.
+// OPC UA Part 4 §5.11.2 Call,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.11.2
+struct CallMethod {
+  NodeId object_id;
+  NodeId method_id;
+  std::vector<Variant> input_arguments;
+};
+
 // The payload of a successful Call. Operation-level failure is reported by the
 // enclosing StatusOr, not by a field here, so a value being present already
 // means the method succeeded.
@@ -31,4 +31,12 @@ struct OperationLimits {
 // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.8.2
 inline constexpr std::uint32_t kMaxBrowseContinuationPoints = 100;
 
+// Maximum number of HistoryRead continuation points the server keeps per
+// session, one per node a paged read is still serving. Exposed as
+// Server.ServerCapabilities.MaxHistoryContinuationPoints and enforced by
+// ServerSession (a node whose read would exceed it returns
+// Bad_NoContinuationPoints). OPC UA Part 4 §5.11.3,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.11.3
+inline constexpr std::uint32_t kMaxHistoryContinuationPoints = 100;
+
 }  // namespace opcua
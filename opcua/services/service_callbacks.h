@@ -9,6 +9,7 @@
 #include "opcua/types/co_result.h"
 #include "opcua/types/status_or.h"
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 
@@ -32,6 +33,12 @@ struct ServiceCallbacks {
           std::vector<BrowsePath>)>;
   using CallCallback = std::function<CoStatusOr<
       CallResult>(NodeId, NodeId, std::vector<Variant>, ServiceContext)>;
+  // One result per method, in request order; the error status fails the
+  // whole request.
+  using CallBatchCallback =
+      std::function<CoStatusOr<std::vector<StatusOr<CallResult>>>(
+          ServiceContext,
+          std::vector<CallMethod>)>;
   using HistoryReadRawCallback =
       std::function<CoStatusOr<HistoryReadRawResult>(HistoryReadRawDetails)>;
   using HistoryReadEventsCallback = std::function<CoStatusOr<
@@ -51,6 +58,12 @@ struct ServiceCallbacks {
       std::function<CoStatusOr<std::vector<StatusCode>>(
           ServiceContext,
           std::vector<DeleteReferencesItem>)>;
+  // One backend id per registered node, in request order.
+  using RegisterNodesCallback = std::function<CoStatusOr<std::vector<NodeId>>(
+      ServiceContext,
+      std::vector<NodeId>)>;
+  using UnregisterNodesCallback =
+      std::function<void(ServiceContext, std::vector<NodeId>)>;
   using CreateSubscriptionCallback =
       std::function<StatusOr<std::unique_ptr<MonitoredItemSubscription>>(
           ServiceContext,
@@ -61,6 +74,15 @@ struct ServiceCallbacks {
   BrowseCallback browse;
   TranslateBrowsePathsCallback translate_browse_paths;
   CallCallback call;
+  // Optional. Receives all methods of a Call request at once, for backends
+  // that pipeline them to their devices; takes precedence over `call`.
+  CallBatchCallback call_batch;
+  // How many `call` invocations of one Call request may be in flight at once.
+  // The default, 1, calls the methods one after another, which a `call` not
+  // written to run concurrently with itself needs. Raise it for backends that
+  // are. 0 removes the cap: every method of the request is started at once,
+  // bounded only by OperationLimits::max_nodes_per_method_call.
+  std::size_t max_concurrent_calls = 1;
   HistoryReadRawCallback history_read_raw;
   HistoryReadEventsCallback history_read_events;
   HistoryUpdateCallback history_update;
@@ -70,6 +92,15 @@ struct ServiceCallbacks {
   AddReferencesCallback add_references;
   DeleteReferencesCallback delete_references;
   CreateSubscriptionCallback create_subscription;
+  // Optional. Resolve the nodes a client registers to the ids the backend
+  // serves fastest — typically numeric handles into its own tables — and
+  // release them again on UnregisterNodes or when the session closes. Read,
+  // Write and CreateMonitoredItems naming a registered node reach the backend
+  // with its resolved id. Without `register_nodes` the client's own ids are
+  // kept. Only used when the runtime hands out registered-node aliases (see
+  // ServerRuntimeContext::registered_node_namespace_index).
+  RegisterNodesCallback register_nodes;
+  UnregisterNodesCallback unregister_nodes;
 };
 
 }  // namespace opcua
@@ -1,12 +1,12 @@
 #include "opcua/session/server_runtime.h"
 
 #include "opcua/base/any_executor.h"
-#include "opcua/base/async_completion.h"
 #include "opcua/base/boost_log.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <iterator>
 #include <span>
 #include <stdexcept>
 #include <string>
@@ -21,6 +21,26 @@ namespace {
 
 BoostLogger logger_{LOG_NAME("ServerRuntime")};
 
+// Swap registered-node aliases for the backend ids they stand for, so the
+// backend is handed ids it resolved itself.
+void ResolveRegisteredNodes(const ServerSession& session,
+                            ua::ReadRequest& request) {
+  for (auto& node : request.nodes_to_read)
+    session.ResolveRegisteredNode(node.node_id);
+}
+
+void ResolveRegisteredNodes(const ServerSession& session,
+                            ua::WriteRequest& request) {
+  for (auto& node : request.nodes_to_write)
+    session.ResolveRegisteredNode(node.node_id);
+}
+
+void ResolveRegisteredNodes(const ServerSession& session,
+                            CreateMonitoredItemsRequest& request) {
+  for (auto& item : request.items_to_create)
+    session.ResolveRegisteredNode(item.item_to_monitor.node_id);
+}
+
 template <typename Response>
 Response SessionMissingResponse() {
   return {.status = StatusCode::Bad_SessionIdInvalid};
@@ -278,7 +298,16 @@ ServerRuntime::ServerRuntime(ServerRuntimeContext&& context)
       now_{std::move(context.now)},
       post_delayed_task_{std::move(context.post_delayed_task)},
       register_server_{std::move(context.register_server)},
-      registered_servers_{std::move(context.registered_servers)} {
+      registered_servers_{std::move(context.registered_servers)},
+      registered_node_namespace_index_{
+          context.registered_node_namespace_index},
+      shard_ids_{context.shard_ids} {
+  if (context.read_cache_entries != 0) {
+    read_cache_ = std::make_unique<ReadCache>(
+        ReadCacheContext{.executor = executor_,
+                         .max_entries = context.read_cache_entries,
+                         .now = now_});
+  }
   // The manager owns session identity and lifetime; this runtime owns what
   // hangs off a session (ServerSession, its subscriptions, the
   // subscription-owner index). Those two must die together, and the manager
@@ -289,12 +318,26 @@ ServerRuntime::ServerRuntime(ServerRuntimeContext&& context)
       [this](const NodeId& authentication_token) {
         ForgetSession(authentication_token);
       });
+  // Sessions time out on this executor, whether or not another client ever
+  // connects. Kept off `post_delayed_task_`: the expiry timer is armed for as
+  // long as any session lives, and that hook is for the waits of requests.
+  if (!session_manager_.has_expiry_scheduler()) {
+    owns_expiry_scheduler_ = true;
+    session_manager_.SetExpiryScheduler(
+        [executor = executor_](Duration delay, std::function<void()> task) {
+          PostDelayedTask(executor,
+                          std::chrono::milliseconds{delay.InMilliseconds()},
+                          std::move(task));
+        });
+  }
 }
 
 ServerRuntime::~ServerRuntime() {
   // The manager outlives this runtime (it is constructed first and destroyed
   // last), so the callback above must not survive it.
   session_manager_.SetSessionRemovedCallback(nullptr);
+  if (owns_expiry_scheduler_)
+    session_manager_.SetExpiryScheduler(nullptr);
 }
 
 Awaitable<ServiceResponse> ServerRuntime::HandleServiceRequest(
@@ -310,7 +353,8 @@ Awaitable<ServiceResponse> ServerRuntime::HandleServiceRequest(
   ServiceHandler handler{
       ServiceHandlerContext{.callbacks = callbacks_,
                             .service_context = std::move(service_context),
-                            .operation_limits = operation_limits_}};
+                            .operation_limits = operation_limits_,
+                            .read_cache = read_cache_.get()}};
   co_return co_await handler.Handle(std::move(request));
 }
 
@@ -323,6 +367,10 @@ void ServerRuntime::Detach(ConnectionState& connection) {
                                connection.authentication_token->ToString())
                     << LOG_TAG("Peer", connection.peer);
   session_manager_.DetachSession(*connection.authentication_token);
+  // A Publish parked for this connection would otherwise wait out its
+  // deadline before noticing the connection is gone.
+  if (auto* session = FindSession(*connection.authentication_token))
+    session->WakePublishWaiters();
   connection.authentication_token.reset();
 }
 
@@ -344,9 +392,38 @@ void ServerRuntime::ForgetSession(const NodeId& authentication_token) {
                     << LOG_TAG("AuthenticationToken",
                                authentication_token.ToString());
   RemoveSessionSubscriptions(authentication_token);
+  if (auto* session = FindSession(authentication_token)) {
+    auto released = session->ReleaseRegisteredNodes();
+    if (callbacks_.unregister_nodes && !released.empty()) {
+      callbacks_.unregister_nodes(session->GetServiceContext(),
+                                  std::move(released));
+    }
+    ReleaseHistoryCursors(session->ReleaseHistoryCursors());
+  }
   sessions_.erase(authentication_token);
 }
 
+void ServerRuntime::ReleaseHistoryCursors(
+    std::vector<ServerSession::HistoryCursor> cursors) const {
+  if (!callbacks_.history_read_raw || cursors.empty())
+    return;
+
+  // Fire-and-forget: nothing answers to a release. It runs after the session
+  // is gone, so it carries its own copy of the callback.
+  CoSpawn(executor_,
+          [history_read_raw = callbacks_.history_read_raw,
+           cursors = std::move(cursors)]() mutable -> Awaitable<void> {
+            for (auto& cursor : cursors) {
+              HistoryReadRawDetails details{
+                  .node_id = std::move(cursor.node_id),
+                  .release_continuation_point = true,
+                  .continuation_point = std::move(cursor.continuation_point)};
+              [[maybe_unused]] auto result =
+                  co_await history_read_raw(std::move(details));
+            }
+          });
+}
+
 void ServerRuntime::RemoveSessionSubscriptions(
     const NodeId& authentication_token) {
   std::erase_if(subscription_owners_, [&](const auto& entry) {
@@ -354,25 +431,60 @@ void ServerRuntime::RemoveSessionSubscriptions(
   });
 }
 
-Awaitable<void> ServerRuntime::Delay(Duration delay) const {
-  if (delay <= Duration{})
-    co_return;
+std::vector<std::unique_ptr<ServerSubscription>>
+ServerRuntime::ReleaseSubscriptions(
+    std::span<const SubscriptionId> subscription_ids,
+    const AnyExecutor& destination) {
+  std::vector<std::unique_ptr<ServerSubscription>> released;
+  for (const auto subscription_id : subscription_ids) {
+    const auto owner_it = subscription_owners_.find(subscription_id);
+    if (owner_it == subscription_owners_.end())
+      continue;
+    auto* session = FindSession(owner_it->second);
+    auto subscription =
+        session ? session->ReleaseSubscription(subscription_id) : nullptr;
+    if (!subscription)
+      continue;
+    // Repointed here rather than on adoption: a backing read completing while
+    // the subscription is in transit must already be headed for the new
+    // owner, not run against a subscription this shard no longer owns.
+    subscription->SetExecutor(destination);
+    subscription_owners_.erase(owner_it);
+    released.push_back(std::move(subscription));
+  }
+  return released;
+}
 
-  base::AsyncCompletion delayed{executor_};
-  auto callback = [delayed]() mutable { delayed.Complete(); };
-  if (post_delayed_task_) {
-    post_delayed_task_(delay, std::move(callback));
-  } else {
-    PostDelayedTask(executor_,
-                    std::chrono::milliseconds{delay.InMilliseconds()},
-                    std::move(callback));
+std::vector<ua::TransferResult> ServerRuntime::AdoptSubscriptions(
+    const ConnectionState& connection,
+    std::vector<std::unique_ptr<ServerSubscription>> subscriptions) {
+  std::vector<ua::TransferResult> results;
+  results.reserve(subscriptions.size());
+  auto* session = FindAttachedSession(connection);
+  for (auto& subscription : subscriptions) {
+    if (!session) {
+      // The target session went away while the subscriptions were in transit;
+      // they die with it, as they would have with their source session.
+      results.push_back(ua::TransferResult{
+          .status_code = Status{StatusCode::Bad_SessionIdInvalid}});
+      continue;
+    }
+    const auto subscription_id = subscription->subscription_id();
+    const auto status = session->AdoptSubscription(std::move(subscription));
+    if (status == StatusCode::Good)
+      subscription_owners_[subscription_id] = *connection.authentication_token;
+    results.push_back(ua::TransferResult{.status_code = Status{status}});
   }
-  co_await delayed.Wait();
+  return results;
 }
 
 Awaitable<ResponseBody> ServerRuntime::Handle(ConnectionState& connection,
                                               RequestBody request,
                                               std::string trace_parent) {
+  // Any service call on the session restarts its timeout.
+  if (connection.authentication_token.has_value())
+    session_manager_.KeepSessionAlive(*connection.authentication_token);
+
   auto body = co_await std::visit(
       [this, &connection,
        &trace_parent](auto&& typed_request) -> Awaitable<ResponseBody> {
@@ -422,7 +534,8 @@ Awaitable<ResponseBody> ServerRuntime::Handle(ConnectionState& connection,
                 SessionMissingResponse<CreateSubscriptionResponse>()};
           // cppcheck-suppress nullPointerRedundantCheck
           const auto response = session->CreateSubscriptionWithId(
-              next_subscription_id_++, typed_request, trace_parent);
+              shard_ids_.Make(next_subscription_id_++), typed_request,
+              trace_parent);
           subscription_owners_[response.subscription_id] =
               *connection.authentication_token;
           co_return ResponseBody{response};
@@ -480,7 +593,9 @@ Awaitable<ResponseBody> ServerRuntime::Handle(ConnectionState& connection,
                   PublishResponse{.status = StatusCode::Good,
                                   .results = std::move(ack_results)}};
             }
-            co_await Delay(*poll.wait_for);
+            // Parked on the session rather than on a timer of its own: a
+            // subscription that becomes publishable wakes it immediately.
+            co_await session->WaitForPublish(*poll.wait_for);
           }
         } else if constexpr (std::is_same_v<T, RepublishRequest>) {
           auto* session = FindAttachedSession(connection);
@@ -553,6 +668,7 @@ Awaitable<ResponseBody> ServerRuntime::Handle(ConnectionState& connection,
             co_return ResponseBody{
                 SessionMissingResponse<CreateMonitoredItemsResponse>()};
           // cppcheck-suppress nullPointerRedundantCheck
+          ResolveRegisteredNodes(*session, typed_request);
           co_return ResponseBody{session->CreateMonitoredItems(typed_request)};
         } else if constexpr (std::is_same_v<T, ModifyMonitoredItemsRequest>) {
           auto* session = FindAttachedSession(connection);
@@ -599,25 +715,80 @@ Awaitable<ResponseBody> ServerRuntime::Handle(ConnectionState& connection,
             co_return SessionMissingResponse<ResponseBody>();
           // cppcheck-suppress nullPointerRedundantCheck
           co_return ResponseBody{session->BrowseNext(typed_request)};
-        } else if constexpr (std::is_same_v<T, ua::RegisterNodesRequest>) {
-          // OPC UA Part 4 §5.3.2: registration is an optional optimization;
-          // with no registered-node handles maintained, echo the requested
-          // NodeIds.
-          if (!FindAttachedSession(connection))
+        } else if constexpr (std::is_same_v<T, ua::HistoryReadRequest>) {
+          auto* session = FindAttachedSession(connection);
+          if (!session)
             co_return SessionMissingResponse<ResponseBody>();
-          co_return ResponseBody{ua::RegisterNodesResponse{
-              .registered_node_ids =
-                  std::move(typed_request.nodes_to_register)}};
+          // cppcheck-suppress nullPointerRedundantCheck
+          auto& attached_session = *session;
+          // The nodes continuing a read carry this session's continuation
+          // points; the handler sees the backend's, and only for the nodes
+          // whose point the session knows.
+          const auto resumption =
+              attached_session.ResumeHistoryRead(typed_request);
+          ua::HistoryReadResponse history{
+              .response_header = {.service_result = StatusCode::Good}};
+          if (!typed_request.nodes_to_read.empty() ||
+              resumption.statuses.empty()) {
+            const auto authentication_token =
+                *connection.authentication_token;
+            auto response = co_await HandleServiceRequest(
+                attached_session, ServiceRequest{std::move(typed_request)},
+                trace_parent);
+            auto* typed = std::get_if<ua::HistoryReadResponse>(&response);
+            // The session may have closed while the backend read; the
+            // cursors it would have held go straight back.
+            if (FindSession(authentication_token) != &attached_session) {
+              std::vector<ServerSession::HistoryCursor> orphaned;
+              for (std::size_t i = 0;
+                   typed && i < typed->results.size() &&
+                   i < resumption.node_ids.size();
+                   ++i) {
+                auto& result = typed->results[i];
+                if (!result.continuation_point.empty()) {
+                  orphaned.push_back(
+                      {.node_id = resumption.node_ids[i],
+                       .continuation_point =
+                           std::move(result.continuation_point)});
+                }
+              }
+              ReleaseHistoryCursors(std::move(orphaned));
+              co_return SessionMissingResponse<ResponseBody>();
+            }
+            if (!typed)
+              co_return SessionMissingResponse<ResponseBody>();
+            history = std::move(*typed);
+          }
+          auto stored = attached_session.StoreHistoryReadResults(
+              std::move(history), resumption);
+          ReleaseHistoryCursors(std::move(stored.unstored));
+          co_return ResponseBody{std::move(stored.response)};
+        } else if constexpr (std::is_same_v<T, ua::RegisterNodesRequest>) {
+          co_return co_await HandleRegisterNodes(connection,
+                                                 std::move(typed_request));
         } else if constexpr (std::is_same_v<T, ua::UnregisterNodesRequest>) {
-          // OPC UA Part 4 §5.3.3: nothing to release, so this is a no-op.
-          if (!FindAttachedSession(connection))
+          // OPC UA Part 4 §5.9.6: ids that are not aliases of this session
+          // were echoed by RegisterNodes and have nothing to release.
+          auto* session = FindAttachedSession(connection);
+          if (!session)
             co_return SessionMissingResponse<ResponseBody>();
+          // cppcheck-suppress nullPointerRedundantCheck
+          auto released =
+              session->UnregisterNodes(typed_request.nodes_to_unregister);
+          if (callbacks_.unregister_nodes && !released.empty()) {
+            callbacks_.unregister_nodes(session->GetServiceContext(),
+                                        std::move(released));
+          }
           co_return ResponseBody{ua::UnregisterNodesResponse{}};
         } else {
           auto* session = FindAttachedSession(connection);
           if (!session)
             co_return SessionMissingResponse<ResponseBody>();
           assert(session != nullptr);
+          if constexpr (std::is_same_v<T, ua::ReadRequest> ||
+                        std::is_same_v<T, ua::WriteRequest>) {
+            ResolveRegisteredNodes(*session, typed_request);
+          }
           auto service_response = co_await HandleServiceRequest(
               *session, ServiceRequest{std::move(typed_request)}, trace_parent);
           co_return std::visit(
@@ -749,6 +920,68 @@ ResponseBody ServerRuntime::HandleRegisterServer2(
   return ResponseBody{std::move(response)};
 }
 
+Awaitable<ResponseBody> ServerRuntime::HandleRegisterNodes(
+    ConnectionState& connection,
+    ua::RegisterNodesRequest request) {
+  auto* session = FindAttachedSession(connection);
+  if (!session)
+    co_return SessionMissingResponse<ResponseBody>();
+
+  auto& nodes = request.nodes_to_register;
+  if (nodes.size() > operation_limits_.max_nodes_per_register_nodes) {
+    co_return ResponseBody{ua::RegisterNodesResponse{
+        .response_header = {.service_result =
+                                StatusCode::Bad_TooManyOperations}}};
+  }
+
+  // OPC UA Part 4 §5.9.5: registration is an optional optimization, and a
+  // server may return the requested ids unchanged. So it does for the nodes
+  // past the session's room — all of them when aliases are off — and those
+  // go on costing what an unregistered node costs.
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.9.5
+  const auto registered_count = std::min(nodes.size(),
+                                         session->RegisteredNodeRoom());
+  std::vector<NodeId> backend_ids(
+      nodes.begin(),
+      nodes.begin() + static_cast<std::ptrdiff_t>(registered_count));
+  if (callbacks_.register_nodes && !backend_ids.empty()) {
+    // Named rather than temporaries of the co_await expression: GCC 12
+    // mishandles temporaries with non-trivial destructors that live across a
+    // suspension.
+    auto service_context = session->GetServiceContext();
+    auto resolve =
+        callbacks_.register_nodes(service_context, std::move(backend_ids));
+    auto resolved = co_await std::move(resolve);
+    if (!resolved.ok()) {
+      co_return ResponseBody{ua::RegisterNodesResponse{
+          .response_header = {.service_result = resolved.status()}}};
+    }
+    backend_ids = std::move(*resolved);
+    // The session may have closed while the backend resolved; hand the ids
+    // straight back.
+    session = FindAttachedSession(connection);
+    if (!session || backend_ids.size() != registered_count) {
+      if (callbacks_.unregister_nodes)
+        callbacks_.unregister_nodes(service_context, std::move(backend_ids));
+      if (!session)
+        co_return SessionMissingResponse<ResponseBody>();
+      co_return ResponseBody{ua::RegisterNodesResponse{
+          .response_header = {.service_result =
+                                  StatusCode::Bad}}};
+    }
+  }
+
+  // cppcheck-suppress nullPointerRedundantCheck
+  auto registered = session->RegisterNodes(std::move(backend_ids));
+  registered.insert(
+      registered.end(),
+      std::make_move_iterator(nodes.begin() +
+                              static_cast<std::ptrdiff_t>(registered_count)),
+      std::make_move_iterator(nodes.end()));
+  co_return ResponseBody{
+      ua::RegisterNodesResponse{.registered_node_ids = std::move(registered)}};
+}
+
 Awaitable<ResponseBody> ServerRuntime::HandleActivateSession(
     ConnectionState& connection,
     ActivateSessionRequest request) {
@@ -779,6 +1012,20 @@ Awaitable<ResponseBody> ServerRuntime::HandleActivateSession(
         .create_subscription = callbacks_.create_subscription,
         .operation_limits = operation_limits_,
         .now = now_,
+        .post_delayed_task = post_delayed_task_,
+        .registered_node_namespace_index = registered_node_namespace_index_,
+        .on_data_change =
+            read_cache_ ? std::function<void(const ReadValueId&,
+                                             const DataValue&)>{
+                              [this](const ReadValueId& key,
+                                     const DataValue& value) {
+                                read_cache_->Update(key, value);
+                              }}
+                        : nullptr,
+        .on_subscription_expired =
+            [this](SubscriptionId subscription_id) {
+              subscription_owners_.erase(subscription_id);
+            },
     });
     sessions_[request.authentication_token] = session;
   }
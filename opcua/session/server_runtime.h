@@ -11,7 +11,9 @@
 #include "opcua/session/server_session_manager.h"
 #include "opcua/types/date_time.h"
 
+#include <memory>
 #include <optional>
+#include <span>
 #include <unordered_map>
 
 namespace opcua {
@@ -31,6 +33,12 @@ struct ConnectionState {
   // Carried into session and per-request logs (the OTel `client.address`
   // equivalent) so records can be correlated to the originating client.
   std::string peer;
+  // Sharded runtime only (see ShardedServerRuntime). `shard` is the shard the
+  // connection is pinned to, where the sessions it creates live, assigned on
+  // its first request. `shard_views` holds the connection as each shard's
+  // runtime sees it; a view is only ever touched on its own shard's executor.
+  std::optional<std::size_t> shard;
+  std::vector<std::shared_ptr<ConnectionState>> shard_views;
 };
 
 // Context of a RegisterServer/RegisterServer2 request. The security part lets
@@ -69,6 +77,19 @@ struct ServerRuntimeContext {
   // through this server — the discovery-server role of OPC UA Part 4 §5.4.2
   // FindServers. The server's own endpoints win on application_uri collision.
   std::function<std::vector<RegisteredServer>()> registered_servers;
+  // Subscription ids are drawn from this shard's share of the numeric space,
+  // so they stay unique when subscriptions move between shards.
+  ShardIds shard_ids;
+  // Namespace of the alias NodeIds RegisterNodes hands out, one table per
+  // session (see ServerSession::RegisterNodes). It must be a namespace the
+  // address space does not use: a numeric id in it names a registered node.
+  // Unset, RegisterNodes echoes the requested ids, which OPC UA Part 4 §5.9.5
+  // allows.
+  std::optional<NamespaceIndex> registered_node_namespace_index;
+  // Most values held by the runtime's read cache (see ReadCache), which
+  // Reads of every session share and their subscriptions keep current. 0
+  // leaves reads uncached.
+  std::size_t read_cache_entries = 0;
 };
 
 class ServerRuntime {
@@ -86,6 +107,24 @@ class ServerRuntime {
                                                std::string trace_parent = {});
   void Detach(ConnectionState& connection);
 
+  // Null unless ServerRuntimeContext::read_cache_entries is set.
+  [[nodiscard]] const ReadCache* read_cache() const {
+    return read_cache_.get();
+  }
+
+  // TransferSubscriptions between shards (see ShardedServerRuntime). The
+  // source shard releases whichever of `subscription_ids` its sessions own —
+  // ids it does not know are skipped — already pointed at the `destination`
+  // executor, and the target shard adopts them for the session bound to
+  // `connection`, answering one TransferResult per released subscription in
+  // the same order.
+  [[nodiscard]] std::vector<std::unique_ptr<ServerSubscription>>
+  ReleaseSubscriptions(std::span<const SubscriptionId> subscription_ids,
+                       const AnyExecutor& destination);
+  [[nodiscard]] std::vector<ua::TransferResult> AdoptSubscriptions(
+      const ConnectionState& connection,
+      std::vector<std::unique_ptr<ServerSubscription>> subscriptions);
+
  private:
   using SessionMap = std::unordered_map<NodeId, std::shared_ptr<ServerSession>>;
 
@@ -94,10 +133,16 @@ class ServerRuntime {
   [[nodiscard]] ServerSession* FindAttachedSession(
       const ConnectionState& connection) const;
   void ForgetSession(const NodeId& authentication_token);
+  // Hands each cursor back to the history backend with a release read.
+  void ReleaseHistoryCursors(
+      std::vector<ServerSession::HistoryCursor> cursors) const;
   void RemoveSessionSubscriptions(const NodeId& authentication_token);
   [[nodiscard]] Awaitable<ResponseBody> HandleActivateSession(
       ConnectionState& connection,
       ActivateSessionRequest request);
+  [[nodiscard]] Awaitable<ResponseBody> HandleRegisterNodes(
+      ConnectionState& connection,
+      ua::RegisterNodesRequest request);
   [[nodiscard]] ResponseBody HandleFindServers(
       const FindServersRequest& request) const;
   [[nodiscard]] ResponseBody HandleGetEndpoints(
@@ -112,11 +157,14 @@ class ServerRuntime {
       const ServerSession& session,
       ServiceRequest request,
       const std::string& trace_parent) const;
-  [[nodiscard]] Awaitable<void> Delay(Duration delay) const;
 
   SessionMap sessions_;
   std::unordered_map<SubscriptionId, NodeId> subscription_owners_;
   SubscriptionId next_subscription_id_ = 1;
+  ShardIds shard_ids_;
+  // Whether this runtime installed the session manager's expiry scheduler, and
+  // so must clear it on destruction.
+  bool owns_expiry_scheduler_ = false;
 
   AnyExecutor executor_;
   ServerSessionManager& session_manager_;
@@ -128,6 +176,8 @@ class ServerRuntime {
   std::function<Status(const RegisteredServer&, const RegisterServerContext&)>
       register_server_;
   std::function<std::vector<RegisteredServer>()> registered_servers_;
+  std::optional<NamespaceIndex> registered_node_namespace_index_;
+  std::unique_ptr<ReadCache> read_cache_;
 };
 
 }  // namespace opcua
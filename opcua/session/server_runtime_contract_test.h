@@ -592,6 +592,212 @@ void ExpectHistoryReadRawPreservesPayloadThroughActivatedSession(
   EXPECT_EQ(fixture.services_.last_history_read_raw->node_id, NumericNode(9));
 }
 
+// A multi-node read pages each node on its own continuation point. The client
+// sees the session's points, never the backend's; the backend gets its own
+// back when the read continues, and a consumed point is gone.
+template <typename Fixture>
+void ExpectPagesMultiNodeHistoryReadThroughSessionContinuationPoints(
+    Fixture& fixture) {
+  typename Fixture::ConnectionState connection;
+  fixture.CreateAndActivate(connection);
+
+  const auto from = fixture.now_;
+  const auto to = fixture.now_ + Duration::FromSeconds(60);
+  const ByteString backend_point{'p', '9'};
+  fixture.services_.history_read_raw =
+      [&](HistoryReadRawDetails details) -> StatusOr<HistoryReadRawResult> {
+    if (details.node_id != NumericNode(9)) {
+      return HistoryReadRawResult{
+          .values = {DataValue{Variant{10.0}, {}, from, from}}};
+    }
+    if (details.continuation_point.empty()) {
+      return HistoryReadRawResult{
+          .values = {DataValue{Variant{1.5}, {}, from, from}},
+          .continuation_point = backend_point};
+    }
+    EXPECT_EQ(details.continuation_point, backend_point);
+    return HistoryReadRawResult{
+        .values = {DataValue{Variant{2.5}, {}, to, to}}};
+  };
+  const auto details = ua::ToExtensionObject(
+      ua::ReadRawModifiedDetails{.start_time = from, .end_time = to});
+
+  const auto first = fixture.template HandleResponse<ua::HistoryReadResponse>(
+      connection,
+      ua::HistoryReadRequest{
+          .history_read_details = details,
+          .nodes_to_read = {{.node_id = NumericNode(9)},
+                            {.node_id = NumericNode(10)}}});
+  ASSERT_EQ(first.results.size(), 2u);
+  EXPECT_EQ(first.results[0].status_code.code(), StatusCode::Good);
+  EXPECT_EQ(first.results[1].status_code.code(), StatusCode::Good);
+  EXPECT_FALSE(first.results[0].continuation_point.empty());
+  EXPECT_NE(first.results[0].continuation_point, backend_point);
+  EXPECT_TRUE(first.results[1].continuation_point.empty());
+  EXPECT_EQ(fixture.services_.history_read_raw_count, 2);
+
+  const auto session_point = first.results[0].continuation_point;
+  const auto next = fixture.template HandleResponse<ua::HistoryReadResponse>(
+      connection,
+      ua::HistoryReadRequest{
+          .history_read_details = details,
+          .nodes_to_read = {{.node_id = NumericNode(9),
+                             .continuation_point = session_point}}});
+  ASSERT_EQ(next.results.size(), 1u);
+  EXPECT_EQ(next.results[0].status_code.code(), StatusCode::Good);
+  EXPECT_TRUE(next.results[0].continuation_point.empty());
+  EXPECT_EQ(fixture.services_.history_read_raw_count, 3);
+
+  const auto replayed =
+      fixture.template HandleResponse<ua::HistoryReadResponse>(
+          connection,
+          ua::HistoryReadRequest{
+              .history_read_details = details,
+              .nodes_to_read = {{.node_id = NumericNode(10)},
+                                {.node_id = NumericNode(9),
+                                 .continuation_point = session_point}}});
+  ASSERT_EQ(replayed.results.size(), 2u);
+  EXPECT_EQ(replayed.results[0].status_code.code(), StatusCode::Good);
+  EXPECT_EQ(replayed.results[1].status_code.code(),
+            StatusCode::Bad_ContinuationPointInvalid);
+  EXPECT_EQ(fixture.services_.history_read_raw_count, 4);
+}
+
+// Continuation points bound what the session holds, not how many nodes one
+// read may name: nodes that finish in one call need none.
+template <typename Fixture>
+void ExpectReadsMoreHistoryNodesThanContinuationPoints(Fixture& fixture) {
+  typename Fixture::ConnectionState connection;
+  fixture.CreateAndActivate(connection);
+
+  const auto from = fixture.now_;
+  const auto to = fixture.now_ + Duration::FromSeconds(60);
+  fixture.services_.history_read_raw =
+      [&](HistoryReadRawDetails) -> StatusOr<HistoryReadRawResult> {
+    return HistoryReadRawResult{
+        .values = {DataValue{Variant{1.5}, {}, from, from}}};
+  };
+  constexpr std::size_t kNodeCount = 2 * kMaxHistoryContinuationPoints + 1;
+  std::vector<ua::HistoryReadValueId> nodes(kNodeCount,
+                                            {.node_id = NumericNode(9)});
+
+  const auto response =
+      fixture.template HandleResponse<ua::HistoryReadResponse>(
+          connection,
+          ua::HistoryReadRequest{
+              .history_read_details = ua::ToExtensionObject(
+                  ua::ReadRawModifiedDetails{.start_time = from,
+                                             .end_time = to}),
+              .nodes_to_read = std::move(nodes)});
+  ASSERT_EQ(response.results.size(), kNodeCount);
+  for (const auto& result : response.results) {
+    EXPECT_EQ(result.status_code.code(), StatusCode::Good);
+    EXPECT_TRUE(result.continuation_point.empty());
+  }
+  EXPECT_EQ(fixture.services_.history_read_raw_count,
+            static_cast<int>(kNodeCount));
+}
+
+// The session holds at most kMaxHistoryContinuationPoints. A node that pages
+// past that bound is answered Bad_NoContinuationPoints and its backend cursor
+// released; a node continuing its own read gives its point back first, so it
+// always finds room.
+template <typename Fixture>
+void ExpectReleasesHistoryCursorsBeyondContinuationPointRoom(
+    Fixture& fixture) {
+  typename Fixture::ConnectionState connection;
+  fixture.CreateAndActivate(connection);
+
+  const auto from = fixture.now_;
+  const auto to = fixture.now_ + Duration::FromSeconds(60);
+  std::vector<HistoryReadRawDetails> released;
+  fixture.services_.history_read_raw =
+      [&](HistoryReadRawDetails details) -> StatusOr<HistoryReadRawResult> {
+    if (details.release_continuation_point) {
+      released.push_back(details);
+      return HistoryReadRawResult{};
+    }
+    return HistoryReadRawResult{
+        .values = {DataValue{Variant{1.5}, {}, from, from}},
+        .continuation_point = ByteString{'p'}};
+  };
+  const auto details = ua::ToExtensionObject(
+      ua::ReadRawModifiedDetails{.start_time = from, .end_time = to});
+  std::vector<ua::HistoryReadValueId> nodes(kMaxHistoryContinuationPoints,
+                                            {.node_id = NumericNode(9)});
+
+  const auto filled = fixture.template HandleResponse<ua::HistoryReadResponse>(
+      connection, ua::HistoryReadRequest{.history_read_details = details,
+                                         .nodes_to_read = std::move(nodes)});
+  ASSERT_EQ(filled.results.size(), kMaxHistoryContinuationPoints);
+  EXPECT_EQ(filled.results.back().status_code.code(), StatusCode::Good);
+  EXPECT_FALSE(filled.results.back().continuation_point.empty());
+
+  const auto overflow =
+      fixture.template HandleResponse<ua::HistoryReadResponse>(
+          connection,
+          ua::HistoryReadRequest{
+              .history_read_details = details,
+              .nodes_to_read = {{.node_id = NumericNode(9),
+                                 .continuation_point =
+                                     filled.results[0].continuation_point},
+                                {.node_id = NumericNode(10)}}});
+  fixture.Drain();
+  ASSERT_EQ(overflow.results.size(), 2u);
+  EXPECT_EQ(overflow.results[0].status_code.code(), StatusCode::Good);
+  EXPECT_FALSE(overflow.results[0].continuation_point.empty());
+  EXPECT_EQ(overflow.results[1].status_code.code(),
+            StatusCode::Bad_NoContinuationPoints);
+  EXPECT_TRUE(overflow.results[1].continuation_point.empty());
+  ASSERT_EQ(released.size(), 1u);
+  EXPECT_EQ(released[0].node_id, NumericNode(10));
+  EXPECT_EQ(released[0].continuation_point, ByteString{'p'});
+}
+
+// Closing a session hands every backend cursor it still holds back to the
+// backend, as a release read of the node it was reading.
+template <typename Fixture>
+void ExpectClosingSessionReleasesHistoryCursors(Fixture& fixture) {
+  typename Fixture::ConnectionState connection;
+  const auto ids = fixture.CreateAndActivate(connection);
+
+  const auto from = fixture.now_;
+  const auto to = fixture.now_ + Duration::FromSeconds(60);
+  const ByteString backend_point{'p', '9'};
+  fixture.services_.history_read_raw =
+      [&](HistoryReadRawDetails details) -> StatusOr<HistoryReadRawResult> {
+    if (details.release_continuation_point)
+      return HistoryReadRawResult{};
+    return HistoryReadRawResult{
+        .values = {DataValue{Variant{1.5}, {}, from, from}},
+        .continuation_point = backend_point};
+  };
+
+  const auto paged = fixture.template HandleResponse<ua::HistoryReadResponse>(
+      connection,
+      ua::HistoryReadRequest{
+          .history_read_details = ua::ToExtensionObject(
+              ua::ReadRawModifiedDetails{.start_time = from, .end_time = to}),
+          .nodes_to_read = {{.node_id = NumericNode(9)}}});
+  ASSERT_EQ(paged.results.size(), 1u);
+  ASSERT_FALSE(paged.results[0].continuation_point.empty());
+  EXPECT_EQ(fixture.services_.history_read_raw_count, 1);
+
+  const auto closed = fixture.template HandleResponse<CloseSessionResponse>(
+      connection,
+      CloseSessionRequest{.session_id = ids.session_id,
+                          .authentication_token = ids.authentication_token});
+  EXPECT_EQ(closed.status.code(), StatusCode::Good);
+  fixture.Drain();
+
+  EXPECT_EQ(fixture.services_.history_read_raw_count, 2);
+  ASSERT_TRUE(fixture.services_.last_history_read_raw.has_value());
+  const auto& released = *fixture.services_.last_history_read_raw;
+  EXPECT_TRUE(released.release_continuation_point);
+  EXPECT_EQ(released.continuation_point, backend_point);
+  EXPECT_EQ(released.node_id, NumericNode(9));
+}
+
 template <typename Fixture>
 void ExpectRejectsHistoryReadRawWithoutActivatedSession(Fixture& fixture) {
   typename Fixture::ConnectionState connection;
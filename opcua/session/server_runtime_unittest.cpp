@@ -45,6 +45,25 @@ TEST_F(ServerRuntimeTest, HistoryReadRawPreservesPayloadThroughSession) {
   test::ExpectHistoryReadRawPreservesPayloadThroughActivatedSession(fixture_);
 }
 
+TEST_F(ServerRuntimeTest,
+       PagesMultiNodeHistoryReadThroughSessionContinuationPoints) {
+  test::ExpectPagesMultiNodeHistoryReadThroughSessionContinuationPoints(
+      fixture_);
+}
+
+TEST_F(ServerRuntimeTest, ReadsMoreHistoryNodesThanContinuationPoints) {
+  test::ExpectReadsMoreHistoryNodesThanContinuationPoints(fixture_);
+}
+
+TEST_F(ServerRuntimeTest,
+       ReleasesHistoryCursorsBeyondContinuationPointRoom) {
+  test::ExpectReleasesHistoryCursorsBeyondContinuationPointRoom(fixture_);
+}
+
+TEST_F(ServerRuntimeTest, ClosingSessionReleasesHistoryCursors) {
+  test::ExpectClosingSessionReleasesHistoryCursors(fixture_);
+}
+
 TEST_F(ServerRuntimeTest, RejectsHistoryReadRawWithoutActivatedSession) {
   test::ExpectRejectsHistoryReadRawWithoutActivatedSession(fixture_);
 }
@@ -99,6 +118,37 @@ TEST_F(ServerRuntimeTest, RegisterNodesEchoesRequestedNodeIds) {
             StatusCode::Good);
 }
 
+// The session timeout counts from the client's last service call, not from
+// activation (OPC UA Part 4 §5.6.2,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.6.2).
+TEST_F(ServerRuntimeTest, ServiceRequestsKeepTheSessionAlive) {
+  DirectRuntimeFixture::ConnectionState connection;
+  const auto ids = fixture_.CreateAndActivate(connection);
+  const ua::ReadRequest read{
+      .nodes_to_read = {{.node_id = NumericNode(1),
+                         .attribute_id =
+                             static_cast<UInt32>(AttributeId::Value)}}};
+
+  // Nine minutes into the default ten-minute timeout, a Read...
+  fixture_.Advance(9 * 60 * 1000);
+  fixture_.HandleResponse<ua::ReadResponse>(connection, read);
+
+  // ...carries the session past where activation alone would have ended it.
+  fixture_.Advance(9 * 60 * 1000);
+  fixture_.session_manager_.PruneExpiredSessions();
+  EXPECT_TRUE(
+      fixture_.session_manager_.FindSession(ids.authentication_token));
+  EXPECT_EQ(fixture_.HandleResponse<ua::ReadResponse>(connection, read)
+                .response_header.service_result.code(),
+            StatusCode::Good);
+
+  // Idle for a full timeout, it goes.
+  fixture_.Advance(10 * 60 * 1000);
+  fixture_.session_manager_.PruneExpiredSessions();
+  EXPECT_FALSE(
+      fixture_.session_manager_.FindSession(ids.authentication_token));
+}
+
 // A fixture that owns its runtime directly, for the two cases that need a
 // non-default ServerRuntimeContext.
 class ConfiguredRuntimeTest : public testing::Test {
@@ -186,6 +236,79 @@ TEST_F(ConfiguredRuntimeTest, PublishDelayUsesInjectedSchedulerCallback) {
   EXPECT_EQ(response->subscription_id, subscription.subscription_id);
 }
 
+// A parked Publish is woken by the notification that makes its subscription
+// due, not by its timer: the response goes out as soon as the data arrives, and
+// holding the request arms no timer beyond the session's one.
+TEST_F(ConfiguredRuntimeTest, ParkedPublishWakesOnNotification) {
+  std::vector<std::function<void()>> scheduled_tasks;
+
+  ServerRuntime runtime{ServerRuntimeContext{
+      .executor = AnyExecutor{executor_},
+      .session_manager = session_manager_,
+      .callbacks =
+          services_.MakeCallbacks(AnyExecutor{executor_}, backing_states_),
+      .now = [this] { return now_; },
+      .post_delayed_task =
+          [&](Duration, std::function<void()> task) {
+            scheduled_tasks.push_back(std::move(task));
+          },
+  }};
+
+  ConnectionState connection = Activate(runtime);
+
+  const auto subscription = std::get<CreateSubscriptionResponse>(WaitAwaitable(
+      executor_,
+      runtime.Handle(connection,
+                     RequestBody{CreateSubscriptionRequest{
+                         .parameters = {.publishing_interval_ms = 100,
+                                        .lifetime_count = 60,
+                                        .max_keep_alive_count = 3,
+                                        .publishing_enabled = true}}})));
+  const auto created = std::get<CreateMonitoredItemsResponse>(WaitAwaitable(
+      executor_,
+      runtime.Handle(
+          connection,
+          RequestBody{CreateMonitoredItemsRequest{
+              .subscription_id = subscription.subscription_id,
+              .items_to_create = {
+                  {.item_to_monitor = {.node_id = NumericNode(5),
+                                       .attribute_id = AttributeId::Value},
+                   .requested_parameters = {.client_handle = 77,
+                                            .queue_size = 1}}}}})));
+  ASSERT_EQ(created.status.code(), StatusCode::Good);
+  Drain(executor_);
+  auto& backing = *backing_states_->back();
+
+  // The first cycle's keep-alive clears the initial message.
+  now_ = now_ + Duration::FromMilliseconds(100);
+  const auto first = std::get<PublishResponse>(WaitAwaitable(
+      executor_, runtime.Handle(connection, RequestBody{PublishRequest{}})));
+  EXPECT_TRUE(first.notification_message.notification_data.empty());
+
+  // Nothing queued: the next Publish parks until the keep-alive deadline.
+  auto publish = StartAwaitable<ResponseBody>(
+      executor_, runtime.Handle(connection, RequestBody{PublishRequest{}}));
+  Drain(executor_);
+  ASSERT_FALSE(publish->done);
+  ASSERT_EQ(scheduled_tasks.size(), 1u);
+
+  // A data change one publishing interval later completes it at once, with
+  // the timer still pending.
+  now_ = now_ + Duration::FromMilliseconds(100);
+  backing.PushDataChange(backing.BackingClientHandle(0),
+                         DataValue{Variant{4.5}, {}, now_, now_});
+  const auto body = WaitResult(executor_, publish);
+  const auto* response = std::get_if<PublishResponse>(&body);
+  ASSERT_NE(response, nullptr);
+  ASSERT_EQ(response->notification_message.notification_data.size(), 1u);
+  const auto* data_change = std::get_if<DataChangeNotification>(
+      &response->notification_message.notification_data.front());
+  ASSERT_NE(data_change, nullptr);
+  ASSERT_EQ(data_change->monitored_items.size(), 1u);
+  EXPECT_EQ(data_change->monitored_items[0].client_handle, 77u);
+  EXPECT_EQ(scheduled_tasks.size(), 1u);
+}
+
 // Operation limits are enforced before the request reaches the application.
 // OPC UA Part 5 §12.4 OperationLimits,
 // https://reference.opcfoundation.org/Core/Part5/v105/docs/12.4
@@ -221,5 +344,93 @@ TEST_F(ConfiguredRuntimeTest, RejectsRequestsExceedingOperationLimits) {
   EXPECT_EQ(services_.read_count, 0);
 }
 
+// RegisterNodes hands out numeric aliases in the configured namespace, backed
+// by the ids the backend resolved the nodes to; Read and CreateMonitoredItems
+// naming an alias reach the backend with its id, and UnregisterNodes gives the
+// id back. OPC UA Part 4 §5.9.5 RegisterNodes,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.9.5
+TEST_F(ConfiguredRuntimeTest, RegisteredNodesReachTheBackendByResolvedId) {
+  constexpr NamespaceIndex kAliasNamespace = 9;
+  const NodeId temperature{"Plant.Area1.Line4.Oven2.Temperature", 2};
+  const NodeId pressure{"Plant.Area1.Line4.Oven2.Pressure", 2};
+  std::vector<NodeId> released;
+
+  auto callbacks =
+      services_.MakeCallbacks(AnyExecutor{executor_}, backing_states_);
+  callbacks.register_nodes =
+      [&](ServiceContext,
+          std::vector<NodeId> nodes) -> CoStatusOr<std::vector<NodeId>> {
+    std::vector<NodeId> handles;
+    for (const auto& node : nodes)
+      handles.push_back(node == temperature ? NumericNode(501)
+                                            : NumericNode(502));
+    co_return handles;
+  };
+  callbacks.unregister_nodes = [&](ServiceContext, std::vector<NodeId> nodes) {
+    released.insert(released.end(), nodes.begin(), nodes.end());
+  };
+  ServerRuntime runtime{ServerRuntimeContext{
+      .executor = AnyExecutor{executor_},
+      .session_manager = session_manager_,
+      .callbacks = std::move(callbacks),
+      .now = [this] { return now_; },
+      .registered_node_namespace_index = kAliasNamespace,
+  }};
+  ConnectionState connection = Activate(runtime);
+
+  const auto registered = std::get<ua::RegisterNodesResponse>(WaitAwaitable(
+      executor_,
+      runtime.Handle(connection, RequestBody{ua::RegisterNodesRequest{
+                                     .nodes_to_register = {temperature,
+                                                           pressure}}})));
+  EXPECT_EQ(registered.response_header.service_result.code(),
+            StatusCode::Good);
+  ASSERT_EQ(registered.registered_node_ids,
+            (std::vector<NodeId>{NodeId{1, kAliasNamespace},
+                                 NodeId{2, kAliasNamespace}}));
+
+  const auto read = std::get<ua::ReadResponse>(WaitAwaitable(
+      executor_,
+      runtime.Handle(
+          connection,
+          RequestBody{ua::ReadRequest{
+              .nodes_to_read = {
+                  {.node_id = registered.registered_node_ids[1],
+                   .attribute_id = static_cast<UInt32>(AttributeId::Value)},
+                  {.node_id = temperature,
+                   .attribute_id =
+                       static_cast<UInt32>(AttributeId::Value)}}}})));
+  EXPECT_EQ(read.response_header.service_result.code(), StatusCode::Good);
+  ASSERT_EQ(services_.last_read_inputs.size(), 2u);
+  EXPECT_EQ(services_.last_read_inputs[0].node_id, NumericNode(502));
+  EXPECT_EQ(services_.last_read_inputs[1].node_id, temperature);
+
+  const auto subscription = std::get<CreateSubscriptionResponse>(WaitAwaitable(
+      executor_, runtime.Handle(connection,
+                                RequestBody{CreateSubscriptionRequest{}})));
+  std::get<CreateMonitoredItemsResponse>(WaitAwaitable(
+      executor_,
+      runtime.Handle(
+          connection,
+          RequestBody{CreateMonitoredItemsRequest{
+              .subscription_id = subscription.subscription_id,
+              .items_to_create = {
+                  {.item_to_monitor = {
+                       .node_id = registered.registered_node_ids[0],
+                       .attribute_id = AttributeId::Value}}}}})));
+  Drain(executor_);
+  ASSERT_EQ(backing_states_->back()->added_items.size(), 1u);
+  EXPECT_EQ(
+      backing_states_->back()->added_items[0].request.item_to_monitor.node_id,
+      NumericNode(501));
+
+  WaitAwaitable(executor_,
+                runtime.Handle(connection,
+                               RequestBody{ua::UnregisterNodesRequest{
+                                   .nodes_to_unregister = {
+                                       registered.registered_node_ids[0]}}}));
+  EXPECT_EQ(released, (std::vector<NodeId>{NumericNode(501)}));
+}
+
 }  // namespace
 }  // namespace opcua
@@ -14,6 +14,12 @@ constexpr size_t kNotFound = static_cast<size_t>(-1);
 ServerSession::ServerSession(ServerSessionContext&& context)
     : ServerSessionContext{std::move(context)} {}
 
+ServerSession::~ServerSession() {
+  // Parked Publishes re-poll, find the session gone and answer
+  // Bad_SessionIdInvalid instead of waiting on a timer that was just canceled.
+  WakePublishWaiters();
+}
+
 size_t ServerSession::ByteStringHash::operator()(
     const ByteString& value) const {
   return std::hash<std::string_view>{}(
@@ -39,8 +45,11 @@ CreateSubscriptionResponse ServerSession::CreateSubscriptionWithId(
   // report the revised values back to the client.
   const auto& revised = subscription->parameters();
 
+  WatchSubscription(*subscription);
+  ScheduleLifetime(*subscription);
   subscriptions_.emplace(subscription_id, std::move(subscription));
   publish_order_.push_back(subscription_id);
+  OnPublishStateChanged();
 
   return {.status = StatusCode::Good,
           .subscription_id = subscription_id,
@@ -54,7 +63,12 @@ ModifySubscriptionResponse ServerSession::ModifySubscription(
   auto* subscription = FindSubscription(request.subscription_id);
   if (!subscription)
     return {.status = StatusCode::Bad_SubscriptionIdInvalid};
-  return subscription->Modify(request);
+  auto response = subscription->Modify(request);
+  if (response.status) {
+    subscription->RestartLifetime(Now());
+    ScheduleLifetime(*subscription);
+  }
+  return response;
 }
 
 ua::SetPublishingModeResponse ServerSession::SetPublishingMode(
@@ -91,6 +105,7 @@ ua::DeleteSubscriptionsResponse ServerSession::DeleteSubscriptions(
     response.results.push_back(Status{StatusCode::Good});
   }
 
+  OnPublishStateChanged();
   return response;
 }
 
@@ -119,6 +134,9 @@ ua::TransferSubscriptionsResponse ServerSession::TransferSubscriptionsFrom(
       continue;
     }
 
+    WatchSubscription(*source_it->second);
+    source_it->second->RestartLifetime(Now());
+    ScheduleLifetime(*source_it->second);
     subscriptions_.emplace(subscription_id, std::move(source_it->second));
     publish_order_.push_back(subscription_id);
     source.EraseSubscription(subscription_id);
@@ -126,9 +144,42 @@ ua::TransferSubscriptionsResponse ServerSession::TransferSubscriptionsFrom(
   }
 
   RefreshNextSubscriptionId();
+  source.OnPublishStateChanged();
+  OnPublishStateChanged();
   return response;
 }
 
+std::unique_ptr<ServerSubscription> ServerSession::ReleaseSubscription(
+    SubscriptionId subscription_id) {
+  auto it = subscriptions_.find(subscription_id);
+  if (it == subscriptions_.end())
+    return nullptr;
+
+  auto subscription = std::move(it->second);
+  subscription->SetPublishReadyCallback(nullptr);
+  subscription->SetDataChangeCallback(nullptr);
+  EraseSubscription(subscription_id);
+  OnPublishStateChanged();
+  return subscription;
+}
+
+StatusCode ServerSession::AdoptSubscription(
+    std::unique_ptr<ServerSubscription> subscription) {
+  const auto subscription_id = subscription->subscription_id();
+  if (FindSubscription(subscription_id))
+    return StatusCode::Bad;
+
+  subscription->SetExecutor(this->executor);
+  WatchSubscription(*subscription);
+  subscription->RestartLifetime(Now());
+  ScheduleLifetime(*subscription);
+  subscriptions_.emplace(subscription_id, std::move(subscription));
+  publish_order_.push_back(subscription_id);
+  RefreshNextSubscriptionId();
+  OnPublishStateChanged();
+  return StatusCode::Good;
+}
+
 CreateMonitoredItemsResponse ServerSession::CreateMonitoredItems(
     const CreateMonitoredItemsRequest& request) {
   if (request.items_to_create.size() >
@@ -175,6 +226,11 @@ ua::SetMonitoringModeResponse ServerSession::SetMonitoringMode(
 
 std::vector<StatusCode> ServerSession::AcknowledgePublishRequest(
     const PublishRequest& request) {
+  // Every Publish request resets the lifetime counter of every subscription
+  // in the session. Recorded once here rather than per subscription; the
+  // queued deadlines catch up when they come due.
+  last_publish_request_time_ = Now();
+
   std::vector<StatusCode> ack_results(
       request.subscription_acknowledgements.size(), StatusCode::Good);
   std::unordered_map<SubscriptionId, std::vector<std::pair<size_t, UInt32>>>
@@ -209,6 +265,12 @@ std::vector<StatusCode> ServerSession::AcknowledgePublishRequest(
 }
 
 ServerSession::PublishPollResult ServerSession::PollPublish() {
+  if (!expired_responses_.empty()) {
+    auto response = std::move(expired_responses_.front());
+    expired_responses_.pop_front();
+    return {.response = std::move(response)};
+  }
+
   const auto now_time = Now();
   const auto pending_index = FindNextReadySubscription(now_time, true);
   const auto publish_index = pending_index != kNotFound
@@ -223,8 +285,10 @@ ServerSession::PublishPollResult ServerSession::PollPublish() {
                   PublishResponse{.status = StatusCode::Bad_NoSubscription}};
     }
 
+    // No cap at the publishing interval: a notification that makes a
+    // subscription due sooner signals the parked Publish (see
+    // WaitForPublish), so waiting out the earliest deadline misses nothing.
     std::optional<DateTime> earliest_deadline;
-    std::optional<Duration> max_wait_before_recheck;
     for (const auto subscription_id : publish_order_) {
       auto* subscription = FindSubscription(subscription_id);
       if (!subscription)
@@ -237,22 +301,13 @@ ServerSession::PublishPollResult ServerSession::PollPublish() {
           !earliest_deadline.has_value() || *deadline < *earliest_deadline
               ? deadline
               : earliest_deadline;
-      max_wait_before_recheck =
-          !max_wait_before_recheck.has_value() ||
-                  subscription->PublishingInterval() < *max_wait_before_recheck
-              ? subscription->PublishingInterval()
-              : max_wait_before_recheck;
     }
 
     if (!earliest_deadline.has_value()) {
       return {.response = PublishResponse{.status = StatusCode::Good}};
     }
 
-    auto wait_for = std::max(Duration{}, *earliest_deadline - now_time);
-    if (max_wait_before_recheck.has_value()) {
-      wait_for = std::min(wait_for, *max_wait_before_recheck);
-    }
-    return {.wait_for = wait_for};
+    return {.wait_for = std::max(Duration{}, *earliest_deadline - now_time)};
   }
 
   const auto subscription_id = publish_order_[publish_index];
@@ -270,6 +325,163 @@ ServerSession::PublishPollResult ServerSession::PollPublish() {
   return {.response = std::move(published)};
 }
 
+Awaitable<void> ServerSession::WaitForPublish(Duration wait_for) {
+  base::AsyncCompletion waiter{this->executor};
+  publish_waiters_.push_back(waiter);
+  ArmPublishTimer(Now() + wait_for);
+  // The returned awaitable holds only the waiter's shared state, so it stays
+  // valid if this session is destroyed while the Publish is parked.
+  return waiter.Wait();
+}
+
+void ServerSession::WakePublishWaiters() {
+  // Completion resumes each waiter through the executor, in the order they
+  // parked, so they re-poll (and re-park) in arrival order.
+  auto waiters = std::move(publish_waiters_);
+  publish_waiters_.clear();
+  for (auto& waiter : waiters)
+    waiter.Complete();
+}
+
+void ServerSession::OnPublishStateChanged() {
+  if (publish_waiters_.empty())
+    return;
+
+  const auto now_time = Now();
+  if (subscriptions_.empty() ||
+      FindNextReadySubscription(now_time, false) != kNotFound) {
+    WakePublishWaiters();
+    return;
+  }
+
+  std::optional<DateTime> earliest_deadline;
+  for (const auto& [subscription_id, subscription] : subscriptions_) {
+    subscription->PrimePublishCycle(now_time);
+    const auto deadline = subscription->NextPublishDeadline();
+    if (deadline.has_value() &&
+        (!earliest_deadline.has_value() || *deadline < *earliest_deadline))
+      earliest_deadline = deadline;
+  }
+  if (earliest_deadline.has_value())
+    ArmPublishTimer(*earliest_deadline);
+}
+
+void ServerSession::ArmPublishTimer(DateTime deadline) {
+  if (publish_timer_deadline_.has_value() &&
+      *publish_timer_deadline_ <= deadline) {
+    return;  // The armed timer fires first and re-polls anyway.
+  }
+
+  publish_timer_cancelation_.Cancel();
+  publish_timer_deadline_ = deadline;
+  const auto delay = std::max(Duration{}, deadline - Now());
+  auto task = publish_timer_cancelation_.Bind([this] {
+    publish_timer_deadline_.reset();
+    WakePublishWaiters();
+  });
+  if (this->post_delayed_task) {
+    this->post_delayed_task(delay, std::move(task));
+  } else {
+    PostDelayedTask(this->executor,
+                    std::chrono::milliseconds{delay.InMilliseconds()},
+                    std::move(task));
+  }
+}
+
+void ServerSession::WatchSubscription(ServerSubscription& subscription) {
+  // The session owns its subscriptions, so the callback cannot outlive it; a
+  // transfer re-points it at the new owner.
+  subscription.SetPublishReadyCallback([this] { OnPublishStateChanged(); });
+  subscription.SetDataChangeCallback(this->on_data_change);
+}
+
+DateTime ServerSession::LifetimeDeadline(
+    const ServerSubscription& subscription) const {
+  auto start = subscription.lifetime_start();
+  if (last_publish_request_time_.has_value())
+    start = std::max(start, *last_publish_request_time_);
+  return start + subscription.LifetimeInterval();
+}
+
+void ServerSession::ScheduleLifetime(const ServerSubscription& subscription) {
+  const auto subscription_id = subscription.subscription_id();
+  const auto deadline = LifetimeDeadline(subscription);
+  const auto it = lifetime_deadlines_.find(subscription_id);
+  if (it != lifetime_deadlines_.end() && it->second <= deadline)
+    return;  // Re-queued at the later deadline once the queued one is due.
+
+  lifetime_deadlines_[subscription_id] = deadline;
+  lifetime_queue_.push({deadline, subscription_id});
+  ArmLifetimeTimer();
+}
+
+void ServerSession::ExpireSubscriptions() {
+  const auto now_time = Now();
+  // A parked Publish is a request the subscriptions can be served with, so
+  // their lifetime counters stay at the start while it waits.
+  if (!publish_waiters_.empty())
+    last_publish_request_time_ = now_time;
+
+  std::vector<SubscriptionId> expired;
+  while (!lifetime_queue_.empty() &&
+         lifetime_queue_.top().deadline <= now_time) {
+    const auto entry = lifetime_queue_.top();
+    lifetime_queue_.pop();
+    const auto it = lifetime_deadlines_.find(entry.subscription_id);
+    if (it == lifetime_deadlines_.end() || it->second != entry.deadline)
+      continue;
+    lifetime_deadlines_.erase(it);
+
+    auto* subscription = FindSubscription(entry.subscription_id);
+    if (!subscription)
+      continue;
+    if (const auto deadline = LifetimeDeadline(*subscription);
+        deadline > now_time) {
+      lifetime_deadlines_.emplace(entry.subscription_id, deadline);
+      lifetime_queue_.push({deadline, entry.subscription_id});
+      continue;
+    }
+
+    // OPC UA Part 4 §5.13.1.1: the subscription is closed, and the
+    // StatusChangeNotification goes out with the next Publish of the session.
+    // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.13.1.1
+    expired_responses_.push_back(subscription->Expire(now_time));
+    EraseSubscription(entry.subscription_id);
+    expired.push_back(entry.subscription_id);
+  }
+
+  for (const auto subscription_id : expired) {
+    if (this->on_subscription_expired)
+      this->on_subscription_expired(subscription_id);
+  }
+  ArmLifetimeTimer();
+}
+
+void ServerSession::ArmLifetimeTimer() {
+  if (lifetime_queue_.empty())
+    return;
+  const auto deadline = lifetime_queue_.top().deadline;
+  if (lifetime_timer_deadline_.has_value() &&
+      *lifetime_timer_deadline_ <= deadline) {
+    return;  // The armed timer fires first and re-arms for the rest.
+  }
+
+  lifetime_timer_cancelation_.Cancel();
+  lifetime_timer_deadline_ = deadline;
+  const auto delay = std::max(Duration{}, deadline - Now());
+  auto task = lifetime_timer_cancelation_.Bind([this] {
+    lifetime_timer_deadline_.reset();
+    ExpireSubscriptions();
+  });
+  if (this->post_lifetime_task) {
+    this->post_lifetime_task(delay, std::move(task));
+  } else {
+    PostDelayedTask(this->executor,
+                    std::chrono::milliseconds{delay.InMilliseconds()},
+                    std::move(task));
+  }
+}
+
 PublishResponse ServerSession::Publish(const PublishRequest& request) {
   auto ack_results = AcknowledgePublishRequest(request);
   auto poll = PollPublish();
@@ -329,6 +541,158 @@ ua::BrowseNextResponse ServerSession::BrowseNext(
   return response;
 }
 
+ServerSession::HistoryReadResumption ServerSession::ResumeHistoryRead(
+    ua::HistoryReadRequest& request) {
+  auto& nodes = request.nodes_to_read;
+  HistoryReadResumption resumption{
+      .statuses = std::vector<StatusCode>(nodes.size(), StatusCode::Good)};
+  std::size_t kept = 0;
+  for (std::size_t index = 0; index < nodes.size(); ++index) {
+    auto& node = nodes[index];
+    if (!node.continuation_point.empty()) {
+      const auto it = history_continuations_.find(node.continuation_point);
+      if (it == history_continuations_.end()) {
+        resumption.statuses[index] = StatusCode::Bad_ContinuationPointInvalid;
+        continue;
+      }
+      node.continuation_point = std::move(it->second.continuation_point);
+      history_continuations_.erase(it);
+    }
+    resumption.node_ids.push_back(node.node_id);
+    if (kept != index)
+      nodes[kept] = std::move(node);
+    ++kept;
+  }
+  nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(kept), nodes.end());
+  return resumption;
+}
+
+ServerSession::StoredHistoryRead ServerSession::StoreHistoryReadResults(
+    ua::HistoryReadResponse response,
+    const HistoryReadResumption& resumption) {
+  StoredHistoryRead stored;
+  // A service fault answers the request as a whole.
+  if (!response.response_header.service_result) {
+    stored.response = std::move(response);
+    return stored;
+  }
+
+  std::vector<ua::HistoryReadResult> results;
+  results.reserve(resumption.statuses.size());
+  auto next = response.results.begin();
+  auto node_id = resumption.node_ids.begin();
+  for (const auto status : resumption.statuses) {
+    if (status != StatusCode::Good) {
+      results.push_back({.status_code = Status{status}});
+      continue;
+    }
+    if (next == response.results.end())
+      break;
+    auto result = std::move(*next++);
+    if (!result.continuation_point.empty()) {
+      HistoryCursor cursor{
+          .node_id = *node_id,
+          .continuation_point = std::move(result.continuation_point)};
+      // Same per-session bound as Browse; the client frees points by reading
+      // on or with releaseContinuationPoints. Past it the node cannot be
+      // continued, and the backend's cursor goes back to it.
+      if (history_continuations_.size() >= kMaxHistoryContinuationPoints) {
+        stored.unstored.push_back(std::move(cursor));
+        result = {.status_code = Status{StatusCode::Bad_NoContinuationPoints}};
+      } else {
+        auto continuation_point = MakeContinuationPoint();
+        history_continuations_.emplace(continuation_point, std::move(cursor));
+        result.continuation_point = std::move(continuation_point);
+      }
+    }
+    ++node_id;
+    results.push_back(std::move(result));
+  }
+  response.results = std::move(results);
+  stored.response = std::move(response);
+  return stored;
+}
+
+std::vector<ServerSession::HistoryCursor>
+ServerSession::ReleaseHistoryCursors() {
+  std::vector<HistoryCursor> released;
+  released.reserve(history_continuations_.size());
+  for (auto& [continuation_point, cursor] : history_continuations_)
+    released.push_back(std::move(cursor));
+  history_continuations_.clear();
+  return released;
+}
+
+std::size_t ServerSession::RegisteredNodeRoom() const {
+  if (!this->registered_node_namespace_index.has_value())
+    return 0;
+  return kMaxRegisteredNodes - registered_nodes_.size() +
+         free_registered_slots_.size();
+}
+
+std::vector<NodeId> ServerSession::RegisterNodes(
+    std::vector<NodeId> backend_ids) {
+  std::vector<NodeId> aliases;
+  aliases.reserve(backend_ids.size());
+  const auto room = RegisteredNodeRoom();
+  for (auto& backend_id : backend_ids) {
+    if (aliases.size() == room)
+      break;
+    std::size_t slot;
+    if (!free_registered_slots_.empty()) {
+      slot = free_registered_slots_.back();
+      free_registered_slots_.pop_back();
+      registered_nodes_[slot] = std::move(backend_id);
+    } else {
+      slot = registered_nodes_.size();
+      registered_nodes_.emplace_back(std::move(backend_id));
+    }
+    aliases.emplace_back(static_cast<NumericId>(slot + 1),
+                         *this->registered_node_namespace_index);
+  }
+  return aliases;
+}
+
+std::vector<NodeId> ServerSession::UnregisterNodes(
+    std::span<const NodeId> node_ids) {
+  std::vector<NodeId> released;
+  for (const auto& node_id : node_ids) {
+    if (!this->registered_node_namespace_index.has_value() ||
+        !node_id.is_numeric() ||
+        node_id.namespace_index() != *this->registered_node_namespace_index) {
+      continue;
+    }
+    const auto slot = static_cast<std::size_t>(node_id.numeric_id()) - 1;
+    if (slot >= registered_nodes_.size() || !registered_nodes_[slot])
+      continue;
+    released.push_back(std::move(*registered_nodes_[slot]));
+    registered_nodes_[slot].reset();
+    free_registered_slots_.push_back(slot);
+  }
+  return released;
+}
+
+std::vector<NodeId> ServerSession::ReleaseRegisteredNodes() {
+  std::vector<NodeId> released;
+  for (auto& backend_id : registered_nodes_) {
+    if (backend_id)
+      released.push_back(std::move(*backend_id));
+  }
+  registered_nodes_.clear();
+  free_registered_slots_.clear();
+  return released;
+}
+
+void ServerSession::ResolveRegisteredNode(NodeId& node_id) const {
+  if (registered_nodes_.empty() || !node_id.is_numeric() ||
+      node_id.namespace_index() != *this->registered_node_namespace_index) {
+    return;
+  }
+  const auto slot = static_cast<std::size_t>(node_id.numeric_id()) - 1;
+  if (slot < registered_nodes_.size() && registered_nodes_[slot])
+    node_id = *registered_nodes_[slot];
+}
+
 std::vector<SubscriptionId> ServerSession::GetSubscriptionIds() const {
   std::vector<SubscriptionId> result;
   result.reserve(publish_order_.size());
@@ -357,6 +721,7 @@ const ServerSubscription* ServerSession::FindSubscription(
 
 void ServerSession::EraseSubscription(SubscriptionId subscription_id) {
   subscriptions_.erase(subscription_id);
+  lifetime_deadlines_.erase(subscription_id);
   const auto it =
       std::find(publish_order_.begin(), publish_order_.end(), subscription_id);
   if (it == publish_order_.end())
@@ -409,9 +774,9 @@ void ServerSession::RefreshNextSubscriptionId() {
         std::max(next_subscription_id_, subscription_id + 1);
 }
 
-ByteString ServerSession::MakeBrowseContinuationPoint() {
-  ByteString value(sizeof(next_browse_continuation_id_), '\0');
-  const auto raw = next_browse_continuation_id_++;
+ByteString ServerSession::MakeContinuationPoint() {
+  ByteString value(sizeof(next_continuation_id_), '\0');
+  const auto raw = next_continuation_id_++;
   std::memcpy(value.data(), &raw, sizeof(raw));
   return value;
 }
@@ -434,7 +799,7 @@ ua::BrowseResult ServerSession::PageBrowseResult(
     return {.status_code = Status{StatusCode::Bad_NoContinuationPoints}};
   }
 
-  auto continuation_point = MakeBrowseContinuationPoint();
+  auto continuation_point = MakeContinuationPoint();
   BrowseContinuationState state;
   state.remaining_references.assign(
       std::make_move_iterator(
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "opcua/base/any_executor.h"
+#include "opcua/base/async_completion.h"
+#include "opcua/base/awaitable.h"
+#include "opcua/base/cancelation.h"
 #include "opcua/message.h"
 #include "opcua/services/operation_limits.h"
 #include "opcua/services/service_callbacks.h"
@@ -10,9 +13,12 @@
 
 #include "opcua/services/service_context.h"
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <queue>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
@@ -30,6 +36,22 @@ struct ServerSessionContext {
   ServiceCallbacks::CreateSubscriptionCallback create_subscription;
   OperationLimits operation_limits;
   std::function<DateTime()> now = &DateTime::Now;
+  // Schedules the session's publish timer. Defaults to a
+  // boost::asio::steady_timer on `executor` when null.
+  std::function<void(Duration, std::function<void()>)> post_delayed_task;
+  // Schedules the subscription lifetime timer, with the same default. Kept
+  // apart from `post_delayed_task`: that timer runs only while a Publish is
+  // parked, this one for as long as the session has subscriptions.
+  std::function<void(Duration, std::function<void()>)> post_lifetime_task;
+  // Namespace of the alias NodeIds RegisterNodes hands out (see
+  // RegisterNodes). Unset, the session keeps no registered nodes.
+  std::optional<NamespaceIndex> registered_node_namespace_index;
+  // Called with the data changes the session's subscriptions receive (see
+  // ServerSubscription::SetDataChangeCallback).
+  std::function<void(const ReadValueId&, const DataValue&)> on_data_change;
+  // Called after a subscription's lifetime ran out and the session deleted it,
+  // so the owner can forget the id.
+  std::function<void(SubscriptionId)> on_subscription_expired;
 };
 
 class ServerSession : private ServerSessionContext {
@@ -40,6 +62,10 @@ class ServerSession : private ServerSessionContext {
   };
 
   explicit ServerSession(ServerSessionContext&& context);
+  ~ServerSession();
+
+  ServerSession(const ServerSession&) = delete;
+  ServerSession& operator=(const ServerSession&) = delete;
 
   const ServiceContext& GetServiceContext() const {
     return this->service_context;
@@ -70,6 +96,15 @@ class ServerSession : private ServerSessionContext {
   ua::TransferSubscriptionsResponse TransferSubscriptionsFrom(
       ServerSession& source,
       const ua::TransferSubscriptionsRequest& request);
+  // The two halves of TransferSubscriptionsFrom, for a source and target
+  // session that live on different shards and so cannot meet in one call.
+  // ReleaseSubscription detaches a subscription (null if this session has no
+  // such subscription); AdoptSubscription takes it over on this session's
+  // executor, or answers Bad (dropping it) if the id is already in use here.
+  std::unique_ptr<ServerSubscription> ReleaseSubscription(
+      SubscriptionId subscription_id);
+  StatusCode AdoptSubscription(
+      std::unique_ptr<ServerSubscription> subscription);
 
   CreateMonitoredItemsResponse CreateMonitoredItems(
       const CreateMonitoredItemsRequest& request);
@@ -83,12 +118,76 @@ class ServerSession : private ServerSessionContext {
   std::vector<StatusCode> AcknowledgePublishRequest(
       const PublishRequest& request);
   PublishPollResult PollPublish();
+  // Parks a Publish that PollPublish could not answer. Completes when one of
+  // the session's subscriptions signals it may have become publishable, when
+  // `wait_for` (the earliest publish deadline PollPublish reported) elapses,
+  // or when the session goes away; the caller then polls again. All parked
+  // Publishes share one session timer, armed for the earliest deadline, so
+  // the number of outstanding requests does not multiply the timers.
+  [[nodiscard]] Awaitable<void> WaitForPublish(Duration wait_for);
+  // Completes every parked Publish so each re-polls (or notices its
+  // connection has gone).
+  void WakePublishWaiters();
   PublishResponse Publish(const PublishRequest& request);
   RepublishResponse Republish(const RepublishRequest& request) const;
   ua::BrowseResponse StoreBrowseResults(
       ua::BrowseResponse response,
       size_t requested_max_references_per_node);
   ua::BrowseNextResponse BrowseNext(const ua::BrowseNextRequest& request);
+  // HistoryRead continuation points (OPC UA Part 4 §5.11.3). The client gets
+  // one of this session's points per paged node and the history backend's
+  // stays behind it, so a long read holds the backend's cursor rather than the
+  // values still to come, and only the session that started a read can
+  // continue it. The session holds at most kMaxHistoryContinuationPoints.
+  //
+  // ResumeHistoryRead swaps each node's point in `request` for the backend's,
+  // consuming it, and removes the nodes naming a point this session does not
+  // hold; the returned statuses, one per original node, mark those
+  // Bad_ContinuationPointInvalid. StoreHistoryReadResults puts their results
+  // back in request order and swaps every backend point in `response` for a
+  // new one of this session's. A node the session has no room left for is
+  // answered Bad_NoContinuationPoints, and its backend cursor is returned in
+  // `unstored` for the caller to release in the backend, as it does with the
+  // cursors ReleaseHistoryCursors empties the session of.
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.11.3
+  struct HistoryCursor {
+    NodeId node_id;
+    ByteString continuation_point;
+  };
+  struct HistoryReadResumption {
+    std::vector<StatusCode> statuses;
+    // The nodes left in the request, in order.
+    std::vector<NodeId> node_ids;
+  };
+  struct StoredHistoryRead {
+    ua::HistoryReadResponse response;
+    std::vector<HistoryCursor> unstored;
+  };
+  HistoryReadResumption ResumeHistoryRead(ua::HistoryReadRequest& request);
+  StoredHistoryRead StoreHistoryReadResults(
+      ua::HistoryReadResponse response,
+      const HistoryReadResumption& resumption);
+  std::vector<HistoryCursor> ReleaseHistoryCursors();
+  // Registered nodes (OPC UA Part 4 §5.9.5). Each registered node gets an
+  // alias NodeId, numeric in `registered_node_namespace_index`, whose
+  // identifier indexes this session's table of backend ids; resolving one
+  // is an array lookup rather than a hash of the client's (often long string)
+  // id. The table holds at most kMaxRegisteredNodes entries.
+  //
+  // RegisterNodes stores `backend_ids` — at most RegisteredNodeRoom() of them
+  // — and returns their aliases in the same order. UnregisterNodes releases
+  // the aliases among `node_ids`, ignoring anything else, and returns the
+  // backend ids they held; ReleaseRegisteredNodes does that for every alias.
+  // ResolveRegisteredNode replaces an alias with its backend id and leaves any
+  // other id alone.
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.9.5
+  static constexpr std::size_t kMaxRegisteredNodes = 65536;
+  std::size_t RegisteredNodeRoom() const;
+  std::vector<NodeId> RegisterNodes(std::vector<NodeId> backend_ids);
+  std::vector<NodeId> UnregisterNodes(std::span<const NodeId> node_ids);
+  std::vector<NodeId> ReleaseRegisteredNodes();
+  void ResolveRegisteredNode(NodeId& node_id) const;
+
   std::vector<SubscriptionId> GetSubscriptionIds() const;
   bool HasSubscription(SubscriptionId subscription_id) const;
 
@@ -105,6 +204,22 @@ class ServerSession : private ServerSessionContext {
       std::unordered_map<SubscriptionId, std::unique_ptr<ServerSubscription>>;
   using BrowseContinuationMap =
       std::unordered_map<ByteString, BrowseContinuationState, ByteStringHash>;
+  // Session continuation point -> the history backend's.
+  using HistoryContinuationMap =
+      std::unordered_map<ByteString, HistoryCursor, ByteStringHash>;
+
+  // A subscription's lifetime deadline in the queue below.
+  struct LifetimeEntry {
+    DateTime deadline;
+    SubscriptionId subscription_id = 0;
+  };
+
+  // Orders the priority queue so the earliest deadline is on top.
+  struct LaterLifetime {
+    bool operator()(const LifetimeEntry& a, const LifetimeEntry& b) const {
+      return a.deadline > b.deadline;
+    }
+  };
 
   DateTime Now() const { return this->now(); }
   ServerSubscription* FindSubscription(SubscriptionId subscription_id);
@@ -114,17 +229,61 @@ class ServerSession : private ServerSessionContext {
   void AdvancePublishCursorAfter(size_t index);
   size_t FindNextReadySubscription(DateTime now, bool require_pending) const;
   void RefreshNextSubscriptionId();
-  ByteString MakeBrowseContinuationPoint();
+  // Re-evaluates parked Publishes after a subscription changed: wakes them if
+  // one is now publishable, otherwise pulls the timer in to the new earliest
+  // deadline.
+  void OnPublishStateChanged();
+  void ArmPublishTimer(DateTime deadline);
+  void WatchSubscription(ServerSubscription& subscription);
+  // When `subscription` runs out of lifetime if no Publish request arrives.
+  DateTime LifetimeDeadline(const ServerSubscription& subscription) const;
+  // Queues the subscription's lifetime deadline unless an entry at or before
+  // it is queued already, and re-arms the lifetime timer.
+  void ScheduleLifetime(const ServerSubscription& subscription);
+  // Deletes the subscriptions whose lifetime ran out, queuing the
+  // StatusChangeNotification each leaves for the next Publish.
+  void ExpireSubscriptions();
+  void ArmLifetimeTimer();
+  ByteString MakeContinuationPoint();
   ua::BrowseResult PageBrowseResult(ua::BrowseResult result,
                                     size_t requested_max_references_per_node);
   ua::BrowseResult ResumeBrowseResult(const ByteString& continuation_point);
 
   SubscriptionMap subscriptions_;
   BrowseContinuationMap browse_continuations_;
+  HistoryContinuationMap history_continuations_;
   std::vector<SubscriptionId> publish_order_;
   SubscriptionId next_subscription_id_ = 1;
   size_t next_publish_index_ = 0;
-  UInt32 next_browse_continuation_id_ = 1;
+  UInt32 next_continuation_id_ = 1;
+
+  std::vector<base::AsyncCompletion> publish_waiters_;
+  // Deadline of the armed publish timer, if any. Re-arming for an earlier
+  // deadline cancels the previous timer through `publish_timer_cancelation_`.
+  std::optional<DateTime> publish_timer_deadline_;
+  Cancelation publish_timer_cancelation_;
+
+  // Lifetime deadlines, earliest on top, so a tick of the lifetime timer
+  // touches only the subscriptions that are due. Entries are invalidated
+  // lazily: one whose subscription was deleted, or that `lifetime_deadlines_`
+  // no longer names, is dropped when it surfaces, and one whose subscription
+  // saw a Publish request since is re-queued at its new deadline.
+  std::priority_queue<LifetimeEntry, std::vector<LifetimeEntry>, LaterLifetime>
+      lifetime_queue_;
+  // The live queue entry of each subscription, by its deadline.
+  std::unordered_map<SubscriptionId, DateTime> lifetime_deadlines_;
+  // Arrival of the last Publish request, which resets the lifetime counter of
+  // every subscription in the session.
+  std::optional<DateTime> last_publish_request_time_;
+  // Final messages of expired subscriptions, answered before anything else.
+  std::deque<PublishResponse> expired_responses_;
+
+  // Backend id of each registered node, at its alias minus one; a released
+  // alias leaves an empty slot on `free_registered_slots_` for reuse.
+  std::vector<std::optional<NodeId>> registered_nodes_;
+  std::vector<std::size_t> free_registered_slots_;
+  std::optional<DateTime> lifetime_timer_deadline_;
+  Cancelation lifetime_timer_cancelation_;
 };
 
 }  // namespace opcua
@@ -131,7 +131,9 @@ Awaitable<CreateSessionResponse> ServerSessionManager::CreateSession(
   };
 
   auto server_nonce = session.server_nonce;
+  expiry_queue_.push({session.expires_at, authentication_token});
   sessions_.insert_or_assign(authentication_token, std::move(session));
+  ArmExpiryTimer();
 
   LOG_INFO(logger_) << "OPC UA session created"
                     << LOG_TAG("SessionId", session_id.ToString())
@@ -406,32 +408,45 @@ void ServerSessionManager::DetachSession(const NodeId& authentication_token) {
   }
 }
 
+void ServerSessionManager::KeepSessionAlive(
+    const NodeId& authentication_token) {
+  if (auto* session = FindSessionState(authentication_token))
+    session->expires_at = Now() + session->revised_timeout;
+}
+
 void ServerSessionManager::PruneExpiredSessions() {
   const auto now_time = Now();
   // Collect first, notify after: the sink reaches back into the session's
-  // owner, and running it from inside the erase predicate would do that while
-  // `sessions_` is mid-rehash.
+  // owner, and running it mid-walk would let it re-enter this manager.
   std::vector<NodeId> removed;
-  std::erase_if(
-      sessions_, [now_time, &removed](const auto& entry) {
-        const auto expired = entry.second.expires_at <= now_time;
-        if (expired) {
-          LOG_INFO(logger_)
-              << "OPC UA session expired"
-              << LOG_TAG("SessionId", entry.second.session_id.ToString())
-              << LOG_TAG("AuthenticationToken",
-                         entry.second.authentication_token.ToString())
-              << LOG_TAG("Activated", entry.second.activated)
-              << LOG_TAG("Attached", entry.second.attached)
-              << LOG_TAG("UserId",
-                         UserIdTag(entry.second.authentication_result))
-              << LOG_TAG("Peer", entry.second.peer);
-          removed.push_back(entry.second.authentication_token);
-        }
-        return expired;
-      });
+  while (!expiry_queue_.empty() &&
+         expiry_queue_.top().expires_at <= now_time) {
+    auto entry = expiry_queue_.top();
+    expiry_queue_.pop();
+    const auto session_it = sessions_.find(entry.authentication_token);
+    if (session_it == sessions_.end())
+      continue;  // Closed or evicted since it was queued.
+    const auto& session = session_it->second;
+    if (now_time < session.expires_at) {
+      // Kept alive since it was queued; wait for the deadline it has now.
+      expiry_queue_.push({session.expires_at, entry.authentication_token});
+      continue;
+    }
+    LOG_INFO(logger_) << "OPC UA session expired"
+                      << LOG_TAG("SessionId", session.session_id.ToString())
+                      << LOG_TAG("AuthenticationToken",
+                                 session.authentication_token.ToString())
+                      << LOG_TAG("Activated", session.activated)
+                      << LOG_TAG("Attached", session.attached)
+                      << LOG_TAG("UserId",
+                                 UserIdTag(session.authentication_result))
+                      << LOG_TAG("Peer", session.peer);
+    removed.push_back(std::move(entry.authentication_token));
+    sessions_.erase(session_it);
+  }
   for (const auto& token : removed)
     NotifySessionRemoved(token);
+  ArmExpiryTimer();
 }
 
 void ServerSessionManager::SetSessionRemovedCallback(
@@ -439,6 +454,15 @@ void ServerSessionManager::SetSessionRemovedCallback(
   on_session_removed = std::move(callback);
 }
 
+void ServerSessionManager::SetExpiryScheduler(
+    std::function<void(Duration, std::function<void()>)> scheduler) {
+  post_delayed_task = std::move(scheduler);
+  // A timer armed through the previous scheduler must not fire into this one.
+  expiry_timer_cancelation_.Cancel();
+  expiry_timer_deadline_.reset();
+  ArmExpiryTimer();
+}
+
 std::optional<ServerSessionLookupResult> ServerSessionManager::FindSession(
     const NodeId& authentication_token) const {
   const auto* session = FindSessionState(authentication_token);
@@ -462,11 +486,11 @@ Duration ServerSessionManager::ReviseTimeout(Duration requested) const {
 }
 
 NodeId ServerSessionManager::MakeSessionId() {
-  return {next_session_id_++, session_namespace_index};
+  return {shard_ids.Make(next_session_id_++), session_namespace_index};
 }
 
 NodeId ServerSessionManager::MakeAuthenticationToken() {
-  return {next_token_id_++, token_namespace_index};
+  return {shard_ids.Make(next_token_id_++), token_namespace_index};
 }
 
 ByteString ServerSessionManager::MakeServerNonce() const {
@@ -554,6 +578,22 @@ void ServerSessionManager::NotifySessionRemoved(
     on_session_removed(authentication_token);
 }
 
+void ServerSessionManager::ArmExpiryTimer() {
+  if (!post_delayed_task || expiry_queue_.empty())
+    return;
+  const auto deadline = expiry_queue_.top().expires_at;
+  if (expiry_timer_deadline_.has_value() && *expiry_timer_deadline_ <= deadline)
+    return;  // The armed timer fires first and re-arms anyway.
+
+  expiry_timer_cancelation_.Cancel();
+  expiry_timer_deadline_ = deadline;
+  const auto delay = std::max(Duration{}, deadline - Now());
+  post_delayed_task(delay, expiry_timer_cancelation_.Bind([this] {
+    expiry_timer_deadline_.reset();
+    PruneExpiredSessions();
+  }));
+}
+
 void ServerSessionManager::EmitSessionAudit(SessionAuditKind kind,
                                             const NodeId& session_id,
                                             const NodeId& user_id,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "opcua/base/awaitable.h"
+#include "opcua/base/cancelation.h"
 #include "opcua/services/service_context.h"
 #include "opcua/session/authentication.h"
 #include "opcua/types/date_time.h"
@@ -11,6 +12,7 @@
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <queue>
 #include <span>
 #include <string>
 #include <unordered_map>
@@ -143,6 +145,25 @@ struct SessionAuditEvent {
   std::string peer;
 };
 
+// Identifier allocation for one shard of a sharded server (see
+// ShardedServerRuntime). Shard `index` of `count` hands out 1-based ids
+// congruent to `index` modulo `count`, so ids stay unique server-wide and an id
+// names the shard that issued it without a table shared between shards. The
+// defaults describe an unsharded server, where ids run 1, 2, 3, ...
+struct ShardIds {
+  UInt32 index = 0;
+  UInt32 count = 1;
+
+  // The `sequence`-th (1-based) id of this shard.
+  [[nodiscard]] UInt32 Make(UInt32 sequence) const {
+    return (sequence - 1) * count + index + 1;
+  }
+  // The shard that issued `id`.
+  [[nodiscard]] UInt32 ShardOf(UInt32 id) const {
+    return id == 0 ? 0 : (id - 1) % count;
+  }
+};
+
 struct ServerSessionManagerContext {
   std::shared_ptr<CoroutineAuthenticator> authenticator;
   // Server application instance certificate (DER). When non-empty, the client
@@ -169,12 +190,22 @@ struct ServerSessionManagerContext {
   // outliving it. Set it with SetSessionRemovedCallback when the owner is
   // constructed after the manager. Null disables the notification.
   std::function<void(const NodeId&)> on_session_removed;
+  // Schedules `task` after `delay` on the executor the manager runs on. The
+  // manager keeps one timer armed for the earliest session deadline, so an
+  // idle session is reaped when it times out rather than at the next
+  // CreateSession or ActivateSession. Set it with SetExpiryScheduler when the
+  // executor's owner is constructed after the manager; ServerRuntime does so
+  // unless one is given here. Null leaves expiry to those two calls.
+  std::function<void(Duration, std::function<void()>)> post_delayed_task;
   std::function<DateTime()> now = &DateTime::Now;
   Duration default_timeout = Duration::FromMinutes(10);
   Duration min_timeout = Duration::FromSeconds(30);
   Duration max_timeout = Duration::FromHours(1);
   NamespaceIndex session_namespace_index = 2;
   NamespaceIndex token_namespace_index = 3;
+  // Session ids and authentication tokens are drawn from this shard's share of
+  // the numeric space, so a token routes to the manager that issued it.
+  ShardIds shard_ids;
 };
 
 class ServerSessionManager : private ServerSessionManagerContext {
@@ -188,6 +219,13 @@ class ServerSessionManager : private ServerSessionManagerContext {
   [[nodiscard]] CloseSessionResponse CloseSession(CloseSessionRequest request);
 
   void DetachSession(const NodeId& authentication_token);
+  // Restarts the session's timeout: the server may close a session only once
+  // the client has called no service for that long (OPC UA Part 4 §5.6.2,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.6.2). O(1); the
+  // expiry queue catches up when the stale deadline comes due.
+  void KeepSessionAlive(const NodeId& authentication_token);
+  // Drops every session whose deadline has passed. Costs O(log n) per session
+  // due, not a scan of them all.
   void PruneExpiredSessions();
 
   // Installs (or clears, when null) the sink described by
@@ -197,6 +235,15 @@ class ServerSessionManager : private ServerSessionManagerContext {
   // sink before it dies.
   void SetSessionRemovedCallback(std::function<void(const NodeId&)> callback);
 
+  // Installs (or clears, when null) the scheduler described by
+  // ServerSessionManagerContext::post_delayed_task, re-arming the expiry
+  // timer through it. The owner must clear it before it dies.
+  void SetExpiryScheduler(
+      std::function<void(Duration, std::function<void()>)> scheduler);
+  [[nodiscard]] bool has_expiry_scheduler() const {
+    return static_cast<bool>(post_delayed_task);
+  }
+
   [[nodiscard]] std::optional<ServerSessionLookupResult> FindSession(
       const NodeId& authentication_token) const;
 
@@ -220,6 +267,20 @@ class ServerSessionManager : private ServerSessionManagerContext {
     std::string peer;
   };
 
+  // A deadline in the expiry queue. Entries are not updated in place: a
+  // session refreshed since its entry was queued is re-queued at its new
+  // deadline when the old one comes due, and an entry whose session is gone is
+  // dropped then.
+  struct ExpiryEntry {
+    DateTime expires_at;
+    NodeId authentication_token;
+  };
+  struct LaterExpiry {
+    bool operator()(const ExpiryEntry& a, const ExpiryEntry& b) const {
+      return b.expires_at < a.expires_at;
+    }
+  };
+
   [[nodiscard]] DateTime Now() const { return now(); }
   [[nodiscard]] Duration ReviseTimeout(Duration requested) const;
   [[nodiscard]] NodeId MakeSessionId();
@@ -240,6 +301,9 @@ class ServerSessionManager : private ServerSessionManagerContext {
   void RemoveSessionByToken(const NodeId& authentication_token);
   // Hands `authentication_token` to on_session_removed when one is installed.
   void NotifySessionRemoved(const NodeId& authentication_token) const;
+  // Points the expiry timer at the earliest queued deadline, unless one at
+  // least as early is already armed.
+  void ArmExpiryTimer();
 
   // Builds a SessionAuditEvent and hands it to on_audit_event when set.
   void EmitSessionAudit(SessionAuditKind kind,
@@ -250,6 +314,10 @@ class ServerSessionManager : private ServerSessionManagerContext {
                         std::string peer) const;
 
   std::unordered_map<NodeId, SessionState> sessions_;
+  std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, LaterExpiry>
+      expiry_queue_;
+  std::optional<DateTime> expiry_timer_deadline_;
+  Cancelation expiry_timer_cancelation_;
   UInt32 next_session_id_ = 1;
   UInt32 next_token_id_ = 1;
 };
@@ -12,9 +12,11 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
 #include <memory>
 #include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace opcua {
@@ -195,6 +197,122 @@ TEST_F(ServerSessionManagerTest, ActivatesDetachesResumesAndClosesSession) {
   EXPECT_FALSE(manager.FindSession(created.authentication_token).has_value());
 }
 
+// Expiry runs off a timer armed for the earliest session deadline, so an idle
+// session goes when it times out even if no other client ever connects.
+class ServerSessionManagerExpiryTest : public testing::Test {
+ protected:
+  opcua::DateTime now_ = opcua::DateTime::Now();
+  opcua::TestExecutor executor_;
+  std::vector<opcua::NodeId> removed_;
+  // Every task the manager scheduled, with its delay.
+  std::vector<std::pair<opcua::Duration, std::function<void()>>> timers_;
+
+  ServerSessionManager manager_{{
+      .authenticator = opcua::MakeCoroutineAuthenticator(
+          [](opcua::LocalizedText, opcua::LocalizedText)
+              -> opcua::Awaitable<
+                  opcua::StatusOr<opcua::AuthenticationResult>> {
+            co_return opcua::AuthenticationResult{
+                .user_id = opcua::NodeId{42, 4}, .multi_sessions = true};
+          }),
+      .on_session_removed =
+          [this](const opcua::NodeId& token) { removed_.push_back(token); },
+      .post_delayed_task =
+          [this](opcua::Duration delay, std::function<void()> task) {
+            timers_.emplace_back(delay, std::move(task));
+          },
+      .now = [this] { return now_; },
+      .min_timeout = opcua::Duration::FromSeconds(10),
+  }};
+
+  opcua::NodeId LogOn(opcua::Duration requested_timeout) {
+    const auto created = opcua::WaitAwaitable(
+        executor_,
+        manager_.CreateSession({.requested_timeout = requested_timeout}));
+    EXPECT_EQ(created.status.code(), opcua::StatusCode::Good);
+    const auto activated = opcua::WaitAwaitable(
+        executor_, manager_.ActivateSession({
+                       .authentication_token = created.authentication_token,
+                       .user_name = opcua::LocalizedText{u"operator"},
+                       .password = opcua::LocalizedText{u"secret"},
+                   }));
+    EXPECT_EQ(activated.status.code(), opcua::StatusCode::Good);
+    return created.authentication_token;
+  }
+
+  // Lets the most recently armed timer's delay pass and fires it.
+  void FireLastTimer() {
+    ASSERT_FALSE(timers_.empty());
+    auto [delay, task] = std::move(timers_.back());
+    timers_.pop_back();
+    now_ = now_ + delay;
+    task();
+  }
+};
+
+TEST_F(ServerSessionManagerExpiryTest, ReapsAnIdleSessionWhenItTimesOut) {
+  const auto token = LogOn(opcua::Duration::FromSeconds(30));
+  ASSERT_EQ(timers_.size(), 1u);
+  EXPECT_EQ(timers_.back().first, opcua::Duration::FromSeconds(30));
+
+  FireLastTimer();
+
+  EXPECT_FALSE(manager_.FindSession(token).has_value());
+  EXPECT_EQ(removed_, std::vector{token});
+  // Nothing left to time out, so nothing is re-armed.
+  EXPECT_TRUE(timers_.empty());
+}
+
+TEST_F(ServerSessionManagerExpiryTest, AnEarlierDeadlineReArmsTheTimer) {
+  const auto slow = LogOn(opcua::Duration::FromSeconds(60));
+  const auto fast = LogOn(opcua::Duration::FromSeconds(20));
+  // The second session's deadline comes first, so the timer moved to it.
+  ASSERT_EQ(timers_.size(), 2u);
+  EXPECT_EQ(timers_.back().first, opcua::Duration::FromSeconds(20));
+
+  FireLastTimer();
+  EXPECT_FALSE(manager_.FindSession(fast).has_value());
+  EXPECT_TRUE(manager_.FindSession(slow).has_value());
+
+  // Re-armed for what remains of the first session's timeout.
+  ASSERT_FALSE(timers_.empty());
+  EXPECT_EQ(timers_.back().first, opcua::Duration::FromSeconds(40));
+  FireLastTimer();
+  EXPECT_FALSE(manager_.FindSession(slow).has_value());
+  EXPECT_EQ(removed_, (std::vector{fast, slow}));
+}
+
+TEST_F(ServerSessionManagerExpiryTest, ActivityPostponesExpiry) {
+  const auto token = LogOn(opcua::Duration::FromSeconds(30));
+
+  now_ = now_ + opcua::Duration::FromSeconds(20);
+  manager_.KeepSessionAlive(token);
+  now_ = now_ - opcua::Duration::FromSeconds(20);
+
+  // The original deadline passes with the session still in use...
+  FireLastTimer();
+  EXPECT_TRUE(manager_.FindSession(token).has_value());
+  EXPECT_TRUE(removed_.empty());
+
+  // ...and the timer follows it to the deadline the activity set.
+  ASSERT_EQ(timers_.size(), 1u);
+  EXPECT_EQ(timers_.back().first, opcua::Duration::FromSeconds(20));
+  FireLastTimer();
+  EXPECT_FALSE(manager_.FindSession(token).has_value());
+}
+
+TEST_F(ServerSessionManagerExpiryTest, AClosedSessionLeavesNothingToReap) {
+  const auto token = LogOn(opcua::Duration::FromSeconds(30));
+  ASSERT_EQ(
+      manager_.CloseSession({.authentication_token = token}).status.code(),
+      opcua::StatusCode::Good);
+  removed_.clear();
+
+  FireLastTimer();
+  EXPECT_TRUE(removed_.empty());
+  EXPECT_TRUE(timers_.empty());
+}
+
 // The single-session gate (AuthenticationResult::multi_sessions == false) and
 // what it counts as "already logged on".
 class ServerSessionManagerSingleSessionTest : public testing::Test {
@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string_view>
 #include <variant>
@@ -53,6 +54,10 @@ class SessionHarness {
                     executor,
                     backing_states_),
             .now = [this] { return now_; },
+            .post_lifetime_task =
+                [this](Duration, std::function<void()> task) {
+                  lifetime_timers_.push_back(std::move(task));
+                },
         }} {}
 
   // A session with its own executor, clock and backing states.
@@ -77,6 +82,15 @@ class SessionHarness {
   // Runs the subscription binding and notification-delivery coroutines.
   void Drain() { opcua::Drain(executor_); }
 
+  // Fires every lifetime timer armed so far; the ones re-arming canceled do
+  // nothing.
+  void FireLifetimeTimers() {
+    auto timers = std::move(lifetime_timers_);
+    lifetime_timers_.clear();
+    for (auto& timer : timers)
+      timer();
+  }
+
   // Creates a subscription and one monitored item on it, binds them, and
   // returns {subscription_id, backing client handle}. Notifications must be
   // pushed under the backing handle; the session republishes them under the
@@ -128,6 +142,7 @@ class SessionHarness {
   DateTime now_;
   TestExecutor executor_;
   std::shared_ptr<BackingStates> backing_states_;
+  std::vector<std::function<void()>> lifetime_timers_;
   ServerSession session_;
 };
 
@@ -455,6 +470,58 @@ TEST(ServerSessionTest, RejectsOperationsOnUnknownSubscription) {
   EXPECT_EQ(deleted.results[0].code(), StatusCode::Bad_SubscriptionIdInvalid);
 }
 
+// OPC UA Part 4 §5.13.1.1: a subscription that sees no Publish request for
+// lifetime_count publishing intervals is closed, and the client learns of it
+// through a StatusChangeNotification of Bad_Timeout.
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.13.1.1
+TEST(ServerSessionTest, ExpiresAnAbandonedSubscriptionWithAStatusChange) {
+  SessionHarness harness{1601, ParseTime("2026-04-21 08:00:00")};
+  const auto item = harness.CreateSubscriptionWithItem(/*client_handle=*/12,
+                                                       /*node_id=*/701);
+  harness.PushDataChange(item, 1.0);
+
+  // 60 intervals of 100 ms; one short of it the subscription lives on.
+  harness.Advance(5900);
+  harness.FireLifetimeTimers();
+  EXPECT_TRUE(harness.session().HasSubscription(item.subscription_id));
+
+  harness.Advance(100);
+  harness.FireLifetimeTimers();
+  EXPECT_FALSE(harness.session().HasSubscription(item.subscription_id));
+  EXPECT_TRUE(harness.backing(item.backing_index).closed);
+
+  const auto expired = harness.session().Publish({});
+  EXPECT_EQ(expired.status.code(), StatusCode::Good);
+  EXPECT_EQ(expired.subscription_id, item.subscription_id);
+  ASSERT_EQ(expired.notification_message.notification_data.size(), 1u);
+  const auto* status_change = std::get_if<StatusChangeNotification>(
+      &expired.notification_message.notification_data[0]);
+  ASSERT_TRUE(status_change);
+  EXPECT_EQ(status_change->status, StatusCode::Bad_Timeout);
+
+  EXPECT_EQ(harness.session().Publish({}).status.code(),
+            StatusCode::Bad_NoSubscription);
+}
+
+TEST(ServerSessionTest, PublishRequestsKeepSubscriptionsAlive) {
+  SessionHarness harness{1701, ParseTime("2026-04-21 09:00:00")};
+  const auto item = harness.CreateSubscriptionWithItem(/*client_handle=*/13,
+                                                       /*node_id=*/702);
+
+  // A Publish partway through restarts the count; the deadline queued at
+  // creation then finds the subscription still alive and re-queues it.
+  harness.Advance(4000);
+  harness.session().Publish({});
+  harness.Advance(2000);
+  harness.FireLifetimeTimers();
+  EXPECT_TRUE(harness.session().HasSubscription(item.subscription_id));
+  EXPECT_FALSE(harness.backing(item.backing_index).closed);
+
+  harness.Advance(4000);
+  harness.FireLifetimeTimers();
+  EXPECT_FALSE(harness.session().HasSubscription(item.subscription_id));
+}
+
 TEST(ServerSessionTest, PublishWithoutSubscriptionsReturnsBadNoSubscription) {
   SessionHarness harness{1001, ParseTime("2026-04-20 17:00:00")};
 
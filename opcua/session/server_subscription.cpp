@@ -2,8 +2,11 @@
 
 #include "opcua/services/service_context.h"
 
+#include <boost/asio/this_coro.hpp>
+
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <variant>
 
 namespace opcua {
@@ -20,8 +23,94 @@ bool IsSupportedMonitoredAttribute(AttributeId attribute_id) {
          IsAttributeEventNotifier(attribute_id);
 }
 
+// Monitored-item notifications carried by one message: the entries of each
+// DataChangeNotification and EventNotificationList, plus one per
+// StatusChangeNotification. This is what maxNotificationsPerPublish and the
+// retransmission bound count, independent of how the entries are grouped into
+// NotificationData.
+std::size_t CountNotifications(const NotificationMessage& message) {
+  std::size_t count = 0;
+  for (const auto& data : message.notification_data) {
+    if (const auto* data_change = std::get_if<DataChangeNotification>(&data))
+      count += data_change->monitored_items.size();
+    else if (const auto* events = std::get_if<EventNotificationList>(&data))
+      count += events->events.size();
+    else
+      ++count;
+  }
+  return count;
+}
+
 }  // namespace
 
+std::size_t ServerSubscription::NotificationQueue::Resize(
+    std::size_t capacity,
+    bool discard_oldest) {
+  capacity_ = std::max<std::size_t>(1, capacity);
+  if (size_ <= capacity_ && slots_.size() <= capacity_)
+    return 0;
+
+  Linearize();
+  const std::size_t discarded = size_ > capacity_ ? size_ - capacity_ : 0;
+  if (discard_oldest) {
+    slots_.erase(slots_.begin(),
+                 slots_.begin() + static_cast<std::ptrdiff_t>(discarded));
+  }
+  size_ -= discarded;
+  slots_.resize(size_);
+  return discarded;
+}
+
+bool ServerSubscription::NotificationQueue::Push(NotificationData notification,
+                                                 bool discard_oldest) {
+  if (size_ == capacity_) {
+    // Full, which implies every slot is allocated and in use.
+    if (discard_oldest) {
+      slots_[head_] = std::move(notification);
+      head_ = (head_ + 1) % slots_.size();
+    }
+    return false;
+  }
+
+  if (size_ < slots_.size()) {
+    slots_[(head_ + size_) % slots_.size()] = std::move(notification);
+  } else {
+    Linearize();
+    slots_.push_back(std::move(notification));
+  }
+  ++size_;
+  return true;
+}
+
+NotificationData ServerSubscription::NotificationQueue::Pop() {
+  NotificationData notification = std::move(slots_[head_]);
+  head_ = (head_ + 1) % slots_.size();
+  if (--size_ == 0)
+    head_ = 0;
+  return notification;
+}
+
+NotificationData& ServerSubscription::NotificationQueue::back() {
+  return slots_[(head_ + size_ - 1) % slots_.size()];
+}
+
+std::size_t ServerSubscription::NotificationQueue::Clear() {
+  const std::size_t cleared = size_;
+  slots_.clear();
+  head_ = 0;
+  size_ = 0;
+  return cleared;
+}
+
+void ServerSubscription::NotificationQueue::Linearize() {
+  if (head_ == 0)
+    return;
+  std::rotate(slots_.begin(),
+              slots_.begin() + static_cast<std::ptrdiff_t>(head_),
+              slots_.end());
+  head_ = 0;
+}
+
 SubscriptionParameters ServerSubscription::ReviseParameters(
     SubscriptionParameters parameters) {
   if (parameters.max_keep_alive_count == 0) {
@@ -46,7 +135,8 @@ ServerSubscription::ServerSubscription(
       executor_{std::move(executor)},
       create_subscription_{std::move(create_subscription)},
       trace_parent_{std::move(trace_parent)},
-      last_publish_time_{publish_cycle_start_time} {}
+      last_publish_time_{publish_cycle_start_time},
+      lifetime_start_{publish_cycle_start_time} {}
 
 ServerSubscription::~ServerSubscription() {
   CloseBackingSubscription(StatusCode::Bad_NoCommunication);
@@ -59,6 +149,9 @@ ModifySubscriptionResponse ServerSubscription::Modify(
   }
 
   parameters_ = ReviseParameters(request.parameters);
+  // The lifetime counter starts over with the new count; the owning session,
+  // which keeps the clock, restarts it (see ServerSession::ModifySubscription).
+  NotifyPublishReady();
   return {.status = StatusCode::Good,
           .revised_publishing_interval_ms = parameters_.publishing_interval_ms,
           .revised_lifetime_count = parameters_.lifetime_count,
@@ -66,7 +159,10 @@ ModifySubscriptionResponse ServerSubscription::Modify(
 }
 
 void ServerSubscription::SetPublishingEnabled(bool publishing_enabled) {
+  if (parameters_.publishing_enabled == publishing_enabled)
+    return;
   parameters_.publishing_enabled = publishing_enabled;
+  NotifyPublishReady();
 }
 
 bool ServerSubscription::IsPublishReady(DateTime now) const {
@@ -75,7 +171,7 @@ bool ServerSubscription::IsPublishReady(DateTime now) const {
 
   const auto elapsed = now - *last_publish_time_;
   if (initial_message_sent_ && parameters_.publishing_enabled &&
-      !pending_notifications_.empty()) {
+      pending_count_ != 0) {
     return elapsed >= PublishingInterval();
   }
 
@@ -83,11 +179,11 @@ bool ServerSubscription::IsPublishReady(DateTime now) const {
     return elapsed >= PublishingInterval();
   }
 
-  if (!parameters_.publishing_enabled || pending_notifications_.empty()) {
+  if (!parameters_.publishing_enabled || pending_count_ == 0) {
     return elapsed >= KeepAliveInterval();
   }
 
-  if (!pending_notifications_.empty()) {
+  if (pending_count_ != 0) {
     return now - *last_publish_time_ >= PublishingInterval();
   }
   return elapsed >= KeepAliveInterval();
@@ -109,7 +205,7 @@ std::optional<DateTime> ServerSubscription::NextPublishDeadline() const {
   }
 
   return *last_publish_time_ +
-         ((parameters_.publishing_enabled && !pending_notifications_.empty())
+         ((parameters_.publishing_enabled && pending_count_ != 0)
               ? PublishingInterval()
               : KeepAliveInterval());
 }
@@ -123,16 +219,36 @@ CreateMonitoredItemsResponse ServerSubscription::CreateMonitoredItems(
   CreateMonitoredItemsResponse response{.status = StatusCode::Good};
   response.results.reserve(request.items_to_create.size());
 
+  BindBatch batch;
   for (const auto& source_item : request.items_to_create) {
+    if (const StatusCode filter_status =
+            ValidateFilter(source_item.requested_parameters);
+        filter_status != StatusCode::Good) {
+      response.results.push_back({.status = filter_status});
+      continue;
+    }
+    std::optional<NumericRange> index_range;
+    if (source_item.index_range.has_value()) {
+      auto parsed = NumericRange::Parse(*source_item.index_range);
+      if (!parsed.ok()) {
+        response.results.push_back({.status = parsed.status().code()});
+        continue;
+      }
+      index_range = std::move(*parsed);
+    }
+
     auto item = std::make_shared<Item>();
     item->monitored_item_id = next_monitored_item_id_++;
     item->item_to_monitor = source_item.item_to_monitor;
-    item->index_range = source_item.index_range;
+    item->index_range = std::move(index_range);
     item->monitoring_mode = source_item.monitoring_mode;
     item->parameters = source_item.requested_parameters;
+    item->parameters.sampling_interval_ms =
+        ReviseSamplingInterval(item->parameters.sampling_interval_ms);
+    ApplyQueueSize(*item);
 
     items_.emplace(item->monitored_item_id, item);
-    RebindItem(*item);
+    RebindItem(*item, batch);
 
     response.results.push_back(
         {.status = item->monitored_item_status,
@@ -143,9 +259,10 @@ CreateMonitoredItemsResponse ServerSubscription::CreateMonitoredItems(
          .revised_queue_size =
              std::max<UInt32>(1, item->parameters.queue_size)});
     if (item->monitored_item_status != StatusCode::Good)
-      items_.erase(item->monitored_item_id);
+      EraseItem(item->monitored_item_id);
   }
 
+  SubmitBindBatch(std::move(batch));
   return response;
 }
 
@@ -158,6 +275,7 @@ ModifyMonitoredItemsResponse ServerSubscription::ModifyMonitoredItems(
   ModifyMonitoredItemsResponse response{.status = StatusCode::Good};
   response.results.reserve(request.items_to_modify.size());
 
+  BindBatch batch;
   for (const auto& source_item : request.items_to_modify) {
     const auto item_it = items_.find(source_item.monitored_item_id);
     if (item_it == items_.end()) {
@@ -166,9 +284,20 @@ ModifyMonitoredItemsResponse ServerSubscription::ModifyMonitoredItems(
       continue;
     }
 
+    if (const StatusCode filter_status =
+            ValidateFilter(source_item.requested_parameters);
+        filter_status != StatusCode::Good) {
+      response.results.push_back({.status = filter_status});
+      continue;
+    }
+
     auto& item = *item_it->second;
     item.parameters = source_item.requested_parameters;
-    RebindItem(item);
+    item.parameters.sampling_interval_ms =
+        ReviseSamplingInterval(item.parameters.sampling_interval_ms);
+    item.sample_interval_start.reset();
+    ApplyQueueSize(item);
+    RebindItem(item, batch);
 
     response.results.push_back(
         {.status = item.monitored_item_status,
@@ -177,6 +306,7 @@ ModifyMonitoredItemsResponse ServerSubscription::ModifyMonitoredItems(
              std::max<UInt32>(1, item.parameters.queue_size)});
   }
 
+  SubmitBindBatch(std::move(batch));
   return response;
 }
 
@@ -191,6 +321,7 @@ ua::DeleteMonitoredItemsResponse ServerSubscription::DeleteMonitoredItems(
 
   response.results.reserve(request.monitored_item_ids.size());
 
+  std::vector<MonitoredItemId> backing_item_ids;
   for (auto monitored_item_id : request.monitored_item_ids) {
     const auto item_it = items_.find(monitored_item_id);
     if (item_it == items_.end()) {
@@ -201,22 +332,13 @@ ua::DeleteMonitoredItemsResponse ServerSubscription::DeleteMonitoredItems(
     // backing subscription outlives it and is never reclaimed, because the
     // backing subscription is only torn down wholesale when this subscription
     // closes.
-    RemoveBackingItem(item_it->second->backing_item_id);
-    items_.erase(item_it);
+    if (item_it->second->backing_item_id != 0)
+      backing_item_ids.push_back(item_it->second->backing_item_id);
+    EraseItem(monitored_item_id);
     response.results.push_back(Status{StatusCode::Good});
   }
 
-  pending_notifications_.erase(
-      std::remove_if(pending_notifications_.begin(),
-                     pending_notifications_.end(),
-                     [&](const auto& queued) {
-                       return std::find(request.monitored_item_ids.begin(),
-                                        request.monitored_item_ids.end(),
-                                        queued.source_item_id) !=
-                              request.monitored_item_ids.end();
-                     }),
-      pending_notifications_.end());
-
+  RemoveBackingItems(std::move(backing_item_ids));
   return response;
 }
 
@@ -263,7 +385,7 @@ std::vector<StatusCode> ServerSubscription::Acknowledge(
 std::optional<PublishResponse> ServerSubscription::TryPublish(DateTime now) {
   PrimePublishCycle(now);
   const bool has_publishable_notifications =
-      parameters_.publishing_enabled && !pending_notifications_.empty();
+      parameters_.publishing_enabled && pending_count_ != 0;
   if (!has_publishable_notifications) {
     if (!IsPublishReady(now))
       return std::nullopt;
@@ -288,8 +410,8 @@ std::optional<PublishResponse> ServerSubscription::TryPublish(DateTime now) {
   // This used to take exactly ONE, which capped an entire subscription at one
   // notification per publishing interval no matter how many monitored items it
   // carried — roughly 2/s at the common 500 ms interval, shared between every
-  // item. Worse than slow: `pending_notifications_` is one deque for the whole
-  // subscription, and with EnforceQueueLimit trimming it per item, a subset of
+  // item. Worse than slow: the pending queue was then one deque for the whole
+  // subscription, and with the per-item limit trimming it in place, a subset of
   // items held the front while the rest surfaced never. Eighteen items on one
   // subscription with queue_size 1 left twelve of them receiving NOTHING for
   // as long as the subscription lived, with no error anywhere — a SCADA
@@ -309,26 +431,67 @@ std::optional<PublishResponse> ServerSubscription::TryPublish(DateTime now) {
   // kMaxNotificationsPerPublishResponse bounds one response either way, and
   // whatever is left is reported through moreNotifications below.
   const UInt32 limit = parameters_.max_notifications_per_publish;
-  const std::size_t requested =
-      limit == 0 ? pending_notifications_.size() : limit;
-  const std::size_t max_entries = std::min(
-      {requested, kMaxNotificationsPerPublishResponse,
-       pending_notifications_.size()});
+  const std::size_t requested = limit == 0 ? pending_count_ : limit;
+  const std::size_t max_entries =
+      std::min({requested, kMaxNotificationsPerPublishResponse,
+                pending_count_});
+
+  // The drained entries are merged into one DataChangeNotification and one
+  // EventNotificationList, in the order they were drained. Sent one per
+  // entry, a response of 1000 data changes carried 1000 ExtensionObjects, each
+  // with its own type id and length prefix for the client to decode; merged it
+  // carries one. StatusChangeNotifications have nothing to merge into and stay
+  // as they are. OPC UA Part 4 §7.26 NotificationMessage,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.26
+  DataChangeNotification data_changes;
+  EventNotificationList events;
+  std::vector<NotificationData> status_changes;
+
+  // Items are served round-robin from ready_items_, one notification per turn,
+  // so a deep queue on one item cannot crowd the others out of a response.
+  std::size_t drained = 0;
+  while (drained < max_entries && !ready_items_.empty()) {
+    const MonitoredItemId monitored_item_id = ready_items_.front();
+    ready_items_.pop_front();
+    const auto item_it = items_.find(monitored_item_id);
+    if (item_it == items_.end() || item_it->second->queue.empty())
+      continue;
+    auto& queue = item_it->second->queue;
+    auto notification = queue.Pop();
+    if (auto* data_change =
+            std::get_if<DataChangeNotification>(&notification)) {
+      std::ranges::move(data_change->monitored_items,
+                        std::back_inserter(data_changes.monitored_items));
+    } else if (auto* event_list =
+                   std::get_if<EventNotificationList>(&notification)) {
+      std::ranges::move(event_list->events, std::back_inserter(events.events));
+    } else {
+      status_changes.push_back(std::move(notification));
+    }
+    ++drained;
+    --pending_count_;
+    if (!queue.empty())
+      ready_items_.push_back(monitored_item_id);
+  }
 
   std::vector<NotificationData> notification_data;
-  notification_data.reserve(max_entries);
-  for (std::size_t i = 0; i < max_entries; ++i) {
-    notification_data.push_back(
-        std::move(pending_notifications_.front().notification));
-    pending_notifications_.pop_front();
-  }
+  notification_data.reserve(2 + status_changes.size());
+  if (!data_changes.monitored_items.empty())
+    notification_data.push_back(std::move(data_changes));
+  if (!events.events.empty())
+    notification_data.push_back(std::move(events));
+  std::ranges::move(status_changes, std::back_inserter(notification_data));
 
   NotificationMessage notification_message{
       .sequence_number = next_sequence_number_++,
       .publish_time = now,
       .notification_data = std::move(notification_data)};
+  // The retained copy shares the notification list with the response (see
+  // NotificationDataList), as does every later Republish of it.
   retransmit_queue_.push_back(notification_message);
-  retained_notifications_ += retransmit_queue_.back().notification_data.size();
+  // Counted the way eviction and Acknowledge take it back off, so the total
+  // cannot drift from what the queue holds.
+  retained_notifications_ += CountNotifications(retransmit_queue_.back());
   // Bounded by notifications retained, not messages held — see the constant.
   //
   // The size guard keeps the message just published Republishable. Note it is
@@ -344,7 +507,7 @@ std::optional<PublishResponse> ServerSubscription::TryPublish(DateTime now) {
   // case rather than to delete this.
   while (retransmit_queue_.size() > 1 &&
          retained_notifications_ > kMaxRetransmitQueueNotifications) {
-    retained_notifications_ -= retransmit_queue_.front().notification_data.size();
+    retained_notifications_ -= CountNotifications(retransmit_queue_.front());
     retransmit_queue_.pop_front();
   }
   last_publish_time_ = now;
@@ -354,7 +517,7 @@ std::optional<PublishResponse> ServerSubscription::TryPublish(DateTime now) {
       .status = StatusCode::Good,
       .subscription_id = subscription_id_,
       .results = {},
-      .more_notifications = !pending_notifications_.empty(),
+      .more_notifications = pending_count_ != 0,
       .notification_message = std::move(notification_message),
       .available_sequence_numbers = AvailableSequenceNumbers()};
 }
@@ -371,6 +534,27 @@ RepublishResponse ServerSubscription::Republish(UInt32 sequence_number) const {
   return {.status = StatusCode::Good, .notification_message = *it};
 }
 
+PublishResponse ServerSubscription::Expire(DateTime now) {
+  CloseBackingSubscription(StatusCode::Bad_Timeout);
+  items_.clear();
+  items_by_backing_handle_.clear();
+  ready_items_.clear();
+  pending_count_ = 0;
+  retransmit_queue_.clear();
+  retained_notifications_ = 0;
+
+  return PublishResponse{
+      .status = StatusCode::Good,
+      .subscription_id = subscription_id_,
+      .results = {},
+      .more_notifications = false,
+      .notification_message = {
+          .sequence_number = next_sequence_number_++,
+          .publish_time = now,
+          .notification_data = {StatusChangeNotification{
+              .status = StatusCode::Bad_Timeout}}}};
+}
+
 StatusCode ServerSubscription::Acknowledge(UInt32 sequence_number) {
   const auto it = std::find_if(
       retransmit_queue_.begin(), retransmit_queue_.end(),
@@ -384,7 +568,7 @@ StatusCode ServerSubscription::Acknowledge(UInt32 sequence_number) {
     return StatusCode::Bad_SequenceNumberUnknown;
   // Acknowledging erases from the middle, so the retained total has to follow
   // it or the bound drifts and starts evicting messages that are still wanted.
-  retained_notifications_ -= it->notification_data.size();
+  retained_notifications_ -= CountNotifications(*it);
   retransmit_queue_.erase(it);
   return StatusCode::Good;
 }
@@ -403,6 +587,12 @@ Duration ServerSubscription::PublishingInterval() const {
   return Duration::FromMilliseconds(std::max<int64_t>(1, interval_ms));
 }
 
+Duration ServerSubscription::LifetimeInterval() const {
+  return Duration::FromMilliseconds(
+      static_cast<int64_t>(PublishingInterval().InMilliseconds()) *
+      static_cast<int64_t>(std::max<UInt32>(1, parameters_.lifetime_count)));
+}
+
 Duration ServerSubscription::KeepAliveInterval() const {
   const auto interval_ms =
       static_cast<int64_t>(PublishingInterval().InMilliseconds()) *
@@ -437,6 +627,7 @@ Status ServerSubscription::StartBackingSubscription() {
     OnSubscriptionError(std::move(status));
   };
   backing_subscription_state_->subscription = std::move(*subscription_result);
+  backing_subscription_state_->executor = executor_;
 
   CoSpawn(executor_, [state = backing_subscription_state_] {
     return ReadBackingSubscriptionLoop(std::move(state));
@@ -469,17 +660,19 @@ ServerSubscription::AddBackingItems(
   co_return co_await (*subscription)->AddItems(std::move(requests));
 }
 
-void ServerSubscription::RemoveBackingItem(MonitoredItemId backing_item_id) {
-  if (backing_item_id == 0 || !backing_subscription_state_) {
+void ServerSubscription::RemoveBackingItems(
+    std::vector<MonitoredItemId> backing_item_ids) {
+  if (backing_item_ids.empty() || !backing_subscription_state_) {
     return;
   }
 
-  // Fire-and-forget, mirroring BindItem: the services that call us
+  // Fire-and-forget, mirroring SubmitBindBatch: the services that call us
   // (DeleteMonitoredItems, ModifyMonitoredItems) answer synchronously, and the
   // response does not depend on the backing release having completed. The
   // state is captured by shared_ptr so the coroutine does not outlive it.
   CoSpawn(executor_, [state = backing_subscription_state_,
-                      backing_item_id]() -> Awaitable<void> {
+                      backing_item_ids = std::move(backing_item_ids)]()
+                         -> Awaitable<void> {
     MonitoredItemSubscription* subscription = nullptr;
     {
       std::lock_guard lock{state->mutex};
@@ -488,8 +681,7 @@ void ServerSubscription::RemoveBackingItem(MonitoredItemId backing_item_id) {
       }
       subscription = state->subscription.get();
     }
-    const MonitoredItemId item_ids[] = {backing_item_id};
-    co_await subscription->RemoveItems(item_ids);
+    co_await subscription->RemoveItems(backing_item_ids);
   });
 }
 
@@ -511,6 +703,7 @@ void ServerSubscription::CloseBackingSubscription(Status status) {
 
 Awaitable<void> ServerSubscription::ReadBackingSubscriptionLoop(
     std::shared_ptr<BackingSubscriptionState> state) {
+  const AnyExecutor current = co_await boost::asio::this_coro::executor;
   for (;;) {
     std::unique_ptr<MonitoredItemSubscription>* subscription = nullptr;
     {
@@ -524,23 +717,83 @@ Awaitable<void> ServerSubscription::ReadBackingSubscriptionLoop(
     StatusOr<std::vector<ItemNotification>> notifications =
         co_await (*subscription)->ReadNext(state->options.max_batch_size);
 
+    AnyExecutor owner;
     {
       std::lock_guard lock{state->mutex};
       if (state->closed) {
         co_return;
       }
+      owner = state->executor;
     }
 
-    if (!notifications.ok()) {
-      state->error_handler(notifications.status());
+    if (owner != current) {
+      // Transferred to a session on another shard while the read was in
+      // flight: the batch and the reading both continue on the new owner.
+      const bool reading = notifications.ok();
+      RunOnOwner(state, current,
+                 [state, notifications = std::move(notifications)]() mutable {
+                   DeliverBackingNotifications(*state,
+                                               std::move(notifications));
+                 });
+      if (reading) {
+        CoSpawn(owner, [state] {
+          return ReadBackingSubscriptionLoop(std::move(state));
+        });
+      }
       co_return;
     }
 
-    state->notification_handler(std::move(*notifications));
+    if (!DeliverBackingNotifications(*state, std::move(notifications)))
+      co_return;
+  }
+}
+
+bool ServerSubscription::DeliverBackingNotifications(
+    BackingSubscriptionState& state,
+    StatusOr<std::vector<ItemNotification>> notifications) {
+  if (!notifications.ok()) {
+    state.error_handler(notifications.status());
+    return false;
+  }
+
+  state.notification_handler(std::move(*notifications));
+  return true;
+}
+
+void ServerSubscription::RunOnOwner(
+    const std::shared_ptr<BackingSubscriptionState>& state,
+    const AnyExecutor& current,
+    std::function<void()> task) {
+  AnyExecutor owner = current;
+  if (state) {
+    std::lock_guard lock{state->mutex};
+    owner = state->executor;
+  }
+  if (owner == current) {
+    task();
+    return;
+  }
+
+  boost::asio::post(owner, [state, task = std::move(task)] {
+    {
+      // The new owner may have dropped the subscription in the meantime.
+      std::lock_guard lock{state->mutex};
+      if (state->closed)
+        return;
+    }
+    task();
+  });
+}
+
+void ServerSubscription::SetExecutor(AnyExecutor executor) {
+  executor_ = executor;
+  if (backing_subscription_state_) {
+    std::lock_guard lock{backing_subscription_state_->mutex};
+    backing_subscription_state_->executor = std::move(executor);
   }
 }
 
-void ServerSubscription::RebindItem(Item& item) {
+void ServerSubscription::RebindItem(Item& item, BindBatch& batch) {
   if (!IsSupportedMonitoredAttribute(item.item_to_monitor.attribute_id)) {
     item.monitored_item_status = StatusCode::Bad_AttributeIdInvalid;
     return;
@@ -555,40 +808,76 @@ void ServerSubscription::RebindItem(Item& item) {
   item.binding_requested = true;
   // A rebind (ModifyMonitoredItems) replaces the binding, so release the one
   // being abandoned before the id is overwritten.
-  RemoveBackingItem(item.backing_item_id);
+  if (item.backing_item_id != 0)
+    batch.backing_item_ids_to_remove.push_back(item.backing_item_id);
   item.backing_item_id = 0;
   item.monitored_item_status = StatusCode::Good;
+  items_by_backing_handle_.erase(item.backing_client_handle);
   item.backing_client_handle = next_backing_client_handle_++;
+  items_by_backing_handle_.emplace(item.backing_client_handle, &item);
 
   MonitoringParameters parameters = item.parameters;
   parameters.client_handle = item.backing_client_handle;
   MonitoredItemCreateRequest request{
       .item_to_monitor = item.item_to_monitor,
-      .index_range = item.index_range,
       .monitoring_mode = item.monitoring_mode,
       .requested_parameters = std::move(parameters)};
 
   const auto item_it = items_.find(item.monitored_item_id);
-  const std::weak_ptr<Item> weak_item =
-      item_it != items_.end() ? item_it->second : std::weak_ptr<Item>{};
-  BindItem(std::move(weak_item), item.backing_client_handle,
-           std::move(request));
+  std::weak_ptr<Item> weak_item;
+  if (item_it != items_.end())
+    weak_item = item_it->second;
+  batch.items.push_back({.item = std::move(weak_item),
+                         .backing_client_handle = item.backing_client_handle});
+  batch.requests.push_back(std::move(request));
+}
+
+void ServerSubscription::EraseItem(MonitoredItemId monitored_item_id) {
+  const auto item_it = items_.find(monitored_item_id);
+  if (item_it == items_.end())
+    return;
+  pending_count_ -= item_it->second->queue.Clear();
+  const auto handle_it =
+      items_by_backing_handle_.find(item_it->second->backing_client_handle);
+  if (handle_it != items_by_backing_handle_.end() &&
+      handle_it->second == item_it->second.get()) {
+    items_by_backing_handle_.erase(handle_it);
+  }
+  items_.erase(item_it);
 }
 
-void ServerSubscription::BindItem(std::weak_ptr<Item> weak_item,
-                                  UInt32 backing_client_handle,
-                                  MonitoredItemCreateRequest request) {
+void ServerSubscription::SubmitBindBatch(BindBatch batch) {
+  // Abandoned bindings go first, so a rebind releases before it binds again,
+  // as it did when each item spawned its own pair of calls.
+  RemoveBackingItems(std::move(batch.backing_item_ids_to_remove));
+  if (batch.requests.empty())
+    return;
+
+  // One AddItems for the whole service call. On an aggregating server the
+  // backing subscription is a session to a downstream tier, where a call per
+  // item made a 5000-item CreateMonitoredItems 5000 round trips.
   CoSpawn(executor_,
-          [this, weak_item = std::move(weak_item), backing_client_handle,
-           request = std::move(request)]() mutable -> Awaitable<void> {
-            std::vector<MonitoredItemCreateRequest> requests;
-            requests.push_back(std::move(request));
+          [this, state = backing_subscription_state_,
+           items = std::move(batch.items),
+           requests = std::move(batch.requests)]() mutable -> Awaitable<void> {
+            const AnyExecutor current =
+                co_await boost::asio::this_coro::executor;
             auto results = co_await AddBackingItems(std::move(requests));
-            OnBindResult(
-                std::move(weak_item), backing_client_handle,
-                results.empty()
-                    ? MonitoredItemCreateResult{.status = StatusCode::Bad}
-                    : std::move(results.front()));
+            // The bind results touch the subscription, which a transfer may
+            // have moved to another shard while AddItems was in flight.
+            RunOnOwner(state, current,
+                       [this, items = std::move(items),
+                        results = std::move(results)]() mutable {
+                         for (std::size_t i = 0; i < items.size(); ++i) {
+                           OnBindResult(
+                               std::move(items[i].item),
+                               items[i].backing_client_handle,
+                               i < results.size()
+                                   ? std::move(results[i])
+                                   : MonitoredItemCreateResult{
+                                         .status = StatusCode::Bad});
+                         }
+                       });
           });
 }
 
@@ -601,10 +890,26 @@ void ServerSubscription::OnBindResult(std::weak_ptr<Item> weak_item,
     // id was still 0 when that happened, so nothing has released the binding
     // the backend just handed us; undo it here rather than strand it.
     if (result.status)
-      RemoveBackingItem(result.monitored_item_id);
+      RemoveBackingItems({result.monitored_item_id});
     return;
   }
 
+  // A PercentDeadband is a percentage of the Variable's EURange, so one on a
+  // Variable without it can never be applied. Only the backend knows which
+  // Variables have one, which is why this is decided here rather than when the
+  // item is created. OPC UA Part 4 §7.22.2 DataChangeFilter,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+  if (result.status && !result.eu_range.has_value()) {
+    const auto* filter =
+        item->parameters.filter
+            ? std::get_if<DataChangeFilter>(&*item->parameters.filter)
+            : nullptr;
+    if (filter && filter->deadband_type == DeadbandType::Percent) {
+      RemoveBackingItems({result.monitored_item_id});
+      result.status = StatusCode::Bad_DeadbandFilterInvalid;
+    }
+  }
+
   item->monitored_item_status = result.status.code();
   if (!result.status) {
     QueueItemStatus(*item, result.status);
@@ -612,6 +917,7 @@ void ServerSubscription::OnBindResult(std::weak_ptr<Item> weak_item,
   }
 
   item->backing_item_id = result.monitored_item_id;
+  item->eu_range = result.eu_range;
 }
 
 void ServerSubscription::OnNotifications(
@@ -619,17 +925,24 @@ void ServerSubscription::OnNotifications(
   for (auto& notification : notifications) {
     const UInt32 client_handle = std::visit(
         [](const auto& value) { return value.client_handle; }, notification);
-    const auto item_it = std::find_if(
-        items_.begin(), items_.end(), [client_handle](const auto& entry) {
-          return entry.second->backing_client_handle == client_handle;
-        });
-    if (item_it == items_.end())
+    const auto item_it = items_by_backing_handle_.find(client_handle);
+    if (item_it == items_by_backing_handle_.end())
       continue;
 
     Item& item = *item_it->second;
     if (auto* data_change =
             std::get_if<MonitoredItemNotification>(&notification)) {
-      QueueDataChange(item, data_change->value);
+      if (data_change_callback_)
+        data_change_callback_(item.item_to_monitor, data_change->value);
+      // A range that selects nothing reports its status in place of the
+      // value. OPC UA Part 4 §7.27 NumericRange,
+      // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.27
+      auto& value = data_change->value;
+      if (item.index_range.has_value() && !IsBad(value.status_code)) {
+        if (const auto status = item.index_range->Apply(value.value); !status)
+          value = DataValue{status.code(), value.server_timestamp};
+      }
+      QueueDataChange(item, value);
     } else if (auto* event = std::get_if<EventFieldList>(&notification)) {
       QueueEventFields(item, std::move(event->event_fields));
     }
@@ -642,24 +955,83 @@ void ServerSubscription::OnSubscriptionError(Status status) {
   }
 }
 
-bool ServerSubscription::PassesDeadband(const Item& item,
-                                        const DataValue& data_value) {
-  // OPC UA Part 4 §7.22.2 DataChangeFilter: an absolute deadband reports a
-  // value only when it differs from the last reported value by at least the
-  // deadband. https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+double ServerSubscription::ReviseSamplingInterval(double requested_ms) const {
+  return requested_ms < 0 ? parameters_.publishing_interval_ms : requested_ms;
+}
+
+StatusCode ServerSubscription::ValidateFilter(
+    const MonitoringParameters& parameters) {
+  const auto* filter =
+      parameters.filter ? std::get_if<DataChangeFilter>(&*parameters.filter)
+                        : nullptr;
+  // A PercentDeadband is a percentage: anything outside 0..100 is invalid.
+  // OPC UA Part 4 §7.22.2 DataChangeFilter,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+  if (filter && filter->deadband_type == DeadbandType::Percent &&
+      (filter->deadband_value < 0 || filter->deadband_value > 100)) {
+    return StatusCode::Bad_DeadbandFilterInvalid;
+  }
+  return StatusCode::Good;
+}
+
+bool ServerSubscription::PassesFilter(const Item& item,
+                                      const DataValue& data_value) {
+  // OPC UA Part 4 §7.22.2 DataChangeFilter: the trigger names what counts as
+  // a change, and the deadband then screens value changes. An item without a
+  // filter gets the default, trigger StatusValue with no deadband — so a
+  // backend re-delivering an unchanged value does not reach the client.
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+  if (!item.last_reported_value.has_value()) {
+    return true;  // The first value is always reported.
+  }
+  const DataValue& last = *item.last_reported_value;
+  // A status change is reported under every trigger, regardless of deadband.
+  if (last.status_code != data_value.status_code ||
+      !(last.qualifier == data_value.qualifier)) {
+    return true;
+  }
+
   const auto* filter =
       item.parameters.filter
           ? std::get_if<DataChangeFilter>(&*item.parameters.filter)
           : nullptr;
-  if (!filter || filter->deadband_type != DeadbandType::Absolute ||
-      filter->deadband_value <= 0) {
+  const DataChangeTrigger trigger =
+      filter ? filter->trigger : DataChangeTrigger::StatusValue;
+  if (trigger == DataChangeTrigger::Status) {
+    return false;
+  }
+  if (trigger == DataChangeTrigger::StatusValueTimestamp &&
+      last.source_timestamp != data_value.source_timestamp) {
     return true;
   }
-  if (!item.last_reported_value.has_value()) {
-    return true;  // The first value is always reported.
+  if (last.value == data_value.value) {
+    return false;
+  }
+  return !filter || PassesDeadband(item, *filter, data_value);
+}
+
+bool ServerSubscription::PassesDeadband(const Item& item,
+                                        const DataChangeFilter& filter,
+                                        const DataValue& data_value) {
+  // An absolute deadband reports a value only when it differs from the last
+  // reported value by at least the deadband; a percent deadband by at least
+  // that percentage of the item's EURange.
+  double deadband = 0;
+  switch (filter.deadband_type) {
+    case DeadbandType::Absolute:
+      deadband = filter.deadband_value;
+      break;
+    case DeadbandType::Percent:
+      if (!item.eu_range.has_value()) {
+        return true;  // Not bound yet; OnBindResult rejects it if it has none.
+      }
+      deadband = filter.deadband_value / 100 *
+                 std::abs(item.eu_range->high - item.eu_range->low);
+      break;
+    case DeadbandType::None:
+      return true;
   }
-  // A status-code change is always reported regardless of the deadband.
-  if (item.last_reported_value->status_code != data_value.status_code) {
+  if (deadband <= 0) {
     return true;
   }
   double previous = 0.0;
@@ -668,17 +1040,41 @@ bool ServerSubscription::PassesDeadband(const Item& item,
       !data_value.value.get(current)) {
     return true;  // Non-numeric values are always reported.
   }
-  return std::abs(current - previous) >= filter->deadband_value;
+  return std::abs(current - previous) >= deadband;
 }
 
 void ServerSubscription::QueueDataChange(Item& item,
                                          const DataValue& data_value) {
   if (item.monitoring_mode != MonitoringMode::Reporting)
     return;
-  if (!PassesDeadband(item, data_value))
+  if (!PassesFilter(item, data_value))
     return;
   item.last_reported_value = data_value;
-  QueueNotification(
+
+  // Samples are coalesced to the item's revised sampling interval: the first
+  // sample in an interval is queued, and later ones replace it while it is
+  // still waiting to be published, so a backend pushing at 1 kHz costs a
+  // 500 ms subscriber one queued value per interval, the latest. The interval
+  // is measured on the sample's own timestamps, which are what the backend
+  // sampled at. OPC UA Part 4 §5.12.1.2 Sampling interval,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.12.1.2
+  const DateTime sample_time = data_value.source_timestamp.is_null()
+                                   ? data_value.server_timestamp
+                                   : data_value.source_timestamp;
+  const auto interval = Duration::FromMicroseconds(static_cast<int64_t>(
+      item.parameters.sampling_interval_ms * 1000));
+  if (interval > Duration{} && !sample_time.is_null() &&
+      item.sample_in_queue && !item.queue.empty() &&
+      item.sample_interval_start.has_value() &&
+      *item.sample_interval_start <= sample_time &&
+      sample_time < *item.sample_interval_start + interval) {
+    auto& queued = std::get<DataChangeNotification>(item.queue.back());
+    queued.monitored_items.front().value = data_value;
+    return;
+  }
+
+  item.sample_interval_start = sample_time;
+  item.sample_in_queue = QueueNotification(
       item,
       DataChangeNotification{
           .monitored_items = {{.client_handle = item.parameters.client_handle,
@@ -703,31 +1099,39 @@ void ServerSubscription::QueueItemStatus(Item& item, Status status) {
   QueueDataChange(item, DataValue{status.code(), DateTime::Now()});
 }
 
-void ServerSubscription::QueueNotification(Item& item,
+bool ServerSubscription::QueueNotification(Item& item,
                                            NotificationData notification) {
-  pending_notifications_.push_back({.source_item_id = item.monitored_item_id,
-                                    .notification = std::move(notification)});
-  EnforceQueueLimit(item);
+  const bool was_empty = pending_count_ == 0;
+  const bool item_was_empty = item.queue.empty();
+  item.sample_in_queue = false;
+  const bool pushed = item.queue.Push(std::move(notification),
+                                      item.parameters.discard_oldest);
+  if (pushed)
+    ++pending_count_;
+  if (item_was_empty && !item.queue.empty())
+    ready_items_.push_back(item.monitored_item_id);
+  // Only the empty -> non-empty edge moves the deadline (from keep-alive to
+  // publishing interval); later notifications in the same cycle change nothing
+  // a parked Publish is waiting on.
+  if (was_empty && parameters_.publishing_enabled)
+    NotifyPublishReady();
+  // A full queue that discards the oldest still takes the notification.
+  return pushed || item.parameters.discard_oldest;
 }
 
-void ServerSubscription::EnforceQueueLimit(const Item& item) {
-  const auto queue_size = std::max<UInt32>(1, item.parameters.queue_size);
-  std::vector<size_t> indices;
-  for (size_t i = 0; i < pending_notifications_.size(); ++i) {
-    if (pending_notifications_[i].source_item_id == item.monitored_item_id)
-      indices.push_back(i);
-  }
-  if (indices.size() <= queue_size)
-    return;
-
-  if (!item.parameters.discard_oldest) {
-    pending_notifications_.erase(pending_notifications_.begin() +
-                                 static_cast<std::ptrdiff_t>(indices.back()));
-    return;
-  }
+void ServerSubscription::ApplyQueueSize(Item& item) {
+  const std::size_t discarded =
+      item.queue.Resize(std::max<UInt32>(1, item.parameters.queue_size),
+                        item.parameters.discard_oldest);
+  pending_count_ -= discarded;
+  // Trimming may have dropped the newest entry.
+  if (discarded != 0)
+    item.sample_in_queue = false;
+}
 
-  pending_notifications_.erase(pending_notifications_.begin() +
-                               static_cast<std::ptrdiff_t>(indices.front()));
+void ServerSubscription::NotifyPublishReady() const {
+  if (publish_ready_callback_)
+    publish_ready_callback_();
 }
 
 }  // namespace opcua
@@ -4,6 +4,7 @@
 #include "opcua/message.h"
 #include "opcua/monitored/monitored_item.h"
 #include "opcua/services/service_callbacks.h"
+#include "opcua/types/numeric_range.h"
 
 #include <deque>
 #include <functional>
@@ -12,6 +13,7 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace opcua {
 
@@ -52,12 +54,12 @@ class ServerSubscription {
   //
   // maxNotificationsPerPublish = 0 means the CLIENT sets no limit (OPC UA
   // Part 4 §5.13.2); it does not oblige the server to send an unbounded
-  // message. `pending_notifications_` has no overall cap — only per-item
-  // trimming — so a subscription with many items and a deep queue can hold
-  // arbitrarily many, and draining all of them into one response would build a
-  // message with no bound at all, against transports that carry an explicit
-  // max_message_size. What is left over is reported through moreNotifications,
-  // which is exactly what that flag is for.
+  // message. The per-item queues have no overall cap (each is bounded only by
+  // its own queue_size), so a subscription with many items and a deep queue
+  // can hold arbitrarily many, and draining all of them into one response
+  // would build a message with no bound at all, against transports that carry
+  // an explicit max_message_size. What is left over is reported through
+  // moreNotifications, which is exactly what that flag is for.
   //
   // At the common 500 ms interval this still allows ~2000 notifications a
   // second, far above any rate these tiers produce.
@@ -73,10 +75,22 @@ class ServerSubscription {
 
   SubscriptionId subscription_id() const { return subscription_id_; }
   const SubscriptionParameters& parameters() const { return parameters_; }
-  bool HasPendingNotifications() const {
-    return !pending_notifications_.empty();
+  bool HasPendingNotifications() const { return pending_count_ != 0; }
+  // Notifications held for Republish, as kMaxRetransmitQueueNotifications
+  // counts them.
+  std::size_t retained_notification_count() const {
+    return retained_notifications_;
   }
   Duration PublishingInterval() const;
+  // How long the subscription lives without a Publish request to serve it:
+  // lifetime_count publishing intervals. OPC UA Part 4 §5.13.1.1,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.13.1.1
+  Duration LifetimeInterval() const;
+  // When the lifetime counter was last reset by something other than a
+  // Publish request — creation, Modify or a transfer to another session. The
+  // owning session tracks Publish requests itself, for all its subscriptions.
+  DateTime lifetime_start() const { return lifetime_start_; }
+  void RestartLifetime(DateTime now) { lifetime_start_ = now; }
   bool IsPublishReady(DateTime now) const;
   void PrimePublishCycle(DateTime now);
   std::optional<DateTime> NextPublishDeadline() const;
@@ -84,6 +98,37 @@ class ServerSubscription {
   ModifySubscriptionResponse Modify(const ModifySubscriptionRequest& request);
   void SetPublishingEnabled(bool publishing_enabled);
 
+  // Invoked whenever this subscription may have become publishable sooner than
+  // its last NextPublishDeadline said: the first notification queued behind an
+  // empty queue, publishing re-enabled, or the publishing interval modified.
+  // The owning session parks Publish requests on it instead of polling.
+  void SetPublishReadyCallback(std::function<void()> callback) {
+    publish_ready_callback_ = std::move(callback);
+  }
+
+  // Invoked with every data change the backing subscription delivers, whole
+  // and before the item's IndexRange, filters and sampling decide what is
+  // queued. The owning session feeds its read cache from it.
+  void SetDataChangeCallback(
+      std::function<void(const ReadValueId&, const DataValue&)> callback) {
+    data_change_callback_ = std::move(callback);
+  }
+
+  // Moves the subscription's asynchronous work — the backing-subscription
+  // reader and in-flight monitored-item binds — onto `executor`. A sharded
+  // server calls this when TransferSubscriptions hands the subscription to a
+  // session on another shard (see ShardedServerRuntime); every continuation
+  // that touches the subscription afterwards runs on the new owner's executor.
+  void SetExecutor(AnyExecutor executor);
+
+  // Answers without waiting for the backend: an item's result covers what
+  // can be checked here (the filter, the index range, the attribute), and the
+  // item is bound afterwards. A failure only the backend can reveal — a
+  // PercentDeadband on a Variable without an EURange, reported as
+  // Bad_DeadbandFilterInvalid, or the bind itself failing — therefore
+  // follows the Good result as the item's status in a later Publish. The
+  // item keeps the id it was created with, for the client to modify it into
+  // something the backend accepts or to delete it.
   CreateMonitoredItemsResponse CreateMonitoredItems(
       const CreateMonitoredItemsRequest& request);
   ModifyMonitoredItemsResponse ModifyMonitoredItems(
@@ -97,26 +142,84 @@ class ServerSubscription {
       const std::vector<UInt32>& sequence_numbers);
   std::optional<PublishResponse> TryPublish(DateTime now);
   RepublishResponse Republish(UInt32 sequence_number) const;
+  // Ends the subscription once its lifetime ran out: releases the backing
+  // subscription and every item bound to it, and returns the last message the
+  // client gets for it, a StatusChangeNotification of Bad_Timeout. The owning
+  // session then deletes the subscription. OPC UA Part 4 §5.13.1.1,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.13.1.1
+  PublishResponse Expire(DateTime now);
 
  private:
+  // One monitored item's undelivered notifications: a ring buffer bounded by
+  // the item's revised queue_size, with overflow resolved in place (OPC UA
+  // Part 4 §5.12.1.5 queue parameters,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.12.1.5).
+  // Slots are allocated as the queue fills rather than up front, since a
+  // client may ask for a deep queue it never uses.
+  class NotificationQueue {
+   public:
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Sets the bound, trimming from the end `discard_oldest` names. Returns
+    // the number of notifications discarded.
+    std::size_t Resize(std::size_t capacity, bool discard_oldest);
+    // Returns false when the queue was full and one notification — the
+    // oldest queued, or the incoming one — was discarded.
+    bool Push(NotificationData notification, bool discard_oldest);
+    NotificationData Pop();
+    // The most recently queued notification. The queue must not be empty.
+    NotificationData& back();
+    std::size_t Clear();
+
+   private:
+    // Moves the entries to the front of `slots_`, oldest first.
+    void Linearize();
+
+    std::vector<NotificationData> slots_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 1;
+  };
+
   struct Item {
     MonitoredItemId monitored_item_id = 0;
     ReadValueId item_to_monitor;
-    std::optional<std::string> index_range;
+    // Applied here to every data change: the backing subscription delivers
+    // whole values.
+    std::optional<NumericRange> index_range;
     MonitoringMode monitoring_mode = MonitoringMode::Reporting;
     MonitoringParameters parameters;
     StatusCode monitored_item_status = StatusCode::Bad;
     UInt32 backing_client_handle = 0;
     MonitoredItemId backing_item_id = 0;
     bool binding_requested = false;
-    // Last value queued for this item; used to apply the DataChangeFilter
-    // absolute deadband.
+    // Reported by the backing subscription on bind; the span a
+    // PercentDeadband is a percentage of.
+    std::optional<EuRange> eu_range;
+    // Last value queued for this item; what the DataChangeFilter trigger and
+    // deadband compare against.
     std::optional<DataValue> last_reported_value;
+    // Start of the current sampling interval, and whether the newest queued
+    // notification is the sample taken in it. While both hold, a later sample
+    // in the same interval replaces that one instead of queuing behind it.
+    std::optional<DateTime> sample_interval_start;
+    bool sample_in_queue = false;
+    NotificationQueue queue;
   };
 
-  struct QueuedNotification {
-    MonitoredItemId source_item_id = 0;
-    NotificationData notification;
+  // Backing-subscription work collected over one service call and submitted
+  // once at its end: the bindings to create, in request order, and the ones
+  // abandoned by rebinding.
+  struct BindBatch {
+    struct PendingItem {
+      std::weak_ptr<Item> item;
+      UInt32 backing_client_handle = 0;
+    };
+
+    std::vector<PendingItem> items;
+    std::vector<MonitoredItemCreateRequest> requests;
+    std::vector<MonitoredItemId> backing_item_ids_to_remove;
   };
 
   struct BackingSubscriptionState {
@@ -126,33 +229,56 @@ class ServerSubscription {
     std::function<void(Status)> error_handler;
     bool closed = false;
     std::unique_ptr<MonitoredItemSubscription> subscription;
+    // Executor of the subscription's current owner. Continuations started on
+    // an earlier owner's executor read it to find their way to the new one.
+    AnyExecutor executor;
   };
 
   StatusCode Acknowledge(UInt32 sequence_number);
   std::vector<UInt32> AvailableSequenceNumbers() const;
   Duration KeepAliveInterval() const;
 
+  // Revises a requested sampling interval: a negative one means "the
+  // publishing interval". OPC UA Part 4 §5.12.1.2 Sampling interval,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/5.12.1.2
+  double ReviseSamplingInterval(double requested_ms) const;
+  // Rejects a DataChangeFilter that can never be applied; Good otherwise.
+  static StatusCode ValidateFilter(const MonitoringParameters& parameters);
   // True if `data_value` should be reported given the item's DataChangeFilter
-  // absolute deadband (status changes and the first value always pass).
-  static bool PassesDeadband(const Item& item, const DataValue& data_value);
+  // trigger and deadband (the first value always passes).
+  static bool PassesFilter(const Item& item, const DataValue& data_value);
+  static bool PassesDeadband(const Item& item,
+                             const DataChangeFilter& filter,
+                             const DataValue& data_value);
 
   Status StartBackingSubscription();
   Awaitable<std::vector<MonitoredItemCreateResult>> AddBackingItems(
       std::vector<MonitoredItemCreateRequest> requests);
-  // Releases one item from the backing subscription. Every path that stops
-  // using a binding must call this: the backing subscription is long-lived
-  // (on an aggregating server it is a session to a downstream tier), so an
-  // unreleased binding is held until the whole subscription closes. A zero id
-  // means the bind is still in flight and OnBindResult does the release.
-  void RemoveBackingItem(MonitoredItemId backing_item_id);
+  // Releases items from the backing subscription in one RemoveItems call.
+  // Every path that stops using a binding must call this: the backing
+  // subscription is long-lived (on an aggregating server it is a session to a
+  // downstream tier), so an unreleased binding is held until the whole
+  // subscription closes. Callers leave out zero ids: a zero id means the bind
+  // is still in flight and OnBindResult does the release.
+  void RemoveBackingItems(std::vector<MonitoredItemId> backing_item_ids);
   void CloseBackingSubscription(Status status);
   static Awaitable<void> ReadBackingSubscriptionLoop(
       std::shared_ptr<BackingSubscriptionState> state);
+  // Hands one ReadNext result to the subscription; false once reading ended.
+  static bool DeliverBackingNotifications(
+      BackingSubscriptionState& state,
+      StatusOr<std::vector<ItemNotification>> notifications);
+  // Runs `task` on the owner's executor: inline when that is still `current`,
+  // posted when the subscription moved shards while the caller was suspended.
+  static void RunOnOwner(const std::shared_ptr<BackingSubscriptionState>& state,
+                         const AnyExecutor& current,
+                         std::function<void()> task);
 
-  void RebindItem(Item& item);
-  void BindItem(std::weak_ptr<Item> weak_item,
-                UInt32 backing_client_handle,
-                MonitoredItemCreateRequest request);
+  // Gives `item` a fresh backing client handle and adds its binding to
+  // `batch`; nothing reaches the backing subscription until SubmitBindBatch.
+  void RebindItem(Item& item, BindBatch& batch);
+  void EraseItem(MonitoredItemId monitored_item_id);
+  void SubmitBindBatch(BindBatch batch);
   void OnBindResult(std::weak_ptr<Item> weak_item,
                     UInt32 backing_client_handle,
                     MonitoredItemCreateResult result);
@@ -161,8 +287,10 @@ class ServerSubscription {
   void QueueDataChange(Item& item, const DataValue& data_value);
   void QueueEventFields(Item& item, std::vector<Variant> event_fields);
   void QueueItemStatus(Item& item, Status status);
-  void QueueNotification(Item& item, NotificationData notification);
-  void EnforceQueueLimit(const Item& item);
+  // Returns true if `notification` is now the newest in the item's queue.
+  bool QueueNotification(Item& item, NotificationData notification);
+  void ApplyQueueSize(Item& item);
+  void NotifyPublishReady() const;
 
   SubscriptionId subscription_id_;
   SubscriptionParameters parameters_;
@@ -170,6 +298,9 @@ class ServerSubscription {
   ServiceCallbacks::CreateSubscriptionCallback create_subscription_;
   const std::string trace_parent_;
   std::shared_ptr<BackingSubscriptionState> backing_subscription_state_;
+  std::function<void()> publish_ready_callback_;
+  std::function<void(const ReadValueId&, const DataValue&)>
+      data_change_callback_;
 
   UInt32 next_monitored_item_id_ = 1;
   UInt32 next_backing_client_handle_ = 1;
@@ -177,11 +308,24 @@ class ServerSubscription {
 
   bool initial_message_sent_ = false;
   std::optional<DateTime> last_publish_time_;
+  DateTime lifetime_start_;
 
   std::unordered_map<MonitoredItemId, std::shared_ptr<Item>> items_;
-  std::deque<QueuedNotification> pending_notifications_;
+  // Secondary index over `items_` by the item's current backing client handle,
+  // which is what backing notifications carry. RebindItem and EraseItem keep it
+  // in step; a handle abandoned by a rebind is dropped, so late notifications
+  // from the old binding find nothing.
+  std::unordered_map<UInt32, Item*> items_by_backing_handle_;
+  // Items whose queue holds notifications, in the order TryPublish serves
+  // them: one notification per item per turn, an item with more going to the
+  // back. An entry may name a deleted item, which TryPublish skips; ids are
+  // never reused.
+  std::deque<MonitoredItemId> ready_items_;
+  // Sum of the item queue sizes.
+  std::size_t pending_count_ = 0;
   std::deque<NotificationMessage> retransmit_queue_;
-  // Sum of notification_data sizes across retransmit_queue_, maintained
+  // Monitored-item notifications across retransmit_queue_ (entries inside each
+  // merged NotificationData, not the NotificationData count), maintained
   // alongside it so the bound above does not have to walk the deque.
   std::size_t retained_notifications_ = 0;
 };
@@ -8,7 +8,10 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <initializer_list>
+#include <iostream>
 #include <memory>
 #include <set>
 #include <string>
@@ -454,6 +457,137 @@ TEST(ServerSubscriptionTest, QueueOverflowCapsQueuedDataChanges) {
   EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{1.0, 2.0}));
 }
 
+// discardOldest = false keeps what is queued and drops the incoming value.
+TEST(ServerSubscriptionTest, DiscardNewestKeepsTheQueuedDataChanges) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto created = harness.subscription().CreateMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_create = {
+           {.item_to_monitor = {.node_id = NumericNode(101),
+                                .attribute_id = AttributeId::Value},
+            .requested_parameters = {.client_handle = kClientHandleBase,
+                                     .queue_size = 2,
+                                     .discard_oldest = false}}}});
+  ASSERT_EQ(created.results.size(), 1u);
+  harness.Drain();
+  const UInt32 backing_handle = harness.backing().BackingClientHandle(0);
+
+  for (int i = 0; i < 3; ++i) {
+    harness.backing().PushDataChange(backing_handle,
+                                     DataValue{Variant{static_cast<double>(i)},
+                                               {},
+                                               harness.start(),
+                                               harness.start()});
+  }
+  harness.Drain();
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{0.0, 1.0}));
+}
+
+// A publish that cannot carry everything serves the items round-robin, so an
+// item with a deep queue does not fill the response ahead of the others.
+TEST(ServerSubscriptionTest, LimitedPublishServesItemsRoundRobin) {
+  auto parameters = DefaultParameters();
+  parameters.max_notifications_per_publish = 3;
+  SubscriptionHarness harness{parameters, ParseTime("2026-04-20 10:00:00")};
+
+  const auto client_handles = harness.CreateItems(3, /*queue_size=*/5);
+  // The first item queues five values before the others queue one each.
+  const UInt32 busy_handle = harness.BackingHandleFor(client_handles[0]);
+  for (int i = 0; i < 5; ++i) {
+    harness.backing().PushDataChange(busy_handle,
+                                     DataValue{Variant{static_cast<double>(i)},
+                                               {},
+                                               harness.start(),
+                                               harness.start()});
+  }
+  harness.Drain();
+  harness.PushToAll({client_handles[1], client_handles[2]}, 9.0);
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeHandles(*publish), client_handles);
+  EXPECT_TRUE(publish->more_notifications);
+}
+
+// Every data change drained into one publish travels in a single
+// DataChangeNotification, in drain order, rather than one NotificationData per
+// sample.
+TEST(ServerSubscriptionTest, MergesDrainedDataChangesIntoOneNotification) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto client_handles = harness.CreateItems(3, /*queue_size=*/2);
+  harness.PushToAll(client_handles, 1.0);
+  harness.PushToAll(client_handles, 2.0);
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  ASSERT_EQ(publish->notification_message.notification_data.size(), 1u);
+  const auto* data_change = std::get_if<DataChangeNotification>(
+      &publish->notification_message.notification_data[0]);
+  ASSERT_NE(data_change, nullptr);
+  EXPECT_EQ(data_change->monitored_items.size(), 6u);
+  EXPECT_EQ(DataChangeValues(*publish),
+            (std::vector<double>{1.0, 1.0, 1.0, 2.0, 2.0, 2.0}));
+}
+
+// A Republish hands back the very notification list the Publish carried, not
+// a copy of it.
+TEST(ServerSubscriptionTest, RepublishSharesThePublishedNotifications) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto client_handles = harness.CreateItems(2, /*queue_size=*/1);
+  harness.PushToAll(client_handles, 1.0);
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  const auto republish = harness.subscription().Republish(
+      publish->notification_message.sequence_number);
+  ASSERT_EQ(republish.status.code(), StatusCode::Good);
+  EXPECT_EQ(republish.notification_message, publish->notification_message);
+  ASSERT_EQ(republish.notification_message.notification_data.size(), 1u);
+  EXPECT_EQ(&republish.notification_message.notification_data[0],
+            &publish->notification_message.notification_data[0]);
+}
+
+// Shrinking an item's queue through ModifyMonitoredItems trims what it already
+// holds to the new size.
+TEST(ServerSubscriptionTest, ModifyShrinksTheQueuedDataChanges) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto client_handles = harness.CreateItems(1, /*queue_size=*/4);
+  const UInt32 backing_handle = harness.BackingHandleFor(client_handles[0]);
+  for (int i = 0; i < 4; ++i) {
+    harness.backing().PushDataChange(backing_handle,
+                                     DataValue{Variant{static_cast<double>(i)},
+                                               {},
+                                               harness.start(),
+                                               harness.start()});
+  }
+  harness.Drain();
+
+  const auto modified = harness.subscription().ModifyMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_modify = {
+           {.monitored_item_id = 1,
+            .requested_parameters = {.client_handle = client_handles[0],
+                                     .queue_size = 2,
+                                     .discard_oldest = true}}}});
+  ASSERT_EQ(modified.results.size(), 1u);
+  harness.Drain();
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{2.0, 3.0}));
+}
+
 TEST(ServerSubscriptionTest, AppliesAbsoluteDeadbandFilter) {
   SubscriptionHarness harness{DefaultParameters(),
                               ParseTime("2026-04-20 10:00:00")};
@@ -488,6 +622,264 @@ TEST(ServerSubscriptionTest, AppliesAbsoluteDeadbandFilter) {
   EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{10.0, 16.0}));
 }
 
+// Creates one Value item on node 101 with `parameters` (the client handle is
+// kClientHandleBase) and binds it. Returns the create result.
+MonitoredItemCreateResult CreateValueItem(SubscriptionHarness& harness,
+                                          MonitoringParameters parameters) {
+  parameters.client_handle = kClientHandleBase;
+  const auto create = harness.subscription().CreateMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_create = {
+           {.item_to_monitor = {.node_id = NumericNode(101),
+                                .attribute_id = AttributeId::Value},
+            .requested_parameters = std::move(parameters)}}});
+  EXPECT_EQ(create.results.size(), 1u);
+  harness.Drain();
+  return create.results.empty() ? MonitoredItemCreateResult{}
+                                : create.results[0];
+}
+
+// Pushes `values` to the item on node 101, the first stamped at the harness
+// start and each later one `step_ms` after the one before, and delivers them.
+void PushValues(SubscriptionHarness& harness,
+                std::initializer_list<double> values,
+                int64_t step_ms = 0) {
+  const UInt32 backing_handle = harness.BackingHandleFor(kClientHandleBase);
+  int64_t offset_ms = 0;
+  for (const double value : values) {
+    harness.backing().PushDataChange(
+        backing_handle, DataValue{Variant{value}, {}, harness.At(offset_ms),
+                                  harness.At(offset_ms)});
+    offset_ms += step_ms;
+  }
+  harness.Drain();
+}
+
+// A percent deadband is a percentage of the EURange the backend reports: 10%
+// of 0..200 is 20.
+TEST(ServerSubscriptionTest, AppliesPercentDeadbandAgainstTheEuRange) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+  harness.backing().eu_range = EuRange{.low = 0, .high = 200};
+
+  const auto result = CreateValueItem(
+      harness, {.filter = MonitoringFilter{DataChangeFilter{
+                    .deadband_type = DeadbandType::Percent,
+                    .deadband_value = 10}},
+                .queue_size = 10});
+  ASSERT_EQ(result.status.code(), StatusCode::Good);
+
+  PushValues(harness, {100.0, 115.0, 121.0, 130.0});
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{100.0, 121.0}));
+}
+
+// A percent deadband outside 0..100 is refused when the item is created, and
+// one on a Variable without an EURange once the backend has bound it.
+TEST(ServerSubscriptionTest, RejectsPercentDeadbandItCannotApply) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto out_of_range = CreateValueItem(
+      harness, {.filter = MonitoringFilter{DataChangeFilter{
+                    .deadband_type = DeadbandType::Percent,
+                    .deadband_value = 150}}});
+  EXPECT_EQ(out_of_range.status.code(), StatusCode::Bad_DeadbandFilterInvalid);
+  EXPECT_TRUE(harness.backing().added_items.empty());
+
+  const auto no_eu_range = CreateValueItem(
+      harness, {.filter = MonitoringFilter{DataChangeFilter{
+                    .deadband_type = DeadbandType::Percent,
+                    .deadband_value = 10}}});
+  ASSERT_EQ(no_eu_range.status.code(), StatusCode::Good);
+  ASSERT_EQ(harness.backing().added_items.size(), 1u);
+  // The binding the backend made is released again.
+  EXPECT_EQ(harness.backing().removed_item_ids,
+            (std::vector<MonitoredItemId>{
+                harness.backing().added_items[0].item_id}));
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  ASSERT_EQ(publish->notification_message.notification_data.size(), 1u);
+  const auto* data_change = std::get_if<DataChangeNotification>(
+      &publish->notification_message.notification_data[0]);
+  ASSERT_NE(data_change, nullptr);
+  ASSERT_EQ(data_change->monitored_items.size(), 1u);
+  EXPECT_EQ(data_change->monitored_items[0].value.status_code,
+            StatusCode::Bad_DeadbandFilterInvalid);
+}
+
+// The create result goes out before the backend has bound the item, so a
+// deadband refused at bind time arrives later, under the id the create
+// returned, and a Modify to a filter the Variable can take binds it again.
+TEST(ServerSubscriptionTest, DeadbandRefusedAtBindTimeLeavesTheItemToModify) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto created = CreateValueItem(
+      harness, {.filter = MonitoringFilter{DataChangeFilter{
+                    .deadband_type = DeadbandType::Percent,
+                    .deadband_value = 10}}});
+  ASSERT_EQ(created.status.code(), StatusCode::Good);
+  ASSERT_NE(created.monitored_item_id, 0u);
+
+  const auto refused = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(refused.has_value());
+  ASSERT_EQ(refused->notification_message.notification_data.size(), 1u);
+  const auto* data_change = std::get_if<DataChangeNotification>(
+      &refused->notification_message.notification_data[0]);
+  ASSERT_NE(data_change, nullptr);
+  ASSERT_EQ(data_change->monitored_items.size(), 1u);
+  EXPECT_EQ(data_change->monitored_items[0].client_handle, kClientHandleBase);
+  EXPECT_EQ(data_change->monitored_items[0].value.status_code,
+            StatusCode::Bad_DeadbandFilterInvalid);
+
+  const auto modified = harness.subscription().ModifyMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_modify = {
+           {.monitored_item_id = created.monitored_item_id,
+            .requested_parameters = {
+                .client_handle = kClientHandleBase,
+                .filter = MonitoringFilter{DataChangeFilter{
+                    .deadband_type = DeadbandType::Absolute,
+                    .deadband_value = 1}},
+                .queue_size = 1,
+                .discard_oldest = true}}}});
+  ASSERT_EQ(modified.results.size(), 1u);
+  EXPECT_EQ(modified.results[0].status.code(), StatusCode::Good);
+  harness.Drain();
+  ASSERT_EQ(harness.backing().added_items.size(), 2u);
+
+  harness.backing().PushDataChange(
+      harness.backing()
+          .added_items.back()
+          .request.requested_parameters.client_handle,
+      DataValue{Variant{5.0}, {}, harness.At(200), harness.At(200)});
+  harness.Drain();
+  const auto publish = harness.subscription().TryPublish(harness.At(200));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{5.0}));
+}
+
+// Without a filter the default trigger, StatusValue, applies: an unchanged
+// value re-delivered by the backend is not reported again.
+TEST(ServerSubscriptionTest, DefaultTriggerDropsUnchangedValues) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+  CreateValueItem(harness, {.queue_size = 10});
+
+  PushValues(harness, {1.0, 1.0, 2.0, 2.0}, /*step_ms=*/10);
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{1.0, 2.0}));
+}
+
+// StatusValueTimestamp also reports a new source timestamp on an unchanged
+// value; Status reports neither value nor timestamp changes.
+TEST(ServerSubscriptionTest, AppliesTheDataChangeTrigger) {
+  {
+    SubscriptionHarness harness{DefaultParameters(),
+                                ParseTime("2026-04-20 10:00:00")};
+    CreateValueItem(harness,
+                    {.filter = MonitoringFilter{DataChangeFilter{
+                         .trigger = DataChangeTrigger::StatusValueTimestamp}},
+                     .queue_size = 10});
+    PushValues(harness, {1.0, 1.0, 1.0}, /*step_ms=*/10);
+    const auto publish = harness.subscription().TryPublish(harness.At(100));
+    ASSERT_TRUE(publish.has_value());
+    EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{1.0, 1.0, 1.0}));
+  }
+  {
+    SubscriptionHarness harness{DefaultParameters(),
+                                ParseTime("2026-04-20 10:00:00")};
+    CreateValueItem(harness,
+                    {.filter = MonitoringFilter{DataChangeFilter{
+                         .trigger = DataChangeTrigger::Status}},
+                     .queue_size = 10});
+    PushValues(harness, {1.0, 2.0, 3.0}, /*step_ms=*/10);
+    const auto publish = harness.subscription().TryPublish(harness.At(100));
+    ASSERT_TRUE(publish.has_value());
+    EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{1.0}));
+  }
+}
+
+// Samples arriving faster than the revised sampling interval are coalesced:
+// each interval queues one value, the latest the backend produced in it.
+TEST(ServerSubscriptionTest, CoalescesSamplesToTheSamplingInterval) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+  const auto result =
+      CreateValueItem(harness, {.sampling_interval_ms = 50, .queue_size = 10});
+  EXPECT_EQ(result.revised_sampling_interval_ms, 50);
+
+  // Ten samples 10 ms apart span two 50 ms intervals.
+  PushValues(harness, {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0},
+             /*step_ms=*/10);
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{4.0, 9.0}));
+}
+
+// The backing subscription delivers whole values; each item's IndexRange is
+// applied to them before they are queued.
+TEST(ServerSubscriptionTest, AppliesTheIndexRangeToDataChanges) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+
+  const auto create = harness.subscription().CreateMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_create = {
+           {.item_to_monitor = {.node_id = NumericNode(101),
+                                .attribute_id = AttributeId::Value},
+            .index_range = "1:2",
+            .requested_parameters = {.client_handle = kClientHandleBase}},
+           {.item_to_monitor = {.node_id = NumericNode(102),
+                                .attribute_id = AttributeId::Value},
+            .index_range = "5",
+            .requested_parameters = {.client_handle = kClientHandleBase + 1}},
+           {.item_to_monitor = {.node_id = NumericNode(103),
+                                .attribute_id = AttributeId::Value},
+            .index_range = "2:1",
+            .requested_parameters = {.client_handle = kClientHandleBase + 2}},
+       }});
+  ASSERT_EQ(create.results.size(), 3u);
+  EXPECT_EQ(create.results[2].status.code(), StatusCode::Bad_IndexRangeInvalid);
+  harness.Drain();
+  ASSERT_EQ(harness.backing().added_items.size(), 2u);
+  for (const auto& added : harness.backing().added_items)
+    EXPECT_FALSE(added.request.index_range.has_value());
+
+  const DataValue waveform{Variant{std::vector<Double>{1.0, 2.0, 3.0, 4.0}},
+                           {},
+                           harness.start(),
+                           harness.start()};
+  harness.backing().PushDataChange(harness.BackingHandleFor(kClientHandleBase),
+                                   waveform);
+  harness.backing().PushDataChange(
+      harness.BackingHandleFor(kClientHandleBase + 1), waveform);
+  harness.Drain();
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  std::vector<DataValue> values;
+  for (const auto& notification :
+       publish->notification_message.notification_data) {
+    if (const auto* data_change =
+            std::get_if<DataChangeNotification>(&notification)) {
+      for (const auto& item : data_change->monitored_items)
+        values.push_back(item.value);
+    }
+  }
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0].value.get<std::vector<Double>>(),
+            (std::vector<Double>{2.0, 3.0}));
+  EXPECT_EQ(values[1].status_code, StatusCode::Bad_IndexRangeNoData);
+}
+
 // The backing subscription outlives individual monitored items, so every path
 // that stops using a binding must release it or the binding is held until the
 // whole subscription closes.
@@ -560,7 +952,7 @@ TEST(ServerSubscriptionTest,
 }
 
 // A client that sets no limit does not get an unbounded message. Nothing caps
-// `pending_notifications_` as a whole — only per-item trimming — so a
+// the queued notifications as a whole (only each item's own queue_size), so a
 // subscription with many items and a deep queue can hold arbitrarily many, and
 // draining all of them into one response would build a message with no bound
 // against transports that carry an explicit max_message_size. The server caps
@@ -679,6 +1071,46 @@ TEST(ServerSubscriptionTest, AcknowledgeReleasesRetainedNotifications) {
             StatusCode::Good);
 }
 
+// The retained total goes up by what each message carries and comes down by
+// the same count when the message is acknowledged, so once the client has
+// acknowledged everything it is back to zero, data changes and events alike.
+TEST(ServerSubscriptionTest,
+     AcknowledgingEveryMessageReleasesAllNotifications) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 10:00:00")};
+  const auto client_handles = harness.CreateItems(3, /*queue_size=*/5);
+  const auto events = harness.subscription().CreateMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_create = {
+           {.item_to_monitor = {.node_id = NumericNode(2253, 0),
+                                .attribute_id = AttributeId::EventNotifier},
+            .requested_parameters = {.client_handle = kClientHandleBase + 100,
+                                     .queue_size = 5,
+                                     .discard_oldest = true}}}});
+  ASSERT_EQ(events.results.size(), 1u);
+  ASSERT_EQ(events.results[0].status.code(), StatusCode::Good);
+  harness.Drain();
+  const UInt32 event_handle = harness.backing().BackingClientHandle(3);
+
+  std::vector<UInt32> sequence_numbers;
+  for (int publish_index = 1; publish_index <= 3; ++publish_index) {
+    harness.PushToAll(client_handles, static_cast<double>(publish_index));
+    harness.backing().PushEvent(event_handle,
+                                {Variant{UInt64{11}}, Variant{UInt32{400}}});
+    harness.backing().PushEvent(event_handle,
+                                {Variant{UInt64{22}}, Variant{UInt32{700}}});
+    harness.Drain();
+    const auto publish =
+        harness.subscription().TryPublish(harness.At(publish_index * 100));
+    ASSERT_TRUE(publish.has_value());
+    sequence_numbers.push_back(publish->notification_message.sequence_number);
+  }
+  EXPECT_EQ(harness.subscription().retained_notification_count(), 3u * 5);
+
+  harness.subscription().Acknowledge(sequence_numbers);
+  EXPECT_EQ(harness.subscription().retained_notification_count(), 0u);
+}
+
 // The queue never evicts down to empty: whatever was just published stays
 // Republishable even when the bound is already exceeded.
 //
@@ -845,5 +1277,122 @@ TEST(ServerSubscriptionTest,
   EXPECT_EQ(DataChangeValues(*publish), (std::vector<double>{2.0}));
 }
 
+// Deleting an item drops it from the backing-handle routing as well: a late
+// notification under its handle is ignored, while its neighbours still route.
+TEST(ServerSubscriptionTest, DeletedItemNoLongerReceivesNotifications) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 13:00:00")};
+
+  const auto client_handles = harness.CreateItems(2, /*queue_size=*/1);
+  const UInt32 deleted_backing_handle =
+      harness.BackingHandleFor(client_handles[0]);
+  const UInt32 kept_backing_handle =
+      harness.BackingHandleFor(client_handles[1]);
+
+  const auto response = harness.subscription().DeleteMonitoredItems(
+      {.subscription_id = kSubscriptionId, .monitored_item_ids = {1}});
+  ASSERT_EQ(response.results.size(), 1u);
+  harness.Drain();
+
+  harness.backing().PushDataChange(
+      deleted_backing_handle,
+      DataValue{Variant{1.0}, {}, harness.start(), harness.start()});
+  harness.backing().PushDataChange(
+      kept_backing_handle,
+      DataValue{Variant{2.0}, {}, harness.start(), harness.start()});
+  harness.Drain();
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeHandles(*publish),
+            (std::vector<UInt32>{client_handles[1]}));
+}
+
+// One CreateMonitoredItems is one AddItems on the backing subscription, and one
+// DeleteMonitoredItems is one RemoveItems, however many items they carry.
+TEST(ServerSubscriptionTest, BindsAndReleasesItemsInOneBackingCall) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 13:00:00")};
+
+  harness.CreateItems(5, /*queue_size=*/1);
+  EXPECT_EQ(harness.backing().add_calls, 1u);
+
+  const auto response = harness.subscription().DeleteMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .monitored_item_ids = {1, 2, 3, 99}});
+  ASSERT_EQ(response.results.size(), 4u);
+  EXPECT_EQ(response.results[3].code(), StatusCode::Bad_MonitoredItemIdInvalid);
+  harness.Drain();
+
+  EXPECT_EQ(harness.backing().remove_calls, 1u);
+  std::vector<MonitoredItemId> expected_removed;
+  for (std::size_t i = 0; i < 3; ++i)
+    expected_removed.push_back(harness.backing().added_items[i].item_id);
+  EXPECT_EQ(harness.backing().removed_item_ids, expected_removed);
+}
+
+// Each item of a batched bind still gets its own result: with the backend
+// refusing every binding, each item reports the failure on its own.
+TEST(ServerSubscriptionTest, BatchedBindFailureIsReportedPerItem) {
+  SubscriptionHarness harness{DefaultParameters(),
+                              ParseTime("2026-04-20 13:00:00")};
+  harness.backing().add_status = Status{StatusCode::Bad_NodeIdUnknown};
+
+  const auto response = harness.subscription().CreateMonitoredItems(
+      {.subscription_id = kSubscriptionId,
+       .items_to_create = {
+           {.item_to_monitor = {.node_id = NumericNode(101),
+                                .attribute_id = AttributeId::Value},
+            .requested_parameters = {.client_handle = kClientHandleBase,
+                                     .queue_size = 1}},
+           {.item_to_monitor = {.node_id = NumericNode(102),
+                                .attribute_id = AttributeId::Value},
+            .requested_parameters = {.client_handle = kClientHandleBase + 1,
+                                     .queue_size = 1}}}});
+  ASSERT_EQ(response.results.size(), 2u);
+  harness.Drain();
+  EXPECT_EQ(harness.backing().add_calls, 1u);
+
+  const auto publish = harness.subscription().TryPublish(harness.At(100));
+  ASSERT_TRUE(publish.has_value());
+  EXPECT_EQ(DataChangeHandles(*publish),
+            (std::vector<UInt32>{kClientHandleBase, kClientHandleBase + 1}));
+}
+
+// Benchmark, not a check: the cost of routing one backing notification to its
+// item as the subscription grows. Routing used to scan every item, so this
+// grew linearly with the item count; with the backing-handle index it stays
+// flat. Run with --gtest_also_run_disabled_tests.
+TEST(ServerSubscriptionTest, DISABLED_BenchmarkNotificationRoutingByItemCount) {
+  constexpr std::size_t kNotifications = 20000;
+  for (const std::size_t item_count : {100u, 1000u, 5000u, 20000u}) {
+    SubscriptionHarness harness{DefaultParameters(),
+                                ParseTime("2026-04-20 13:00:00")};
+    harness.CreateItems(item_count, /*queue_size=*/1);
+
+    // Every notification targets one item with queue_size 1, so the publish
+    // queue stays at one entry and only the routing cost scales.
+    const UInt32 backing_handle =
+        harness.backing().BackingClientHandle(item_count - 1);
+    for (std::size_t i = 0; i < kNotifications; ++i) {
+      harness.backing().PushDataChange(
+          backing_handle, DataValue{Variant{static_cast<double>(i)},
+                                    {},
+                                    harness.start(),
+                                    harness.start()});
+    }
+    const auto started = std::chrono::steady_clock::now();
+    harness.Drain();
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    std::cout << "items=" << item_count << " ns/notification="
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                         .count() /
+                     static_cast<long long>(kNotifications)
+              << std::endl;
+    EXPECT_TRUE(harness.subscription().HasPendingNotifications());
+  }
+}
+
 }  // namespace
 }  // namespace opcua
@@ -0,0 +1,248 @@
+#include "opcua/session/sharded_server_runtime.h"
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace opcua {
+
+namespace {
+
+ShardIds MakeShardIds(const ShardedServerRuntimeContext& context,
+                      std::size_t index) {
+  return {.index = static_cast<UInt32>(index),
+          .count = static_cast<UInt32>(
+              std::max<std::size_t>(context.shard_count, 1))};
+}
+
+ServerSessionManagerContext MakeSessionManagerContext(
+    const ShardedServerRuntimeContext& context,
+    std::size_t index) {
+  auto session_manager = context.session_manager;
+  session_manager.shard_ids = MakeShardIds(context, index);
+  return session_manager;
+}
+
+template <typename T>
+constexpr bool kIsSessionlessRequest =
+    std::is_same_v<T, CreateSessionRequest> ||
+    std::is_same_v<T, FindServersRequest> ||
+    std::is_same_v<T, GetEndpointsRequest> ||
+    std::is_same_v<T, RegisterServerRequest> ||
+    std::is_same_v<T, RegisterServer2Request>;
+
+}  // namespace
+
+ServerShard::ServerShard(const ShardedServerRuntimeContext& context,
+                         std::size_t index)
+    : executor{context.executor_factory()},
+      session_manager{MakeSessionManagerContext(context, index)},
+      runtime{ServerRuntimeContext{
+          .executor = executor,
+          .session_manager = session_manager,
+          .callbacks = context.callbacks,
+          .endpoints = context.endpoints,
+          .operation_limits = context.operation_limits,
+          .now = context.now,
+          .post_delayed_task = context.post_delayed_task,
+          .register_server = context.register_server,
+          .registered_servers = context.registered_servers,
+          .shard_ids = MakeShardIds(context, index),
+          .registered_node_namespace_index =
+              context.registered_node_namespace_index,
+          .read_cache_entries = context.read_cache_entries,
+      }} {}
+
+ShardedServerRuntime::ShardedServerRuntime(
+    ShardedServerRuntimeContext&& context)
+    : token_namespace_index_{context.session_manager.token_namespace_index} {
+  const auto shard_count = std::max<std::size_t>(context.shard_count, 1);
+  shards_.reserve(shard_count);
+  for (std::size_t index = 0; index < shard_count; ++index)
+    shards_.push_back(std::make_unique<ServerShard>(context, index));
+}
+
+std::size_t ShardedServerRuntime::HomeShard(ConnectionState& connection) {
+  if (!connection.shard.has_value()) {
+    connection.shard =
+        next_home_shard_.fetch_add(1, std::memory_order_relaxed) %
+        shards_.size();
+    connection.shard_views.resize(shards_.size());
+  }
+  return *connection.shard;
+}
+
+std::size_t ShardedServerRuntime::SessionShard(
+    ConnectionState& connection,
+    const NodeId& authentication_token) {
+  if (!authentication_token.is_numeric() ||
+      authentication_token.namespace_index() != token_namespace_index_ ||
+      authentication_token.numeric_id() == 0) {
+    return HomeShard(connection);
+  }
+  const ShardIds shard_ids{.count = static_cast<UInt32>(shards_.size())};
+  return shard_ids.ShardOf(authentication_token.numeric_id());
+}
+
+Awaitable<ResponseBody> ShardedServerRuntime::Handle(
+    ConnectionState& connection,
+    RequestBody request,
+    std::string trace_parent) {
+  if (auto* transfer =
+          std::get_if<ua::TransferSubscriptionsRequest>(&request)) {
+    co_return co_await HandleTransferSubscriptions(
+        connection, std::move(*transfer), std::move(trace_parent));
+  }
+
+  // Activate/CloseSession name their session in the request; everything else
+  // session-bound runs where the connection's session lives, and the
+  // sessionless services — CreateSession included — on the home shard.
+  std::optional<NodeId> rebinds;
+  const auto shard_index = std::visit(
+      [&](const auto& typed_request) -> std::size_t {
+        using T = std::decay_t<decltype(typed_request)>;
+        if constexpr (std::is_same_v<T, ActivateSessionRequest> ||
+                      std::is_same_v<T, CloseSessionRequest>) {
+          rebinds = typed_request.authentication_token;
+          return SessionShard(connection, typed_request.authentication_token);
+        } else if constexpr (kIsSessionlessRequest<T>) {
+          return HomeShard(connection);
+        } else {
+          if (!connection.authentication_token.has_value())
+            return HomeShard(connection);
+          return SessionShard(connection, *connection.authentication_token);
+        }
+      },
+      request);
+
+  auto handle = [request = std::move(request),
+                 trace_parent = std::move(trace_parent)](
+                    ServerShard& shard,
+                    ConnectionState& view) mutable -> Awaitable<ResponseBody> {
+    co_return co_await shard.runtime.Handle(view, std::move(request),
+                                            std::move(trace_parent));
+  };
+  auto body = co_await RunOnShard<ResponseBody>(connection, shard_index,
+                                                std::move(handle));
+
+  // The shard bound (or unbound) its view; mirror that on the connection so
+  // later requests are routed to the session's shard.
+  if (rebinds.has_value()) {
+    if (const auto* activated = std::get_if<ActivateSessionResponse>(&body)) {
+      if (activated->status)
+        connection.authentication_token = std::move(rebinds);
+    } else if (connection.authentication_token == rebinds) {
+      connection.authentication_token.reset();
+    }
+  }
+  co_return body;
+}
+
+Awaitable<ResponseBody> ShardedServerRuntime::HandleTransferSubscriptions(
+    ConnectionState& connection,
+    ua::TransferSubscriptionsRequest request,
+    std::string trace_parent) {
+  const auto target_shard =
+      connection.authentication_token.has_value()
+          ? SessionShard(connection, *connection.authentication_token)
+          : HomeShard(connection);
+
+  // The target's own shard first: it transfers between the sessions it owns
+  // and reports the rest as unknown.
+  auto handle = [request, trace_parent = std::move(trace_parent)](
+                    ServerShard& shard,
+                    ConnectionState& view) mutable -> Awaitable<ResponseBody> {
+    co_return co_await shard.runtime.Handle(
+        view, RequestBody{std::move(request)}, std::move(trace_parent));
+  };
+  auto body = co_await RunOnShard<ResponseBody>(connection, target_shard,
+                                                std::move(handle));
+  if (auto* response = std::get_if<ua::TransferSubscriptionsResponse>(&body))
+    co_await TransferFromOtherShards(connection, target_shard, request,
+                                     *response);
+  co_return body;
+}
+
+Awaitable<void> ShardedServerRuntime::TransferFromOtherShards(
+    ConnectionState& connection,
+    std::size_t target_shard,
+    const ua::TransferSubscriptionsRequest& request,
+    ua::TransferSubscriptionsResponse& response) {
+  if (!response.response_header.service_result ||
+      response.results.size() != request.subscription_ids.size()) {
+    co_return;
+  }
+
+  std::unordered_map<SubscriptionId, std::size_t> unresolved;
+  for (std::size_t i = 0; i < request.subscription_ids.size(); ++i) {
+    if (response.results[i].status_code.code() ==
+        StatusCode::Bad_SubscriptionIdInvalid) {
+      unresolved.emplace(request.subscription_ids[i], i);
+    }
+  }
+
+  // Every other shard in turn releases the subscriptions it owns, already
+  // headed for the target's executor, and the target adopts them.
+  const auto destination = shards_[target_shard]->executor;
+  for (std::size_t shard_index = 0;
+       shard_index < shards_.size() && !unresolved.empty(); ++shard_index) {
+    if (shard_index == target_shard)
+      continue;
+
+    std::vector<SubscriptionId> subscription_ids;
+    subscription_ids.reserve(unresolved.size());
+    for (const auto& [subscription_id, index] : unresolved)
+      subscription_ids.push_back(subscription_id);
+
+    using Released = std::vector<std::unique_ptr<ServerSubscription>>;
+    auto release = [subscription_ids = std::move(subscription_ids),
+                    destination](ServerShard& shard,
+                                 ConnectionState&) -> Awaitable<Released> {
+      co_return shard.runtime.ReleaseSubscriptions(subscription_ids,
+                                                   destination);
+    };
+    auto released = co_await RunOnShard<Released>(connection, shard_index,
+                                                  std::move(release));
+    if (released.empty())
+      continue;
+
+    std::vector<SubscriptionId> released_ids;
+    released_ids.reserve(released.size());
+    for (const auto& subscription : released)
+      released_ids.push_back(subscription->subscription_id());
+
+    auto adopt = [released = std::move(released)](
+                     ServerShard& shard, ConnectionState& view) mutable
+        -> Awaitable<std::vector<ua::TransferResult>> {
+      co_return shard.runtime.AdoptSubscriptions(view, std::move(released));
+    };
+    const auto results = co_await RunOnShard<std::vector<ua::TransferResult>>(
+        connection, target_shard, std::move(adopt));
+    for (std::size_t i = 0; i < released_ids.size(); ++i) {
+      const auto it = unresolved.find(released_ids[i]);
+      response.results[it->second] = results[i];
+      unresolved.erase(it);
+    }
+  }
+}
+
+void ShardedServerRuntime::Detach(ConnectionState& connection) {
+  for (std::size_t shard_index = 0; shard_index < connection.shard_views.size();
+       ++shard_index) {
+    auto view = std::move(connection.shard_views[shard_index]);
+    if (!view)
+      continue;
+    auto& shard = *shards_[shard_index];
+    boost::asio::post(shard.executor, [&shard, view = std::move(view)] {
+      view->closed = true;
+      shard.runtime.Detach(*view);
+    });
+  }
+  connection.shard_views.clear();
+  connection.shard.reset();
+  connection.authentication_token.reset();
+}
+
+}  // namespace opcua
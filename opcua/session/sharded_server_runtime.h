@@ -0,0 +1,153 @@
+#pragma once
+
+#include "opcua/base/any_executor.h"
+#include "opcua/base/awaitable.h"
+#include "opcua/session/server_runtime.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace opcua {
+
+struct ShardedServerRuntimeContext {
+  // Number of shards, each with its own executor, ServerSessionManager and
+  // ServerRuntime. 0 is treated as 1.
+  std::size_t shard_count = 1;
+  // Called once per shard for the executor that shard runs on — typically one
+  // io_context per core, each run by its own thread.
+  AnyExecutorFactory executor_factory;
+  // Configuration shared by every shard's session manager; `shard_ids` is
+  // assigned per shard. The callbacks it holds (authenticator,
+  // decrypt_user_token, on_audit_event) are invoked from every shard's
+  // executor and must be safe to call concurrently. The single-session gate
+  // (AuthenticationResult::multi_sessions = false) sees only the sessions of
+  // the shard the user activates on.
+  ServerSessionManagerContext session_manager;
+  // As in ServerRuntimeContext, shared by every shard's runtime and invoked
+  // from every shard's executor.
+  ServiceCallbacks callbacks;
+  std::vector<EndpointDescription> endpoints;
+  OperationLimits operation_limits;
+  std::function<DateTime()> now = &DateTime::Now;
+  std::function<void(Duration, std::function<void()>)> post_delayed_task;
+  std::function<Status(const RegisteredServer&, const RegisterServerContext&)>
+      register_server;
+  std::function<std::vector<RegisteredServer>()> registered_servers;
+  std::optional<NamespaceIndex> registered_node_namespace_index;
+  // Per shard: each shard's runtime caches the reads of its own sessions.
+  std::size_t read_cache_entries = 0;
+};
+
+// One shard: an executor and the session state that lives on it. Everything
+// here is only ever touched on `executor`.
+struct ServerShard {
+  ServerShard(const ShardedServerRuntimeContext& context, std::size_t index);
+
+  AnyExecutor executor;
+  ServerSessionManager session_manager;
+  ServerRuntime runtime;
+};
+
+// ServerRuntime spread over several executors. ServerRuntime and
+// ServerSessionManager keep their maps unsynchronised and run on one executor;
+// rather than lock them, this runs one of each per shard and shares nothing
+// between shards.
+//
+// A connection is pinned round-robin to a shard on its first request, and the
+// sessions it creates live there. Every later request is carried to the shard
+// owning the session it names — the authentication token says which (see
+// ShardIds) — and the response carried back, each a post to the other
+// executor. That covers session lookup and ActivateSession on a connection
+// pinned elsewhere. TransferSubscriptions between sessions on different shards
+// moves the subscriptions the same way: released on the source shard, adopted
+// on the target's.
+//
+// Handle and Detach must be called on the connection's own executor, which
+// owns the ConnectionState; each shard works on its own view of it (see
+// ConnectionState::shard_views).
+class ShardedServerRuntime {
+ public:
+  explicit ShardedServerRuntime(ShardedServerRuntimeContext&& context);
+
+  ShardedServerRuntime(const ShardedServerRuntime&) = delete;
+  ShardedServerRuntime& operator=(const ShardedServerRuntime&) = delete;
+
+  [[nodiscard]] std::size_t shard_count() const { return shards_.size(); }
+  [[nodiscard]] ServerShard& shard(std::size_t index) {
+    return *shards_[index];
+  }
+
+  // Same contract as ServerRuntime::Handle.
+  [[nodiscard]] Awaitable<ResponseBody> Handle(ConnectionState& connection,
+                                               RequestBody request,
+                                               std::string trace_parent = {});
+  void Detach(ConnectionState& connection);
+
+  // The shard `connection` is pinned to, pinning it on first use.
+  std::size_t HomeShard(ConnectionState& connection);
+  // The shard whose session manager issued `authentication_token`; the
+  // connection's home shard for a token no shard could have issued, which
+  // then answers Bad_SessionIdInvalid as an unsharded runtime would.
+  [[nodiscard]] std::size_t SessionShard(ConnectionState& connection,
+                                         const NodeId& authentication_token);
+
+  // Completes a TransferSubscriptions that the target session's shard has
+  // answered: the subscriptions it reported unknown are looked up on the other
+  // shards, released there and adopted by the session bound to the
+  // connection's view on `target_shard`, and `response` updated to match.
+  [[nodiscard]] Awaitable<void> TransferFromOtherShards(
+      ConnectionState& connection,
+      std::size_t target_shard,
+      const ua::TransferSubscriptionsRequest& request,
+      ua::TransferSubscriptionsResponse& response);
+
+  // Runs `fn(shard, view)` on shard `shard_index`'s executor against the
+  // connection's view for that shard and resumes the caller with its result.
+  // The building block of Handle, for transports that route requests
+  // themselves.
+  template <class T, class F>
+  [[nodiscard]] Awaitable<T> RunOnShard(ConnectionState& connection,
+                                        std::size_t shard_index,
+                                        F fn);
+
+ private:
+  [[nodiscard]] Awaitable<ResponseBody> HandleTransferSubscriptions(
+      ConnectionState& connection,
+      ua::TransferSubscriptionsRequest request,
+      std::string trace_parent);
+
+  std::vector<std::unique_ptr<ServerShard>> shards_;
+  NamespaceIndex token_namespace_index_;
+  std::atomic<std::size_t> next_home_shard_ = 0;
+};
+
+template <class T, class F>
+Awaitable<T> ShardedServerRuntime::RunOnShard(ConnectionState& connection,
+                                              std::size_t shard_index,
+                                              F fn) {
+  HomeShard(connection);
+  auto& view = connection.shard_views[shard_index];
+  if (!view) {
+    // Seeded here, before any shard has seen it; from now on only the shard
+    // touches it. What the transport records is fixed once the channel is
+    // open, so a snapshot is all a shard needs.
+    view = std::make_shared<ConnectionState>(ConnectionState{
+        .secure_channel = connection.secure_channel,
+        .client_certificate = connection.client_certificate,
+        .peer = connection.peer});
+  }
+
+  // Named rather than a temporary of the co_await expression: GCC 12 mishandles
+  // temporaries with non-trivial destructors that live across a suspension.
+  auto& shard = *shards_[shard_index];
+  auto run = [&shard, view, fn = std::move(fn)]() mutable -> Awaitable<T> {
+    co_return co_await fn(shard, *view);
+  };
+  co_return co_await CoSpawnAndWait(shard.executor, std::move(run));
+}
+
+}  // namespace opcua
@@ -0,0 +1,236 @@
+#include "opcua/session/sharded_server_runtime.h"
+
+#include "opcua/session/server_runtime_contract_test.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace opcua {
+namespace {
+
+using test::BackingStates;
+using test::NumericNode;
+using test::ScriptedServices;
+
+// The runtime contract over two shards. Connections are pinned round-robin, so
+// consecutive connections land on different shards and the contract's resume
+// and transfer cases cross between them. Every executor is a TestExecutor
+// polled from the test thread, which keeps the hops deterministic.
+class ShardedRuntimeFixture {
+ public:
+  using ConnectionState = opcua::ConnectionState;
+
+  struct SessionIds {
+    NodeId session_id;
+    NodeId authentication_token;
+  };
+
+  DateTime now_ = test::ParseTime("2026-04-22 09:00:00");
+  const NodeId expected_user_id_ = NumericNode(700, 5);
+  // The connections' own executor; each shard gets one of `shard_executors_`.
+  TestExecutor connection_executor_;
+  std::vector<TestExecutor> shard_executors_{TestExecutor{}, TestExecutor{}};
+  ScriptedServices services_;
+  std::shared_ptr<BackingStates> backing_states_ =
+      std::make_shared<BackingStates>();
+  std::vector<std::pair<Duration, std::function<void()>>> delayed_tasks_;
+
+  ShardedServerRuntime runtime_{ShardedServerRuntimeContext{
+      .shard_count = shard_executors_.size(),
+      .executor_factory =
+          [this, next = std::size_t{0}]() mutable {
+            return AnyExecutor{shard_executors_[next++]};
+          },
+      .session_manager =
+          {
+              .authenticator = MakeCoroutineAuthenticator(
+                  [this](LocalizedText user_name, LocalizedText password)
+                      -> CoStatusOr<AuthenticationResult> {
+                    EXPECT_EQ(user_name, LocalizedText{u"operator"});
+                    EXPECT_EQ(password, LocalizedText{u"secret"});
+                    co_return AuthenticationResult{
+                        .user_id = expected_user_id_, .multi_sessions = true};
+                  }),
+              .now = [this] { return now_; },
+          },
+      .callbacks = services_.MakeCallbacks(AnyExecutor{connection_executor_},
+                                           backing_states_),
+      .now = [this] { return now_; },
+      .post_delayed_task =
+          [this](Duration delay, std::function<void()> task) {
+            delayed_tasks_.emplace_back(delay, std::move(task));
+          },
+  }};
+
+  template <class Response, class Request>
+  Response HandleResponse(ConnectionState& connection, Request request) {
+    auto result = StartAwaitable<ResponseBody>(
+        connection_executor_,
+        runtime_.Handle(connection, RequestBody{std::move(request)}));
+
+    for (int step = 0; step < 16 && !result->done; ++step) {
+      Drain();
+      if (result->done || delayed_tasks_.empty())
+        break;
+      auto [delay, task] = std::move(delayed_tasks_.front());
+      delayed_tasks_.erase(delayed_tasks_.begin());
+      now_ = now_ + delay;
+      task();
+    }
+    Drain();
+
+    EXPECT_TRUE(result->done) << "request never completed";
+    if (!result->done || !result->value.has_value())
+      return Response{};
+    auto* response = std::get_if<Response>(&*result->value);
+    EXPECT_TRUE(response) << "unexpected response body";
+    return response ? std::move(*response) : Response{};
+  }
+
+  SessionIds CreateAndActivate(ConnectionState& connection) {
+    const auto created = HandleResponse<CreateSessionResponse>(
+        connection, CreateSessionRequest{});
+    EXPECT_EQ(created.status.code(), StatusCode::Good);
+    const auto activated = HandleResponse<ActivateSessionResponse>(
+        connection, ActivateSessionRequest{
+                        .session_id = created.session_id,
+                        .authentication_token = created.authentication_token,
+                        .user_name = LocalizedText{u"operator"},
+                        .password = LocalizedText{u"secret"},
+                    });
+    EXPECT_EQ(activated.status.code(), StatusCode::Good);
+    return {created.session_id, created.authentication_token};
+  }
+
+  void Detach(ConnectionState& connection) {
+    runtime_.Detach(connection);
+    Drain();
+  }
+
+  // Polls every executor until none has work left: a hop to a shard and the
+  // reply back are each a post to the other executor.
+  void Drain() {
+    for (bool ran = true; ran;) {
+      ran = false;
+      for (auto* executor : AllExecutors()) {
+        if (executor->HasReadyTasks()) {
+          opcua::Drain(*executor);
+          ran = true;
+        }
+      }
+    }
+  }
+
+  void Advance(int64_t ms) { now_ = now_ + Duration::FromMilliseconds(ms); }
+
+  FakeMonitoredItemSubscription::State& backing(std::size_t index) const {
+    return *backing_states_->at(index);
+  }
+
+ private:
+  std::vector<TestExecutor*> AllExecutors() {
+    std::vector<TestExecutor*> executors{&connection_executor_};
+    for (auto& executor : shard_executors_)
+      executors.push_back(&executor);
+    return executors;
+  }
+};
+
+class ShardedServerRuntimeTest : public testing::Test {
+ protected:
+  ShardedRuntimeFixture fixture_;
+};
+
+TEST_F(ShardedServerRuntimeTest,
+       RoutesReadRequestsThroughActivatedSessionUser) {
+  test::ExpectRoutesReadRequestsThroughActivatedSessionUser(fixture_);
+}
+
+TEST_F(ShardedServerRuntimeTest,
+       ServiceRequestsWithoutActivatedSessionAreRejected) {
+  test::ExpectServiceRequestsWithoutActivatedSessionAreRejected(fixture_);
+}
+
+TEST_F(ShardedServerRuntimeTest,
+       PreservesLiveSubscriptionStateAcrossDetachAndResume) {
+  test::ExpectPreservesLiveSubscriptionStateAcrossDetachAndResume(fixture_);
+}
+
+TEST_F(ShardedServerRuntimeTest, TransfersSubscriptionsAcrossSessions) {
+  test::ExpectTransfersSubscriptionsAcrossSessions(fixture_);
+}
+
+TEST_F(ShardedServerRuntimeTest, CloseSessionClearsAttachedState) {
+  test::ExpectCloseSessionClearsAttachedState(fixture_);
+}
+
+TEST_F(ShardedServerRuntimeTest,
+       PublishReturnsKeepAliveWhenNoNotificationsAreQueued) {
+  test::ExpectPublishReturnsKeepAliveWhenNoNotifications(fixture_);
+}
+
+// Each connection is pinned to the next shard, its session lives there, and
+// the token it gets back names that shard, so a request carrying it finds the
+// session without asking any other shard.
+TEST_F(ShardedServerRuntimeTest, PinsConnectionsAndTheirSessionsToShards) {
+  ConnectionState first;
+  ConnectionState second;
+  const auto first_ids = fixture_.CreateAndActivate(first);
+  const auto second_ids = fixture_.CreateAndActivate(second);
+
+  ASSERT_TRUE(first.shard.has_value());
+  ASSERT_TRUE(second.shard.has_value());
+  EXPECT_NE(*first.shard, *second.shard);
+  EXPECT_EQ(
+      fixture_.runtime_.SessionShard(first, first_ids.authentication_token),
+      *first.shard);
+  EXPECT_EQ(
+      fixture_.runtime_.SessionShard(second, second_ids.authentication_token),
+      *second.shard);
+
+  auto& first_shard = fixture_.runtime_.shard(*first.shard);
+  EXPECT_TRUE(
+      first_shard.session_manager.FindSession(first_ids.authentication_token));
+  EXPECT_FALSE(
+      first_shard.session_manager.FindSession(second_ids.authentication_token));
+  EXPECT_NE(first_ids.session_id, second_ids.session_id);
+  EXPECT_NE(first_ids.authentication_token, second_ids.authentication_token);
+}
+
+// ActivateSession on a connection pinned to another shard is carried to the
+// session's shard; the connection's later requests follow it there.
+TEST_F(ShardedServerRuntimeTest, ActivatesSessionFromConnectionOnOtherShard) {
+  ConnectionState owner;
+  const auto ids = fixture_.CreateAndActivate(owner);
+  fixture_.Detach(owner);
+
+  ConnectionState other;
+  fixture_.HandleResponse<GetEndpointsResponse>(other, GetEndpointsRequest{});
+  ASSERT_TRUE(other.shard.has_value());
+  ASSERT_NE(*other.shard,
+            fixture_.runtime_.SessionShard(other, ids.authentication_token));
+
+  const auto resumed = fixture_.HandleResponse<ActivateSessionResponse>(
+      other, ActivateSessionRequest{
+                 .session_id = ids.session_id,
+                 .authentication_token = ids.authentication_token,
+             });
+  EXPECT_EQ(resumed.status.code(), StatusCode::Good);
+  EXPECT_EQ(other.authentication_token, ids.authentication_token);
+
+  const auto read = fixture_.HandleResponse<ua::ReadResponse>(
+      other,
+      ua::ReadRequest{.nodes_to_read = {{.node_id = NumericNode(1),
+                                         .attribute_id = static_cast<UInt32>(
+                                             AttributeId::Value)}}});
+  EXPECT_EQ(read.response_header.service_result.code(), StatusCode::Good);
+  EXPECT_EQ(fixture_.services_.last_read_context.user_id(),
+            fixture_.expected_user_id_);
+}
+
+}  // namespace
+}  // namespace opcua
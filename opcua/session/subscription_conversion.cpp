@@ -53,16 +53,13 @@ EventFieldList FromUa(const ua::EventFieldList& w) {
 // Wraps a generated notification body as an ExtensionObject. `json_body`
 // selects the body form: a JSON body renders inline on the websocket transport
 // (the web client has no binary decoder), a binary body renders as a spec
-// ExtensionObject on UA-TCP (and as UaEncoding=1 base64 over JSON).
+// ExtensionObject on UA-TCP (and as UaEncoding=1 base64 over JSON). Either
+// body is kept unencoded so the response encoder writes it in place.
 template <class Notification>
-ExtensionObject WrapNotification(const Notification& wire,
-                                 std::uint32_t json_id,
-                                 bool json_body) {
-  if (json_body) {
-    return ExtensionObject{ExpandedNodeId{NodeId{json_id}},
-                           ua::EncodeJson(wire)};
-  }
-  return ua::ToExtensionObject(wire);
+ExtensionObject WrapNotification(Notification wire, bool json_body) {
+  if (json_body)
+    return ua::ToInPlaceJsonExtensionObject(std::move(wire));
+  return ua::ToInPlaceExtensionObject(std::move(wire));
 }
 
 // Wraps a managed NotificationData alternative as its generated
@@ -76,7 +73,7 @@ ExtensionObject ToExtensionObject(const NotificationData& notification,
     for (const auto& item : data_change->monitored_items) {
       wire.monitored_items.push_back(ToUa(item));
     }
-    return WrapNotification(wire, kDataChangeNotificationJsonId, json_body);
+    return WrapNotification(std::move(wire), json_body);
   }
   if (const auto* events = std::get_if<EventNotificationList>(&notification)) {
     ua::EventNotificationList wire;
@@ -84,77 +81,80 @@ ExtensionObject ToExtensionObject(const NotificationData& notification,
     for (const auto& event : events->events) {
       wire.events.push_back(ToUa(event));
     }
-    return WrapNotification(wire, kEventNotificationListJsonId, json_body);
+    return WrapNotification(std::move(wire), json_body);
   }
   const auto& status_change = std::get<StatusChangeNotification>(notification);
   return WrapNotification(
       ua::StatusChangeNotification{.status = Status{status_change.status}},
-      kStatusChangeNotificationJsonId, json_body);
+      json_body);
 }
 
-// Inverse: decodes a generated NotificationData ExtensionObject (binary or
-// inline JSON body) into a managed NotificationData. Returns nullopt for an
-// unrecognized extension type so the caller drops it.
-std::optional<NotificationData> FromExtensionObject(
-    const ExtensionObject& extension_object) {
-  ua::DataChangeNotification data_change;
-  if (ua::FromExtensionObject(extension_object, data_change)) {
-    DataChangeNotification managed;
-    managed.monitored_items.reserve(data_change.monitored_items.size());
-    for (const auto& item : data_change.monitored_items) {
-      managed.monitored_items.push_back(FromUa(item));
-    }
-    return managed;
-  }
-  ua::EventNotificationList events;
-  if (ua::FromExtensionObject(extension_object, events)) {
-    EventNotificationList managed;
-    managed.events.reserve(events.events.size());
-    for (const auto& event : events.events) {
-      managed.events.push_back(FromUa(event));
-    }
-    return managed;
+DataChangeNotification FromUa(const ua::DataChangeNotification& w) {
+  DataChangeNotification managed;
+  managed.monitored_items.reserve(w.monitored_items.size());
+  for (const auto& item : w.monitored_items) {
+    managed.monitored_items.push_back(FromUa(item));
   }
-  ua::StatusChangeNotification status_change;
-  if (ua::FromExtensionObject(extension_object, status_change)) {
-    return StatusChangeNotification{.status = status_change.status.code()};
+  return managed;
+}
+
+EventNotificationList FromUa(const ua::EventNotificationList& w) {
+  EventNotificationList managed;
+  managed.events.reserve(w.events.size());
+  for (const auto& event : w.events) {
+    managed.events.push_back(FromUa(event));
   }
+  return managed;
+}
 
-  // Inline JSON body (the websocket transport): match the DefaultJson id.
-  const auto* json =
-      std::any_cast<boost::json::value>(&extension_object.value());
-  if (json == nullptr) {
-    return std::nullopt;
+StatusChangeNotification FromUa(const ua::StatusChangeNotification& w) {
+  return StatusChangeNotification{.status = w.status.code()};
+}
+
+// Reads `extension_object` as a `Notification` in any body form: binary,
+// inline JSON matched on the DefaultJson id `json_id`, or a JSON body still
+// held in place. Nullopt if it is some other type.
+template <class Notification>
+std::optional<NotificationData> ReadNotification(
+    const ExtensionObject& extension_object,
+    std::uint32_t json_id) {
+  Notification wire;
+  if (ua::FromExtensionObject(extension_object, wire)) {
+    return FromUa(wire);
   }
   const NodeId& id = extension_object.data_type_id().node_id();
-  if (!id.is_numeric() || id.namespace_index() != 0) {
+  if (!id.is_numeric() || id.namespace_index() != 0 ||
+      id.numeric_id() != json_id) {
     return std::nullopt;
   }
-  if (id.numeric_id() == kDataChangeNotificationJsonId) {
-    ua::DecodeJson(*json, data_change);
-    DataChangeNotification managed;
-    managed.monitored_items.reserve(data_change.monitored_items.size());
-    for (const auto& item : data_change.monitored_items) {
-      managed.monitored_items.push_back(FromUa(item));
-    }
-    return managed;
-  }
-  if (id.numeric_id() == kEventNotificationListJsonId) {
-    ua::DecodeJson(*json, events);
-    EventNotificationList managed;
-    managed.events.reserve(events.events.size());
-    for (const auto& event : events.events) {
-      managed.events.push_back(FromUa(event));
-    }
-    return managed;
+  if (const auto* json =
+          std::any_cast<boost::json::value>(&extension_object.value())) {
+    ua::DecodeJson(*json, wire);
+    return FromUa(wire);
   }
-  if (id.numeric_id() == kStatusChangeNotificationJsonId) {
-    ua::DecodeJson(*json, status_change);
-    return StatusChangeNotification{.status = status_change.status.code()};
+  if (ua::FromJsonExtensionObject(extension_object, wire)) {
+    return FromUa(wire);
   }
   return std::nullopt;
 }
 
+// Inverse: decodes a generated NotificationData ExtensionObject (binary or
+// inline JSON body) into a managed NotificationData. Returns nullopt for an
+// unrecognized extension type so the caller drops it.
+std::optional<NotificationData> FromExtensionObject(
+    const ExtensionObject& extension_object) {
+  if (auto data_change = ReadNotification<ua::DataChangeNotification>(
+          extension_object, kDataChangeNotificationJsonId)) {
+    return data_change;
+  }
+  if (auto events = ReadNotification<ua::EventNotificationList>(
+          extension_object, kEventNotificationListJsonId)) {
+    return events;
+  }
+  return ReadNotification<ua::StatusChangeNotification>(
+      extension_object, kStatusChangeNotificationJsonId);
+}
+
 ua::NotificationMessage ToUa(const NotificationMessage& m, bool json_body) {
   ua::NotificationMessage wire;
   wire.sequence_number = m.sequence_number;
@@ -171,12 +171,14 @@ NotificationMessage FromUa(const ua::NotificationMessage& w) {
   NotificationMessage managed;
   managed.sequence_number = w.sequence_number;
   managed.publish_time = w.publish_time;
-  managed.notification_data.reserve(w.notification_data.size());
+  std::vector<NotificationData> notification_data;
+  notification_data.reserve(w.notification_data.size());
   for (const auto& extension_object : w.notification_data) {
     if (auto notification = FromExtensionObject(extension_object)) {
-      managed.notification_data.push_back(std::move(*notification));
+      notification_data.push_back(std::move(*notification));
     }
   }
+  managed.notification_data = std::move(notification_data);
   return managed;
 }
 
@@ -45,8 +45,9 @@ ModifySubscriptionResponse ToManaged(
 
 // --- Publish / Republish. ---
 //
-// The managed NotificationMessage carries a std::vector<NotificationData>
-// (a std::variant of DataChange/Event/StatusChange notifications); the
+// The managed NotificationMessage carries a shared NotificationDataList of
+// NotificationData (a std::variant of DataChange/Event/StatusChange
+// notifications); the
 // generated one carries a std::vector<ExtensionObject>. Each notification is
 // converted with To/FromExtensionObject, so a NotificationData that arrives in
 // an unrecognized extension type is dropped rather than mis-decoded.
@@ -6,6 +6,7 @@
 #include <openssl/rand.h>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstring>
 #include <utility>
@@ -17,8 +18,8 @@ constexpr std::size_t kRsaOaepSha1Overhead = 42;
 constexpr std::size_t kHmacSha256TagSize = 32;
 constexpr std::size_t kAesBlockSize = 16;
 
-// ByteString is std::vector<char>, so one overload covers both.
-std::span<const std::uint8_t> ByteSpan(const std::vector<char>& v) {
+// Covers ByteString (std::vector<char>) as well as spans into a frame.
+std::span<const std::uint8_t> ByteSpan(std::span<const char> v) {
   return {reinterpret_cast<const std::uint8_t*>(v.data()), v.size()};
 }
 
@@ -463,10 +464,22 @@ CoStatus ClientSecureChannel::OpenSecureChannel(
     // OPC UA Part 6 §6.7.5 key derivation:
     //   ClientKeys = P_SHA256(ServerNonce, ClientNonce)
     //   ServerKeys = P_SHA256(ClientNonce, ServerNonce)
-    client_keys_ = crypto::DeriveBasic256Sha256Keys(
-        ByteSpan(response.server_nonce), ByteSpan(client_nonce_));
-    server_keys_ = crypto::DeriveBasic256Sha256Keys(
-        ByteSpan(client_nonce_), ByteSpan(response.server_nonce));
+    auto client_crypto = crypto::SymmetricContext::Create(
+        crypto::DeriveBasic256Sha256Keys(ByteSpan(response.server_nonce),
+                                         ByteSpan(client_nonce_)),
+        crypto::SymmetricContext::Direction::Encrypt);
+    auto server_crypto = crypto::SymmetricContext::Create(
+        crypto::DeriveBasic256Sha256Keys(ByteSpan(client_nonce_),
+                                         ByteSpan(response.server_nonce)),
+        crypto::SymmetricContext::Direction::Decrypt);
+    if (!client_crypto.ok()) {
+      co_return client_crypto.status();
+    }
+    if (!server_crypto.ok()) {
+      co_return server_crypto.status();
+    }
+    client_crypto_ = std::move(*client_crypto);
+    server_crypto_ = std::move(*server_crypto);
   }
 
   opened_ = true;
@@ -476,99 +489,64 @@ CoStatus ClientSecureChannel::OpenSecureChannel(
 StatusOr<std::vector<char>>
 ClientSecureChannel::BuildSymmetricBasic256Sha256Frame(
     MessageType type,
+    char chunk_type,
     std::uint32_t request_id,
-    const std::vector<char>& body) {
-  // 1. Assemble the plaintext prefix (frame header, channel_id, sym header)
-  //    plus the plaintext payload [seq_header][body]. We'll re-encode once
-  //    padding+signature are known.
-  //
-  // Plaintext for encrypt: [seq_header 8B][body][padding][PaddingSize 1B]
-  // where padding ensures (payload + 1 + 32 sig) % 16 == 0.
-  std::vector<char> plaintext_payload;
-  {
-    Encoder enc{plaintext_payload};
-    enc.Encode(next_sequence_number_++);
-    enc.Encode(request_id);
+    std::span<const char> body) {
+  // Frame: [16-byte header][seq header][body][padding][PaddingSize][tag],
+  // where padding makes everything after the header a multiple of the AES
+  // block size. The frame is assembled once with its final message_size, so
+  // the HMAC covers header and plaintext where they lie and the cipher then
+  // runs over them in place.
+  const char* type_tag = nullptr;
+  switch (type) {
+    case MessageType::SecureMessage:
+      type_tag = "MSG";
+      break;
+    case MessageType::SecureClose:
+      type_tag = "CLO";
+      break;
+    default:
+      return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
   }
-  plaintext_payload.insert(plaintext_payload.end(), body.begin(), body.end());
 
+  constexpr std::size_t kHeaderSize = 16;
+  const std::size_t plaintext_size = 8 + body.size();
   const std::size_t pad_count =
       (kAesBlockSize -
-       (plaintext_payload.size() + 1 + kHmacSha256TagSize) % kAesBlockSize) %
+       (plaintext_size + 1 + kHmacSha256TagSize) % kAesBlockSize) %
       kAesBlockSize;
   if (pad_count > 255) {
     return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
   }
-  plaintext_payload.insert(plaintext_payload.end(), pad_count,
-                           static_cast<char>(pad_count));
-  plaintext_payload.push_back(static_cast<char>(pad_count));
+  const std::size_t signed_size = kHeaderSize + plaintext_size + pad_count + 1;
 
-  // 2. Build the header portion (8-byte frame header + channel_id + sym
-  //    header) so we can compute the signature over the whole plaintext
-  //    frame.
-  std::vector<char> header_portion;
+  std::vector<char> frame;
+  frame.reserve(signed_size + kHmacSha256TagSize);
+  frame.insert(frame.end(), type_tag, type_tag + 3);
+  frame.push_back(chunk_type);
+  frame.insert(frame.end(), 4, 0);
   {
-    // Frame header: 4-byte type tag + 4-byte message_size (fixed later).
-    const char* type_tag = nullptr;
-    switch (type) {
-      case MessageType::SecureMessage:
-        type_tag = "MSGF";
-        break;
-      case MessageType::SecureClose:
-        type_tag = "CLOF";
-        break;
-      default:
-        return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
-    }
-    header_portion.insert(header_portion.end(), type_tag, type_tag + 4);
-    const std::uint32_t placeholder_size = 0;
-    header_portion.insert(header_portion.end(),
-                          reinterpret_cast<const char*>(&placeholder_size),
-                          reinterpret_cast<const char*>(&placeholder_size) + 4);
-    Encoder enc{header_portion};
+    Encoder enc{frame};
     enc.Encode(channel_id_);
     enc.Encode(token_id_);
+    enc.Encode(next_sequence_number_++);
+    enc.Encode(request_id);
   }
+  frame.insert(frame.end(), body.begin(), body.end());
+  frame.insert(frame.end(), pad_count + 1, static_cast<char>(pad_count));
+  frame.resize(signed_size + kHmacSha256TagSize);
+  FixUpFrameSize(frame);
 
-  // 3. Pre-compute the final frame size so the HMAC covers the final
-  //    message_size field (AES-256-CBC with no padding preserves input
-  //    length, so cipher_size = plaintext_payload.size + sig_size).
-  const std::size_t cipher_size = plaintext_payload.size() + kHmacSha256TagSize;
-  const std::size_t predicted_final_size = header_portion.size() + cipher_size;
-  {
-    const auto size32 = static_cast<std::uint32_t>(predicted_final_size);
-    std::memcpy(header_portion.data() + 4, &size32, sizeof(size32));
-  }
-
-  // 4. Sign [header_portion + plaintext_payload] with the client's HMAC key.
-  std::vector<char> to_sign;
-  to_sign.reserve(header_portion.size() + plaintext_payload.size());
-  to_sign.insert(to_sign.end(), header_portion.begin(), header_portion.end());
-  to_sign.insert(to_sign.end(), plaintext_payload.begin(),
-                 plaintext_payload.end());
-  const auto signature =
-      crypto::HmacSha256(ByteSpan(client_keys_.signing_key), ByteSpan(to_sign));
-
-  // 4. Append signature to the plaintext payload, then encrypt.
-  std::vector<char> encrypted_input;
-  encrypted_input.reserve(plaintext_payload.size() + signature.size());
-  encrypted_input.insert(encrypted_input.end(), plaintext_payload.begin(),
-                         plaintext_payload.end());
-  encrypted_input.insert(encrypted_input.end(), signature.begin(),
-                         signature.end());
-  auto ciphertext = crypto::AesCbcEncrypt(
-      ByteSpan(client_keys_.encrypting_key),
-      ByteSpan(client_keys_.initialization_vector), ByteSpan(encrypted_input));
-  if (!ciphertext.ok()) {
-    return StatusOr<std::vector<char>>{ciphertext.status()};
+  // Sign with the client's HMAC key, then encrypt [plaintext][tag] in place.
+  auto* bytes = reinterpret_cast<std::uint8_t*>(frame.data());
+  const std::span<std::uint8_t> encrypted{bytes + kHeaderSize,
+                                          frame.size() - kHeaderSize};
+  if (!client_crypto_.Reset() ||
+      !client_crypto_.UpdateMac({bytes, signed_size}) ||
+      !client_crypto_.FinishMac(bytes + signed_size) ||
+      !client_crypto_.Cipher(encrypted, encrypted.data())) {
+    return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
   }
-
-  // 5. Final frame = header_portion + ciphertext; fix up message_size.
-  std::vector<char> frame;
-  frame.reserve(header_portion.size() + ciphertext->size());
-  frame.insert(frame.end(), header_portion.begin(), header_portion.end());
-  frame.insert(frame.end(), ciphertext->begin(), ciphertext->end());
-  FixUpFrameSize(frame);
   return StatusOr<std::vector<char>>{std::move(frame)};
 }
 
@@ -590,54 +568,52 @@ ClientSecureChannel::DecodeSymmetricBasic256Sha256Frame(
     return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
   }
 
-  // Decrypt the post-header bytes with the server's encrypting key.
-  std::span<const char> cipher_span{frame.data() + kHeaderSize,
-                                    frame.size() - kHeaderSize};
-  auto decrypted = crypto::AesCbcDecrypt(
-      ByteSpan(server_keys_.encrypting_key),
-      ByteSpan(server_keys_.initialization_vector),
-      {reinterpret_cast<const std::uint8_t*>(cipher_span.data()),
-       cipher_span.size()});
-  if (!decrypted.ok()) {
-    return StatusOr<ServiceResponse>{decrypted.status()};
+  // Decrypt with the server's key straight into the response body: the first
+  // block, which holds the sequence header, goes to the stack so every later
+  // block lands at its final offset and nothing is moved afterwards.
+  const auto ciphertext =
+      ByteSpan(std::span<const char>{frame}.subspan(kHeaderSize));
+  if (ciphertext.size() < kAesBlockSize + kHmacSha256TagSize ||
+      ciphertext.size() % kAesBlockSize != 0) {
+    return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
   }
-  if (decrypted->size() < kHmacSha256TagSize) {
+  std::array<std::uint8_t, kAesBlockSize> first_block;
+  ServiceResponse response;
+  response.body.resize(ciphertext.size() - 8);
+  auto* body_bytes = reinterpret_cast<std::uint8_t*>(response.body.data());
+  if (!server_crypto_.Reset() ||
+      !server_crypto_.Cipher(ciphertext.first(kAesBlockSize),
+                             first_block.data()) ||
+      !server_crypto_.Cipher(ciphertext.subspan(kAesBlockSize),
+                             body_bytes + 8)) {
     return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
   }
-
-  // Last 32 bytes = HMAC signature; verify over [header +
-  // plaintext_before_sig].
-  const auto sig_begin = decrypted->size() - kHmacSha256TagSize;
-  std::vector<char> signed_region;
-  signed_region.reserve(kHeaderSize + sig_begin);
-  signed_region.insert(signed_region.end(), frame.begin(),
-                       frame.begin() + kHeaderSize);
-  signed_region.insert(signed_region.end(), decrypted->begin(),
-                       decrypted->begin() + sig_begin);
-  const auto expected_tag = crypto::HmacSha256(
-      ByteSpan(server_keys_.signing_key), ByteSpan(signed_region));
-  if (expected_tag.size() != kHmacSha256TagSize ||
-      std::memcmp(expected_tag.data(), decrypted->data() + sig_begin,
+  std::memcpy(body_bytes, first_block.data() + 8, 8);
+
+  // The last 32 plaintext bytes are the HMAC over [header + plaintext before
+  // it]. Offsets below are into the plaintext, which starts 8 bytes before
+  // the body.
+  const auto sig_begin = ciphertext.size() - kHmacSha256TagSize;
+  std::array<std::uint8_t, kHmacSha256TagSize> expected_tag;
+  if (!server_crypto_.UpdateMac(ByteSpan({frame.data(), kHeaderSize})) ||
+      !server_crypto_.UpdateMac(first_block) ||
+      !server_crypto_.UpdateMac({body_bytes + 8, sig_begin - kAesBlockSize}) ||
+      !server_crypto_.FinishMac(expected_tag.data()) ||
+      std::memcmp(expected_tag.data(), body_bytes + sig_begin - 8,
                   kHmacSha256TagSize) != 0) {
     return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
   }
 
   // Strip padding: last byte before sig is PaddingSize.
-  const auto pad_size = static_cast<std::uint8_t>((*decrypted)[sig_begin - 1]);
+  const auto pad_size = body_bytes[sig_begin - 8 - 1];
   if (sig_begin < static_cast<std::size_t>(1 + pad_size) + 8) {
     return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
   }
   const auto body_end = sig_begin - 1 - pad_size;
 
-  // First 8 bytes of decrypted = seq_header (sequence_number + request_id).
-  std::uint32_t sequence_number = 0;
-  std::uint32_t request_id = 0;
-  std::memcpy(&sequence_number, decrypted->data(), 4);
-  std::memcpy(&request_id, decrypted->data() + 4, 4);
-
-  ServiceResponse response;
-  response.request_id = request_id;
-  response.body.assign(decrypted->begin() + 8, decrypted->begin() + body_end);
+  // First 8 plaintext bytes = seq_header (sequence_number + request_id).
+  std::memcpy(&response.request_id, first_block.data() + 4, 4);
+  response.body.resize(body_end - 8);
   return StatusOr<ServiceResponse>{std::move(response)};
 }
 
@@ -653,28 +629,46 @@ CoStatus ClientSecureChannel::SendServiceRequest(
   // transport readers steal each other's frames. ClientChannel drives
   // ShouldRenew/RenewIfNeeded from its send path only while no responses are
   // pending.
-  if (UsesSignAndEncrypt()) {
-    auto framed = BuildSymmetricBasic256Sha256Frame(MessageType::SecureMessage,
-                                                    request_id, body);
+  // Split to what the server accepts, as announced in its Acknowledge (OPC UA
+  // Part 6 §6.7.2). Chunks are framed one at a time, right before each write.
+  const auto& acknowledge = transport_.acknowledge();
+  const ChunkLimits limits{
+      .buffer_size = acknowledge.receive_buffer_size,
+      .max_message_size = acknowledge.max_message_size,
+      .max_chunk_count = acknowledge.max_chunk_count,
+  };
+  const auto chunk_body_size =
+      ChunkBodySize(body.size(), limits, UsesSignAndEncrypt());
+  if (!chunk_body_size.has_value()) {
+    co_return Status{StatusCode::Bad_RequestTooLarge};
+  }
+
+  std::span<const char> remaining{body};
+  do {
+    const auto slice =
+        remaining.first(std::min(*chunk_body_size, remaining.size()));
+    remaining = remaining.subspan(slice.size());
+    const char chunk_type = remaining.empty() ? 'F' : 'C';
+    auto framed =
+        UsesSignAndEncrypt()
+            ? BuildSymmetricBasic256Sha256Frame(MessageType::SecureMessage,
+                                                chunk_type, request_id, slice)
+            : StatusOr<std::vector<char>>{EncodeSymmetricMessageChunk(
+                  {.message_type = MessageType::SecureMessage,
+                   .chunk_type = chunk_type},
+                  channel_id_, token_id_,
+                  {.sequence_number = next_sequence_number_++,
+                   .request_id = request_id},
+                  slice)};
     if (!framed.ok()) {
       co_return framed.status();
     }
-    co_return co_await transport_.WriteFrame(*framed);
-  }
-  const SecureConversationMessage message{
-      .frame_header = {.message_type = MessageType::SecureMessage,
-                       .chunk_type = 'F',
-                       .message_size = 0},
-      .secure_channel_id = channel_id_,
-      .asymmetric_security_header = std::nullopt,
-      .symmetric_security_header =
-          SymmetricSecurityHeader{.token_id = token_id_},
-      .sequence_header = {.sequence_number = next_sequence_number_++,
-                          .request_id = request_id},
-      .body = body,
-  };
-  co_return co_await transport_.WriteFrame(
-      EncodeSecureConversationMessage(message));
+    const auto status = co_await transport_.WriteFrame(*framed);
+    if (status.bad()) {
+      co_return status;
+    }
+  } while (!remaining.empty());
+  co_return Status{StatusCode::Good};
 }
 
 StatusOr<ClientSecureChannel::ServiceResponse>
@@ -708,6 +702,7 @@ ClientSecureChannel::ReadServiceResponse() {
   // message. The caps bound memory against a malformed or hostile server.
   constexpr char kIntermediateChunk = 'C';
   constexpr char kFinalChunk = 'F';
+  constexpr char kAbortChunk = 'A';
   constexpr std::size_t kMaxResponseChunks = 8192;
   constexpr std::size_t kMaxResponseBytes = 64u * 1024 * 1024;
 
@@ -727,8 +722,21 @@ ClientSecureChannel::ReadServiceResponse() {
       co_return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
     }
     const char chunk_type = (*frame)[3];
+    if (chunk_type == kAbortChunk) {
+      // The server gave up on the message, e.g. with Bad_ResponseTooLarge. The
+      // abort body is its Error code and Reason; surface the code.
+      auto chunk = DecodeServiceMessageChunk(*frame);
+      std::uint32_t error = 0;
+      if (chunk.ok()) {
+        Decoder decoder{chunk->body};
+        if (decoder.Decode(error) && Status::FromFullCode(error).bad()) {
+          co_return StatusOr<ServiceResponse>{Status::FromFullCode(error)};
+        }
+      }
+      co_return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
+    }
     if (chunk_type != kIntermediateChunk && chunk_type != kFinalChunk) {
-      // 'A' (abort) or an unknown chunk type: discard the whole message.
+      // An unknown chunk type: discard the whole message.
       co_return StatusOr<ServiceResponse>{Status{StatusCode::Bad}};
     }
 
@@ -762,7 +770,7 @@ CoStatus ClientSecureChannel::Close() {
   Status status{StatusCode::Good};
   if (UsesSignAndEncrypt()) {
     auto framed = BuildSymmetricBasic256Sha256Frame(MessageType::SecureClose,
-                                                    request_id, body);
+                                                    'F', request_id, body);
     if (framed.ok()) {
       status = co_await transport_.WriteFrame(*framed);
     } else {
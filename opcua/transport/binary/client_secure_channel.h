@@ -62,9 +62,11 @@ class ClientSecureChannel {
   // revised lifetime while preserving the logical channel.
   [[nodiscard]] CoStatus Renew(std::uint32_t requested_lifetime_ms = 60000);
 
-  // Wraps `body` into a symmetric SecureMessage frame and writes it to the
-  // transport. `request_id` uniquely identifies the in-flight request for
-  // the client channel's correlation table.
+  // Wraps `body` into symmetric SecureMessage chunks no larger than the
+  // server's receive buffer and writes them to the transport. `request_id`
+  // uniquely identifies the in-flight request for the client channel's
+  // correlation table. A body beyond the server's MaxMessageSize or
+  // MaxChunkCount is not sent: Bad_RequestTooLarge.
   [[nodiscard]] CoStatus SendServiceRequest(std::uint32_t request_id,
                                             const std::vector<char>& body);
 
@@ -150,11 +152,13 @@ class ClientSecureChannel {
   [[nodiscard]] StatusOr<AsymmetricDecodedResponse>
   DecodeAsymmetricBasic256Sha256OpenFrame(const std::vector<char>& frame);
 
-  // Symmetric SignAndEncrypt (MSG / CLO) framing helpers.
+  // Symmetric SignAndEncrypt (MSG / CLO) framing helpers. Each MessageChunk
+  // is signed and encrypted on its own.
   [[nodiscard]] StatusOr<std::vector<char>> BuildSymmetricBasic256Sha256Frame(
       MessageType type,
+      char chunk_type,
       std::uint32_t request_id,
-      const std::vector<char>& body);
+      std::span<const char> body);
   [[nodiscard]] StatusOr<ServiceResponse> DecodeSymmetricBasic256Sha256Frame(
       const std::vector<char>& frame);
 
@@ -175,11 +179,11 @@ class ClientSecureChannel {
   std::uint32_t next_sequence_number_ = 1;
   std::uint32_t next_request_id_ = 1;
 
-  // Derived symmetric keys (Basic256Sha256 only). client_* are used to
-  // encrypt/sign outbound messages; server_* are used to verify/decrypt
-  // inbound messages.
-  crypto::DerivedKeys client_keys_;
-  crypto::DerivedKeys server_keys_;
+  // Symmetric contexts keyed from the derived keys (Basic256Sha256 only),
+  // rebuilt at Open and every Renew. client_* encrypts/signs outbound
+  // messages; server_* verifies/decrypts inbound messages.
+  crypto::SymmetricContext client_crypto_;
+  crypto::SymmetricContext server_crypto_;
   ByteString client_nonce_;
 };
 
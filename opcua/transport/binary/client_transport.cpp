@@ -5,24 +5,14 @@
 #include <utility>
 
 namespace opcua::binary {
-namespace {
-
-std::vector<char> SubspanToVector(const std::vector<char>& bytes,
-                                  std::size_t offset,
-                                  std::size_t size) {
-  return {bytes.begin() + static_cast<std::ptrdiff_t>(offset),
-          bytes.begin() + static_cast<std::ptrdiff_t>(offset + size)};
-}
-
-}  // namespace
 
 ClientTransport::ClientTransport(ClientTransportContext&& context)
     : transport_{std::move(context.transport)},
       endpoint_url_{std::move(context.endpoint_url)},
       limits_{context.limits},
-      read_buffer_size_{context.read_buffer_size},
       max_frame_size_{context.max_frame_size},
-      write_queue_{transport_} {}
+      write_queue_{transport_},
+      buffer_{context.read_buffer_size} {}
 
 CoStatus ClientTransport::Connect() {
   auto open_result = co_await transport_.open();
@@ -80,33 +70,29 @@ CoStatus ClientTransport::Connect() {
 }
 
 CoStatusOr<std::vector<char>> ClientTransport::ReadFrame() {
-  std::vector<char> read_buffer(read_buffer_size_);
   for (;;) {
-    if (pending_bytes_.size() >= 8) {
-      const auto header = DecodeFrameHeader(std::vector<char>{
-          pending_bytes_.begin(), pending_bytes_.begin() + 8});
+    if (buffer_.size() >= 8) {
+      const auto header = DecodeFrameHeader(buffer_.data().first(8));
       if (!header.has_value() || header->message_size < 8 ||
           header->message_size > max_frame_size_) {
         co_return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
       }
-      if (pending_bytes_.size() >= header->message_size) {
-        auto frame = SubspanToVector(pending_bytes_, 0, header->message_size);
-        pending_bytes_.erase(
-            pending_bytes_.begin(),
-            pending_bytes_.begin() +
-                static_cast<std::ptrdiff_t>(header->message_size));
+      if (buffer_.size() >= header->message_size) {
+        // The one copy a frame takes on this side: callers keep it across
+        // further reads, which reuse the buffer.
+        const auto bytes = buffer_.data().first(header->message_size);
+        std::vector<char> frame{bytes.begin(), bytes.end()};
+        buffer_.Consume(header->message_size);
         co_return StatusOr<std::vector<char>>{std::move(frame)};
       }
     }
 
-    auto read_result = co_await transport_.read(read_buffer);
+    auto read_result = co_await transport_.read(buffer_.PrepareRead());
     if (!read_result.ok() || *read_result == 0) {
       co_return StatusOr<std::vector<char>>{
           Status{StatusCode::Bad_NoCommunication}};
     }
-    pending_bytes_.insert(
-        pending_bytes_.end(), read_buffer.begin(),
-        read_buffer.begin() + static_cast<std::ptrdiff_t>(*read_result));
+    buffer_.CommitRead(*read_result);
   }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "opcua/base/awaitable.h"
+#include "opcua/transport/binary/frame_buffer.h"
 #include "opcua/transport/binary/protocol.h"
 #include "opcua/types/co_result.h"
 #include "opcua/types/status.h"
@@ -50,13 +51,12 @@ class ClientTransport {
   transport::any_transport transport_;
   const std::string endpoint_url_;
   const TransportLimits limits_;
-  const std::size_t read_buffer_size_;
   const std::size_t max_frame_size_;
   transport::WriteQueue write_queue_;
 
   bool open_ = false;
   AcknowledgeMessage acknowledge_{};
-  std::vector<char> pending_bytes_;
+  FrameBuffer buffer_;
 };
 
 }  // namespace opcua::binary
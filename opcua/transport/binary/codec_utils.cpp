@@ -3,6 +3,7 @@
 #include "opcua/base/utf_convert.h"
 
 #include <cstring>
+#include <memory>
 
 namespace opcua::binary {
 namespace {
@@ -54,10 +55,32 @@ namespace {
 using SharedDataValue = std::shared_ptr<const DataValue>;
 using SharedVariant = std::shared_ptr<const Variant>;
 
+// The unencoded body of an ExtensionObject built by ToInPlaceExtensionObject,
+// or nullptr.
+const ExtensionObjectBody* InPlaceBody(const ExtensionObject& value) {
+  const auto* body =
+      std::any_cast<std::shared_ptr<const ExtensionObjectBody>>(&value.value());
+  return body != nullptr ? body->get() : nullptr;
+}
+
 void AppendExtensionObjectValue(Encoder& encoder,
                                 const ExtensionObject& value) {
-  const ByteString* body = value.binary_body();
   encoder.Encode(value.data_type_id());
+  // An unencoded body goes straight into the output behind a length prefix
+  // that is filled in once the body's actual size is known.
+  if (const auto* in_place = InPlaceBody(value)) {
+    encoder.Encode(std::uint8_t{0x01});
+    const std::size_t length_offset = encoder.bytes().size();
+    encoder.Extend(sizeof(std::int32_t));
+    in_place->Encode(encoder);
+    const std::size_t length =
+        encoder.bytes().size() - length_offset - sizeof(std::int32_t);
+    detail::StoreLittleEndian(encoder.bytes().data() + length_offset,
+                              static_cast<std::int32_t>(length));
+    return;
+  }
+
+  const ByteString* body = value.binary_body();
   // OPC UA Part 6 §5.2.2.15: encoding byte 0x00 means "no body" and is NOT
   // followed by a length; 0x01 means a ByteString body follows. An
   // ExtensionObject with no value (the default) has no body, so it must encode
@@ -107,6 +130,24 @@ void AppendArray(Encoder& encoder,
   }
 }
 
+// Forward declaration: the element codecs below are specialized per type.
+template <class T>
+void EncodeElement(Encoder& encoder, const T& value);
+
+// The elements of a Variant array. Numbers and DateTimes take the Encoder's
+// block path — a historian's array of 100k Doubles is one resize and one
+// memcpy rather than 800k push_backs; everything else goes element by element.
+template <class T>
+void AppendVariantArray(Encoder& encoder, const std::vector<T>& values) {
+  if constexpr (BulkEncodable<T> || std::is_same_v<T, DateTime>) {
+    encoder.EncodeArray(std::span<const T>{values});
+  } else {
+    AppendArray(encoder, values, [&](const T& element) {
+      EncodeElement<T>(encoder, element);
+    });
+  }
+}
+
 // Safety cap on the element count of a Null (EMPTY) Variant array, whose
 // elements occupy no wire bytes and so cannot be bounded by the remaining
 // buffer. Guards against an allocation decode bomb.
@@ -219,28 +260,230 @@ bool DecodeElement(Decoder& decoder, SharedVariant& value) {
   return true;
 }
 
+// Sizes of the Variant elements, mirroring EncodeElement.
+template <class T>
+std::size_t ElementSize(const T& value) {
+  return EncodedSize(value);
+}
+
+template <>
+std::size_t ElementSize(const SharedDataValue& value) {
+  return EncodedSize(value ? *value : DataValue{});
+}
+
+template <>
+std::size_t ElementSize(const SharedVariant& value) {
+  return EncodedSize(value ? *value : Variant{});
+}
+
+template <class T>
+std::size_t VariantArraySize(const std::vector<T>& values) {
+  std::size_t size = sizeof(std::int32_t);
+  if constexpr (BulkEncodable<T> || std::is_same_v<T, bool>) {
+    size += values.size() * sizeof(T);
+  } else if constexpr (std::is_same_v<T, DateTime>) {
+    size += values.size() * sizeof(std::int64_t);
+  } else {
+    for (const auto& value : values)
+      size += ElementSize<T>(value);
+  }
+  return size;
+}
+
+// The UTF-8 length of `text` as UtfConvert produces it: a surrogate pair is
+// one four-byte character and an unpaired surrogate is dropped.
+std::size_t Utf8Length(std::u16string_view text) {
+  std::size_t length = 0;
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    const char16_t unit = text[i];
+    if (unit < 0x80) {
+      length += 1;
+    } else if (unit < 0x800) {
+      length += 2;
+    } else if (unit >= 0xD800 && unit <= 0xDBFF) {
+      if (i + 1 < text.size() && text[i + 1] >= 0xDC00 &&
+          text[i + 1] <= 0xDFFF) {
+        length += 4;
+        ++i;
+      }
+    } else if (unit < 0xDC00 || unit > 0xDFFF) {
+      length += 3;
+    }
+  }
+  return length;
+}
+
+// The identifier part of a NodeId after its encoding byte, for the encoding
+// Encoder::Encode(NodeId) picks.
+std::size_t NodeIdBodySize(const NodeId& node_id) {
+  if (node_id.is_numeric() && node_id.namespace_index() == 0 &&
+      node_id.numeric_id() <= 0xff) {
+    return 1;
+  }
+  if (node_id.is_numeric() && node_id.namespace_index() <= 0xff &&
+      node_id.numeric_id() <= 0xffff) {
+    return 3;
+  }
+  if (node_id.is_numeric())
+    return 6;
+  if (node_id.is_string())
+    return 2 + EncodedSize(node_id.string_id());
+  if (node_id.is_guid())
+    return 2 + EncodedSize(node_id.guid_id());
+  return 2 + EncodedSize(node_id.opaque_id());
+}
+
 }  // namespace
 
+std::size_t EncodedSize(std::string_view value) {
+  return sizeof(std::int32_t) + value.size();
+}
+
+std::size_t EncodedSize(const String& value) {
+  return EncodedSize(std::string_view{value});
+}
+
+std::size_t EncodedSize(const QualifiedName& value) {
+  return sizeof(std::uint16_t) + EncodedSize(value.name());
+}
+
+std::size_t EncodedSize(const LocalizedText& value) {
+  std::size_t size = 1;
+  if (!value.locale.empty())
+    size += EncodedSize(value.locale);
+  if (!value.text.empty())
+    size += sizeof(std::int32_t) + Utf8Length(value.text);
+  return size;
+}
+
+std::size_t EncodedSize(DateTime) {
+  return sizeof(std::int64_t);
+}
+
+std::size_t EncodedSize(const Guid&) {
+  return 16;
+}
+
+std::size_t EncodedSize(const ByteString& value) {
+  return sizeof(std::int32_t) + value.size();
+}
+
+std::size_t EncodedSize(const XmlElement& value) {
+  return EncodedSize(std::string_view{value.value});
+}
+
+std::size_t EncodedSize(const NodeId& node_id) {
+  return 1 + NodeIdBodySize(node_id);
+}
+
+std::size_t EncodedSize(const ExpandedNodeId& node_id) {
+  // Encoder::Encode(ExpandedNodeId) has no Guid form and writes the opaque
+  // one instead.
+  const NodeId& id = node_id.node_id();
+  std::size_t size = 1 + (id.is_guid() ? 2 + EncodedSize(id.opaque_id())
+                                        : NodeIdBodySize(id));
+  if (!node_id.namespace_uri().empty())
+    size += EncodedSize(node_id.namespace_uri());
+  if (node_id.server_index() != 0)
+    size += EncodedSize(node_id.server_index());
+  return size;
+}
+
+std::size_t EncodedSize(Status) {
+  return sizeof(std::uint32_t);
+}
+
+std::size_t EncodedSize(const DiagnosticInfo& value) {
+  std::size_t size = 1;
+  if (value.symbolic_id.has_value())
+    size += EncodedSize(*value.symbolic_id);
+  if (value.namespace_uri.has_value())
+    size += EncodedSize(*value.namespace_uri);
+  if (value.locale.has_value())
+    size += EncodedSize(*value.locale);
+  if (value.localized_text.has_value())
+    size += EncodedSize(*value.localized_text);
+  if (value.additional_info.has_value())
+    size += EncodedSize(*value.additional_info);
+  if (value.inner_status_code.has_value())
+    size += EncodedSize(*value.inner_status_code);
+  if (value.inner_diagnostic_info != nullptr)
+    size += EncodedSize(*value.inner_diagnostic_info);
+  return size;
+}
+
+std::size_t EncodedSize(const DataValue& value) {
+  std::size_t size = 1;
+  if (!value.value.is_null())
+    size += EncodedSize(value.value);
+  if (!IsGood(value.status_code))
+    size += EncodedSize(Status{value.status_code});
+  if (!value.source_timestamp.is_null())
+    size += EncodedSize(value.source_timestamp);
+  if (!value.server_timestamp.is_null())
+    size += EncodedSize(value.server_timestamp);
+  return size;
+}
+
+std::size_t EncodedSize(const Variant& value) {
+  if (value.is_array()) {
+    switch (value.type()) {
+      case Variant::EMPTY:
+        return 1 + sizeof(std::int32_t);
+#define OPCUA_ARRAY_SIZE(NAME, SCALAR, ELEMENT) \
+  case Variant::NAME:                           \
+    return 1 + VariantArraySize(value.get<std::vector<ELEMENT>>());
+        OPCUA_VARIANT_BUILT_IN_TYPES(OPCUA_ARRAY_SIZE)
+#undef OPCUA_ARRAY_SIZE
+      case Variant::COUNT:
+        return 1 + sizeof(std::int32_t);
+    }
+    return 1;
+  }
+
+  switch (value.type()) {
+    case Variant::EMPTY:
+      return 1;
+#define OPCUA_SCALAR_SIZE(NAME, SCALAR, ELEMENT) \
+  case Variant::NAME:                            \
+    return 1 + ElementSize<SCALAR>(value.get<SCALAR>());
+    OPCUA_VARIANT_BUILT_IN_TYPES(OPCUA_SCALAR_SIZE)
+#undef OPCUA_SCALAR_SIZE
+    case Variant::COUNT:
+      return 1;
+  }
+  return 1;
+}
+
+std::size_t EncodedSize(const ExtensionObject& value) {
+  std::size_t size = EncodedSize(value.data_type_id()) + 1;
+  if (const auto* in_place = InPlaceBody(value))
+    return size + sizeof(std::int32_t) + in_place->EncodedSize();
+  if (const ByteString* body = value.binary_body())
+    return size + EncodedSize(*body);
+  return size;
+}
+
+char* Encoder::Extend(std::size_t count) {
+  const std::size_t offset = bytes_.size();
+  bytes_.resize(offset + count);
+  return bytes_.data() + offset;
+}
+
 void Encoder::Encode(std::uint8_t value) {
   bytes_.push_back(static_cast<char>(value));
 }
 
 void Encoder::Encode(std::uint16_t value) {
-  bytes_.push_back(static_cast<char>(value & 0xff));
-  bytes_.push_back(static_cast<char>((value >> 8) & 0xff));
+  detail::StoreLittleEndian(Extend(sizeof(value)), value);
 }
 
 void Encoder::Encode(std::uint32_t value) {
-  bytes_.push_back(static_cast<char>(value & 0xff));
-  bytes_.push_back(static_cast<char>((value >> 8) & 0xff));
-  bytes_.push_back(static_cast<char>((value >> 16) & 0xff));
-  bytes_.push_back(static_cast<char>((value >> 24) & 0xff));
+  detail::StoreLittleEndian(Extend(sizeof(value)), value);
 }
 
 void Encoder::Encode(std::uint64_t value) {
-  for (int i = 0; i < 8; ++i) {
-    bytes_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
-  }
+  detail::StoreLittleEndian(Extend(sizeof(value)), value);
 }
 
 void Encoder::Encode(bool value) {
@@ -256,13 +499,11 @@ void Encoder::Encode(std::int64_t value) {
 }
 
 void Encoder::Encode(float value) {
-  const auto* raw = reinterpret_cast<const char*>(&value);
-  bytes_.insert(bytes_.end(), raw, raw + sizeof(value));
+  detail::StoreLittleEndian(Extend(sizeof(value)), value);
 }
 
 void Encoder::Encode(double value) {
-  const auto* raw = reinterpret_cast<const char*>(&value);
-  bytes_.insert(bytes_.end(), raw, raw + sizeof(value));
+  detail::StoreLittleEndian(Extend(sizeof(value)), value);
 }
 
 void Encoder::Encode(std::string_view value) {
@@ -300,6 +541,17 @@ void Encoder::Encode(DateTime value) {
   Encode(value.ToInternalValue());
 }
 
+void Encoder::EncodeArray(std::span<const DateTime> values) {
+  // DateTime is a class over its Int64 tick count, so it is written value by
+  // value, but still into one pre-sized block.
+  Encode(static_cast<std::int32_t>(values.size()));
+  char* out = Extend(values.size() * sizeof(std::int64_t));
+  for (const DateTime value : values) {
+    detail::StoreLittleEndian(out, value.ToInternalValue());
+    out += sizeof(std::int64_t);
+  }
+}
+
 void Encoder::Encode(const Guid& value) {
   // OPC UA Part 6 §5.2.2.6 Guid: Data1/Data2/Data3 as little-endian integers
   // followed by Data4's eight bytes in order,
@@ -500,12 +752,9 @@ void Encoder::Encode(const Variant& value) {
         Encode(static_cast<std::int32_t>(
             value.get<std::vector<std::monostate>>().size()));
         return;
-#define OPCUA_ENCODE_ARRAY(NAME, SCALAR, ELEMENT)         \
-  case Variant::NAME:                                     \
-    AppendArray(*this, value.get<std::vector<ELEMENT>>(), \
-                [&](const ELEMENT& element) {             \
-                  EncodeElement<ELEMENT>(*this, element); \
-                });                                       \
+#define OPCUA_ENCODE_ARRAY(NAME, SCALAR, ELEMENT)              \
+  case Variant::NAME:                                          \
+    AppendVariantArray(*this, value.get<std::vector<ELEMENT>>()); \
     return;
         OPCUA_VARIANT_BUILT_IN_TYPES(OPCUA_ENCODE_ARRAY)
 #undef OPCUA_ENCODE_ARRAY
@@ -12,11 +12,15 @@
 #include "opcua/types/variant.h"
 #include "opcua/types/xml_element.h"
 
+#include <bit>
+#include <concepts>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace opcua::binary {
@@ -32,9 +36,44 @@ struct DecodedExtensionObject {
   std::vector<char> body;
 };
 
+namespace detail {
+
+// Writes `value` at `out` in little-endian byte order, whatever the host's.
+template <class T>
+void StoreLittleEndian(char* out, T value) {
+  using Raw = std::conditional_t<
+      sizeof(T) == 1, std::uint8_t,
+      std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                         std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                                            std::uint64_t>>>;
+  auto raw = std::bit_cast<Raw>(value);
+  if constexpr (std::endian::native == std::endian::big)
+    raw = std::byteswap(raw);
+  std::memcpy(out, &raw, sizeof(raw));
+}
+
+}  // namespace detail
+
+// Fixed-size numbers whose wire form is their little-endian in-memory form
+// (OPC UA Part 6 §5.2.2 Built-in Types), so an array of them can be written as
+// one block. bool is excluded: std::vector<bool> has no contiguous storage.
+template <class T>
+concept BulkEncodable =
+    std::is_arithmetic_v<T> && !std::same_as<T, bool> && sizeof(T) <= 8;
+
 class Encoder {
  public:
   explicit Encoder(std::vector<char>& bytes) : bytes_{bytes} {}
+  // Reserves room for `size_hint` more bytes up front, for a caller that can
+  // estimate what it is about to write.
+  Encoder(std::vector<char>& bytes, std::size_t size_hint) : bytes_{bytes} {
+    bytes_.reserve(bytes_.size() + size_hint);
+  }
+
+  // Grows the output by `count` bytes and returns a cursor to them, for a
+  // caller writing a run of fixed-size values in one go rather than a
+  // push_back per byte.
+  char* Extend(std::size_t count);
 
   void Encode(std::uint8_t value);
   void Encode(std::uint16_t value);
@@ -67,6 +106,13 @@ class Encoder {
   void Encode(const ExtensionObject& value);
   void Encode(const EncodedExtensionObject& value);
 
+  // An Int32 element count followed by the elements (OPC UA Part 6 §5.2.5
+  // Arrays), written as a single block: one resize, then one memcpy on a
+  // little-endian host.
+  template <BulkEncodable T>
+  void EncodeArray(std::span<const T> values);
+  void EncodeArray(std::span<const DateTime> values);
+
   std::vector<char>& bytes() { return bytes_; }
 
  private:
@@ -118,6 +164,61 @@ class Decoder {
   std::size_t offset_ = 0;
 };
 
+// A structured value an ExtensionObject carries unencoded, held in its body as
+// a `std::shared_ptr<const ExtensionObjectBody>`. The Encoder writes it
+// straight into the enclosing message and backpatches the length prefix, so
+// the body is neither encoded into a ByteString of its own nor copied. See
+// ToInPlaceExtensionObject in opcua/ua/ua_binary_codec.h.
+class ExtensionObjectBody {
+ public:
+  virtual ~ExtensionObjectBody() = default;
+
+  // The bytes Encode writes; used to reserve the output, not trusted for the
+  // length prefix.
+  virtual std::size_t EncodedSize() const = 0;
+  virtual void Encode(Encoder& encoder) const = 0;
+};
+
+// The number of bytes Encoder::Encode writes for a value, so that a message
+// can be encoded into a buffer reserved once at its final size. The generated
+// EncodedSize overloads (opcua/ua/ua_binary_codec.h) bottom out in these.
+template <class T>
+  requires std::is_arithmetic_v<T>
+constexpr std::size_t EncodedSize(T) {
+  return sizeof(T);
+}
+std::size_t EncodedSize(std::string_view value);
+std::size_t EncodedSize(const String& value);
+std::size_t EncodedSize(const QualifiedName& value);
+std::size_t EncodedSize(const LocalizedText& value);
+std::size_t EncodedSize(DateTime value);
+std::size_t EncodedSize(const Guid& value);
+std::size_t EncodedSize(const ByteString& value);
+std::size_t EncodedSize(const XmlElement& value);
+std::size_t EncodedSize(const NodeId& node_id);
+std::size_t EncodedSize(const ExpandedNodeId& node_id);
+std::size_t EncodedSize(Status value);
+std::size_t EncodedSize(const DiagnosticInfo& value);
+std::size_t EncodedSize(const DataValue& value);
+std::size_t EncodedSize(const Variant& value);
+std::size_t EncodedSize(const ExtensionObject& value);
+
+template <BulkEncodable T>
+void Encoder::EncodeArray(std::span<const T> values) {
+  Encode(static_cast<std::int32_t>(values.size()));
+  if (values.empty())
+    return;
+  char* out = Extend(values.size_bytes());
+  if constexpr (std::endian::native == std::endian::little) {
+    std::memcpy(out, values.data(), values.size_bytes());
+  } else {
+    for (const T value : values) {
+      detail::StoreLittleEndian(out, value);
+      out += sizeof(T);
+    }
+  }
+}
+
 void AppendMessage(Encoder& encoder,
                    std::uint32_t type_id,
                    std::span<const char> payload);
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 
 #include <gtest/gtest.h>
 
@@ -457,6 +458,58 @@ TEST(CodecUtilsTest, RoundTripsVariants) {
   EXPECT_TRUE(decoder.consumed());
 }
 
+TEST(CodecUtilsTest, EncodesNumericArraysAsLittleEndianBlocks) {
+  std::vector<char> bytes;
+  Encoder encoder{bytes};
+  encoder.Encode(
+      opcua::Variant{std::vector<opcua::Int16>{0x0102, -2}});
+  encoder.Encode(opcua::Variant{std::vector<opcua::Double>{1.0}});
+
+  // Int16 array: mask, Int32 count, then the elements back to back.
+  const std::vector<char> expected{
+      static_cast<char>(0x80 | 4), 2, 0, 0, 0,  //
+      0x02, 0x01, static_cast<char>(0xfe), static_cast<char>(0xff),
+      // Double array holding 1.0 (0x3ff0000000000000).
+      static_cast<char>(0x80 | 11), 1, 0, 0, 0,  //
+      0, 0, 0, 0, 0, 0, static_cast<char>(0xf0), 0x3f};
+  EXPECT_EQ(bytes, expected);
+}
+
+TEST(CodecUtilsTest, RoundTripsLargeNumericArrays) {
+  std::vector<opcua::Double> doubles(100000);
+  std::vector<opcua::UInt64> integers(doubles.size());
+  std::vector<opcua::DateTime> times;
+  for (std::size_t i = 0; i < doubles.size(); ++i) {
+    doubles[i] = static_cast<double>(i) * 0.25 - 1000;
+    integers[i] = 0x0102030405060708ULL * i;
+  }
+  for (int i = 0; i < 16; ++i) {
+    times.push_back(opcua::DateTime::FromDeltaSinceWindowsEpoch(
+        opcua::Duration::FromMicroseconds(1000000LL * i + 7)));
+  }
+
+  std::vector<char> bytes;
+  // Two arrays of 8-byte elements, each behind a mask and a count.
+  Encoder encoder{bytes, doubles.size() * 16 + 2 * 5};
+  const auto* reserved = bytes.data();
+  encoder.Encode(opcua::Variant{doubles});
+  encoder.Encode(opcua::Variant{integers});
+  EXPECT_EQ(bytes.data(), reserved);
+  encoder.Encode(opcua::Variant{times});
+
+  Decoder decoder{bytes};
+  opcua::Variant decoded_doubles;
+  opcua::Variant decoded_integers;
+  opcua::Variant decoded_times;
+  ASSERT_TRUE(decoder.Decode(decoded_doubles));
+  ASSERT_TRUE(decoder.Decode(decoded_integers));
+  ASSERT_TRUE(decoder.Decode(decoded_times));
+  EXPECT_TRUE(decoder.consumed());
+  EXPECT_EQ(decoded_doubles.get<std::vector<opcua::Double>>(), doubles);
+  EXPECT_EQ(decoded_integers.get<std::vector<opcua::UInt64>>(), integers);
+  EXPECT_EQ(decoded_times.get<std::vector<opcua::DateTime>>(), times);
+}
+
 TEST(CodecUtilsTest, RejectsTruncatedPayloads) {
   std::vector<char> truncated_string;
   Encoder truncated_encoder{truncated_string};
@@ -657,6 +710,81 @@ TEST(CodecUtilsTest, RoundTripsDataValueAndNestedVariant) {
   EXPECT_TRUE(decoder.consumed());
 }
 
+// Encodes `value` and checks EncodedSize predicted the byte count.
+template <class T>
+void ExpectEncodedSizeMatches(const T& value) {
+  std::vector<char> bytes;
+  Encoder encoder{bytes};
+  encoder.Encode(value);
+  EXPECT_EQ(EncodedSize(value), bytes.size());
+}
+
+TEST(CodecUtilsTest, EncodedSizeMatchesTheEncodedBytes) {
+  ExpectEncodedSizeMatches(String{"caf\xc3\xa9"});
+  ExpectEncodedSizeMatches(ByteString{});
+  ExpectEncodedSizeMatches(opcua::LocalizedText{u"\u00e9t\U0001f600"});
+  ExpectEncodedSizeMatches(opcua::NodeId{7, 0});
+  ExpectEncodedSizeMatches(opcua::NodeId{70000, 3});
+  ExpectEncodedSizeMatches(opcua::NodeId{"name", 2});
+  ExpectEncodedSizeMatches(opcua::ExpandedNodeId{opcua::NodeId{300, 1}});
+  ExpectEncodedSizeMatches(opcua::Variant{});
+  ExpectEncodedSizeMatches(opcua::Variant{opcua::Int32{5}});
+  ExpectEncodedSizeMatches(
+      opcua::Variant{std::vector<opcua::Double>{1.0, 2.0, 3.0}});
+  ExpectEncodedSizeMatches(
+      opcua::Variant{std::vector<String>{"a", "", "longer"}});
+
+  DataValue value;
+  value.value = opcua::Variant{String{"text"}};
+  value.status_code = StatusCode::Uncertain;
+  ExpectEncodedSizeMatches(
+      opcua::Variant{std::make_shared<const DataValue>(value)});
+  value.source_timestamp = opcua::DateTime::FromInternalValue(1);
+  value.server_timestamp = opcua::DateTime::FromInternalValue(2);
+  ExpectEncodedSizeMatches(value);
+
+  DiagnosticInfo info;
+  info.additional_info = "why";
+  info.inner_status_code = Status{StatusCode::Bad};
+  ExpectEncodedSizeMatches(info);
+}
+
+// Writes a String, claiming to need `claimed_size` bytes for it.
+class StringBody final : public ExtensionObjectBody {
+ public:
+  StringBody(String value, std::size_t claimed_size)
+      : value_{std::move(value)}, claimed_size_{claimed_size} {}
+
+  std::size_t EncodedSize() const override { return claimed_size_; }
+  void Encode(Encoder& encoder) const override { encoder.Encode(value_); }
+
+ private:
+  String value_;
+  std::size_t claimed_size_;
+};
+
+// An in-place body encodes to the same bytes as the ByteString holding its
+// encoding, and its length prefix comes from what it wrote, not what it
+// claimed.
+TEST(CodecUtilsTest, EncodesInPlaceExtensionObjectBodiesLikeByteStrings) {
+  const opcua::ExpandedNodeId type_id{opcua::NodeId{12345, 0}};
+
+  std::vector<char> body;
+  Encoder{body}.Encode(String{"payload"});
+  std::vector<char> expected;
+  Encoder{expected}.Encode(opcua::ExtensionObject{type_id, ByteString{body}});
+
+  for (const std::size_t claimed_size : {std::size_t{0}, body.size(),
+                                         std::size_t{100}}) {
+    const opcua::ExtensionObject in_place{
+        type_id, std::shared_ptr<const ExtensionObjectBody>{
+                     std::make_shared<StringBody>("payload", claimed_size)}};
+    std::vector<char> bytes;
+    Encoder{bytes}.Encode(in_place);
+    EXPECT_EQ(bytes, expected) << claimed_size;
+  }
+}
+
 // A peer may send sub-100ns timestamps that opcuapp cannot represent. Dropping
 // the extra fields keeps the rest of the frame parseable; rejecting the whole
 // DataValue would desynchronise the stream.
@@ -1,6 +1,7 @@
 #include "opcua/transport/binary/crypto.h"
 
 #include <openssl/bio.h>
+#include <openssl/core_names.h>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
 #include <openssl/pem.h>
@@ -465,4 +466,101 @@ DerivedKeys DeriveBasic256Sha256Keys(std::span<const std::uint8_t> secret,
   return keys;
 }
 
+// ---------------------------------------------------------------------------
+// SymmetricContext
+
+SymmetricContext::~SymmetricContext() {
+  EVP_CIPHER_CTX_free(cipher_);
+  EVP_MAC_CTX_free(mac_);
+}
+
+SymmetricContext::SymmetricContext(SymmetricContext&& other) noexcept
+    : cipher_{std::exchange(other.cipher_, nullptr)},
+      mac_{std::exchange(other.mac_, nullptr)},
+      iv_{std::move(other.iv_)} {}
+
+SymmetricContext& SymmetricContext::operator=(
+    SymmetricContext&& other) noexcept {
+  if (this != &other) {
+    EVP_CIPHER_CTX_free(cipher_);
+    EVP_MAC_CTX_free(mac_);
+    cipher_ = std::exchange(other.cipher_, nullptr);
+    mac_ = std::exchange(other.mac_, nullptr);
+    iv_ = std::move(other.iv_);
+  }
+  return *this;
+}
+
+StatusOr<SymmetricContext> SymmetricContext::Create(const DerivedKeys& keys,
+                                                    Direction direction) {
+  if (keys.encrypting_key.size() != 32 ||
+      keys.initialization_vector.size() != kBlockSize) {
+    return StatusOr<SymmetricContext>{BadCrypto()};
+  }
+  SymmetricContext context;
+  context.iv_ = keys.initialization_vector;
+
+  // The AES key schedule is expanded once here; Reset only reloads the IV.
+  context.cipher_ = EVP_CIPHER_CTX_new();
+  if (!context.cipher_ ||
+      EVP_CipherInit_ex(
+          context.cipher_, EVP_aes_256_cbc(), nullptr,
+          reinterpret_cast<const unsigned char*>(keys.encrypting_key.data()),
+          reinterpret_cast<const unsigned char*>(context.iv_.data()),
+          direction == Direction::Encrypt ? 1 : 0) != 1 ||
+      EVP_CIPHER_CTX_set_padding(context.cipher_, 0) != 1) {
+    return StatusOr<SymmetricContext>{BadCrypto()};
+  }
+
+  // Likewise the HMAC inner/outer pads are computed once; re-initialising
+  // without a key restarts from them.
+  EVP_MAC* hmac = EVP_MAC_fetch(nullptr, OSSL_MAC_NAME_HMAC, nullptr);
+  if (!hmac) {
+    return StatusOr<SymmetricContext>{BadCrypto()};
+  }
+  context.mac_ = EVP_MAC_CTX_new(hmac);
+  EVP_MAC_free(hmac);
+  char digest[] = OSSL_DIGEST_NAME_SHA2_256;
+  const OSSL_PARAM params[] = {
+      OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+      OSSL_PARAM_construct_end()};
+  if (!context.mac_ ||
+      EVP_MAC_init(
+          context.mac_,
+          reinterpret_cast<const unsigned char*>(keys.signing_key.data()),
+          keys.signing_key.size(), params) != 1) {
+    return StatusOr<SymmetricContext>{BadCrypto()};
+  }
+  return StatusOr<SymmetricContext>{std::move(context)};
+}
+
+bool SymmetricContext::Reset() {
+  return !empty() &&
+         EVP_CipherInit_ex(
+             cipher_, nullptr, nullptr, nullptr,
+             reinterpret_cast<const unsigned char*>(iv_.data()), -1) == 1 &&
+         EVP_MAC_init(mac_, nullptr, 0, nullptr) == 1;
+}
+
+bool SymmetricContext::Cipher(std::span<const std::uint8_t> in,
+                              std::uint8_t* out) {
+  if (empty() || in.size() % kBlockSize != 0) {
+    return false;
+  }
+  int out_len = 0;
+  return EVP_CipherUpdate(cipher_, out, &out_len, in.data(),
+                          static_cast<int>(in.size())) == 1 &&
+         static_cast<std::size_t>(out_len) == in.size();
+}
+
+bool SymmetricContext::UpdateMac(std::span<const std::uint8_t> data) {
+  return !empty() && EVP_MAC_update(mac_, data.data(), data.size()) == 1;
+}
+
+bool SymmetricContext::FinishMac(std::uint8_t* tag) {
+  std::size_t tag_len = 0;
+  return !empty() && EVP_MAC_final(mac_, tag, &tag_len, kTagSize) == 1 &&
+         tag_len == kTagSize;
+}
+
 }  // namespace opcua::binary::crypto
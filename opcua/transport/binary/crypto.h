@@ -16,6 +16,10 @@ struct x509_st;
 using X509 = x509_st;
 struct evp_pkey_st;
 using EVP_PKEY = evp_pkey_st;
+struct evp_cipher_ctx_st;
+using EVP_CIPHER_CTX = evp_cipher_ctx_st;
+struct evp_mac_ctx_st;
+using EVP_MAC_CTX = evp_mac_ctx_st;
 
 namespace opcua::binary::crypto {
 
@@ -159,4 +163,54 @@ struct DerivedKeys {
     std::span<const std::uint8_t> secret,
     std::span<const std::uint8_t> seed);
 
+// Pre-keyed AES-256-CBC and HMAC-SHA256 state for one direction of a secure
+// channel. AesCbc* and HmacSha256 above key a fresh OpenSSL context on every
+// call; a channel instead creates one SymmetricContext per direction when its
+// keys are derived (Open and every Renew), and each message only rewinds the
+// cipher to the derived IV and the MAC to its key. Both are fed piecewise, so
+// a secure message is signed, verified, encrypted and decrypted where it lies
+// rather than concatenated into scratch buffers first.
+class SymmetricContext {
+ public:
+  enum class Direction { Encrypt, Decrypt };
+
+  static constexpr std::size_t kBlockSize = 16;
+  static constexpr std::size_t kTagSize = 32;
+
+  SymmetricContext() noexcept = default;
+  ~SymmetricContext();
+  SymmetricContext(const SymmetricContext&) = delete;
+  SymmetricContext& operator=(const SymmetricContext&) = delete;
+  SymmetricContext(SymmetricContext&& other) noexcept;
+  SymmetricContext& operator=(SymmetricContext&& other) noexcept;
+
+  [[nodiscard]] static StatusOr<SymmetricContext> Create(
+      const DerivedKeys& keys,
+      Direction direction);
+
+  [[nodiscard]] bool empty() const { return cipher_ == nullptr; }
+
+  // Starts a message: the cipher restarts from the derived IV (every OPC UA
+  // message is encrypted independently) and the MAC from its key.
+  [[nodiscard]] bool Reset();
+
+  // Encrypts or decrypts `in` into `out` per the direction. `in` must be a
+  // whole number of blocks and `out` at least as long; `out` may be `in`
+  // itself, but must not otherwise overlap it. Consecutive calls continue the
+  // CBC chain of the current message.
+  [[nodiscard]] bool Cipher(std::span<const std::uint8_t> in,
+                            std::uint8_t* out);
+
+  // Adds `data` to the MAC of the current message.
+  [[nodiscard]] bool UpdateMac(std::span<const std::uint8_t> data);
+  // Writes the kTagSize-byte tag of everything passed to UpdateMac since
+  // Reset.
+  [[nodiscard]] bool FinishMac(std::uint8_t* tag);
+
+ private:
+  EVP_CIPHER_CTX* cipher_ = nullptr;
+  EVP_MAC_CTX* mac_ = nullptr;
+  ByteString iv_;
+};
+
 }  // namespace opcua::binary::crypto
@@ -9,6 +9,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -275,5 +276,55 @@ TEST(CryptoTest, DeriveBasic256Sha256KeysShape) {
   EXPECT_NE(keys.signing_key, keys.encrypting_key);
 }
 
+TEST(CryptoTest, SymmetricContextMatchesOneShotPrimitives) {
+  const std::array<std::uint8_t, 4> secret{1, 2, 3, 4};
+  const std::array<std::uint8_t, 4> seed{5, 6, 7, 8};
+  const auto keys = DeriveBasic256Sha256Keys(secret, seed);
+  auto encrypt =
+      SymmetricContext::Create(keys, SymmetricContext::Direction::Encrypt);
+  auto decrypt =
+      SymmetricContext::Create(keys, SymmetricContext::Direction::Decrypt);
+  ASSERT_TRUE(encrypt.ok());
+  ASSERT_TRUE(decrypt.ok());
+
+  std::vector<std::uint8_t> plaintext(64);
+  for (std::size_t i = 0; i < plaintext.size(); ++i) {
+    plaintext[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  const auto expected_cipher =
+      AesCbcEncrypt(AsByteSpan(keys.encrypting_key),
+                    AsByteSpan(keys.initialization_vector), plaintext);
+  ASSERT_TRUE(expected_cipher.ok());
+  const auto expected_tag = HmacSha256(AsByteSpan(keys.signing_key), plaintext);
+
+  // Two messages through the same contexts: Reset must fully rewind both the
+  // CBC chain and the MAC between them.
+  for (int message = 0; message < 2; ++message) {
+    SCOPED_TRACE(message);
+    std::vector<std::uint8_t> buffer = plaintext;
+    const std::span<std::uint8_t> bytes{buffer};
+    std::array<std::uint8_t, SymmetricContext::kTagSize> tag{};
+
+    ASSERT_TRUE(encrypt->Reset());
+    ASSERT_TRUE(encrypt->UpdateMac(bytes.first(5)));
+    ASSERT_TRUE(encrypt->UpdateMac(bytes.subspan(5)));
+    ASSERT_TRUE(encrypt->FinishMac(tag.data()));
+    EXPECT_EQ(std::memcmp(tag.data(), expected_tag.data(), tag.size()), 0);
+
+    // In place and in two pieces that continue the chain.
+    ASSERT_TRUE(encrypt->Cipher(bytes.first(16), bytes.data()));
+    ASSERT_TRUE(encrypt->Cipher(bytes.subspan(16), bytes.data() + 16));
+    EXPECT_EQ(
+        std::memcmp(buffer.data(), expected_cipher->data(), buffer.size()), 0);
+
+    ASSERT_TRUE(decrypt->Reset());
+    ASSERT_TRUE(decrypt->Cipher(bytes, bytes.data()));
+    EXPECT_EQ(buffer, plaintext);
+  }
+
+  EXPECT_FALSE(encrypt->Cipher(std::span{plaintext}.first(15),
+                               std::vector<std::uint8_t>(16).data()));
+}
+
 }  // namespace
 }  // namespace opcua::binary::crypto
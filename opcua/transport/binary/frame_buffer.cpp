@@ -0,0 +1,40 @@
+#include "opcua/transport/binary/frame_buffer.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace opcua::binary {
+
+FrameBuffer::FrameBuffer(std::size_t read_size)
+    : read_size_{read_size}, storage_(read_size) {}
+
+std::span<char> FrameBuffer::PrepareRead() {
+  if (storage_.size() - end_ < read_size_ && begin_ != 0) {
+    const std::size_t pending = end_ - begin_;
+    std::memmove(storage_.data(), storage_.data() + begin_, pending);
+    begin_ = 0;
+    end_ = pending;
+  }
+  // Still short: a frame larger than the buffer is being received. The vector
+  // grows geometrically, so receiving it stays linear in its size.
+  if (storage_.size() - end_ < read_size_) {
+    storage_.resize(end_ + read_size_);
+  }
+  return {storage_.data() + end_, storage_.size() - end_};
+}
+
+void FrameBuffer::CommitRead(std::size_t count) {
+  assert(count <= storage_.size() - end_);
+  end_ += count;
+}
+
+void FrameBuffer::Consume(std::size_t count) {
+  assert(count <= size());
+  begin_ += count;
+  if (begin_ == end_) {
+    begin_ = 0;
+    end_ = 0;
+  }
+}
+
+}  // namespace opcua::binary
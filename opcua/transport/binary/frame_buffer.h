@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace opcua::binary {
+
+// Receive buffer for a UA TCP byte stream. Reads land directly in its free
+// tail and complete frames are parsed in place at its head, so a frame is
+// never copied out to be decoded. Consumed bytes are reclaimed lazily: only
+// when the tail is too short for the next read is the unconsumed remainder —
+// at most one partial frame — moved to the front. A read that delivers many
+// frames therefore costs one move at most, not one per frame.
+class FrameBuffer {
+ public:
+  // `read_size` is the free space guaranteed to every PrepareRead.
+  explicit FrameBuffer(std::size_t read_size);
+
+  // Free space for the next transport read, at least `read_size` bytes. Valid
+  // until the next call of any non-const member.
+  std::span<char> PrepareRead();
+  // Appends the first `count` bytes of the last PrepareRead span.
+  void CommitRead(std::size_t count);
+
+  // The bytes received but not yet consumed. Valid until the next PrepareRead.
+  std::span<const char> data() const {
+    return {storage_.data() + begin_, end_ - begin_};
+  }
+  std::size_t size() const { return end_ - begin_; }
+
+  // Drops `count` bytes from the front, e.g. a frame that was just handled.
+  void Consume(std::size_t count);
+
+ private:
+  const std::size_t read_size_;
+  std::vector<char> storage_;
+  std::size_t begin_ = 0;
+  std::size_t end_ = 0;
+};
+
+}  // namespace opcua::binary
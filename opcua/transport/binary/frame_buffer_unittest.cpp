@@ -0,0 +1,55 @@
+#include "opcua/transport/binary/frame_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace opcua::binary {
+namespace {
+
+void Receive(FrameBuffer& buffer, std::string_view bytes) {
+  auto free = buffer.PrepareRead();
+  ASSERT_GE(free.size(), bytes.size());
+  std::ranges::copy(bytes, free.begin());
+  buffer.CommitRead(bytes.size());
+}
+
+std::string_view View(std::span<const char> bytes) {
+  return {bytes.data(), bytes.size()};
+}
+
+TEST(FrameBufferTest, ParsesFramesInPlace) {
+  FrameBuffer buffer{16};
+  Receive(buffer, "aaaabbbbbb");
+  const char* head = buffer.data().data();
+
+  EXPECT_EQ(View(buffer.data().first(4)), "aaaa");
+  buffer.Consume(4);
+  // The next frame is read where it was received, not moved to the front.
+  EXPECT_EQ(buffer.data().data(), head + 4);
+  EXPECT_EQ(View(buffer.data()), "bbbbbb");
+  buffer.Consume(6);
+  EXPECT_EQ(buffer.size(), 0u);
+}
+
+TEST(FrameBufferTest, KeepsAPartialFrameAcrossReads) {
+  FrameBuffer buffer{8};
+  Receive(buffer, "12345678");
+  buffer.Consume(5);
+  // Too little room left for a full read: the partial "678" moves to the front.
+  Receive(buffer, "9abcdefg");
+  EXPECT_EQ(View(buffer.data()), "6789abcdefg");
+}
+
+TEST(FrameBufferTest, GrowsForAFrameLargerThanOneRead) {
+  FrameBuffer buffer{4};
+  for (std::string_view chunk : {"0123", "4567", "89ab", "cdef"}) {
+    Receive(buffer, chunk);
+  }
+  EXPECT_EQ(View(buffer.data()), "0123456789abcdef");
+  EXPECT_GE(buffer.PrepareRead().size(), 4u);
+}
+
+}  // namespace
+}  // namespace opcua::binary
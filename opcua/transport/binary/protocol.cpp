@@ -74,7 +74,7 @@ std::vector<char> EncodeWithHeader(MessageType message_type,
 
 }  // namespace
 
-std::optional<FrameHeader> DecodeFrameHeader(const std::vector<char>& bytes) {
+std::optional<FrameHeader> DecodeFrameHeader(std::span<const char> bytes) {
   if (bytes.size() < kHeaderSize) {
     return std::nullopt;
   }
@@ -121,7 +121,7 @@ std::vector<char> EncodeHelloMessage(const HelloMessage& message) {
   });
 }
 
-std::optional<HelloMessage> DecodeHelloMessage(const std::vector<char>& bytes) {
+std::optional<HelloMessage> DecodeHelloMessage(std::span<const char> bytes) {
   const auto header = DecodeFrameHeader(bytes);
   if (!header || header->message_type != MessageType::Hello ||
       header->message_size != bytes.size()) {
@@ -157,7 +157,7 @@ std::vector<char> EncodeAcknowledgeMessage(const AcknowledgeMessage& message) {
 }
 
 std::optional<AcknowledgeMessage> DecodeAcknowledgeMessage(
-    const std::vector<char>& bytes) {
+    std::span<const char> bytes) {
   const auto header = DecodeFrameHeader(bytes);
   if (!header || header->message_type != MessageType::Acknowledge ||
       header->message_size != bytes.size()) {
@@ -187,7 +187,7 @@ std::vector<char> EncodeErrorMessage(const ErrorMessage& message) {
   });
 }
 
-std::optional<ErrorMessage> DecodeErrorMessage(const std::vector<char>& bytes) {
+std::optional<ErrorMessage> DecodeErrorMessage(std::span<const char> bytes) {
   const auto header = DecodeFrameHeader(bytes);
   if (!header || header->message_type != MessageType::Error ||
       header->message_size != bytes.size()) {
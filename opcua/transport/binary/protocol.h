@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -61,21 +62,21 @@ struct NegotiationResult {
 };
 
 [[nodiscard]] std::optional<FrameHeader> DecodeFrameHeader(
-    const std::vector<char>& bytes);
+    std::span<const char> bytes);
 [[nodiscard]] std::vector<char> EncodeFrameHeader(const FrameHeader& header);
 
 [[nodiscard]] std::vector<char> EncodeHelloMessage(const HelloMessage& message);
 [[nodiscard]] std::optional<HelloMessage> DecodeHelloMessage(
-    const std::vector<char>& bytes);
+    std::span<const char> bytes);
 
 [[nodiscard]] std::vector<char> EncodeAcknowledgeMessage(
     const AcknowledgeMessage& message);
 [[nodiscard]] std::optional<AcknowledgeMessage> DecodeAcknowledgeMessage(
-    const std::vector<char>& bytes);
+    std::span<const char> bytes);
 
 [[nodiscard]] std::vector<char> EncodeErrorMessage(const ErrorMessage& message);
 [[nodiscard]] std::optional<ErrorMessage> DecodeErrorMessage(
-    const std::vector<char>& bytes);
+    std::span<const char> bytes);
 
 // OPC UA Part 6 7.1.2.3/7.1.2.4: the server returns the protocol version it
 // will use, constrains send/receive buffers to what the peer can handle, and
@@ -34,7 +34,9 @@ struct AuthenticatedRequestTraits;
   X(RepublishRequest, RepublishResponse)                                 \
   X(ua::TransferSubscriptionsRequest, ua::TransferSubscriptionsResponse) \
   X(ua::DeleteMonitoredItemsRequest, ua::DeleteMonitoredItemsResponse)   \
-  X(ua::SetMonitoringModeRequest, ua::SetMonitoringModeResponse)
+  X(ua::SetMonitoringModeRequest, ua::SetMonitoringModeResponse)         \
+  X(ua::RegisterNodesRequest, ua::RegisterNodesResponse)                 \
+  X(ua::UnregisterNodesRequest, ua::UnregisterNodesResponse)
 
 #define OPCUA_BINARY_DECLARE_AUTH_TRAITS(Request, Response) \
   template <>                                               \
@@ -56,59 +58,77 @@ concept AuthenticatedRequest =
 }  // namespace
 
 Runtime::Runtime(RuntimeContext&& context)
-    : session_manager_{context.session_manager},
-      runtime_{ServerRuntimeContext{
-          .executor = context.executor,
-          .session_manager = context.session_manager,
-          .callbacks = std::move(context.callbacks),
-          .endpoints = std::move(context.endpoints),
-          .operation_limits = context.operation_limits,
-          .now = std::move(context.now),
-          .post_delayed_task = std::move(context.post_delayed_task),
-          .register_server = std::move(context.register_server),
-          .registered_servers = std::move(context.registered_servers),
-      }} {}
+    : session_manager_{&context.session_manager} {
+  runtime_.emplace(ServerRuntimeContext{
+      .executor = context.executor,
+      .session_manager = context.session_manager,
+      .callbacks = std::move(context.callbacks),
+      .endpoints = std::move(context.endpoints),
+      .operation_limits = context.operation_limits,
+      .now = std::move(context.now),
+      .post_delayed_task = std::move(context.post_delayed_task),
+      .register_server = std::move(context.register_server),
+      .registered_servers = std::move(context.registered_servers),
+      .registered_node_namespace_index =
+          context.registered_node_namespace_index,
+      .read_cache_entries = context.read_cache_entries,
+  });
+}
+
+Runtime::Runtime(ShardedServerRuntimeContext&& context)
+    : shards_{std::make_unique<ShardedServerRuntime>(std::move(context))} {}
 
 Awaitable<ResponseBody> Runtime::HandleBody(ConnectionState& connection,
                                             RequestBody request,
                                             std::string trace_parent) {
-  co_return co_await runtime_.Handle(connection, std::move(request),
-                                     std::move(trace_parent));
+  if (shards_) {
+    co_return co_await shards_->Handle(connection, std::move(request),
+                                       std::move(trace_parent));
+  }
+  co_return co_await runtime_->Handle(connection, std::move(request),
+                                      std::move(trace_parent));
 }
 
 void Runtime::Detach(ConnectionState& connection) {
-  runtime_.Detach(connection);
+  if (shards_) {
+    shards_->Detach(connection);
+    return;
+  }
+  runtime_->Detach(connection);
 }
 
 Awaitable<std::optional<ResponseBody>> Runtime::HandleSessionRequest(
+    Target target,
     ConnectionState& connection,
     CreateSessionRequest request) {
-  co_return ResponseBody{
-      co_await Handle<CreateSessionResponse>(connection, std::move(request))};
+  co_return ResponseBody{co_await HandleOn<CreateSessionResponse>(
+      target, connection, std::move(request))};
 }
 
 Awaitable<std::optional<ResponseBody>> Runtime::HandleSessionRequest(
+    Target target,
     ConnectionState& connection,
     const ServiceRequestHeader& header,
     ActivateSessionRequest request) {
   const auto session =
-      session_manager_.FindSession(header.authentication_token);
+      target.session_manager.FindSession(header.authentication_token);
   if (!session.has_value()) {
     co_return std::nullopt;
   }
 
   request.session_id = session->session_id;
   request.authentication_token = header.authentication_token;
-  co_return ResponseBody{
-      co_await Handle<ActivateSessionResponse>(connection, std::move(request))};
+  co_return ResponseBody{co_await HandleOn<ActivateSessionResponse>(
+      target, connection, std::move(request))};
 }
 
 Awaitable<std::optional<ResponseBody>> Runtime::HandleSessionRequest(
+    Target target,
     ConnectionState& connection,
     const ServiceRequestHeader& header,
     CloseSessionRequest request) {
   const auto session =
-      session_manager_.FindSession(header.authentication_token);
+      target.session_manager.FindSession(header.authentication_token);
   if (!session.has_value()) {
     co_return ResponseBody{
         CloseSessionResponse{.status = StatusCode::Bad_SessionIdInvalid}};
@@ -116,15 +136,49 @@ Awaitable<std::optional<ResponseBody>> Runtime::HandleSessionRequest(
 
   request.session_id = session->session_id;
   request.authentication_token = header.authentication_token;
-  co_return ResponseBody{
-      co_await Handle<CloseSessionResponse>(connection, std::move(request))};
+  co_return ResponseBody{co_await HandleOn<CloseSessionResponse>(
+      target, connection, std::move(request))};
 }
 
 Awaitable<std::optional<ResponseBody>> Runtime::HandleDecodedRequest(
     ConnectionState& connection,
     const DecodedRequest& request) {
+  if (!shards_) {
+    co_return co_await HandleDecodedRequestOn(
+        Target{*session_manager_, *runtime_}, connection, request);
+  }
+
+  // The header's authentication token names the shard owning the session;
+  // sessionless requests carry none and run on the connection's own shard.
+  const auto shard_index =
+      shards_->SessionShard(connection, request.header.authentication_token);
+  auto handle = [&request](ServerShard& shard, ConnectionState& view)
+      -> Awaitable<std::optional<ResponseBody>> {
+    co_return co_await HandleDecodedRequestOn(
+        Target{shard.session_manager, shard.runtime}, view, request);
+  };
+  auto body = co_await shards_->RunOnShard<std::optional<ResponseBody>>(
+      connection, shard_index, std::move(handle));
+
+  // Subscriptions owned by sessions on other shards are carried over once the
+  // session's own shard has transferred what it holds.
+  const auto* transfer =
+      std::get_if<ua::TransferSubscriptionsRequest>(&request.body);
+  auto* transferred =
+      body ? std::get_if<ua::TransferSubscriptionsResponse>(&*body) : nullptr;
+  if (transfer && transferred) {
+    co_await shards_->TransferFromOtherShards(connection, shard_index,
+                                              *transfer, *transferred);
+  }
+  co_return body;
+}
+
+Awaitable<std::optional<ResponseBody>> Runtime::HandleDecodedRequestOn(
+    Target target,
+    ConnectionState& connection,
+    const DecodedRequest& request) {
   co_return co_await std::visit(
-      [this, &connection,
+      [target, &connection,
        &request](auto typed_request) -> Awaitable<std::optional<ResponseBody>> {
         using T = std::decay_t<decltype(typed_request)>;
         if constexpr (std::is_same_v<T, FindServersRequest> ||
@@ -133,20 +187,20 @@ Awaitable<std::optional<ResponseBody>> Runtime::HandleDecodedRequest(
                       std::is_same_v<T, RegisterServer2Request>) {
           // Sessionless discovery services (incl. RegisterServer/2, WS-F):
           // routed straight to the runtime, no authentication token required.
-          co_return co_await HandleBody(connection,
-                                        RequestBody{std::move(typed_request)});
+          co_return co_await target.runtime.Handle(
+              connection, RequestBody{std::move(typed_request)});
         } else if constexpr (std::is_same_v<T, CreateSessionRequest>) {
-          co_return co_await HandleSessionRequest(connection,
+          co_return co_await HandleSessionRequest(target, connection,
                                                   std::move(typed_request));
         } else if constexpr (std::is_same_v<T, ActivateSessionRequest>) {
-          co_return co_await HandleSessionRequest(connection, request.header,
-                                                  std::move(typed_request));
+          co_return co_await HandleSessionRequest(
+              target, connection, request.header, std::move(typed_request));
         } else if constexpr (std::is_same_v<T, CloseSessionRequest>) {
-          co_return co_await HandleSessionRequest(connection, request.header,
-                                                  std::move(typed_request));
+          co_return co_await HandleSessionRequest(
+              target, connection, request.header, std::move(typed_request));
         } else if constexpr (AuthenticatedRequest<T>) {
           co_return co_await HandleAuthenticatedRequest<
-              AuthenticatedResponse<T>>(connection, request,
+              AuthenticatedResponse<T>>(target, connection, request,
                                         std::move(typed_request));
         } else {
           static_assert(!kIsSessionRequest<T>,
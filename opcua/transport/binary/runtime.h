@@ -5,8 +5,13 @@
 #include "opcua/base/awaitable.h"
 #include "opcua/message.h"
 #include "opcua/session/server_runtime.h"
+#include "opcua/session/sharded_server_runtime.h"
 #include "opcua/transport/binary/service_codec.h"
 
+#include <cstddef>
+#include <memory>
+#include <optional>
+
 namespace opcua::binary {
 
 template <typename Response>
@@ -73,6 +78,11 @@ struct RuntimeContext {
   // Optional snapshot of servers registered via RegisterServer, surfaced
   // through FindServers (see ServerRuntimeContext::registered_servers).
   std::function<std::vector<RegisteredServer>()> registered_servers;
+  // See ServerRuntimeContext::registered_node_namespace_index. Unforwarded,
+  // RegisterNodes over UA Binary would only ever echo the requested ids.
+  std::optional<NamespaceIndex> registered_node_namespace_index;
+  // See ServerRuntimeContext::read_cache_entries. 0 leaves reads uncached.
+  std::size_t read_cache_entries = 0;
 };
 
 // UA Binary reuses the canonical shared server-side session/subscription/
@@ -80,6 +90,11 @@ struct RuntimeContext {
 class Runtime {
  public:
   explicit Runtime(RuntimeContext&& context);
+  // Multi-core mode: requests run on `context.shard_count` shards, each with
+  // its own executor, session manager and runtime (see ShardedServerRuntime).
+  // A connection's sessionless requests run on the shard it is pinned to and
+  // every other request on the shard of the session its header names.
+  explicit Runtime(ShardedServerRuntimeContext&& context);
 
   // `trace_parent` carries the W3C traceparent from the decoded request
   // header (empty = absent); see ServiceRequestHeader::trace_parent.
@@ -87,15 +102,8 @@ class Runtime {
   [[nodiscard]] Awaitable<Response> Handle(ConnectionState& connection,
                                            Request request,
                                            std::string trace_parent = {}) {
-    auto body = co_await HandleBody(connection, RequestBody{std::move(request)},
-                                    std::move(trace_parent));
-    if (auto* typed = std::get_if<Response>(&body)) {
-      co_return std::move(*typed);
-    }
-    if (auto* fault = std::get_if<ServiceFault>(&body)) {
-      co_return BuildRuntimeErrorResponse<Response>(fault->status);
-    }
-    co_return BuildRuntimeErrorResponse<Response>(StatusCode::Bad);
+    co_return UnpackResponse<Response>(co_await HandleBody(
+        connection, RequestBody{std::move(request)}, std::move(trace_parent)));
   }
 
   void Detach(ConnectionState& connection);
@@ -105,14 +113,48 @@ class Runtime {
       const DecodedRequest& request);
 
  private:
+  // The session manager and runtime a decoded request runs against: this
+  // runtime's own, or those of the shard owning the request's session.
+  struct Target {
+    ServerSessionManager& session_manager;
+    ServerRuntime& runtime;
+  };
+
+  template <typename Response>
+  static Response UnpackResponse(ResponseBody body) {
+    if (auto* typed = std::get_if<Response>(&body)) {
+      return std::move(*typed);
+    }
+    if (auto* fault = std::get_if<ServiceFault>(&body)) {
+      return BuildRuntimeErrorResponse<Response>(fault->status);
+    }
+    return BuildRuntimeErrorResponse<Response>(StatusCode::Bad);
+  }
+
   [[nodiscard]] Awaitable<ResponseBody> HandleBody(
       ConnectionState& connection,
       RequestBody request,
       std::string trace_parent = {});
 
+  [[nodiscard]] static Awaitable<std::optional<ResponseBody>>
+  HandleDecodedRequestOn(Target target,
+                         ConnectionState& connection,
+                         const DecodedRequest& request);
+
+  template <typename Response, typename Request>
+  [[nodiscard]] static Awaitable<Response> HandleOn(
+      Target target,
+      ConnectionState& connection,
+      Request request,
+      std::string trace_parent = {}) {
+    co_return UnpackResponse<Response>(co_await target.runtime.Handle(
+        connection, RequestBody{std::move(request)}, std::move(trace_parent)));
+  }
+
   template <typename Response, typename Request>
-  [[nodiscard]] Awaitable<std::optional<ResponseBody>>
-  HandleAuthenticatedRequest(ConnectionState& connection,
+  [[nodiscard]] static Awaitable<std::optional<ResponseBody>>
+  HandleAuthenticatedRequest(Target target,
+                             ConnectionState& connection,
                              const DecodedRequest& request,
                              Request typed_request) {
     if (!connection.authentication_token.has_value() ||
@@ -122,24 +164,30 @@ class Runtime {
           StatusCode::Bad_SessionIdInvalid)};
     }
 
-    co_return ResponseBody{co_await Handle<Response>(
-        connection, std::move(typed_request), request.header.trace_parent)};
+    co_return ResponseBody{co_await HandleOn<Response>(
+        target, connection, std::move(typed_request),
+        request.header.trace_parent)};
   }
 
-  [[nodiscard]] Awaitable<std::optional<ResponseBody>> HandleSessionRequest(
-      ConnectionState& connection,
-      CreateSessionRequest request);
-  [[nodiscard]] Awaitable<std::optional<ResponseBody>> HandleSessionRequest(
-      ConnectionState& connection,
-      const ServiceRequestHeader& header,
-      ActivateSessionRequest request);
-  [[nodiscard]] Awaitable<std::optional<ResponseBody>> HandleSessionRequest(
-      ConnectionState& connection,
-      const ServiceRequestHeader& header,
-      CloseSessionRequest request);
-
-  ServerSessionManager& session_manager_;
-  ServerRuntime runtime_;
+  [[nodiscard]] static Awaitable<std::optional<ResponseBody>>
+  HandleSessionRequest(Target target,
+                       ConnectionState& connection,
+                       CreateSessionRequest request);
+  [[nodiscard]] static Awaitable<std::optional<ResponseBody>>
+  HandleSessionRequest(Target target,
+                       ConnectionState& connection,
+                       const ServiceRequestHeader& header,
+                       ActivateSessionRequest request);
+  [[nodiscard]] static Awaitable<std::optional<ResponseBody>>
+  HandleSessionRequest(Target target,
+                       ConnectionState& connection,
+                       const ServiceRequestHeader& header,
+                       CloseSessionRequest request);
+
+  // Exactly one of the two is set.
+  ServerSessionManager* session_manager_ = nullptr;
+  std::optional<ServerRuntime> runtime_;
+  std::unique_ptr<ShardedServerRuntime> shards_;
 };
 
 }  // namespace opcua::binary
@@ -94,8 +94,16 @@ class BinaryRuntimeFixture {
 
   template <class Response, class Request>
   Response HandleResponse(ConnectionState& connection, Request request) {
+    return HandleResponse<Response>(runtime_, connection, std::move(request));
+  }
+
+  // The same, on a runtime a test built with its own RuntimeContext.
+  template <class Response, class Request>
+  Response HandleResponse(Runtime& runtime,
+                          ConnectionState& connection,
+                          Request request) {
     auto result = StartAwaitable<Response>(
-        executor_, runtime_.Handle<Response>(connection, std::move(request)));
+        executor_, runtime.Handle<Response>(connection, std::move(request)));
 
     for (int step = 0; step < 16 && !result->done; ++step) {
       opcua::Drain(executor_);
@@ -115,11 +123,15 @@ class BinaryRuntimeFixture {
   }
 
   SessionIds CreateAndActivate(ConnectionState& connection) {
+    return CreateAndActivate(runtime_, connection);
+  }
+
+  SessionIds CreateAndActivate(Runtime& runtime, ConnectionState& connection) {
     const auto created = HandleResponse<CreateSessionResponse>(
-        connection, CreateSessionRequest{});
+        runtime, connection, CreateSessionRequest{});
     EXPECT_EQ(created.status.code(), StatusCode::Good);
     const auto activated = HandleResponse<ActivateSessionResponse>(
-        connection, ActivateSessionRequest{
+        runtime, connection, ActivateSessionRequest{
                         .session_id = created.session_id,
                         .authentication_token = created.authentication_token,
                         .user_name = LocalizedText{u"operator"},
@@ -330,5 +342,113 @@ TEST(BinaryRuntimeLimitsTest, ConfiguredOperationLimitsAreEnforced) {
   EXPECT_EQ(fixture.services_.read_count, 0);
 }
 
+// The registered-node namespace must reach the inner ServerRuntimeContext too:
+// dropped there, RegisterNodes over UA Binary would only echo the requested
+// ids, and a Read naming an alias would never reach the node it stands for.
+// OPC UA Part 4 §5.9.5 RegisterNodes,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.9.5
+TEST(BinaryRuntimeConfigTest, RegisteredNodesResolveOverBinary) {
+  constexpr NamespaceIndex kAliasNamespace = 9;
+  class AliasingFixture : public BinaryRuntimeFixture {
+   public:
+    Runtime aliasing_runtime_{RuntimeContext{
+        .executor = AnyExecutor{executor_},
+        .session_manager = session_manager_,
+        .callbacks =
+            services_.MakeCallbacks(AnyExecutor{executor_}, backing_states_),
+        .endpoints = MakeTestEndpoints(),
+        .now = [this] { return now_; },
+        .registered_node_namespace_index = kAliasNamespace,
+    }};
+  };
+
+  AliasingFixture fixture;
+  BinaryRuntimeFixture::ConnectionState connection;
+
+  const auto created = WaitAwaitable(
+      fixture.executor_,
+      fixture.aliasing_runtime_.Handle<CreateSessionResponse>(
+          connection, CreateSessionRequest{}));
+  ASSERT_EQ(created.status.code(), StatusCode::Good);
+  const auto activated = WaitAwaitable(
+      fixture.executor_,
+      fixture.aliasing_runtime_.Handle<ActivateSessionResponse>(
+          connection, ActivateSessionRequest{
+                          .session_id = created.session_id,
+                          .authentication_token = created.authentication_token,
+                          .user_name = LocalizedText{u"operator"},
+                          .password = LocalizedText{u"secret"},
+                      }));
+  ASSERT_EQ(activated.status.code(), StatusCode::Good);
+
+  // Through the decoded-request entry point, as the wire delivers it.
+  const NodeId temperature{"Plant.Area1.Line4.Oven2.Temperature", 2};
+  const auto registered = WaitAwaitable(
+      fixture.executor_,
+      fixture.aliasing_runtime_.HandleDecodedRequest(
+          connection,
+          DecodedRequest{
+              .header = {.authentication_token = created.authentication_token,
+                         .request_handle = 1},
+              .body = ua::RegisterNodesRequest{
+                  .nodes_to_register = {temperature}},
+          }));
+  ASSERT_TRUE(registered.has_value());
+  const auto* aliases = std::get_if<ua::RegisterNodesResponse>(&*registered);
+  ASSERT_NE(aliases, nullptr);
+  ASSERT_EQ(aliases->registered_node_ids,
+            (std::vector<NodeId>{NodeId{1, kAliasNamespace}}));
+
+  const auto read = WaitAwaitable(
+      fixture.executor_,
+      fixture.aliasing_runtime_.Handle<ua::ReadResponse>(
+          connection,
+          ua::ReadRequest{.nodes_to_read = {
+                              {.node_id = aliases->registered_node_ids[0],
+                               .attribute_id = static_cast<UInt32>(
+                                   AttributeId::Value)}}}));
+  EXPECT_EQ(read.response_header.service_result.code(), StatusCode::Good);
+  ASSERT_EQ(fixture.services_.last_read_inputs.size(), 1u);
+  EXPECT_EQ(fixture.services_.last_read_inputs[0].node_id, temperature);
+}
+
+// The read cache configured on the Binary transport must actually serve: a
+// Read whose MaxAge the first one's value still meets stays off the backend.
+// OPC UA Part 4 §5.10.2 Read,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/5.10.2
+TEST(BinaryRuntimeConfigTest, ReadsAreServedFromTheConfiguredCache) {
+  class CachingFixture : public BinaryRuntimeFixture {
+   public:
+    Runtime caching_runtime_{RuntimeContext{
+        .executor = AnyExecutor{executor_},
+        .session_manager = session_manager_,
+        .callbacks =
+            services_.MakeCallbacks(AnyExecutor{executor_}, backing_states_),
+        .endpoints = MakeTestEndpoints(),
+        .now = [this] { return now_; },
+        .read_cache_entries = 16,
+    }};
+  };
+
+  CachingFixture fixture;
+  BinaryRuntimeFixture::ConnectionState connection;
+  fixture.CreateAndActivate(fixture.caching_runtime_, connection);
+
+  const ua::ReadRequest request{
+      .max_age = 1000,
+      .nodes_to_read = {
+          {.node_id = NumericNode(1),
+           .attribute_id = static_cast<UInt32>(AttributeId::Value)}}};
+  for (int i = 0; i < 2; ++i) {
+    const auto response = fixture.HandleResponse<ua::ReadResponse>(
+        fixture.caching_runtime_, connection, request);
+    EXPECT_EQ(response.response_header.service_result.code(),
+              StatusCode::Good);
+    ASSERT_EQ(response.results.size(), 1u);
+    EXPECT_EQ(response.results[0].value, Variant{42.0});
+  }
+  EXPECT_EQ(fixture.services_.read_count, 1);
+}
+
 }  // namespace
 }  // namespace opcua::binary
@@ -2,6 +2,8 @@
 #include "opcua/transport/binary/codec_utils.h"
 #include "opcua/types/date_time.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <utility>
 
@@ -12,8 +14,8 @@ constexpr std::size_t kRsaOaepSha1Overhead = 42;
 constexpr std::size_t kHmacSha256TagSize = 32;
 constexpr std::size_t kAesBlockSize = 16;
 
-// ByteString is std::vector<char>, so one overload covers both.
-std::span<const std::uint8_t> ByteSpan(const std::vector<char>& v) {
+// Covers ByteString (std::vector<char>) as well as spans into a frame.
+std::span<const std::uint8_t> ByteSpan(std::span<const char> v) {
   return {reinterpret_cast<const std::uint8_t*>(v.data()), v.size()};
 }
 
@@ -108,7 +110,7 @@ bool ReadResponseHeader(Decoder& decoder, ResponseHeader& header) {
 }  // namespace
 
 std::optional<SecureConversationMessage> DecodeSecureConversationMessage(
-    const std::vector<char>& frame) {
+    std::span<const char> frame) {
   const auto frame_header = DecodeFrameHeader(frame);
   if (!frame_header || frame_header->message_size != frame.size()) {
     return std::nullopt;
@@ -154,7 +156,18 @@ std::vector<char> EncodeSecureConversationMessage(
       EncodeFrameHeader({.message_type = message.frame_header.message_type,
                          .chunk_type = message.frame_header.chunk_type,
                          .message_size = 0});
-  Encoder encoder{frame};
+  // Channel id, security header and sequence header, then the body: sized up
+  // front so that appending a large body never reallocates the frame.
+  std::size_t size_hint = 4 + 8 + message.body.size();
+  if (message.frame_header.message_type == MessageType::SecureOpen) {
+    const auto& header = *message.asymmetric_security_header;
+    size_hint += 12 + header.security_policy_uri.size() +
+                 header.sender_certificate.size() +
+                 header.receiver_certificate_thumbprint.size();
+  } else {
+    size_hint += 4;
+  }
+  Encoder encoder{frame, size_hint};
   encoder.Encode(message.secure_channel_id);
 
   if (message.frame_header.message_type == MessageType::SecureOpen) {
@@ -175,6 +188,61 @@ std::vector<char> EncodeSecureConversationMessage(
   return frame;
 }
 
+std::vector<char> EncodeSymmetricMessageChunk(FrameHeader frame_header,
+                                              std::uint32_t secure_channel_id,
+                                              std::uint32_t token_id,
+                                              SequenceHeader sequence_header,
+                                              std::span<const char> body) {
+  frame_header.message_size = 0;
+  std::vector<char> frame = EncodeFrameHeader(frame_header);
+  Encoder encoder{frame, 16 + body.size()};
+  encoder.Encode(secure_channel_id);
+  encoder.Encode(token_id);
+  encoder.Encode(sequence_header.sequence_number);
+  encoder.Encode(sequence_header.request_id);
+  frame.insert(frame.end(), body.begin(), body.end());
+  FixUpFrameSize(frame);
+  return frame;
+}
+
+std::optional<std::size_t> ChunkBodySize(std::size_t body_size,
+                                         const ChunkLimits& limits,
+                                         bool sign_and_encrypt) {
+  if (limits.max_message_size != 0 && body_size > limits.max_message_size) {
+    return std::nullopt;
+  }
+
+  std::size_t chunk_body_size = std::max<std::size_t>(body_size, 1);
+  if (limits.buffer_size != 0) {
+    // Message header, channel id and token id stay in the clear; the sequence
+    // header precedes the body. Under SignAndEncrypt the sequence header,
+    // body, padding, PaddingSize byte and signature are encrypted as whole
+    // AES blocks.
+    constexpr std::size_t kHeaderSize = 16;
+    constexpr std::size_t kSequenceHeaderSize = 8;
+    const std::size_t overhead =
+        kSequenceHeaderSize + (sign_and_encrypt ? 1 + kHmacSha256TagSize : 0);
+    std::size_t room = limits.buffer_size > kHeaderSize
+                           ? limits.buffer_size - kHeaderSize
+                           : 0;
+    if (sign_and_encrypt) {
+      room -= room % kAesBlockSize;
+    }
+    if (room <= overhead) {
+      return std::nullopt;
+    }
+    chunk_body_size = std::min(chunk_body_size, room - overhead);
+  }
+
+  const std::size_t chunk_count =
+      std::max<std::size_t>(1, (body_size + chunk_body_size - 1) /
+                                   chunk_body_size);
+  if (limits.max_chunk_count != 0 && chunk_count > limits.max_chunk_count) {
+    return std::nullopt;
+  }
+  return chunk_body_size;
+}
+
 std::optional<OpenSecureChannelRequest> DecodeOpenSecureChannelRequestBody(
     const std::vector<char>& body) {
   Decoder body_decoder{body};
@@ -333,7 +401,7 @@ SecureChannel::SecureChannel(
     : config_{std::move(config)}, channel_id_{channel_id} {}
 
 Awaitable<SecureChannel::Result> SecureChannel::HandleFrame(
-    std::vector<char> frame) {
+    std::span<const char> frame) {
   const auto frame_header = DecodeFrameHeader(frame);
   if (!frame_header || frame_header->message_size != frame.size()) {
     co_return Result{.close_transport = true};
@@ -379,7 +447,7 @@ Awaitable<SecureChannel::Result> SecureChannel::HandleFrame(
 }
 
 SecureChannel::Result SecureChannel::HandleOpenNone(
-    const std::vector<char>& frame) {
+    std::span<const char> frame) {
   const auto message = DecodeSecureConversationMessage(frame);
   if (!message.has_value()) {
     return Result{.close_transport = true};
@@ -419,7 +487,7 @@ SecureChannel::Result SecureChannel::HandleOpenNone(
 }
 
 SecureChannel::Result SecureChannel::HandleOpenSecure(
-    const std::vector<char>& frame) {
+    std::span<const char> frame) {
   // Parse the cleartext prefix: channel id + asymmetric security header
   // (policy URI, sender certificate = client cert DER, receiver thumbprint).
   Decoder dec{std::span<const char>{frame}.subspan(8)};
@@ -557,10 +625,19 @@ SecureChannel::Result SecureChannel::HandleOpenSecure(
     return Result{.close_transport = true};
   }
 
-  inbound_keys_ = crypto::DeriveBasic256Sha256Keys(
-      ByteSpan(server_nonce), ByteSpan(request->client_nonce));
-  outbound_keys_ = crypto::DeriveBasic256Sha256Keys(
-      ByteSpan(request->client_nonce), ByteSpan(server_nonce));
+  auto inbound_crypto = crypto::SymmetricContext::Create(
+      crypto::DeriveBasic256Sha256Keys(ByteSpan(server_nonce),
+                                       ByteSpan(request->client_nonce)),
+      crypto::SymmetricContext::Direction::Decrypt);
+  auto outbound_crypto = crypto::SymmetricContext::Create(
+      crypto::DeriveBasic256Sha256Keys(ByteSpan(request->client_nonce),
+                                       ByteSpan(server_nonce)),
+      crypto::SymmetricContext::Direction::Encrypt);
+  if (!inbound_crypto.ok() || !outbound_crypto.ok()) {
+    return Result{.close_transport = true};
+  }
+  inbound_crypto_ = std::move(*inbound_crypto);
+  outbound_crypto_ = std::move(*outbound_crypto);
   server_nonce_ = std::move(server_nonce);
   client_certificate_der_ = std::move(header.sender_certificate);
   basic256_active_ = true;
@@ -569,14 +646,14 @@ SecureChannel::Result SecureChannel::HandleOpenSecure(
 }
 
 SecureChannel::Result SecureChannel::HandleSecureMessage(
-    const std::vector<char>& frame,
+    std::span<const char> frame,
     bool is_close) {
   if (!opened_) {
     return Result{.close_transport = true};
   }
 
   if (!basic256_active_) {
-    const auto message = DecodeSecureConversationMessage(frame);
+    auto message = DecodeSecureConversationMessage(frame);
     if (!message.has_value() || message->secure_channel_id != channel_id_ ||
         !message->symmetric_security_header) {
       return Result{.close_transport = true};
@@ -598,7 +675,7 @@ SecureChannel::Result SecureChannel::HandleSecureMessage(
       return Result{.close_transport = true,
                     .graceful_close = request.has_value()};
     }
-    return Result{.service_payload = message->body,
+    return Result{.service_payload = std::move(message->body),
                   .request_id = message->sequence_header.request_id};
   }
 
@@ -617,44 +694,48 @@ SecureChannel::Result SecureChannel::HandleSecureMessage(
     return Result{.close_transport = true};
   }
 
-  std::span<const char> cipher_span{frame.data() + kHeaderSize,
-                                    frame.size() - kHeaderSize};
-  auto decrypted = crypto::AesCbcDecrypt(
-      ByteSpan(inbound_keys_.encrypting_key),
-      ByteSpan(inbound_keys_.initialization_vector),
-      {reinterpret_cast<const std::uint8_t*>(cipher_span.data()),
-       cipher_span.size()});
-  if (!decrypted.ok() || decrypted->size() < kHmacSha256TagSize) {
+  // Decrypt straight into the service payload: the first block, which holds
+  // the sequence header, goes to the stack, so every later block lands at
+  // its final offset in `body` and nothing is moved afterwards. The HMAC is
+  // fed the header and the plaintext where they lie.
+  const auto ciphertext = ByteSpan(frame.subspan(kHeaderSize));
+  if (ciphertext.size() < kAesBlockSize + kHmacSha256TagSize ||
+      ciphertext.size() % kAesBlockSize != 0) {
     return Result{.close_transport = true};
   }
-
-  const auto sig_begin = decrypted->size() - kHmacSha256TagSize;
-  std::vector<char> signed_region;
-  signed_region.reserve(kHeaderSize + sig_begin);
-  signed_region.insert(
-      signed_region.end(), frame.begin(),
-      frame.begin() + static_cast<std::ptrdiff_t>(kHeaderSize));
-  signed_region.insert(
-      signed_region.end(), decrypted->begin(),
-      decrypted->begin() + static_cast<std::ptrdiff_t>(sig_begin));
-  const auto expected_tag = crypto::HmacSha256(
-      ByteSpan(inbound_keys_.signing_key), ByteSpan(signed_region));
-  if (expected_tag.size() != kHmacSha256TagSize ||
-      std::memcmp(expected_tag.data(), decrypted->data() + sig_begin,
+  std::array<std::uint8_t, kAesBlockSize> first_block;
+  std::vector<char> body(ciphertext.size() - 8);
+  auto* body_bytes = reinterpret_cast<std::uint8_t*>(body.data());
+  if (!inbound_crypto_.Reset() ||
+      !inbound_crypto_.Cipher(ciphertext.first(kAesBlockSize),
+                              first_block.data()) ||
+      !inbound_crypto_.Cipher(ciphertext.subspan(kAesBlockSize),
+                              body_bytes + 8)) {
+    return Result{.close_transport = true};
+  }
+  std::memcpy(body_bytes, first_block.data() + 8, 8);
+
+  // Offsets below are into the plaintext, which starts 8 bytes before `body`.
+  const auto sig_begin = ciphertext.size() - kHmacSha256TagSize;
+  std::array<std::uint8_t, kHmacSha256TagSize> expected_tag;
+  if (!inbound_crypto_.UpdateMac(ByteSpan(frame.first(kHeaderSize))) ||
+      !inbound_crypto_.UpdateMac(first_block) ||
+      !inbound_crypto_.UpdateMac(
+          {body_bytes + 8, sig_begin - kAesBlockSize}) ||
+      !inbound_crypto_.FinishMac(expected_tag.data()) ||
+      std::memcmp(expected_tag.data(), body_bytes + sig_begin - 8,
                   kHmacSha256TagSize) != 0) {
     return Result{.close_transport = true};
   }
 
-  const auto pad_size = static_cast<std::uint8_t>((*decrypted)[sig_begin - 1]);
+  const auto pad_size = body_bytes[sig_begin - 8 - 1];
   if (sig_begin < static_cast<std::size_t>(1 + pad_size) + 8) {
     return Result{.close_transport = true};
   }
   const auto body_end = sig_begin - 1 - pad_size;
   std::uint32_t request_id = 0;
-  std::memcpy(&request_id, decrypted->data() + 4, 4);
-  std::vector<char> body{
-      decrypted->begin() + 8,
-      decrypted->begin() + static_cast<std::ptrdiff_t>(body_end)};
+  std::memcpy(&request_id, first_block.data() + 4, 4);
+  body.resize(body_end - 8);
 
   if (is_close) {
     const auto request = DecodeCloseSecureChannelRequestBody(body);
@@ -667,23 +748,23 @@ SecureChannel::Result SecureChannel::HandleSecureMessage(
 
 std::vector<char> SecureChannel::BuildServiceResponse(std::uint32_t request_id,
                                                       std::vector<char> body) {
+  return BuildServiceResponseChunk(request_id, 'F', body);
+}
+
+std::vector<char> SecureChannel::BuildServiceResponseChunk(
+    std::uint32_t request_id,
+    char chunk_type,
+    std::span<const char> body) {
   if (basic256_active_) {
-    auto framed = BuildSecureServiceResponse(request_id, body);
+    auto framed = BuildSecureServiceResponse(request_id, chunk_type, body);
     return framed.ok() ? std::move(*framed) : std::vector<char>{};
   }
 
-  SecureConversationMessage message{
-      .frame_header = {.message_type = MessageType::SecureMessage,
-                       .chunk_type = 'F',
-                       .message_size = 0},
-      .secure_channel_id = channel_id_,
-      .symmetric_security_header =
-          SymmetricSecurityHeader{.token_id = token_id_},
-      .sequence_header = {.sequence_number = next_sequence_number_++,
-                          .request_id = request_id},
-      .body = std::move(body),
-  };
-  return EncodeSecureConversationMessage(message);
+  return EncodeSymmetricMessageChunk(
+      {.message_type = MessageType::SecureMessage, .chunk_type = chunk_type},
+      channel_id_, token_id_,
+      {.sequence_number = next_sequence_number_++, .request_id = request_id},
+      body);
 }
 
 std::vector<char> SecureChannel::BuildOpenResponse(
@@ -827,71 +908,48 @@ StatusOr<std::vector<char>> SecureChannel::BuildSecureOpenResponse(
 
 StatusOr<std::vector<char>> SecureChannel::BuildSecureServiceResponse(
     std::uint32_t request_id,
-    const std::vector<char>& body) {
-  // Plaintext: [seq header][body][padding][PaddingSize], padded so the whole
-  // (payload + 1 + 32-byte HMAC tag) is a multiple of the AES block size.
-  std::vector<char> plaintext_payload;
-  {
-    Encoder enc{plaintext_payload};
-    enc.Encode(next_sequence_number_++);
-    enc.Encode(request_id);
-  }
-  plaintext_payload.insert(plaintext_payload.end(), body.begin(), body.end());
-
+    char chunk_type,
+    std::span<const char> body) {
+  // Frame: [16-byte header][seq header][body][padding][PaddingSize][tag],
+  // padded so everything after the header is a multiple of the AES block
+  // size. It is assembled once; the HMAC covers header and plaintext where
+  // they lie, and the cipher then runs over them in place.
+  constexpr std::size_t kHeaderSize = 16;
+  const std::size_t plaintext_size = 8 + body.size();
   const std::size_t pad_count =
       (kAesBlockSize -
-       (plaintext_payload.size() + 1 + kHmacSha256TagSize) % kAesBlockSize) %
+       (plaintext_size + 1 + kHmacSha256TagSize) % kAesBlockSize) %
       kAesBlockSize;
   if (pad_count > 255) {
     return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
   }
-  plaintext_payload.insert(plaintext_payload.end(), pad_count,
-                           static_cast<char>(pad_count));
-  plaintext_payload.push_back(static_cast<char>(pad_count));
+  const std::size_t signed_size = kHeaderSize + plaintext_size + pad_count + 1;
 
-  // 16-byte header: "MSGF" + size + channel id + token id.
-  std::vector<char> header_portion;
-  header_portion.insert(header_portion.end(), {'M', 'S', 'G', 'F', 0, 0, 0, 0});
+  std::vector<char> frame;
+  frame.reserve(signed_size + kHmacSha256TagSize);
+  frame.insert(frame.end(), {'M', 'S', 'G', chunk_type, 0, 0, 0, 0});
   {
-    Encoder enc{header_portion};
+    Encoder enc{frame};
     enc.Encode(channel_id_);
     enc.Encode(token_id_);
+    enc.Encode(next_sequence_number_++);
+    enc.Encode(request_id);
   }
+  frame.insert(frame.end(), body.begin(), body.end());
+  frame.insert(frame.end(), pad_count + 1, static_cast<char>(pad_count));
+  frame.resize(signed_size + kHmacSha256TagSize);
+  // The signature covers the final message_size field.
+  FixUpFrameSize(frame);
 
-  const std::size_t cipher_size = plaintext_payload.size() + kHmacSha256TagSize;
-  const std::size_t predicted_final_size = header_portion.size() + cipher_size;
-  {
-    const auto size32 = static_cast<std::uint32_t>(predicted_final_size);
-    std::memcpy(header_portion.data() + 4, &size32, sizeof(size32));
-  }
-
-  std::vector<char> to_sign;
-  to_sign.reserve(header_portion.size() + plaintext_payload.size());
-  to_sign.insert(to_sign.end(), header_portion.begin(), header_portion.end());
-  to_sign.insert(to_sign.end(), plaintext_payload.begin(),
-                 plaintext_payload.end());
-  const auto signature = crypto::HmacSha256(
-      ByteSpan(outbound_keys_.signing_key), ByteSpan(to_sign));
-
-  std::vector<char> encrypted_input;
-  encrypted_input.reserve(plaintext_payload.size() + signature.size());
-  encrypted_input.insert(encrypted_input.end(), plaintext_payload.begin(),
-                         plaintext_payload.end());
-  encrypted_input.insert(encrypted_input.end(), signature.begin(),
-                         signature.end());
-  auto ciphertext =
-      crypto::AesCbcEncrypt(ByteSpan(outbound_keys_.encrypting_key),
-                            ByteSpan(outbound_keys_.initialization_vector),
-                            ByteSpan(encrypted_input));
-  if (!ciphertext.ok()) {
-    return StatusOr<std::vector<char>>{ciphertext.status()};
+  auto* bytes = reinterpret_cast<std::uint8_t*>(frame.data());
+  const std::span<std::uint8_t> encrypted{bytes + kHeaderSize,
+                                          frame.size() - kHeaderSize};
+  if (!outbound_crypto_.Reset() ||
+      !outbound_crypto_.UpdateMac({bytes, signed_size}) ||
+      !outbound_crypto_.FinishMac(bytes + signed_size) ||
+      !outbound_crypto_.Cipher(encrypted, encrypted.data())) {
+    return StatusOr<std::vector<char>>{Status{StatusCode::Bad}};
   }
-
-  std::vector<char> frame;
-  frame.reserve(header_portion.size() + ciphertext->size());
-  frame.insert(frame.end(), header_portion.begin(), header_portion.end());
-  frame.insert(frame.end(), ciphertext->begin(), ciphertext->end());
-  FixUpFrameSize(frame);
   return StatusOr<std::vector<char>>{std::move(frame)};
 }
 
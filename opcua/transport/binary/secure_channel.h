@@ -106,10 +106,41 @@ struct CloseSecureChannelRequest {
 };
 
 [[nodiscard]] std::optional<SecureConversationMessage>
-DecodeSecureConversationMessage(const std::vector<char>& frame);
+DecodeSecureConversationMessage(std::span<const char> frame);
 [[nodiscard]] std::vector<char> EncodeSecureConversationMessage(
     const SecureConversationMessage& message);
 
+// Frames one symmetric MessageChunk (MSG / CLO) under SecurityPolicy=None
+// straight from a body slice, so a chunking sender need not copy each slice
+// into a SecureConversationMessage first.
+[[nodiscard]] std::vector<char> EncodeSymmetricMessageChunk(
+    FrameHeader frame_header,
+    std::uint32_t secure_channel_id,
+    std::uint32_t token_id,
+    SequenceHeader sequence_header,
+    std::span<const char> body);
+
+// What one side of a connection may send, as announced by the other in
+// Hello/Acknowledge (OPC UA Part 6 §7.1.2.3/§7.1.2.4): MessageChunks of at
+// most `buffer_size` bytes, and per message at most `max_message_size` body
+// bytes in at most `max_chunk_count` chunks. 0 leaves a limit unset.
+struct ChunkLimits {
+  std::uint32_t buffer_size = 0;
+  std::uint32_t max_message_size = 0;
+  std::uint32_t max_chunk_count = 0;
+};
+
+// Body bytes carried by each MessageChunk when a message body of `body_size`
+// bytes is split under `limits` (OPC UA Part 6 §6.7.2): what remains of
+// `buffer_size` after the symmetric headers and, under SignAndEncrypt, after
+// the signature, padding and rounding down to whole cipher blocks. Every
+// chunk but the last is full. Empty when the message cannot be sent within
+// `limits`; the sender reports Bad_RequestTooLarge / Bad_ResponseTooLarge.
+[[nodiscard]] std::optional<std::size_t> ChunkBodySize(
+    std::size_t body_size,
+    const ChunkLimits& limits,
+    bool sign_and_encrypt);
+
 [[nodiscard]] std::optional<OpenSecureChannelRequest>
 DecodeOpenSecureChannelRequestBody(const std::vector<char>& body);
 [[nodiscard]] std::vector<char> EncodeOpenSecureChannelResponseBody(
@@ -190,9 +221,22 @@ class SecureChannel {
       std::shared_ptr<const SecureChannelServerConfig> config,
       std::uint32_t channel_id = 1);
 
-  [[nodiscard]] Awaitable<Result> HandleFrame(std::vector<char> frame);
+  // `frame` is only read while the returned awaitable runs, so a transport can
+  // hand over a view of its receive buffer rather than a copy.
+  [[nodiscard]] Awaitable<Result> HandleFrame(std::span<const char> frame);
+  // Frames a whole service response as a single final chunk.
   [[nodiscard]] std::vector<char> BuildServiceResponse(std::uint32_t request_id,
                                                        std::vector<char> body);
+  // Frames one MessageChunk of a service response: 'C' intermediate, 'F'
+  // final, or 'A' abort, whose body is an Error code and Reason (OPC UA Part 6
+  // §6.7.3). Each chunk takes the next sequence number and, under
+  // Basic256Sha256, is signed and encrypted on its own, so a large response
+  // is written out chunk by chunk rather than framed whole. Empty if the
+  // chunk cannot be secured.
+  [[nodiscard]] std::vector<char> BuildServiceResponseChunk(
+      std::uint32_t request_id,
+      char chunk_type,
+      std::span<const char> body);
 
   [[nodiscard]] bool opened() const { return opened_; }
   [[nodiscard]] std::uint32_t channel_id() const { return channel_id_; }
@@ -208,11 +252,11 @@ class SecureChannel {
 
  private:
   // SecurityPolicy=None OpenSecureChannel handling (no crypto transforms).
-  [[nodiscard]] Result HandleOpenNone(const std::vector<char>& frame);
+  [[nodiscard]] Result HandleOpenNone(std::span<const char> frame);
   // Basic256Sha256 SignAndEncrypt OpenSecureChannel handling.
-  [[nodiscard]] Result HandleOpenSecure(const std::vector<char>& frame);
+  [[nodiscard]] Result HandleOpenSecure(std::span<const char> frame);
   // Symmetric (MSG / CLO) handling under Basic256Sha256 SignAndEncrypt.
-  [[nodiscard]] Result HandleSecureMessage(const std::vector<char>& frame,
+  [[nodiscard]] Result HandleSecureMessage(std::span<const char> frame,
                                            bool is_close);
 
   [[nodiscard]] std::vector<char> BuildOpenResponse(
@@ -227,10 +271,11 @@ class SecureChannel {
       const crypto::PrivateKey& client_public_key,
       const ByteString& client_certificate_thumbprint,
       const ByteString& server_nonce);
-  // Symmetric SignAndEncrypt frame for an outbound MSG body.
+  // Symmetric SignAndEncrypt chunk for an outbound MSG body slice.
   [[nodiscard]] StatusOr<std::vector<char>> BuildSecureServiceResponse(
       std::uint32_t request_id,
-      const std::vector<char>& body);
+      char chunk_type,
+      std::span<const char> body);
 
   std::shared_ptr<const SecureChannelServerConfig> config_;
   std::uint32_t channel_id_;
@@ -243,11 +288,12 @@ class SecureChannel {
   std::uint32_t next_sequence_number_ = 1;
   bool opened_ = false;
 
-  // Basic256Sha256 SignAndEncrypt state. inbound_keys_ verify/decrypt client
-  // traffic; outbound_keys_ sign/encrypt server traffic (OPC UA Part 6 §6.7.5).
+  // Basic256Sha256 SignAndEncrypt state, re-keyed at Open and every Renew.
+  // inbound_crypto_ verifies/decrypts client traffic; outbound_crypto_
+  // signs/encrypts server traffic (OPC UA Part 6 §6.7.5).
   bool basic256_active_ = false;
-  crypto::DerivedKeys inbound_keys_;
-  crypto::DerivedKeys outbound_keys_;
+  crypto::SymmetricContext inbound_crypto_;
+  crypto::SymmetricContext outbound_crypto_;
   ByteString server_nonce_;
   ByteString client_certificate_der_;
 };
@@ -5,7 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstring>
+#include <span>
 #include <string_view>
 
 namespace opcua::binary {
@@ -325,6 +327,61 @@ TEST(SecureChannelTest, RoutesMessageBodyAfterOpen) {
   EXPECT_EQ(response->body, (std::vector<char>{'o', 'k'}));
 }
 
+TEST(SecureChannelTest, ChunkBodySizeFitsChunksToTheReceiveBuffer) {
+  // None: 16 bytes of headers in the clear plus the 8-byte sequence header.
+  EXPECT_EQ(ChunkBodySize(1000, {.buffer_size = 124}, false), 100u);
+  // SignAndEncrypt: 16 clear bytes, then whole AES blocks holding the sequence
+  // header, body, PaddingSize byte and 32-byte signature. 130 leaves 112
+  // encrypted bytes (7 blocks), so 112 - 8 - 1 - 32 = 71 body bytes.
+  EXPECT_EQ(ChunkBodySize(1000, {.buffer_size = 130}, true), 71u);
+  // A body that fits whole is not split, and no limit means one chunk.
+  EXPECT_EQ(ChunkBodySize(10, {.buffer_size = 124}, false), 10u);
+  EXPECT_EQ(ChunkBodySize(1000, {}, true), 1000u);
+
+  EXPECT_FALSE(ChunkBodySize(1000, {.buffer_size = 24}, false).has_value());
+  EXPECT_FALSE(ChunkBodySize(1000, {.max_message_size = 999}, false));
+  // 1000 bytes at 100 per chunk is 10 chunks.
+  EXPECT_TRUE(ChunkBodySize(1000, {.buffer_size = 124, .max_chunk_count = 10},
+                            false));
+  EXPECT_FALSE(ChunkBodySize(1000, {.buffer_size = 124, .max_chunk_count = 9},
+                             false));
+}
+
+TEST(SecureChannelTest, ResponseChunksReassembleWithinTheBuffer) {
+  SecureChannel channel{7};
+  std::vector<char> body(250);
+  for (std::size_t i = 0; i < body.size(); ++i) {
+    body[i] = static_cast<char>(i);
+  }
+  constexpr ChunkLimits kLimits{.buffer_size = 124};
+  const auto chunk_body_size = ChunkBodySize(body.size(), kLimits, false);
+  ASSERT_TRUE(chunk_body_size.has_value());
+
+  std::vector<char> reassembled;
+  std::vector<char> chunk_types;
+  std::uint32_t last_sequence_number = 0;
+  for (std::size_t offset = 0; offset < body.size();
+       offset += *chunk_body_size) {
+    const auto slice = std::span{body}.subspan(
+        offset, std::min(*chunk_body_size, body.size() - offset));
+    const bool last = offset + slice.size() == body.size();
+    const auto frame =
+        channel.BuildServiceResponseChunk(9, last ? 'F' : 'C', slice);
+    EXPECT_LE(frame.size(), kLimits.buffer_size);
+
+    const auto chunk = DecodeSecureConversationMessage(frame);
+    ASSERT_TRUE(chunk.has_value());
+    EXPECT_EQ(chunk->sequence_header.request_id, 9u);
+    EXPECT_GT(chunk->sequence_header.sequence_number, last_sequence_number);
+    last_sequence_number = chunk->sequence_header.sequence_number;
+    chunk_types.push_back(chunk->frame_header.chunk_type);
+    reassembled.insert(reassembled.end(), chunk->body.begin(),
+                       chunk->body.end());
+  }
+  EXPECT_EQ(chunk_types, (std::vector<char>{'C', 'C', 'F'}));
+  EXPECT_EQ(reassembled, body);
+}
+
 // Regression: the Renew response must advertise the token the server expects
 // NEXT (OPC UA Part 4 §5.5.2 ChannelSecurityToken) — it used to encode the
 // superseded id (rotation happened after building the response), so a client
@@ -553,6 +553,18 @@ std::optional<DecodedRequest> DecodeRepublishRequest(
                         .body = subscription_conversion::ToManaged(request)};
 }
 
+// A service message behind the NodeId of its encoding (see AppendMessage),
+// written into one buffer reserved at the message's exact size.
+template <class Message>
+std::vector<char> EncodeMessage(const Message& message) {
+  const NodeId type_id{Message::kBinaryEncodingId};
+  std::vector<char> body;
+  Encoder encoder{body, EncodedSize(type_id) + ua::EncodedSize(message)};
+  encoder.Encode(type_id);
+  ua::Encode(encoder, message);
+  return body;
+}
+
 }  // namespace
 
 // -- ua:: wire projection -----------------------------------------------------
@@ -681,15 +693,7 @@ std::optional<std::vector<char>> EncodeServiceRequest(
         ua::ApplyRequestEnvelope(message.request_header,
                                  header.authentication_token,
                                  header.request_handle, header.trace_parent);
-        std::vector<char> payload;
-        std::vector<char> body;
-        Encoder payload_encoder{payload};
-        Encoder body_encoder{body};
-        ua::Encode(payload_encoder, message);
-        AppendMessage(body_encoder,
-                      std::decay_t<decltype(message)>::kBinaryEncodingId,
-                      payload);
-        return body;
+        return EncodeMessage(message);
       },
       request);
 }
@@ -920,15 +924,7 @@ std::optional<std::vector<char>> EncodeServiceResponse(
         auto message = ToWireResponse(typed_response);
         message.response_header = ua::MakeResponseHeader(
             request_handle, message.response_header.service_result);
-        std::vector<char> payload;
-        std::vector<char> body;
-        Encoder payload_encoder{payload};
-        Encoder body_encoder{body};
-        ua::Encode(payload_encoder, message);
-        AppendMessage(body_encoder,
-                      std::decay_t<decltype(message)>::kBinaryEncodingId,
-                      payload);
-        return body;
+        return EncodeMessage(message);
       },
       response);
 }
@@ -1,9 +1,13 @@
 #include "opcua/transport/binary/tcp_connection.h"
 
 #include "opcua/base/boost_log.h"
+#include "opcua/transport/binary/codec_utils.h"
 
 #include <algorithm>
 #include <exception>
+#include <span>
+#include <string>
+#include <utility>
 
 namespace opcua::binary {
 namespace {
@@ -21,13 +25,6 @@ constexpr char kAbortChunk = 'A';
 // max_chunk_count (0 = unlimited on the wire).
 constexpr std::size_t kDefaultMaxChunkCount = 8192;
 
-std::vector<char> SubspanToVector(const std::vector<char>& bytes,
-                                  std::size_t offset,
-                                  std::size_t size) {
-  return {bytes.begin() + static_cast<std::ptrdiff_t>(offset),
-          bytes.begin() + static_cast<std::ptrdiff_t>(offset + size)};
-}
-
 }  // namespace
 
 TcpConnection::TcpConnection(TcpConnectionContext&& context)
@@ -38,8 +35,7 @@ Awaitable<void> TcpConnection::Run() {
   [[maybe_unused]] auto open_result = co_await transport.open();
   peer_ = transport.peer();
   transport::WriteQueue write_queue{transport};
-  std::vector<char> read_buffer(read_buffer_size);
-  std::vector<char> pending_bytes;
+  FrameBuffer buffer{read_buffer_size};
 
   // This drain covers every path that RETURNS from the read loop. It
   // deliberately does not cover an unwind: catching to re-run it would mean
@@ -47,15 +43,13 @@ Awaitable<void> TcpConnection::Run() {
   // co_await. A service frame that outlives the connection instead has to
   // detect that for itself — see the `alive_` token in StartServiceFrame.
   for (;;) {
-    auto read_result = co_await transport.read(read_buffer);
+    auto read_result = co_await transport.read(buffer.PrepareRead());
     if (!read_result.ok() || *read_result == 0) {
       break;
     }
 
-    pending_bytes.insert(
-        pending_bytes.end(), read_buffer.begin(),
-        read_buffer.begin() + static_cast<std::ptrdiff_t>(*read_result));
-    if (!(co_await ProcessBufferedFrames(write_queue, pending_bytes))) {
+    buffer.CommitRead(*read_result);
+    if (!(co_await ProcessBufferedFrames(write_queue, buffer))) {
       break;
     }
   }
@@ -66,14 +60,13 @@ Awaitable<void> TcpConnection::Run() {
 
 Awaitable<bool> TcpConnection::ProcessBufferedFrames(
     transport::WriteQueue& write_queue,
-    std::vector<char>& pending_bytes) {
+    FrameBuffer& buffer) {
   for (;;) {
-    if (pending_bytes.size() < 8) {
+    if (buffer.size() < 8) {
       co_return true;
     }
 
-    const auto header = DecodeFrameHeader(
-        std::vector<char>{pending_bytes.begin(), pending_bytes.begin() + 8});
+    const auto header = DecodeFrameHeader(buffer.data().first(8));
     if (!header.has_value()) {
       co_return co_await WriteErrorAndClose(write_queue, StatusCode::Bad,
                                             "Invalid UA TCP frame header");
@@ -82,22 +75,23 @@ Awaitable<bool> TcpConnection::ProcessBufferedFrames(
       co_return co_await WriteErrorAndClose(write_queue, StatusCode::Bad,
                                             "UA TCP frame too large");
     }
-    if (pending_bytes.size() < header->message_size) {
+    if (buffer.size() < header->message_size) {
       co_return true;
     }
 
-    auto frame = SubspanToVector(pending_bytes, 0, header->message_size);
-    pending_bytes.erase(pending_bytes.begin(),
-                        pending_bytes.begin() +
-                            static_cast<std::ptrdiff_t>(header->message_size));
+    // The frame is handled where it was received: nothing else touches the
+    // buffer until this returns, and whatever outlives the frame (a service
+    // payload) is copied out by SecureChannel.
+    const auto frame = buffer.data().first(header->message_size);
     if (!(co_await ProcessFrame(write_queue, frame))) {
       co_return false;
     }
+    buffer.Consume(header->message_size);
   }
 }
 
 Awaitable<bool> TcpConnection::ProcessFrame(transport::WriteQueue& write_queue,
-                                            const std::vector<char>& frame) {
+                                            std::span<const char> frame) {
   const auto header = DecodeFrameHeader(frame);
   if (!header.has_value()) {
     co_return co_await WriteErrorAndClose(write_queue, StatusCode::Bad,
@@ -127,6 +121,11 @@ Awaitable<bool> TcpConnection::ProcessFrame(transport::WriteQueue& write_queue,
       }
 
       hello_received_ = true;
+      send_limits_ = {
+          .buffer_size = negotiated.acknowledge->send_buffer_size,
+          .max_message_size = hello->max_message_size,
+          .max_chunk_count = hello->max_chunk_count,
+      };
       const auto encoded = EncodeAcknowledgeMessage(*negotiated.acknowledge);
       [[maybe_unused]] auto write_result =
           co_await write_queue.Write({encoded.data(), encoded.size()});
@@ -271,10 +270,9 @@ void TcpConnection::StartServiceFrame(transport::WriteQueue write_queue,
                 co_return;
               }
               if (outbound_payload.has_value() && !outbound_payload->empty()) {
-                auto outbound_frame = secure_channel_.BuildServiceResponse(
-                    request_id, std::move(*outbound_payload));
-                [[maybe_unused]] auto write_result = co_await write_queue.Write(
-                    {outbound_frame.data(), outbound_frame.size()});
+                co_await WriteServiceResponse(write_queue, request_id,
+                                              std::move(*outbound_payload),
+                                              alive);
                 if (alive.expired()) {
                   co_return;
                 }
@@ -299,6 +297,67 @@ void TcpConnection::StartServiceFrame(transport::WriteQueue write_queue,
           });
 }
 
+Awaitable<void> TcpConnection::WriteServiceResponse(
+    transport::WriteQueue& write_queue,
+    std::uint32_t request_id,
+    std::vector<char> body,
+    std::weak_ptr<bool> alive) {
+  // Queue behind the response started before this one. The gate is completed
+  // on every exit, so a response that fails or is cancelled cannot stall the
+  // ones queued behind it.
+  auto previous = std::exchange(
+      last_response_written_, base::AsyncCompletion{transport.get_executor()});
+  struct CompleteOnExit {
+    base::AsyncCompletion written;
+    ~CompleteOnExit() { written.Complete(); }
+  } complete_on_exit{*last_response_written_};
+  if (previous.has_value()) {
+    co_await previous->Wait();
+    if (alive.expired()) {
+      co_return;
+    }
+  }
+
+  const auto chunk_body_size =
+      ChunkBodySize(body.size(), send_limits_, secure_channel_.secure());
+  if (!chunk_body_size.has_value()) {
+    // Nothing of the response has been sent, so an abort chunk fails just
+    // this request and leaves the channel usable (OPC UA Part 6 §6.7.3).
+    LOG_WARNING(logger_) << "OPC UA service response exceeds client limits"
+                         << LOG_TAG("RequestId", request_id)
+                         << LOG_TAG("Size", body.size())
+                         << LOG_TAG("Peer", peer_);
+    std::vector<char> abort_body;
+    Encoder encoder{abort_body};
+    encoder.Encode(Status{StatusCode::Bad_ResponseTooLarge}.full_code());
+    encoder.Encode(std::string{"Response exceeds the negotiated limits"});
+    const auto frame = secure_channel_.BuildServiceResponseChunk(
+        request_id, kAbortChunk, abort_body);
+    [[maybe_unused]] auto write_result =
+        co_await write_queue.Write({frame.data(), frame.size()});
+    co_return;
+  }
+
+  // Only the chunk being written is held framed (and encrypted) at a time.
+  std::span<const char> remaining{body};
+  do {
+    const auto slice =
+        remaining.first(std::min(*chunk_body_size, remaining.size()));
+    remaining = remaining.subspan(slice.size());
+    const auto frame = secure_channel_.BuildServiceResponseChunk(
+        request_id, remaining.empty() ? kFinalChunk : kIntermediateChunk,
+        slice);
+    if (frame.empty()) {
+      co_return;
+    }
+    [[maybe_unused]] auto write_result =
+        co_await write_queue.Write({frame.data(), frame.size()});
+    if (alive.expired()) {
+      co_return;
+    }
+  } while (!remaining.empty());
+}
+
 Awaitable<void> TcpConnection::WaitForServiceFrames() {
   if (pending_service_frames_ == 0 || !service_frames_drained_.has_value()) {
     co_return;
@@ -2,6 +2,7 @@
 
 #include "opcua/base/async_completion.h"
 #include "opcua/base/awaitable.h"
+#include "opcua/transport/binary/frame_buffer.h"
 #include "opcua/transport/binary/protocol.h"
 #include "opcua/transport/binary/secure_channel.h"
 
@@ -11,6 +12,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -48,11 +50,12 @@ class TcpConnection : private TcpConnectionContext {
   [[nodiscard]] Awaitable<void> Run();
 
  private:
+  // Handles every complete frame at the head of `buffer`, in place.
   [[nodiscard]] Awaitable<bool> ProcessBufferedFrames(
       transport::WriteQueue& write_queue,
-      std::vector<char>& pending_bytes);
+      FrameBuffer& buffer);
   [[nodiscard]] Awaitable<bool> ProcessFrame(transport::WriteQueue& write_queue,
-                                             const std::vector<char>& frame);
+                                             std::span<const char> frame);
   // Reassembles a SecureMessage split across MessageChunks: 'C' intermediate
   // chunk bodies are accumulated, 'F' final dispatches the whole message, 'A'
   // aborts and discards the partial message. Enforces max chunk count and total
@@ -67,6 +70,15 @@ class TcpConnection : private TcpConnectionContext {
   void StartServiceFrame(transport::WriteQueue write_queue,
                          std::vector<char> payload,
                          std::uint32_t request_id);
+  // Writes a service response as MessageChunks within send_limits_, each
+  // framed just before it is written. Responses are written one at a time, in
+  // the order they complete. A response beyond the client's limits fails with
+  // an abort chunk carrying Bad_ResponseTooLarge.
+  [[nodiscard]] Awaitable<void> WriteServiceResponse(
+      transport::WriteQueue& write_queue,
+      std::uint32_t request_id,
+      std::vector<char> body,
+      std::weak_ptr<bool> alive);
   [[nodiscard]] Awaitable<void> WaitForServiceFrames();
   void FinishServiceFrame();
   [[nodiscard]] Awaitable<bool> WriteErrorAndClose(
@@ -75,12 +87,18 @@ class TcpConnection : private TcpConnectionContext {
       std::string reason);
 
   bool hello_received_ = false;
+  // What the client accepts, from its Hello and our Acknowledge.
+  ChunkLimits send_limits_;
   // Remote peer ("address:port") captured while the transport is connected,
   // so failure logs can still identify the client after disconnect.
   std::string peer_;
   SecureChannel secure_channel_;
   std::size_t pending_service_frames_ = 0;
   std::optional<base::AsyncCompletion> service_frames_drained_;
+  // Completes once the most recently started response is fully written. The
+  // client reassembles one message at a time, so the chunks of two responses
+  // must never interleave on the wire.
+  std::optional<base::AsyncCompletion> last_response_written_;
 
   // Liveness token for the detached service-frame coroutines StartServiceFrame
   // spawns. Run()'s drain covers every path that *returns*, but a cancelled
@@ -0,0 +1,308 @@
+#include "opcua/transport/websocket/acceptor.h"
+
+#include "opcua/transport/websocket/subprotocol.h"
+
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/ssl/ssl_stream.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+#include <chrono>
+#include <span>
+
+namespace opcua::ws {
+
+namespace {
+
+namespace http = boost::beast::http;
+namespace websocket = boost::beast::websocket;
+using boost::asio::ip::tcp;
+
+// Covers the TCP, TLS and HTTP exchanges before the upgrade; Beast's own
+// handshake timeout covers the rest.
+constexpr std::chrono::seconds kHandshakeTimeout{30};
+
+auto RedirectError(boost::system::error_code& error) {
+  return boost::asio::redirect_error(boost::asio::use_awaitable, error);
+}
+
+std::string FormatPeer(const tcp::socket& socket) {
+  boost::system::error_code error;
+  const auto endpoint = socket.remote_endpoint(error);
+  if (error)
+    return {};
+  return endpoint.address().to_string() + ":" +
+         std::to_string(endpoint.port());
+}
+
+// An upgraded connection, in the shape of a transport. Writes go out as one
+// message each, binary or text as set in the handshake.
+//
+// A message-oriented connection (JSON) hands a message over in pieces, so the
+// reader needs no buffer as large as the largest message allowed: a read fills
+// the span it is given and only a read that comes up short of it ends the
+// message. A message that ends exactly where the span does is followed by an
+// empty read (see ReceiveBuffer). A stream connection (UA Secure Conversation,
+// whose chunks carry their own length) returns what has arrived, and an empty
+// read only once the connection has closed.
+template <typename Stream>
+class Connection {
+ public:
+  Connection(std::unique_ptr<websocket::stream<Stream>> websocket,
+             bool message_oriented,
+             std::string name,
+             std::string peer)
+      : websocket_{std::move(websocket)},
+        message_oriented_{message_oriented},
+        name_{std::move(name)},
+        peer_{std::move(peer)} {}
+  Connection(Connection&&) = default;
+  Connection& operator=(Connection&&) = default;
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  // Already open: the handshake opened it.
+  transport::awaitable<transport::error_code> open() {
+    co_return transport::OK;
+  }
+
+  transport::awaitable<transport::error_code> close() {
+    if (!websocket_->is_open())
+      co_return transport::OK;
+    boost::system::error_code error;
+    co_await websocket_->async_close(websocket::close_code::normal,
+                                     RedirectError(error));
+    co_return error;
+  }
+
+  transport::awaitable<transport::expected<transport::any_transport>> accept() {
+    co_return transport::ERR_NOT_IMPLEMENTED;
+  }
+
+  transport::awaitable<transport::expected<size_t>> read(std::span<char> data) {
+    if (message_ended_) {
+      message_ended_ = false;
+      co_return size_t{0};
+    }
+
+    std::size_t size = 0;
+    while (size < data.size()) {
+      boost::system::error_code error;
+      size += co_await websocket_->async_read_some(
+          boost::asio::buffer(data.data() + size, data.size() - size),
+          RedirectError(error));
+      // Closed between messages is the end of the connection; closed halfway
+      // through one is an error, not a shorter message.
+      if (error == websocket::error::closed && !in_message_ && size == 0)
+        co_return size_t{0};
+      if (error)
+        co_return error;
+      if (!message_oriented_)
+        co_return size;
+      if (websocket_->is_message_done()) {
+        in_message_ = false;
+        message_ended_ = size == data.size();
+        co_return size;
+      }
+    }
+
+    in_message_ = true;
+    co_return size;
+  }
+
+  transport::awaitable<transport::expected<size_t>> write(
+      std::span<const char> data) {
+    boost::system::error_code error;
+    const auto size = co_await websocket_->async_write(
+        boost::asio::buffer(data.data(), data.size()), RedirectError(error));
+    if (error)
+      co_return error;
+    co_return size;
+  }
+
+  std::string name() const { return name_; }
+  std::string peer() const { return peer_; }
+  bool message_oriented() const { return message_oriented_; }
+  bool connected() const { return websocket_->is_open(); }
+  bool active() const { return false; }
+  transport::executor get_executor() { return websocket_->get_executor(); }
+
+ private:
+  std::unique_ptr<websocket::stream<Stream>> websocket_;
+  bool message_oriented_;
+  std::string name_;
+  std::string peer_;
+  bool in_message_ = false;
+  bool message_ended_ = false;
+};
+
+template <typename Stream>
+Awaitable<void> Refuse(Stream& stream,
+                       const HandshakeRequest& request,
+                       http::status status,
+                       std::string_view body) {
+  http::response<http::string_body> response{status, request.version()};
+  response.set(http::field::content_type, "text/plain");
+  response.keep_alive(false);
+  response.body() = body;
+  response.prepare_payload();
+  boost::system::error_code error;
+  co_await http::async_write(stream, response, RedirectError(error));
+  boost::beast::get_lowest_layer(stream).socket().shutdown(
+      tcp::socket::shutdown_send, error);
+}
+
+template <typename Stream>
+Awaitable<transport::expected<AcceptedConnection>> Upgrade(
+    const AcceptorContext& context,
+    const HandshakeOptions& options,
+    Stream stream,
+    std::string_view name,
+    std::string peer) {
+  boost::beast::flat_buffer buffer;
+  HandshakeRequest request;
+  boost::system::error_code error;
+  co_await http::async_read(stream, buffer, request, RedirectError(error));
+  if (error)
+    co_return error;
+
+  if (!websocket::is_upgrade(request)) {
+    co_await Refuse(stream, request, http::status::bad_request,
+                    "WebSocket upgrade expected");
+    co_return transport::ERR_INVALID_ARGUMENT;
+  }
+
+  if (context.handshake_callback) {
+    if (auto reject = context.handshake_callback(request)) {
+      co_await Refuse(stream, request, reject->status, reject->body);
+      co_return transport::ERR_INVALID_ARGUMENT;
+    }
+  }
+
+  const auto offered = request[http::field::sec_websocket_protocol];
+  const auto subprotocol = SelectSubprotocol(
+      std::string_view{offered.data(), offered.size()}, options.uacp_served);
+  if (!subprotocol) {
+    co_await Refuse(stream, request, http::status::bad_request,
+                    "Unsupported subprotocol");
+    co_return transport::ERR_INVALID_ARGUMENT;
+  }
+
+  auto websocket = std::make_unique<websocket::stream<Stream>>(
+      std::move(stream));
+  boost::beast::get_lowest_layer(*websocket).expires_never();
+  websocket->set_option(websocket::stream_base::timeout::suggested(
+      boost::beast::role_type::server));
+  websocket->set_option(websocket::stream_base::decorator(
+      [subprotocol = *subprotocol, callback = context.response_callback](
+          websocket::response_type& response) {
+        if (callback)
+          callback(response);
+        response.set(http::field::sec_websocket_protocol,
+                     boost::beast::string_view{subprotocol.data(),
+                                               subprotocol.size()});
+      }));
+  if (options.permessage_deflate)
+    websocket->set_option(*options.permessage_deflate);
+  websocket->read_message_max(options.max_message_size);
+  // UA Secure Conversation chunks are bytes, JSON is UTF-8 text (OPC UA
+  // Part 6 §7.5.2).
+  const bool uacp = *subprotocol == kUacpSubprotocol;
+  websocket->binary(uacp);
+
+  co_await websocket->async_accept(request, RedirectError(error));
+  if (error)
+    co_return error;
+
+  co_return AcceptedConnection{
+      .transport = transport::any_transport{Connection<Stream>{
+          std::move(websocket), /*message_oriented=*/!uacp, std::string{name},
+          std::move(peer)}},
+      .subprotocol = *subprotocol};
+}
+
+}  // namespace
+
+Acceptor::Acceptor(AcceptorContext context) : context_{std::move(context)} {}
+
+Acceptor::~Acceptor() = default;
+
+Awaitable<transport::error_code> Acceptor::Open() {
+  tcp::resolver resolver{context_.executor};
+  boost::system::error_code error;
+  const auto endpoints = co_await resolver.async_resolve(
+      context_.host, context_.port, RedirectError(error));
+  if (error)
+    co_return error;
+  if (endpoints.empty())
+    co_return transport::ERR_INVALID_ARGUMENT;
+
+  const tcp::endpoint endpoint = *endpoints.begin();
+  tcp::acceptor acceptor{context_.executor};
+  acceptor.open(endpoint.protocol(), error);
+  if (!error)
+    acceptor.set_option(tcp::acceptor::reuse_address{true}, error);
+  if (!error)
+    acceptor.bind(endpoint, error);
+  if (!error)
+    acceptor.listen(tcp::acceptor::max_listen_connections, error);
+  if (error)
+    co_return error;
+
+  acceptor_.emplace(std::move(acceptor));
+  co_return transport::OK;
+}
+
+transport::error_code Acceptor::Close() {
+  if (!acceptor_)
+    return transport::OK;
+  boost::system::error_code error;
+  acceptor_->close(error);
+  return error;
+}
+
+unsigned short Acceptor::port() const {
+  if (!acceptor_)
+    return 0;
+  boost::system::error_code error;
+  return acceptor_->local_endpoint(error).port();
+}
+
+Awaitable<transport::expected<tcp::socket>> Acceptor::Accept() {
+  if (!acceptor_ || !acceptor_->is_open())
+    co_return transport::ERR_ABORTED;
+  boost::system::error_code error;
+  auto socket = co_await acceptor_->async_accept(RedirectError(error));
+  if (error)
+    co_return error;
+  co_return std::move(socket);
+}
+
+Awaitable<transport::expected<AcceptedConnection>> Acceptor::Handshake(
+    tcp::socket socket,
+    HandshakeOptions options) const {
+  auto peer = FormatPeer(socket);
+  boost::beast::tcp_stream stream{std::move(socket)};
+  stream.expires_after(kHandshakeTimeout);
+  if (!context_.tls_context) {
+    co_return co_await Upgrade(context_, options, std::move(stream),
+                               "WebSocket", std::move(peer));
+  }
+
+  boost::beast::ssl_stream<boost::beast::tcp_stream> tls_stream{
+      std::move(stream), *context_.tls_context};
+  boost::system::error_code error;
+  co_await tls_stream.async_handshake(boost::asio::ssl::stream_base::server,
+                                      RedirectError(error));
+  if (error)
+    co_return error;
+  co_return co_await Upgrade(context_, options, std::move(tls_stream),
+                             "WebSocket TLS", std::move(peer));
+}
+
+}  // namespace opcua::ws
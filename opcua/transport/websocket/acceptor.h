@@ -0,0 +1,99 @@
+#pragma once
+
+#include "opcua/base/awaitable.h"
+
+#include <transport/any_transport.h>
+#include <transport/error.h>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/status.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/rfc6455.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace opcua::ws {
+
+using HandshakeRequest =
+    boost::beast::http::request<boost::beast::http::string_body>;
+
+// Refuses a WebSocket upgrade with an HTTP error answer.
+struct HandshakeReject {
+  boost::beast::http::status status;
+  std::string body;
+};
+
+struct AcceptorContext {
+  transport::executor executor;
+  std::string host;
+  // "0" binds a free port; Acceptor::port() says which.
+  std::string port;
+  // Serves wss:// with this context (see tls_context.h); null serves ws://.
+  std::shared_ptr<boost::asio::ssl::context> tls_context;
+  // Vets the upgrade request, e.g. its target and Origin, before a
+  // subprotocol is chosen.
+  std::function<std::optional<HandshakeReject>(const HandshakeRequest&)>
+      handshake_callback;
+  // Adds headers to the 101 answer, e.g. Server.
+  std::function<void(boost::beast::websocket::response_type&)>
+      response_callback;
+};
+
+// What the server serves on a connection, which the handshake settles.
+struct HandshakeOptions {
+  std::size_t max_message_size = 4 * 1024 * 1024;
+  bool uacp_served = false;
+  // Offers permessage-deflate with these options (see permessage_deflate.h).
+  std::optional<boost::beast::websocket::permessage_deflate>
+      permessage_deflate;
+};
+
+// A connection whose opening handshake is done, and the OPC UA subprotocol it
+// agreed (kUaJsonSubprotocol or kUacpSubprotocol, see subprotocol.h).
+struct AcceptedConnection {
+  transport::any_transport transport;
+  std::string_view subprotocol;
+};
+
+// Listens for WebSocket clients. The opening handshake (RFC 6455 §4.2) is run
+// here rather than in a generic transport because OPC UA settles the encoding
+// in it: the subprotocol the client offers picks JSON or UA Secure
+// Conversation, the answer has to name it, and a UACP connection must send
+// binary messages — a browser drops a text message that is not UTF-8.
+class Acceptor {
+ public:
+  explicit Acceptor(AcceptorContext context);
+  ~Acceptor();
+
+  Acceptor(const Acceptor&) = delete;
+  Acceptor& operator=(const Acceptor&) = delete;
+
+  [[nodiscard]] Awaitable<transport::error_code> Open();
+  transport::error_code Close();
+
+  // The port listened on, once open.
+  unsigned short port() const;
+
+  // Waits for the next TCP connection. Fails once closed.
+  [[nodiscard]] Awaitable<transport::expected<boost::asio::ip::tcp::socket>>
+  Accept();
+
+  // Runs the TLS and WebSocket handshakes on an accepted socket. A client
+  // that offers no subprotocol the server serves is refused with 400.
+  [[nodiscard]] Awaitable<transport::expected<AcceptedConnection>> Handshake(
+      boost::asio::ip::tcp::socket socket,
+      HandshakeOptions options) const;
+
+ private:
+  const AcceptorContext context_;
+  std::optional<boost::asio::ip::tcp::acceptor> acceptor_;
+};
+
+}  // namespace opcua::ws
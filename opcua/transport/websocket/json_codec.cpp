@@ -10,6 +10,7 @@
 // history_conversion produces, before transcoding them to JSON bodies.
 #include "opcua/ua/ua_binary_codec.h"
 #include "opcua/ua/ua_json_codec.h"
+#include "opcua/ua/ua_json_writer.h"
 
 #include <boost/json.hpp>
 
@@ -1054,6 +1055,50 @@ boost::json::value EncodeJson(const ServiceResponse& response) {
       response);
 }
 
+namespace detail {
+
+// The members EncodeJson(ServiceResponse) builds for `response`, one of its
+// alternatives, streamed into the object `writer` has open. Taking the
+// alternative itself spares the caller wrapping it in a ServiceResponse copy.
+template <class Response>
+void WriteServiceResponse(ua::json::Writer& writer, const Response& response) {
+  writer.Key("service");
+  writer.String(Response::kServiceName);
+  writer.Key("body");
+  if constexpr (std::is_same_v<Response, ua::HistoryReadResponse> ||
+                std::is_same_v<Response, ua::ReadResponse>) {
+    ua::WriteJson(writer, WithJsonBodies(response));
+  } else {
+    ua::WriteJson(writer, response);
+  }
+}
+
+// One per ServiceResponse alternative, the types SerializeJson passes.
+template void WriteServiceResponse(ua::json::Writer&, const ua::ReadResponse&);
+template void WriteServiceResponse(ua::json::Writer&, const ua::WriteResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::BrowseResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::BrowseNextResponse&);
+template void WriteServiceResponse(
+    ua::json::Writer&,
+    const ua::TranslateBrowsePathsToNodeIdsResponse&);
+template void WriteServiceResponse(ua::json::Writer&, const ua::CallResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::HistoryReadResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::HistoryUpdateResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::AddNodesResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::DeleteNodesResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::AddReferencesResponse&);
+template void WriteServiceResponse(ua::json::Writer&,
+                                   const ua::DeleteReferencesResponse&);
+
+}  // namespace detail
+
 namespace {
 
 // Decodes a conformant ua:: JSON body when the envelope's service matches the
@@ -1099,11 +1144,15 @@ std::optional<ServiceResponse> DecodeAnyJsonResponse(
 
 }  // namespace
 
-StatusOr<ServiceRequest> DecodeServiceRequest(const boost::json::value& json) {
+namespace detail {
+
+// The bodies the generated codec decodes, by service name, for a caller that
+// has already taken the envelope apart. The generated decoders report a
+// malformed field by throwing ua::json::Error; it goes no further than here.
+StatusOr<ServiceRequest> DecodeServiceRequestBody(
+    std::string_view service,
+    const boost::json::value& body) {
   try {
-    const auto& obj = RequireObject(json);
-    const auto& body = RequireField(obj, "body");
-    auto service = RequireString(RequireField(obj, "service"));
     if (auto request = DecodeAnyJsonRequest<
             ua::ReadRequest, ua::WriteRequest, ua::BrowseRequest,
             ua::BrowseNextRequest, ua::TranslateBrowsePathsToNodeIdsRequest,
@@ -1117,12 +1166,10 @@ StatusOr<ServiceRequest> DecodeServiceRequest(const boost::json::value& json) {
   }
 }
 
-StatusOr<ServiceResponse> DecodeServiceResponse(
-    const boost::json::value& json) {
+StatusOr<ServiceResponse> DecodeServiceResponseBody(
+    std::string_view service,
+    const boost::json::value& body) {
   try {
-    const auto& obj = RequireObject(json);
-    const auto& body = RequireField(obj, "body");
-    auto service = RequireString(RequireField(obj, "service"));
     if (auto response = DecodeAnyJsonResponse<
             ua::ReadResponse, ua::WriteResponse, ua::BrowseResponse,
             ua::BrowseNextResponse, ua::TranslateBrowsePathsToNodeIdsResponse,
@@ -1136,4 +1183,29 @@ StatusOr<ServiceResponse> DecodeServiceResponse(
   }
 }
 
+}  // namespace detail
+
+StatusOr<ServiceRequest> DecodeServiceRequest(const boost::json::value& json) {
+  try {
+    const auto& obj = RequireObject(json);
+    const auto& body = RequireField(obj, "body");
+    auto service = RequireString(RequireField(obj, "service"));
+    return detail::DecodeServiceRequestBody(service, body);
+  } catch (...) {
+    return Status{StatusCode::Bad_TypeMismatch};
+  }
+}
+
+StatusOr<ServiceResponse> DecodeServiceResponse(
+    const boost::json::value& json) {
+  try {
+    const auto& obj = RequireObject(json);
+    const auto& body = RequireField(obj, "body");
+    auto service = RequireString(RequireField(obj, "service"));
+    return detail::DecodeServiceResponseBody(service, body);
+  } catch (...) {
+    return Status{StatusCode::Bad_TypeMismatch};
+  }
+}
+
 }  // namespace opcua::ws
@@ -4,8 +4,13 @@
 #include "opcua/services/service_message.h"
 #include "opcua/types/status_or.h"
 
+#include <boost/json/monotonic_resource.hpp>
+#include <boost/json/parser.hpp>
 #include <boost/json/value.hpp>
 
+#include <string>
+#include <string_view>
+
 namespace opcua::ws {
 
 boost::json::value EncodeJson(const ServiceRequest& request);
@@ -13,9 +18,37 @@ boost::json::value EncodeJson(const ServiceResponse& response);
 boost::json::value EncodeJson(const RequestMessage& request);
 boost::json::value EncodeJson(const ResponseMessage& response);
 
+// The text of `EncodeJson(response)`, byte for byte, written without building
+// the DOM for the services whose bodies have a generated writer (Publish and
+// the attribute, view, method, history and node-management services).
+std::string SerializeJson(const ResponseMessage& response);
+
 StatusOr<ServiceRequest> DecodeServiceRequest(const boost::json::value& json);
 StatusOr<ServiceResponse> DecodeServiceResponse(const boost::json::value& json);
 StatusOr<RequestMessage> DecodeRequestMessage(const boost::json::value& json);
 StatusOr<ResponseMessage> DecodeResponseMessage(const boost::json::value& json);
 
+// Decodes the request text arriving on one connection. Each message is parsed
+// into an arena owned by the decoder and released once the message has been
+// converted to its RequestMessage, so a connection reuses the same memory from
+// one request to the next instead of allocating a fresh DOM every time.
+// Malformed text and a malformed envelope come back as Bad_TypeMismatch
+// without an exception being thrown.
+class RequestDecoder {
+ public:
+  RequestDecoder();
+
+  RequestDecoder(const RequestDecoder&) = delete;
+  RequestDecoder& operator=(const RequestDecoder&) = delete;
+
+  StatusOr<RequestMessage> Decode(std::string_view payload);
+
+ private:
+  // Enough for the DOM of a typical request; a larger one spills into blocks
+  // the arena frees when it is released.
+  unsigned char initial_buffer_[4096];
+  boost::json::monotonic_resource arena_;
+  boost::json::parser parser_;
+};
+
 }  // namespace opcua::ws
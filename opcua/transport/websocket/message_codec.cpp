@@ -4,12 +4,15 @@
 #include "opcua/session/discovery_conversion.h"
 #include "opcua/session/session_conversion.h"
 #include "opcua/ua/ua_json_codec.h"
+#include "opcua/ua/ua_json_writer.h"
 #include "opcua/ua/ua_service_header.h"
 
 #include <boost/json.hpp>
 
 #include <limits>
+#include <optional>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
 
@@ -51,10 +54,14 @@ ua::DeleteSubscriptionsResponse DecodeDeleteSubscriptionsResponse(
 boost::json::value EncodePublishRequest(const PublishRequest& request);
 PublishRequest DecodePublishRequest(const boost::json::value& json);
 boost::json::value EncodePublishResponse(const PublishResponse& response);
+void WritePublishResponse(ua::json::Writer& writer,
+                          const PublishResponse& response);
 PublishResponse DecodePublishResponse(const boost::json::value& json);
 boost::json::value EncodeRepublishRequest(const RepublishRequest& request);
 RepublishRequest DecodeRepublishRequest(const boost::json::value& json);
 boost::json::value EncodeRepublishResponse(const RepublishResponse& response);
+void WriteRepublishResponse(ua::json::Writer& writer,
+                            const RepublishResponse& response);
 RepublishResponse DecodeRepublishResponse(const boost::json::value& json);
 boost::json::value EncodeTransferSubscriptionsRequest(
     const ua::TransferSubscriptionsRequest& request);
@@ -96,6 +103,15 @@ boost::json::value EncodeSetMonitoringModeResponse(
     const ua::SetMonitoringModeResponse& response);
 ua::SetMonitoringModeResponse DecodeSetMonitoringModeResponse(
     const boost::json::value& json);
+// Defined for each ServiceResponse alternative.
+template <class Response>
+void WriteServiceResponse(ua::json::Writer& writer, const Response& response);
+StatusOr<ServiceRequest> DecodeServiceRequestBody(
+    std::string_view service,
+    const boost::json::value& body);
+StatusOr<ServiceResponse> DecodeServiceResponseBody(
+    std::string_view service,
+    const boost::json::value& body);
 }  // namespace detail
 
 namespace {
@@ -127,12 +143,6 @@ const value& RequireField(const object& json, std::string_view key) {
   ThrowJsonError("Missing required field");
 }
 
-std::string_view RequireString(const value& json) {
-  if (!json.is_string())
-    ThrowJsonError("Expected JSON string");
-  return json.as_string();
-}
-
 std::uint64_t RequireUInt64(const value& json) {
   if (json.is_uint64())
     return json.as_uint64();
@@ -328,6 +338,38 @@ std::string ReadTraceParent(const boost::json::value& body) {
   }
 }
 
+// The `{requestHandle, service, body}` envelope every message shares.
+struct Envelope {
+  UInt32 request_handle = 0;
+  std::string_view service;
+  const value* body = nullptr;
+};
+
+// Reads the envelope without throwing. A peer sending garbage most often gets
+// the envelope wrong, and that is rejected here as a status before any body
+// decoder, with its exceptions, gets to run.
+std::optional<Envelope> ReadEnvelope(const value& json) {
+  const object* obj = json.if_object();
+  if (obj == nullptr)
+    return std::nullopt;
+  const value* body = obj->if_contains("body");
+  const value* service = obj->if_contains("service");
+  const value* request_handle = obj->if_contains("requestHandle");
+  if (body == nullptr || service == nullptr || !service->is_string() ||
+      request_handle == nullptr)
+    return std::nullopt;
+  std::uint64_t handle = 0;
+  if (request_handle->is_uint64())
+    handle = request_handle->as_uint64();
+  else if (request_handle->is_int64() && request_handle->as_int64() >= 0)
+    handle = static_cast<std::uint64_t>(request_handle->as_int64());
+  else
+    return std::nullopt;
+  return Envelope{.request_handle = static_cast<UInt32>(handle),
+                  .service = service->as_string(),
+                  .body = body};
+}
+
 }  // namespace
 
 boost::json::value EncodeJson(const RequestMessage& request) {
@@ -492,17 +534,56 @@ boost::json::value EncodeJson(const ResponseMessage& response) {
       response.body);
 }
 
+std::string SerializeJson(const ResponseMessage& response) {
+  std::string output;
+  ua::json::Writer writer{output};
+  std::visit(
+      [&](const auto& typed_response) {
+        using T = std::decay_t<decltype(typed_response)>;
+        if constexpr (std::is_same_v<T, PublishResponse> ||
+                      std::is_same_v<T, RepublishResponse> ||
+                      requires { ServiceResponse{typed_response}; }) {
+          writer.BeginObject();
+          writer.Key("requestHandle");
+          writer.UInt64(response.request_handle);
+          if constexpr (std::is_same_v<T, PublishResponse>) {
+            writer.Key("service");
+            writer.String("Publish");
+            writer.Key("body");
+            detail::WritePublishResponse(writer, typed_response);
+          } else if constexpr (std::is_same_v<T, RepublishResponse>) {
+            writer.Key("service");
+            writer.String("Republish");
+            writer.Key("body");
+            detail::WriteRepublishResponse(writer, typed_response);
+          } else {
+            detail::WriteServiceResponse(writer, typed_response);
+          }
+          writer.EndObject();
+        } else {
+          // The session, discovery and subscription-management responses are
+          // small and infrequent; they keep their DOM encoders.
+          writer.Value(EncodeJson(response));
+        }
+      },
+      response.body);
+  return output;
+}
+
 StatusOr<RequestMessage> DecodeRequestMessage(const boost::json::value& json) {
+  const auto envelope = ReadEnvelope(json);
+  if (!envelope)
+    return Status{StatusCode::Bad_TypeMismatch};
+  const auto& body = *envelope->body;
+  const auto service = envelope->service;
+  RequestMessage message{
+      .request_handle = envelope->request_handle,
+      .body = CloseSessionRequest{},
+      .trace_parent = ReadTraceParent(body),
+  };
+  // The session and subscription decoders below throw on a malformed body, as
+  // the generated codec they sit on does.
   try {
-    const auto& obj = RequireObject(json);
-    const auto& body = RequireField(obj, "body");
-    const auto service = RequireString(RequireField(obj, "service"));
-    RequestMessage message{
-        .request_handle = static_cast<UInt32>(
-            RequireUInt64(RequireField(obj, "requestHandle"))),
-        .body = CloseSessionRequest{},
-        .trace_parent = ReadTraceParent(body),
-    };
     if (service == "FindServers") {
       message.body = DecodeFindServersRequest(body);
     } else if (service == "GetEndpoints") {
@@ -536,8 +617,7 @@ StatusOr<RequestMessage> DecodeRequestMessage(const boost::json::value& json) {
     } else if (service == "SetMonitoringMode") {
       message.body = detail::DecodeSetMonitoringModeRequest(body);
     } else {
-      const object service_json{{"service", service}, {"body", body}};
-      auto decoded = DecodeServiceRequest(service_json);
+      auto decoded = detail::DecodeServiceRequestBody(service, body);
       if (!decoded.ok())
         return decoded.status();
       message.body = std::visit(
@@ -554,15 +634,16 @@ StatusOr<RequestMessage> DecodeRequestMessage(const boost::json::value& json) {
 
 StatusOr<ResponseMessage> DecodeResponseMessage(
     const boost::json::value& json) {
+  const auto envelope = ReadEnvelope(json);
+  if (!envelope)
+    return Status{StatusCode::Bad_TypeMismatch};
+  const auto& body = *envelope->body;
+  const auto service = envelope->service;
+  ResponseMessage message{
+      .request_handle = envelope->request_handle,
+      .body = CloseSessionResponse{},
+  };
   try {
-    const auto& obj = RequireObject(json);
-    const auto& body = RequireField(obj, "body");
-    const auto service = RequireString(RequireField(obj, "service"));
-    ResponseMessage message{
-        .request_handle = static_cast<UInt32>(
-            RequireUInt64(RequireField(obj, "requestHandle"))),
-        .body = CloseSessionResponse{},
-    };
     if (service == "FindServers") {
       message.body = DecodeFindServersResponse(body);
     } else if (service == "GetEndpoints") {
@@ -598,8 +679,7 @@ StatusOr<ResponseMessage> DecodeResponseMessage(
     } else if (service == "ServiceFault") {
       message.body = DecodeServiceFault(body);
     } else {
-      const object service_json{{"service", service}, {"body", body}};
-      auto decoded = DecodeServiceResponse(service_json);
+      auto decoded = detail::DecodeServiceResponseBody(service, body);
       if (!decoded.ok())
         return decoded.status();
       message.body = std::visit(
@@ -614,4 +694,26 @@ StatusOr<ResponseMessage> DecodeResponseMessage(
   }
 }
 
+RequestDecoder::RequestDecoder() : arena_{initial_buffer_} {}
+
+StatusOr<RequestMessage> RequestDecoder::Decode(std::string_view payload) {
+  parser_.reset(&arena_);
+  boost::json::error_code error;
+  parser_.write(payload.data(), payload.size(), error);
+  if (error) {
+    // Drop the partial DOM before the arena it was built in.
+    parser_.reset();
+    arena_.release();
+    return Status{StatusCode::Bad_TypeMismatch};
+  }
+
+  StatusOr<RequestMessage> message = [&] {
+    // The DOM lives in the arena and must be gone before it is released.
+    const value json = parser_.release();
+    return DecodeRequestMessage(json);
+  }();
+  arena_.release();
+  return message;
+}
+
 }  // namespace opcua::ws
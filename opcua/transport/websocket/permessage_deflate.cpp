@@ -0,0 +1,46 @@
+#include "opcua/transport/websocket/permessage_deflate.h"
+
+namespace opcua::ws {
+
+namespace {
+
+bool InRange(int value, int min, int max) {
+  return value >= min && value <= max;
+}
+
+// Only compiled in where the member exists.
+template <typename Options>
+void SetMinMessageSize(Options& options, std::size_t size) {
+  if constexpr (detail::HasMsgSizeThreshold<Options>)
+    options.msg_size_threshold = size;
+}
+
+}  // namespace
+
+transport::error_code ConfigurePermessageDeflate(
+    boost::beast::websocket::permessage_deflate& options,
+    const PermessageDeflateConfig& config) {
+  if (!InRange(config.server_max_window_bits, 9, 15) ||
+      !InRange(config.client_max_window_bits, 9, 15) ||
+      !InRange(config.compression_level, 0, 9) ||
+      !InRange(config.memory_level, 1, 9)) {
+    return transport::ERR_INVALID_ARGUMENT;
+  }
+  // Silently compressing every message would ignore the setting.
+  if (!kPermessageDeflateMinMessageSizeSupported &&
+      config.min_message_size != 0) {
+    return transport::ERR_INVALID_ARGUMENT;
+  }
+
+  options.server_enable = true;
+  options.server_max_window_bits = config.server_max_window_bits;
+  options.client_max_window_bits = config.client_max_window_bits;
+  options.server_no_context_takeover = config.server_no_context_takeover;
+  options.client_no_context_takeover = config.client_no_context_takeover;
+  options.compLevel = config.compression_level;
+  options.memLevel = config.memory_level;
+  SetMinMessageSize(options, config.min_message_size);
+  return transport::OK;
+}
+
+}  // namespace opcua::ws
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "transport/error.h"
+
+#include <boost/beast/websocket/option.hpp>
+
+#include <cstddef>
+
+namespace opcua::ws {
+
+// RFC 7692 permessage-deflate, https://www.rfc-editor.org/rfc/rfc7692. JSON
+// service messages, Publish responses above all, repeat the same field names
+// message after message and compress well. Compression is opt-in: it spends
+// CPU and per-connection zlib state to save bandwidth.
+struct PermessageDeflateConfig {
+  // The LZ77 window, as a base-2 logarithm (RFC 7692 §7.1.2), 9 to 15; zlib
+  // does not support 8. The compressor keeps about 2^(bits+2) bytes per
+  // connection and the decompressor 2^bits, so a smaller window trades ratio
+  // for memory on servers with many connections.
+  int server_max_window_bits = 15;
+  int client_max_window_bits = 15;
+
+  // Start each message with an empty window (RFC 7692 §7.1.1), so no zlib
+  // state is kept between messages, at some cost in ratio.
+  bool server_no_context_takeover = false;
+  bool client_no_context_takeover = false;
+
+  // zlib's deflate level (0 to 9) and memLevel (1 to 9).
+  int compression_level = 6;
+  int memory_level = 4;
+
+  // Messages shorter than this are sent uncompressed: a keep-alive Publish
+  // response gains nothing from the deflate header. Zero compresses every
+  // message, and is the only value a Beast without
+  // permessage_deflate::msg_size_threshold accepts (see
+  // kPermessageDeflateMinMessageSizeSupported).
+  std::size_t min_message_size = 0;
+};
+
+namespace detail {
+
+template <class Options>
+concept HasMsgSizeThreshold =
+    requires(Options options) { options.msg_size_threshold; };
+
+}  // namespace detail
+
+// Whether this Beast can leave short messages uncompressed.
+inline constexpr bool kPermessageDeflateMinMessageSizeSupported =
+    detail::HasMsgSizeThreshold<boost::beast::websocket::permessage_deflate>;
+
+// Fills the options the WebSocket stream negotiates the extension with, for
+// the server role. Fails with ERR_INVALID_ARGUMENT when a value is out of
+// range, or is a min_message_size this Beast cannot honour.
+[[nodiscard]] transport::error_code ConfigurePermessageDeflate(
+    boost::beast::websocket::permessage_deflate& options,
+    const PermessageDeflateConfig& config);
+
+}  // namespace opcua::ws
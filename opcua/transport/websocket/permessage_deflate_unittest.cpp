@@ -0,0 +1,57 @@
+#include "opcua/transport/websocket/permessage_deflate.h"
+
+#include <gtest/gtest.h>
+
+namespace opcua::ws {
+namespace {
+
+TEST(PermessageDeflateTest, EnablesTheServerRoleWithTheConfiguredWindows) {
+  boost::beast::websocket::permessage_deflate options;
+  ASSERT_EQ(ConfigurePermessageDeflate(options,
+                                       {.server_max_window_bits = 10,
+                                        .client_max_window_bits = 12,
+                                        .server_no_context_takeover = true,
+                                        .compression_level = 3}),
+            transport::OK);
+
+  EXPECT_TRUE(options.server_enable);
+  EXPECT_FALSE(options.client_enable);
+  EXPECT_EQ(options.server_max_window_bits, 10);
+  EXPECT_EQ(options.client_max_window_bits, 12);
+  EXPECT_TRUE(options.server_no_context_takeover);
+  EXPECT_FALSE(options.client_no_context_takeover);
+  EXPECT_EQ(options.compLevel, 3);
+  EXPECT_EQ(options.memLevel, 4);
+}
+
+TEST(PermessageDeflateTest, RejectsValuesZlibCannotUse) {
+  boost::beast::websocket::permessage_deflate options;
+  EXPECT_EQ(
+      ConfigurePermessageDeflate(options, {.server_max_window_bits = 8}),
+      transport::ERR_INVALID_ARGUMENT);
+  EXPECT_EQ(
+      ConfigurePermessageDeflate(options, {.client_max_window_bits = 16}),
+      transport::ERR_INVALID_ARGUMENT);
+  EXPECT_EQ(ConfigurePermessageDeflate(options, {.compression_level = 10}),
+            transport::ERR_INVALID_ARGUMENT);
+  EXPECT_EQ(ConfigurePermessageDeflate(options, {.memory_level = 0}),
+            transport::ERR_INVALID_ARGUMENT);
+  EXPECT_FALSE(options.server_enable);
+}
+
+// A Beast that compresses every message cannot honour a minimum size; the
+// configuration is refused rather than the setting quietly ignored.
+TEST(PermessageDeflateTest, AcceptsAMinimumSizeOnlyWhereBeastHonoursIt) {
+  boost::beast::websocket::permessage_deflate options;
+  EXPECT_EQ(ConfigurePermessageDeflate(options, {.min_message_size = 0}),
+            transport::OK);
+
+  boost::beast::websocket::permessage_deflate thresholded;
+  EXPECT_EQ(ConfigurePermessageDeflate(thresholded, {.min_message_size = 256}),
+            kPermessageDeflateMinMessageSizeSupported
+                ? transport::OK
+                : transport::ERR_INVALID_ARGUMENT);
+}
+
+}  // namespace
+}  // namespace opcua::ws
@@ -3,6 +3,7 @@
 #include "opcua/base/time_utils.h"
 #include "opcua/session/subscription_conversion.h"
 #include "opcua/ua/ua_json_codec.h"
+#include "opcua/ua/ua_json_writer.h"
 
 #include <boost/json.hpp>
 
@@ -120,6 +121,12 @@ value EncodePublishResponse(const PublishResponse& response) {
       subscription_conversion::ToWire(response, /*json_body=*/true));
 }
 
+void WritePublishResponse(ua::json::Writer& writer,
+                          const PublishResponse& response) {
+  ua::WriteJson(writer,
+                subscription_conversion::ToWire(response, /*json_body=*/true));
+}
+
 PublishResponse DecodePublishResponse(const value& json) {
   ua::PublishResponse wire;
   ua::DecodeJson(json, wire);
@@ -140,6 +147,11 @@ value EncodeRepublishResponse(const RepublishResponse& response) {
   return ua::EncodeJson(subscription_conversion::ToWire(response));
 }
 
+void WriteRepublishResponse(ua::json::Writer& writer,
+                            const RepublishResponse& response) {
+  ua::WriteJson(writer, subscription_conversion::ToWire(response));
+}
+
 RepublishResponse DecodeRepublishResponse(const value& json) {
   ua::RepublishResponse wire;
   ua::DecodeJson(json, wire);
@@ -0,0 +1,67 @@
+#include "opcua/transport/websocket/receive_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace opcua::ws {
+
+namespace {
+
+// Holds a typical service request in one read.
+constexpr std::size_t kInitialCapacity = 4 * 1024;
+
+}  // namespace
+
+ReceiveBuffer::ReceiveBuffer(std::size_t max_message_size,
+                             std::size_t retained_size)
+    : max_message_size_{max_message_size}, retained_size_{retained_size} {}
+
+std::span<char> ReceiveBuffer::Prepare() {
+  if (size_ == capacity_ && capacity_ < max_message_size_) {
+    const auto capacity =
+        std::min(capacity_ == 0 ? kInitialCapacity : capacity_ * 2,
+                 max_message_size_);
+    // Left uninitialized: only the bytes a read fills are ever touched.
+    auto storage = std::make_unique_for_overwrite<char[]>(capacity);
+    std::copy_n(storage_.get(), size_, storage.get());
+    storage_ = std::move(storage);
+    capacity_ = capacity;
+  }
+
+  if (size_ == max_message_size_) {
+    if (overflowed_)
+      return {};
+    probing_ = true;
+    prepared_ = 1;
+    return {&overflow_byte_, 1};
+  }
+
+  prepared_ = capacity_ - size_;
+  return {storage_.get() + size_, prepared_};
+}
+
+bool ReceiveBuffer::Commit(std::size_t size) {
+  assert(size <= prepared_);
+  if (std::exchange(probing_, false)) {
+    overflowed_ = size != 0;
+    return !overflowed_;
+  }
+  size_ += size;
+  return size < prepared_;
+}
+
+std::string_view ReceiveBuffer::Message() const {
+  return {storage_.get(), size_};
+}
+
+void ReceiveBuffer::Consume() {
+  size_ = 0;
+  overflowed_ = false;
+  if (capacity_ > retained_size_) {
+    storage_.reset();
+    capacity_ = 0;
+  }
+}
+
+}  // namespace opcua::ws
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace opcua::ws {
+
+// A connection's buffer for incoming WebSocket messages. Nothing says how
+// large a message is before it has been read, so the message is read in
+// pieces: each read fills the span Prepare() offers, and a read that comes up
+// short of it ends the message. A message that ends exactly where the span
+// does is followed by an empty read (acceptor.cpp). The storage starts small
+// and doubles whenever a message outgrows it, up to `max_message_size`, so a
+// connection holds memory in proportion to the messages it actually gets.
+// Once a message has grown the storage past `retained_size` it is dropped, so
+// one large request does not pin memory for the rest of the connection.
+class ReceiveBuffer {
+ public:
+  ReceiveBuffer(std::size_t max_message_size, std::size_t retained_size);
+
+  // Space for the next piece of the message. Once the message holds
+  // `max_message_size` bytes this is a single byte outside the message, so
+  // the empty read that ends a message of exactly that size can still be
+  // taken. Empty when a byte was read into it: the message is too large.
+  [[nodiscard]] std::span<char> Prepare();
+
+  // `size` bytes were read into the span Prepare() returned. True when that
+  // ended the message.
+  [[nodiscard]] bool Commit(std::size_t size);
+
+  // The message read so far. Empty after an empty read ended no message,
+  // which is how a transport reports a closed connection.
+  [[nodiscard]] std::string_view Message() const;
+
+  // Done with the message; the view Message() returned is no longer used.
+  void Consume();
+
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  std::size_t max_message_size_;
+  std::size_t retained_size_;
+  std::unique_ptr<char[]> storage_;
+  std::size_t capacity_ = 0;
+  std::size_t size_ = 0;
+  std::size_t prepared_ = 0;
+  // The byte Prepare() offers past `max_message_size`, never part of the
+  // message; `overflowed_` once a read has filled it.
+  char overflow_byte_ = 0;
+  bool probing_ = false;
+  bool overflowed_ = false;
+};
+
+}  // namespace opcua::ws
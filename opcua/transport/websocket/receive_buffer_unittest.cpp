@@ -0,0 +1,115 @@
+#include "opcua/transport/websocket/receive_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+namespace opcua::ws {
+namespace {
+
+// Reads `message` into `buffer` the way a WebSocket connection hands it over:
+// a piece per span offered, and an empty read when it ends on a full span.
+void Read(ReceiveBuffer& buffer, std::string_view message) {
+  for (;;) {
+    auto space = buffer.Prepare();
+    ASSERT_FALSE(space.empty());
+    const auto size = std::min(space.size(), message.size());
+    std::ranges::copy(message.substr(0, size), space.begin());
+    message.remove_prefix(size);
+    if (buffer.Commit(size))
+      return;
+  }
+}
+
+TEST(ReceiveBufferTest, StartsSmallAndTakesAShortMessageInOneRead) {
+  ReceiveBuffer buffer{/*max_message_size=*/1024 * 1024,
+                       /*retained_size=*/64 * 1024};
+  EXPECT_EQ(buffer.capacity(), 0u);
+
+  auto space = buffer.Prepare();
+  EXPECT_EQ(space.size(), 4u * 1024);
+  constexpr std::string_view kMessage = R"({"RequestHandle":1})";
+  std::ranges::copy(kMessage, space.begin());
+  EXPECT_TRUE(buffer.Commit(kMessage.size()));
+  EXPECT_EQ(buffer.Message(), kMessage);
+}
+
+// A message longer than the storage doubles it, keeping what was read, until
+// it fits; memory follows the message rather than the limit.
+TEST(ReceiveBufferTest, GrowsGeometricallyWithTheMessage) {
+  ReceiveBuffer buffer{/*max_message_size=*/1024 * 1024,
+                       /*retained_size=*/64 * 1024};
+  const std::string message(10 * 1024, 'x');
+
+  Read(buffer, message);
+  EXPECT_EQ(buffer.Message(), message);
+  EXPECT_EQ(buffer.capacity(), 16u * 1024);
+}
+
+TEST(ReceiveBufferTest, EndsAMessageThatFillsTheSpanOnTheEmptyReadAfterIt) {
+  ReceiveBuffer buffer{/*max_message_size=*/1024 * 1024,
+                       /*retained_size=*/64 * 1024};
+  const std::string message(4 * 1024, 'x');
+
+  Read(buffer, message);
+  EXPECT_EQ(buffer.Message(), message);
+}
+
+// At the limit one byte more is offered, to tell a message that ends there
+// from one that goes on; a byte read into it makes the message too large.
+TEST(ReceiveBufferTest, StopsOfferingSpaceAtTheLimit) {
+  ReceiveBuffer buffer{/*max_message_size=*/6 * 1024,
+                       /*retained_size=*/64 * 1024};
+  EXPECT_EQ(buffer.Prepare().size(), 4u * 1024);
+  EXPECT_FALSE(buffer.Commit(4 * 1024));
+  EXPECT_EQ(buffer.Prepare().size(), 2u * 1024);
+  EXPECT_FALSE(buffer.Commit(2 * 1024));
+  EXPECT_EQ(buffer.Prepare().size(), 1u);
+  EXPECT_FALSE(buffer.Commit(1));
+  EXPECT_TRUE(buffer.Prepare().empty());
+  EXPECT_EQ(buffer.Message().size(), 6u * 1024);
+}
+
+TEST(ReceiveBufferTest, TakesAMessageOfExactlyTheMaximumSize) {
+  ReceiveBuffer buffer{/*max_message_size=*/6 * 1024,
+                       /*retained_size=*/64 * 1024};
+  const std::string message(6 * 1024, 'x');
+
+  Read(buffer, message);
+  EXPECT_EQ(buffer.Message(), message);
+  EXPECT_EQ(buffer.capacity(), 6u * 1024);
+
+  // The next message starts afresh.
+  buffer.Consume();
+  Read(buffer, "{}");
+  EXPECT_EQ(buffer.Message(), "{}");
+}
+
+TEST(ReceiveBufferTest, AnEmptyReadOnNoMessageLeavesItEmpty) {
+  ReceiveBuffer buffer{/*max_message_size=*/1024, /*retained_size=*/64};
+  (void)buffer.Prepare();
+  EXPECT_TRUE(buffer.Commit(0));
+  EXPECT_TRUE(buffer.Message().empty());
+}
+
+// Small messages reuse the storage; a message that grew it above the retained
+// size gives it back once handled, and the next read starts small again.
+TEST(ReceiveBufferTest, ReleasesStorageAfterALargeMessage) {
+  ReceiveBuffer buffer{/*max_message_size=*/1024 * 1024,
+                       /*retained_size=*/8 * 1024};
+
+  Read(buffer, std::string(100, 'x'));
+  buffer.Consume();
+  EXPECT_EQ(buffer.capacity(), 4u * 1024);
+
+  Read(buffer, std::string(20 * 1024, 'x'));
+  buffer.Consume();
+  EXPECT_EQ(buffer.capacity(), 0u);
+
+  EXPECT_EQ(buffer.Prepare().size(), 4u * 1024);
+}
+
+}  // namespace
+}  // namespace opcua::ws
@@ -3,14 +3,13 @@
 #include "opcua/base/awaitable.h"
 #include "opcua/base/boost_log.h"
 #include "opcua/transport/websocket/json_codec.h"
+#include "opcua/transport/websocket/receive_buffer.h"
 
 #include <transport/write_queue.h>
 
-#include <boost/json/parse.hpp>
-#include <boost/json/serialize.hpp>
-
 #include <atomic>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -41,22 +40,33 @@ struct ConnectionTaskState {
 
 }  // namespace
 
-Server::Server(ServerContext&& context) : ServerContext{std::move(context)} {}
+Server::Server(ServerContext&& context)
+    : ServerContext{std::move(context)}, acceptor_{acceptor} {}
 
 Awaitable<transport::error_code> Server::Open() {
   if (opened_)
     co_return transport::OK;
 
-  auto error = co_await acceptor.open();
+  if (permessage_deflate) {
+    permessage_deflate_options_.emplace();
+    if (auto error = ConfigurePermessageDeflate(*permessage_deflate_options_,
+                                                *permessage_deflate)) {
+      LOG_ERROR(logger_) << "OPC UA WS permessage-deflate rejected"
+                         << LOG_TAG("Error", error.message());
+      co_return error;
+    }
+  }
+
+  auto error = co_await acceptor_.Open();
   if (error)
     co_return error;
 
   opened_ = true;
   closing_ = false;
   active_tasks_ = 0;
-  tasks_closed_.emplace(acceptor.get_executor());
+  tasks_closed_.emplace(acceptor.executor);
   TaskStarted();
-  CoSpawn(acceptor.get_executor(), [this]() -> Awaitable<void> {
+  CoSpawn(acceptor.executor, [this]() -> Awaitable<void> {
     co_await AcceptLoop();
     TaskFinished();
   });
@@ -69,32 +79,45 @@ Awaitable<transport::error_code> Server::Close() {
 
   opened_ = false;
   closing_ = true;
-  auto error = co_await acceptor.close();
+  auto error = acceptor_.Close();
   if (active_tasks_ != 0 && tasks_closed_) {
     co_await tasks_closed_->Wait();
   }
   co_return error;
 }
 
-Awaitable<void> Server::ServeConnection(transport::any_transport transport) {
-  co_await RunConnection(std::move(transport));
+Awaitable<void> Server::ServeConnection(transport::any_transport transport,
+                                        std::string_view subprotocol) {
+  if (subprotocol == kUacpSubprotocol)
+    co_await RunUacpConnection(std::move(transport));
+  else
+    co_await RunConnection(std::move(transport));
 }
 
 Awaitable<void> Server::AcceptLoop() {
   while (opened_) {
-    auto accepted = co_await acceptor.accept();
+    auto accepted = co_await acceptor_.Accept();
     if (!accepted.ok())
       co_return;
 
-    auto transport = std::move(accepted.value());
-    auto executor = transport.get_executor();
+    auto socket = std::move(accepted.value());
+    auto executor = socket.get_executor();
     TaskStarted();
-    CoSpawn(
-        executor,
-        [this, transport = std::move(transport)]() mutable -> Awaitable<void> {
-          co_await ServeConnection(std::move(transport));
-          TaskFinished();
-        });
+    // The handshake runs in the connection's own task, so a slow client does
+    // not hold up the next accept.
+    CoSpawn(executor,
+            [this, socket = std::move(socket)]() mutable -> Awaitable<void> {
+              auto connection = co_await acceptor_.Handshake(
+                  std::move(socket),
+                  {.max_message_size = max_message_size,
+                   .uacp_served = serve_uacp != nullptr,
+                   .permessage_deflate = permessage_deflate_options_});
+              if (connection.ok()) {
+                co_await ServeConnection(std::move(connection->transport),
+                                         connection->subprotocol);
+              }
+              TaskFinished();
+            });
   }
 }
 
@@ -123,30 +146,35 @@ Awaitable<void> Server::RunConnection(transport::any_transport transport) {
                     << LOG_TAG("ConnectionId", state->connection_id)
                     << LOG_TAG("Transport", state->transport.name())
                     << LOG_TAG("Peer", state->connection.peer);
-  std::vector<char> buffer(max_message_size_value);
+  ReceiveBuffer buffer{max_message_size_value, receive_buffer_retained_size};
+  RequestDecoder decoder;
 
   for (;;) {
-    auto read_result = co_await state->transport.read(buffer);
-    if (!read_result.ok() || *read_result == 0)
-      break;
-
-    StatusOr<RequestMessage> request{StatusCode::Bad_TypeMismatch};
-    try {
-      const std::string_view payload{buffer.data(), *read_result};
-      request = DecodeRequestMessage(boost::json::parse(payload));
-    } catch (const std::exception& e) {
-      LOG_WARNING(logger_) << "OPC UA WS request parse failed"
-                           << LOG_TAG("Reason", e.what())
-                           << LOG_TAG("Peer", state->connection.peer);
-    } catch (...) {
-      LOG_WARNING(logger_) << "OPC UA WS request parse failed"
+    const auto space = buffer.Prepare();
+    if (space.empty()) {
+      LOG_WARNING(logger_) << "OPC UA WS request too large"
+                           << LOG_TAG("MaxMessageSize", max_message_size_value)
                            << LOG_TAG("Peer", state->connection.peer);
+      break;
     }
 
+    auto read_result = co_await state->transport.read(space);
+    if (!read_result.ok())
+      break;
+    if (!buffer.Commit(*read_result))
+      continue;
+    if (buffer.Message().empty())
+      break;
+
+    auto request = decoder.Decode(buffer.Message());
+    buffer.Consume();
     if (!request.ok()) {
-      auto encoded = boost::json::serialize(EncodeJson(ResponseMessage{
+      LOG_WARNING(logger_) << "OPC UA WS request parse failed"
+                           << LOG_TAG("Status", ToString(request.status()))
+                           << LOG_TAG("Peer", state->connection.peer);
+      auto encoded = SerializeJson(ResponseMessage{
           .request_handle = 0,
-          .body = ServiceFault{.status = StatusCode::Bad_TypeMismatch}}));
+          .body = ServiceFault{.status = StatusCode::Bad_TypeMismatch}});
       if (encoded.size() > max_message_size_value)
         break;
 
@@ -166,7 +194,7 @@ Awaitable<void> Server::RunConnection(transport::any_transport transport) {
               auto response =
                   ResponseMessage{.request_handle = request.request_handle,
                                   .body = std::move(body)};
-              auto encoded = boost::json::serialize(EncodeJson(response));
+              auto encoded = SerializeJson(response);
               if (encoded.size() > max_message_size_value)
                 co_return;
 
@@ -194,4 +222,22 @@ Awaitable<void> Server::RunConnection(transport::any_transport transport) {
   [[maybe_unused]] auto close_result = co_await state->transport.close();
 }
 
+Awaitable<void> Server::RunUacpConnection(
+    transport::any_transport transport) {
+  const auto peer = transport.peer();
+  if (!serve_uacp) {
+    LOG_WARNING(logger_) << "OPC UA WS binary connection refused"
+                         << LOG_TAG("Reason", "opcua+uacp is not served")
+                         << LOG_TAG("Peer", peer);
+    [[maybe_unused]] auto close_result = co_await transport.close();
+    co_return;
+  }
+
+  LOG_INFO(logger_) << "OPC UA WS connection opened"
+                    << LOG_TAG("Subprotocol", kUacpSubprotocol)
+                    << LOG_TAG("Transport", transport.name())
+                    << LOG_TAG("Peer", peer);
+  co_await serve_uacp(std::move(transport));
+}
+
 }  // namespace opcua::ws
@@ -2,18 +2,36 @@
 
 #include "opcua/base/async_completion.h"
 #include "opcua/session/server_runtime.h"
+#include "opcua/transport/websocket/acceptor.h"
+#include "opcua/transport/websocket/permessage_deflate.h"
+#include "opcua/transport/websocket/subprotocol.h"
 
 #include <transport/any_transport.h>
 #include <transport/error.h>
 
+#include <functional>
 #include <optional>
+#include <string_view>
 
 namespace opcua::ws {
 
 struct ServerContext {
-  transport::any_transport acceptor;
+  AcceptorContext acceptor;
   ServerRuntime& runtime;
   size_t max_message_size = 4 * 1024 * 1024;
+  // A connection keeps its receive buffer after messages up to this size and
+  // frees it after a larger one, so the memory an idle connection holds stays
+  // near this bound however large its past requests were (see
+  // receive_buffer.h).
+  size_t receive_buffer_retained_size = 64 * 1024;
+  // Offers permessage-deflate to clients that ask for it; null does not. Open
+  // fails with ERR_INVALID_ARGUMENT when the configuration cannot be applied.
+  std::optional<PermessageDeflateConfig> permessage_deflate;
+  // Serves connections that negotiated opcua+uacp (see subprotocol.h): UA
+  // Secure Conversation in binary WebSocket messages, normally
+  // binary::Server::ServeConnection. When null, opcua+uacp is not offered in
+  // the handshake and only JSON is served.
+  std::function<Awaitable<void>(transport::any_transport)> serve_uacp;
 };
 
 class Server : private ServerContext {
@@ -22,16 +40,27 @@ class Server : private ServerContext {
 
   [[nodiscard]] Awaitable<transport::error_code> Open();
   [[nodiscard]] Awaitable<transport::error_code> Close();
+  // Serves a connection whose handshake is done, in the encoding of the
+  // subprotocol it agreed.
   [[nodiscard]] Awaitable<void> ServeConnection(
-      transport::any_transport transport);
+      transport::any_transport transport,
+      std::string_view subprotocol = kUaJsonSubprotocol);
+
+  // The port listened on, once open.
+  unsigned short port() const { return acceptor_.port(); }
 
  private:
   [[nodiscard]] Awaitable<void> AcceptLoop();
   [[nodiscard]] Awaitable<void> RunConnection(
       transport::any_transport transport);
+  [[nodiscard]] Awaitable<void> RunUacpConnection(
+      transport::any_transport transport);
   void TaskStarted();
   void TaskFinished();
 
+  Acceptor acceptor_;
+  std::optional<boost::beast::websocket::permessage_deflate>
+      permessage_deflate_options_;
   bool opened_ = false;
   bool closing_ = false;
   std::size_t active_tasks_ = 0;
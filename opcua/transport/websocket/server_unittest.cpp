@@ -4,6 +4,8 @@
 #include "opcua/base/test/test_executor.h"
 #include "opcua/session/authentication_adapters.h"
 #include "opcua/session/server_runtime_contract_test.h"
+#include "opcua/transport/binary/protocol.h"
+#include "opcua/transport/binary/server.h"
 #include "opcua/transport/websocket/json_codec.h"
 #include "transport/transport.h"
 
@@ -150,8 +152,10 @@ class ServerTest : public Test {
     return *DecodeResponseMessage(boost::json::parse(response));
   }
 
-  void ServePeer(const std::shared_ptr<MessagePeerState>& peer) {
-    opcua::WaitAwaitable(executor_, server_->ServeConnection(MakePeer(peer)));
+  void ServePeer(const std::shared_ptr<MessagePeerState>& peer,
+                 std::string_view subprotocol = kUaJsonSubprotocol) {
+    opcua::WaitAwaitable(executor_,
+                         server_->ServeConnection(MakePeer(peer), subprotocol));
   }
 
   transport::any_transport MakePeer(
@@ -182,11 +186,8 @@ class ServerTest : public Test {
       .session_manager = session_manager_,
       .callbacks = services_.MakeCallbacks(any_executor_, backing_states_),
   }};
-  std::shared_ptr<AcceptorState> acceptor_state_ =
-      std::make_shared<AcceptorState>();
   std::unique_ptr<Server> server_ = std::make_unique<Server>(ServerContext{
-      .acceptor = transport::any_transport{ScriptedAcceptorTransport{
-          any_executor_, acceptor_state_}},
+      .acceptor = {.executor = any_executor_},
       .runtime = runtime_,
       .max_message_size = 1024,
   });
@@ -260,6 +261,60 @@ TEST_F(ServerTest, InvalidJsonProducesServiceFault) {
   EXPECT_EQ(fault->status.code(), opcua::StatusCode::Bad_TypeMismatch);
 }
 
+// A connection that negotiated opcua+uacp goes to the binary server, which
+// reads the client's Hello itself and answers it over the same WebSocket.
+TEST_F(ServerTest, HandsUacpConnectionsToTheBinaryServer) {
+  binary::Runtime binary_runtime{binary::RuntimeContext{
+      .executor = any_executor_,
+      .session_manager = session_manager_,
+      .callbacks = services_.MakeCallbacks(any_executor_, backing_states_),
+  }};
+  binary::Server binary_server{binary::ServerContext{
+      .acceptor = transport::any_transport{ScriptedAcceptorTransport{
+          any_executor_, std::make_shared<AcceptorState>()}},
+      .runtime = binary_runtime,
+      .session_manager = session_manager_,
+  }};
+  Server server{ServerContext{
+      .acceptor = {.executor = any_executor_},
+      .runtime = runtime_,
+      .max_message_size = 1024,
+      .serve_uacp =
+          [&binary_server](transport::any_transport transport) {
+            return binary_server.ServeConnection(std::move(transport));
+          },
+  }};
+
+  auto peer = std::make_shared<MessagePeerState>();
+  const auto hello = binary::EncodeHelloMessage(
+      {.receive_buffer_size = 65535,
+       .send_buffer_size = 65535,
+       .endpoint_url = "opc.wss://localhost/ua"});
+  peer->incoming.emplace_back(hello.begin(), hello.end());
+  opcua::WaitAwaitable(
+      executor_, server.ServeConnection(MakePeer(peer), kUacpSubprotocol));
+
+  ASSERT_EQ(peer->writes.size(), 1u);
+  const std::vector<char> acknowledge{peer->writes[0].begin(),
+                                      peer->writes[0].end()};
+  EXPECT_TRUE(binary::DecodeAcknowledgeMessage(acknowledge).has_value());
+  EXPECT_TRUE(peer->closed);
+}
+
+// Without a binary server the handshake never agrees opcua+uacp; a connection
+// handed over with it anyway is closed without an answer rather than sent a
+// JSON fault it cannot read.
+TEST_F(ServerTest, ClosesUacpConnectionsWhenBinaryIsNotServed) {
+  auto peer = std::make_shared<MessagePeerState>();
+  const auto hello = binary::EncodeHelloMessage(
+      {.endpoint_url = "opc.wss://localhost/ua"});
+  peer->incoming.emplace_back(hello.begin(), hello.end());
+  ServePeer(peer, kUacpSubprotocol);
+
+  EXPECT_TRUE(peer->writes.empty());
+  EXPECT_TRUE(peer->closed);
+}
+
 TEST_F(ServerTest, DisconnectDetachesSessionForResume) {
   // The session id and authentication token come from CreateSession rather
   // than being assumed to be {1,ns2}/{1,ns3}: hard-coding the allocator's
@@ -329,17 +384,5 @@ TEST_F(ServerTest, DisconnectDetachesSessionForResume) {
          "and update this test and the in-process contract together";
 }
 
-TEST_F(ServerTest, OpenAndCloseDriveAcceptorLifecycle) {
-  EXPECT_FALSE(acceptor_state_->opened);
-  EXPECT_FALSE(acceptor_state_->closed);
-
-  EXPECT_EQ(opcua::WaitAwaitable(executor_, server_->Open()), transport::OK);
-  Drain(executor_);
-  EXPECT_TRUE(acceptor_state_->opened);
-
-  EXPECT_EQ(opcua::WaitAwaitable(executor_, server_->Close()), transport::OK);
-  EXPECT_TRUE(acceptor_state_->closed);
-}
-
 }  // namespace
 }  // namespace opcua::ws
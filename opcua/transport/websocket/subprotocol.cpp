@@ -0,0 +1,35 @@
+#include "opcua/transport/websocket/subprotocol.h"
+
+namespace opcua::ws {
+namespace {
+
+std::string_view Trim(std::string_view value) {
+  constexpr std::string_view kWhitespace = " \t";
+  const auto first = value.find_first_not_of(kWhitespace);
+  if (first == std::string_view::npos)
+    return {};
+  const auto last = value.find_last_not_of(kWhitespace);
+  return value.substr(first, last - first + 1);
+}
+
+}  // namespace
+
+std::optional<std::string_view> SelectSubprotocol(std::string_view offered,
+                                                  bool uacp_served) {
+  // A comma-separated token list (RFC 6455 §11.3.4), in client preference
+  // order.
+  while (!offered.empty()) {
+    const auto comma = offered.find(',');
+    const auto token = Trim(offered.substr(0, comma));
+    if (token == kUaJsonSubprotocol)
+      return kUaJsonSubprotocol;
+    if (token == kUacpSubprotocol && uacp_served)
+      return kUacpSubprotocol;
+    if (comma == std::string_view::npos)
+      break;
+    offered.remove_prefix(comma + 1);
+  }
+  return std::nullopt;
+}
+
+}  // namespace opcua::ws
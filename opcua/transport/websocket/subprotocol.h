@@ -0,0 +1,28 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+// The WebSocket subprotocols OPC UA defines (OPC UA Part 6 §7.5.2,
+// https://reference.opcfoundation.org/Core/Part6/v105/docs/7.5.2). The client
+// lists the ones it speaks in Sec-WebSocket-Protocol and the server's handshake
+// answer names the one chosen; Acceptor (acceptor.h) does the exchange, and
+// these helpers decide it.
+namespace opcua::ws {
+
+// The JSON encoding, one service message per WebSocket text message. The
+// default, and all a browser client without a binary decoder offers.
+inline constexpr std::string_view kUaJsonSubprotocol = "opcua+uajson";
+
+// UA Secure Conversation (Hello/Acknowledge, then secure channel chunks) in
+// WebSocket binary messages, exactly as over UA TCP.
+inline constexpr std::string_view kUacpSubprotocol = "opcua+uacp";
+
+// The subprotocol to accept for a Sec-WebSocket-Protocol header value: the
+// first one the client lists that the server serves, so a client that prefers
+// JSON gets JSON. opcua+uacp counts only when `uacp_served`. Nullopt when the
+// client offers none of them.
+std::optional<std::string_view> SelectSubprotocol(std::string_view offered,
+                                                  bool uacp_served);
+
+}  // namespace opcua::ws
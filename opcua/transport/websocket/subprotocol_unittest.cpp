@@ -0,0 +1,28 @@
+#include "opcua/transport/websocket/subprotocol.h"
+
+#include <gtest/gtest.h>
+
+namespace opcua::ws {
+namespace {
+
+TEST(SubprotocolTest, FollowsTheClientsPreference) {
+  EXPECT_EQ(SelectSubprotocol("opcua+uacp, opcua+uajson", true),
+            kUacpSubprotocol);
+  EXPECT_EQ(SelectSubprotocol("opcua+uajson,opcua+uacp", true),
+            kUaJsonSubprotocol);
+  EXPECT_EQ(SelectSubprotocol(" chat ,\topcua+uacp ", true), kUacpSubprotocol);
+}
+
+// JSON stays the answer for any client that does not ask for binary, and
+// binary is never chosen when the server does not serve it.
+TEST(SubprotocolTest, FallsBackToJsonOrNothing) {
+  EXPECT_EQ(SelectSubprotocol("opcua+uajson", true), kUaJsonSubprotocol);
+  EXPECT_EQ(SelectSubprotocol("opcua+uacp, opcua+uajson", false),
+            kUaJsonSubprotocol);
+  EXPECT_EQ(SelectSubprotocol("opcua+uacp", false), std::nullopt);
+  EXPECT_EQ(SelectSubprotocol("", true), std::nullopt);
+  EXPECT_EQ(SelectSubprotocol("opcua+uacpx, chat", true), std::nullopt);
+}
+
+}  // namespace
+}  // namespace opcua::ws
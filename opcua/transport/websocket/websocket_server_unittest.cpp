@@ -4,7 +4,8 @@
 #include "opcua/base/any_executor.h"
 #include "opcua/session/authentication_adapters.h"
 #include "opcua/session/server_runtime_contract_test.h"
-#include "transport/websocket_transport.h"
+#include "opcua/transport/binary/protocol.h"
+#include "opcua/transport/websocket/tls_context.h"
 
 #include <boost/asio/connect.hpp>
 #include <boost/asio/io_context.hpp>
@@ -22,7 +23,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <functional>
 #include <optional>
+#include <span>
 #include <thread>
 
 using namespace testing;
@@ -87,30 +90,6 @@ opcua::NodeId NumericNode(opcua::NumericId id, opcua::NamespaceIndex ns = 2) {
   return {id, ns};
 }
 
-std::string Trim(std::string_view value) {
-  while (!value.empty() &&
-         std::isspace(static_cast<unsigned char>(value.front())))
-    value.remove_prefix(1);
-  while (!value.empty() &&
-         std::isspace(static_cast<unsigned char>(value.back())))
-    value.remove_suffix(1);
-  return std::string{value};
-}
-
-bool HeaderContainsToken(std::string_view header, std::string_view token) {
-  while (!header.empty()) {
-    const auto comma = header.find(',');
-    const auto part =
-        comma == std::string_view::npos ? header : header.substr(0, comma);
-    if (Trim(part) == token)
-      return true;
-    if (comma == std::string_view::npos)
-      break;
-    header.remove_prefix(comma + 1);
-  }
-  return false;
-}
-
 class BeastClient {
  public:
   void Connect(const std::string& host,
@@ -119,6 +98,9 @@ class BeastClient {
                const std::string& subprotocol) {
     const auto results = resolver_.resolve(host, std::to_string(port));
     boost::beast::get_lowest_layer(websocket_).connect(results);
+    boost::beast::websocket::permessage_deflate permessage_deflate;
+    permessage_deflate.client_enable = true;
+    websocket_.set_option(permessage_deflate);
     websocket_.set_option(boost::beast::websocket::stream_base::decorator(
         [origin, subprotocol](boost::beast::websocket::request_type& request) {
           if (!origin.empty())
@@ -128,7 +110,12 @@ class BeastClient {
                         subprotocol);
           }
         }));
-    websocket_.handshake(host + ":" + std::to_string(port), "/ua");
+    websocket_.handshake(response_, host + ":" + std::to_string(port), "/ua");
+  }
+
+  // The 101 answer to the last Connect.
+  const boost::beast::websocket::response_type& response() const {
+    return response_;
   }
 
   void Send(const RequestMessage& request) {
@@ -137,6 +124,14 @@ class BeastClient {
     websocket_.write(boost::asio::buffer(payload));
   }
 
+  void SendBinary(std::span<const char> payload) {
+    websocket_.binary(true);
+    websocket_.write(boost::asio::buffer(payload.data(), payload.size()));
+  }
+
+  // Whether the last message read came in a binary frame.
+  bool got_binary() const { return websocket_.got_binary(); }
+
   std::string Read(std::chrono::milliseconds timeout = std::chrono::seconds{
                        30}) {
     boost::beast::get_lowest_layer(websocket_).expires_after(timeout);
@@ -161,6 +156,7 @@ class BeastClient {
   boost::asio::ip::tcp::resolver resolver_{io_context_};
   boost::beast::websocket::stream<boost::beast::tcp_stream> websocket_{
       io_context_};
+  boost::beast::websocket::response_type response_;
 };
 
 class TlsBeastClient {
@@ -274,7 +270,6 @@ class WebSocketServerTest : public Test {
                                                 boost::asio::use_future);
       EXPECT_EQ(close_future.get().value(), 0);
       server_.reset();
-      acceptor_ = nullptr;
     }
     runtime_.reset();
     callback_executor_ = opcua::AnyExecutor{};
@@ -284,8 +279,9 @@ class WebSocketServerTest : public Test {
       thread_->join();
   }
 
-  void StartServer(
-      std::optional<transport::WebSocketServerTlsConfig> tls = std::nullopt) {
+  void StartServer(std::optional<TlsContextConfig> tls = std::nullopt,
+                   std::function<Awaitable<void>(transport::any_transport)>
+                       serve_uacp = nullptr) {
     callback_executor_ = io_context_.get_executor();
     runtime_.emplace(ServerRuntimeContext{
         .executor = callback_executor_,
@@ -293,69 +289,54 @@ class WebSocketServerTest : public Test {
         .callbacks =
             services_.MakeCallbacks(callback_executor_, backing_states_),
     });
-    auto acceptor = std::make_unique<transport::WebSocketTransport>(
-        io_context_.get_executor(), transport::log_source{}, "127.0.0.1", "0",
-        /*active=*/false,
-        transport::WebSocketServerOptions{
-            .tls = std::move(tls),
-            .handshake_callback =
-                [](const transport::WebSocketServerRequest& request)
-                -> std::optional<transport::WebSocketServerReject> {
-              if (request.target() != "/ua") {
-                return transport::WebSocketServerReject{
-                    .status = http::status::not_found,
-                    .body = "Invalid target",
-                };
-              }
-
-              const auto subprotocol_it =
-                  request.find(http::field::sec_websocket_protocol);
-              if (subprotocol_it == request.end() ||
-                  !HeaderContainsToken(subprotocol_it->value(),
-                                       "opcua+uajson")) {
-                return transport::WebSocketServerReject{
-                    .status = http::status::bad_request,
-                    .body = "Missing required subprotocol",
-                };
-              }
-
-              const auto origin_it = request.find(http::field::origin);
-              if (origin_it == request.end()) {
-                return transport::WebSocketServerReject{
-                    .status = http::status::forbidden,
-                    .body = "Origin required",
-                };
-              }
-
-              if (origin_it->value() != "https://scada.local") {
-                return transport::WebSocketServerReject{
-                    .status = http::status::forbidden,
-                    .body = "Origin denied",
-                };
-              }
-
-              return std::nullopt;
-            },
-            .enable_permessage_deflate = true,
-            .response_callback =
-                [](boost::beast::websocket::response_type& response) {
-                  response.set(http::field::server, "scada-opcua-ws");
-                  response.set(http::field::sec_websocket_protocol,
-                               "opcua+uajson");
-                },
-        });
-    acceptor_ = acceptor.get();
+    std::shared_ptr<boost::asio::ssl::context> tls_context;
+    if (tls) {
+      tls_context = std::make_shared<boost::asio::ssl::context>(
+          boost::asio::ssl::context::tls_server);
+      ASSERT_EQ(ConfigureServerTlsContext(*tls_context, *tls), transport::OK);
+    }
     server_.emplace(ServerContext{
-        .acceptor = transport::any_transport{std::move(acceptor)},
+        .acceptor =
+            {.executor = io_context_.get_executor(),
+             .host = "127.0.0.1",
+             .port = "0",
+             .tls_context = std::move(tls_context),
+             .handshake_callback =
+                 [](const HandshakeRequest& request)
+                 -> std::optional<HandshakeReject> {
+               if (request.target() != "/ua") {
+                 return HandshakeReject{.status = http::status::not_found,
+                                        .body = "Invalid target"};
+               }
+
+               const auto origin_it = request.find(http::field::origin);
+               if (origin_it == request.end()) {
+                 return HandshakeReject{.status = http::status::forbidden,
+                                        .body = "Origin required"};
+               }
+
+               if (origin_it->value() != "https://scada.local") {
+                 return HandshakeReject{.status = http::status::forbidden,
+                                        .body = "Origin denied"};
+               }
+
+               return std::nullopt;
+             },
+             .response_callback =
+                 [](boost::beast::websocket::response_type& response) {
+                   response.set(http::field::server, "scada-opcua-ws");
+                 }},
         .runtime = *runtime_,
         .max_message_size = 4 * 1024 * 1024,
+        .permessage_deflate = PermessageDeflateConfig{},
+        .serve_uacp = std::move(serve_uacp),
     });
     auto open_future = boost::asio::co_spawn(io_context_, server_->Open(),
                                              boost::asio::use_future);
     EXPECT_EQ(open_future.get(), transport::OK);
   }
 
-  unsigned short port() const { return acceptor_->local_endpoint().port(); }
+  unsigned short port() const { return server_->port(); }
 
   boost::asio::io_context io_context_;
   std::optional<
@@ -378,7 +359,6 @@ class WebSocketServerTest : public Test {
                  .user_id = NumericNode(700, 5), .multi_sessions = true};
            })}};
   std::optional<ServerRuntime> runtime_;
-  transport::WebSocketTransport* acceptor_ = nullptr;
   std::optional<Server> server_;
 };
 
@@ -408,12 +388,18 @@ TEST_F(WebSocketServerTest,
 
   BeastClient client;
   client.Connect("127.0.0.1", port(), "https://scada.local", "opcua+uajson");
+  EXPECT_EQ(client.response()[http::field::sec_websocket_protocol],
+            "opcua+uajson");
+  EXPECT_EQ(client.response()[http::field::server], "scada-opcua-ws");
+  EXPECT_THAT(
+      std::string{client.response()[http::field::sec_websocket_extensions]},
+      HasSubstr("permessage-deflate"));
   ExpectBrowsePagingRoundTrip(client);
   client.Close();
 }
 
 TEST_F(WebSocketServerTest, AcceptsTlsHandshakeAndRoutesBrowsePagingEndToEnd) {
-  StartServer(transport::WebSocketServerTlsConfig{
+  StartServer(TlsContextConfig{
       .certificate_chain_pem = kTestCertificatePem,
       .private_key_pem = kTestPrivateKeyPem,
   });
@@ -461,8 +447,111 @@ TEST_F(WebSocketServerTest, RejectsMissingRequiredSubprotocol) {
                boost::system::system_error);
 }
 
+// A request far larger than the receive buffer starts out is read in pieces
+// into a buffer that grows to fit it.
+TEST_F(WebSocketServerTest, ReadsRequestsLargerThanTheInitialReceiveBuffer) {
+  StartServer();
+
+  services_.read = [](opcua::ServiceContext,
+                      std::vector<opcua::ReadValueId> inputs)
+      -> opcua::StatusOr<std::vector<opcua::DataValue>> {
+    return std::vector<opcua::DataValue>(inputs.size());
+  };
+
+  BeastClient client;
+  client.Connect("127.0.0.1", port(), "https://scada.local", "opcua+uajson");
+  const auto created = std::get<CreateSessionResponse>(
+      DecodeResponseMessage(
+          boost::json::parse(client.Request(
+              {.request_handle = 1, .body = CreateSessionRequest{}})))
+          ->body);
+  const auto activated = std::get<ActivateSessionResponse>(
+      DecodeResponseMessage(
+          boost::json::parse(client.Request(
+              {.request_handle = 2,
+               .body = ActivateSessionRequest{
+                   .session_id = created.session_id,
+                   .authentication_token = created.authentication_token,
+                   .user_name = opcua::LocalizedText{u"operator"},
+                   .password = opcua::LocalizedText{u"secret"}}})))
+          ->body);
+  ASSERT_EQ(activated.status.code(), opcua::StatusCode::Good);
+
+  ua::ReadRequest read;
+  for (int i = 0; i < 1000; ++i) {
+    auto name = "Plant.Area1.Pump" + std::to_string(i) + ".Discharge.Pressure";
+    read.nodes_to_read.push_back(
+        {.node_id = opcua::NodeId{std::move(name), 2},
+         .attribute_id =
+             static_cast<opcua::UInt32>(opcua::AttributeId::Value)});
+  }
+  ASSERT_GT(boost::json::serialize(
+                EncodeJson(RequestMessage{.request_handle = 3, .body = read}))
+                .size(),
+            64u * 1024);
+
+  const auto response = *DecodeResponseMessage(boost::json::parse(
+      client.Request({.request_handle = 3, .body = std::move(read)})));
+  const auto* read_response = std::get_if<ua::ReadResponse>(&response.body);
+  ASSERT_NE(read_response, nullptr);
+  EXPECT_EQ(read_response->results.size(), 1000u);
+  client.Close();
+}
+
+// Only JSON is served here, so a client offering nothing else is refused.
+TEST_F(WebSocketServerTest, RejectsUacpWhenBinaryIsNotServed) {
+  StartServer();
+
+  BeastClient client;
+  EXPECT_THROW(
+      client.Connect("127.0.0.1", port(), "https://scada.local", "opcua+uacp"),
+      boost::system::system_error);
+}
+
+// A client listing opcua+uacp first gets it, named in the answer, and the
+// server's Acknowledge comes back in a binary message (OPC UA Part 6 §7.5.2).
+TEST_F(WebSocketServerTest, NegotiatesUacpAndAnswersInBinaryMessages) {
+  // Stands in for binary::Server: answers the Hello and hangs up.
+  auto acknowledge_hello =
+      [](transport::any_transport transport) -> Awaitable<void> {
+    std::vector<char> buffer(1024);
+    auto read_result = co_await transport.read(buffer);
+    if (!read_result.ok() || *read_result == 0)
+      co_return;
+    const auto hello =
+        binary::DecodeHelloMessage(std::span{buffer}.first(*read_result));
+    if (!hello)
+      co_return;
+    const auto negotiated = binary::NegotiateHello(*hello, {});
+    if (!negotiated.acknowledge)
+      co_return;
+    const auto acknowledge =
+        binary::EncodeAcknowledgeMessage(*negotiated.acknowledge);
+    [[maybe_unused]] auto write_result = co_await transport.write(acknowledge);
+    [[maybe_unused]] auto close_result = co_await transport.close();
+  };
+  StartServer(std::nullopt, acknowledge_hello);
+
+  BeastClient client;
+  client.Connect("127.0.0.1", port(), "https://scada.local",
+                 "opcua+uacp, opcua+uajson");
+  EXPECT_EQ(client.response()[http::field::sec_websocket_protocol],
+            "opcua+uacp");
+
+  client.SendBinary(binary::EncodeHelloMessage(
+      {.receive_buffer_size = 65535,
+       .send_buffer_size = 65535,
+       .endpoint_url = "opc.ws://127.0.0.1/ua"}));
+  const auto message = client.Read();
+  EXPECT_TRUE(client.got_binary());
+  EXPECT_TRUE(binary::DecodeAcknowledgeMessage(
+                  std::span{message.data(), message.size()})
+                  .has_value());
+  client.Close();
+}
+
 TEST_F(WebSocketServerTest, RejectsOriginOutsideAllowListOverTls) {
-  StartServer(transport::WebSocketServerTlsConfig{
+  StartServer(TlsContextConfig{
       .certificate_chain_pem = kTestCertificatePem,
       .private_key_pem = kTestPrivateKeyPem,
   });
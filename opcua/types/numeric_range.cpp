@@ -0,0 +1,160 @@
+#include "opcua/types/numeric_range.h"
+
+#include <algorithm>
+#include <charconv>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace opcua {
+
+namespace {
+
+// The array alternatives of a Variant, by Variant::Type and element type.
+#define OPCUA_NUMERIC_RANGE_ARRAY_TYPES(V)           \
+  V(EMPTY, std::monostate)                           \
+  V(BOOL, bool)                                      \
+  V(INT8, Int8)                                      \
+  V(UINT8, UInt8)                                    \
+  V(INT16, Int16)                                    \
+  V(UINT16, UInt16)                                  \
+  V(INT32, Int32)                                    \
+  V(UINT32, UInt32)                                  \
+  V(INT64, Int64)                                    \
+  V(UINT64, UInt64)                                  \
+  V(FLOAT, Float)                                    \
+  V(DOUBLE, Double)                                  \
+  V(STRING, String)                                  \
+  V(DATE_TIME, DateTime)                             \
+  V(GUID, Guid)                                      \
+  V(BYTE_STRING, ByteString)                         \
+  V(XML_ELEMENT, XmlElement)                         \
+  V(NODE_ID, NodeId)                                 \
+  V(EXPANDED_NODE_ID, ExpandedNodeId)                \
+  V(STATUS_CODE, Status)                             \
+  V(QUALIFIED_NAME, QualifiedName)                   \
+  V(LOCALIZED_TEXT, LocalizedText)                   \
+  V(EXTENSION_OBJECT, ExtensionObject)               \
+  V(DATA_VALUE, std::shared_ptr<const DataValue>)    \
+  V(VARIANT, Variant)                                \
+  V(DIAGNOSTIC_INFO, DiagnosticInfo)
+
+using Dimensions = std::span<const NumericRange::Dimension>;
+
+bool ParseIndex(std::string_view text, UInt32& index) {
+  if (text.empty())
+    return false;
+  const auto* end = text.data() + text.size();
+  const auto [ptr, error] = std::from_chars(text.data(), end, index);
+  return error == std::errc{} && ptr == end;
+}
+
+// Keeps the elements `dimension` spans, up to the end of `elements`. False if
+// it starts past the end.
+template <class Elements>
+bool Slice(Elements& elements, const NumericRange::Dimension& dimension) {
+  if (dimension.low >= elements.size())
+    return false;
+  const auto end = std::min<std::size_t>(std::size_t{dimension.high} + 1,
+                                         elements.size());
+  elements.erase(elements.begin() + end, elements.end());
+  elements.erase(elements.begin(), elements.begin() + dimension.low);
+  return true;
+}
+
+Status ApplyRange(Variant& value, Dimensions dimensions);
+
+// A ByteString or String is the last dimension there can be.
+template <class Bytes>
+Status ApplyToBytes(Bytes& bytes, Dimensions dimensions) {
+  if (dimensions.size() != 1 || !Slice(bytes, dimensions.front()))
+    return StatusCode::Bad_IndexRangeNoData;
+  return StatusCode::Good;
+}
+
+template <class T>
+Status ApplyToArray(std::vector<T>& elements, Dimensions dimensions) {
+  if (!Slice(elements, dimensions.front()))
+    return StatusCode::Bad_IndexRangeNoData;
+  const auto inner = dimensions.subspan(1);
+  if (inner.empty())
+    return StatusCode::Good;
+
+  // The remaining dimensions select within each element, which has to be an
+  // array itself: a ByteString, a String, or a Variant holding an array.
+  if constexpr (std::is_same_v<T, String> || std::is_same_v<T, ByteString>) {
+    for (auto& element : elements) {
+      if (auto status = ApplyToBytes(element, inner); !status)
+        return status;
+    }
+    return StatusCode::Good;
+  } else if constexpr (std::is_same_v<T, Variant>) {
+    for (auto& element : elements) {
+      if (auto status = ApplyRange(element, inner); !status)
+        return status;
+    }
+    return StatusCode::Good;
+  } else {
+    return StatusCode::Bad_IndexRangeNoData;
+  }
+}
+
+Status ApplyRange(Variant& value, Dimensions dimensions) {
+  if (value.is_array()) {
+    switch (value.type()) {
+#define OPCUA_APPLY_TO_ARRAY(NAME, ELEMENT) \
+  case Variant::NAME:                       \
+    return ApplyToArray(value.get<std::vector<ELEMENT>>(), dimensions);
+      OPCUA_NUMERIC_RANGE_ARRAY_TYPES(OPCUA_APPLY_TO_ARRAY)
+#undef OPCUA_APPLY_TO_ARRAY
+      case Variant::COUNT:
+        break;
+    }
+    return StatusCode::Bad_IndexRangeNoData;
+  }
+
+  switch (value.type()) {
+    case Variant::STRING:
+      return ApplyToBytes(value.get<String>(), dimensions);
+    case Variant::BYTE_STRING:
+      return ApplyToBytes(value.get<ByteString>(), dimensions);
+    default:
+      // A scalar has no elements to select.
+      return StatusCode::Bad_IndexRangeNoData;
+  }
+}
+
+}  // namespace
+
+// static
+StatusOr<NumericRange> NumericRange::Parse(std::string_view text) {
+  NumericRange range;
+  while (true) {
+    const auto comma = text.find(',');
+    const auto part = text.substr(0, comma);
+
+    Dimension dimension;
+    if (const auto colon = part.find(':'); colon == std::string_view::npos) {
+      if (!ParseIndex(part, dimension.low))
+        return StatusCode::Bad_IndexRangeInvalid;
+      dimension.high = dimension.low;
+    } else if (!ParseIndex(part.substr(0, colon), dimension.low) ||
+               !ParseIndex(part.substr(colon + 1), dimension.high) ||
+               dimension.low >= dimension.high) {
+      return StatusCode::Bad_IndexRangeInvalid;
+    }
+    range.dimensions_.push_back(dimension);
+
+    if (comma == std::string_view::npos)
+      return range;
+    text.remove_prefix(comma + 1);
+  }
+}
+
+Status NumericRange::Apply(Variant& value) const {
+  if (dimensions_.empty())
+    return StatusCode::Good;
+  return ApplyRange(value, dimensions_);
+}
+
+}  // namespace opcua
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "opcua/types/basic_types.h"
+#include "opcua/types/status.h"
+#include "opcua/types/status_or.h"
+#include "opcua/types/variant.h"
+
+#include <string_view>
+#include <vector>
+
+namespace opcua {
+
+// A parsed IndexRange: for each dimension of an array, the index or the
+// inclusive `low:high` span to take, written as "2", "2:5" or "1:2,0:3".
+// ByteString and String values count as arrays of bytes, so the dimension
+// after the last array dimension selects from them. OPC UA Part 4 §7.27
+// NumericRange,
+// https://reference.opcfoundation.org/Core/Part4/v105/docs/7.27
+class NumericRange {
+ public:
+  struct Dimension {
+    UInt32 low = 0;
+    UInt32 high = 0;
+
+    bool operator==(const Dimension&) const = default;
+  };
+
+  // Bad_IndexRangeInvalid for text that does not parse or a span whose low
+  // bound is not below its high bound.
+  static StatusOr<NumericRange> Parse(std::string_view text);
+
+  const std::vector<Dimension>& dimensions() const { return dimensions_; }
+
+  // Cuts `value` down to the elements the range selects. A range reaching past
+  // the end takes what there is; Bad_IndexRangeNoData if it starts past the
+  // end, or `value` has fewer dimensions than the range.
+  Status Apply(Variant& value) const;
+
+ private:
+  std::vector<Dimension> dimensions_;
+};
+
+}  // namespace opcua
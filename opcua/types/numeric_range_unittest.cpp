@@ -0,0 +1,91 @@
+#include "opcua/types/numeric_range.h"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <vector>
+
+namespace opcua {
+namespace {
+
+using Dimension = NumericRange::Dimension;
+
+// Applies `text` to `value`, which must parse. Returns the status, leaving the
+// sliced value in `value`.
+StatusCode Apply(std::string_view text, Variant& value) {
+  const auto range = NumericRange::Parse(text);
+  EXPECT_TRUE(range.ok()) << text;
+  return range.ok() ? range->Apply(value).code() : range.status().code();
+}
+
+TEST(NumericRangeTest, ParsesIndexesSpansAndDimensions) {
+  const auto range = NumericRange::Parse("2,0:3,10");
+  ASSERT_TRUE(range.ok());
+  EXPECT_EQ(range->dimensions(),
+            (std::vector<Dimension>{{2, 2}, {0, 3}, {10, 10}}));
+}
+
+// OPC UA Part 4 §7.27: a span's first index is below its second, and nothing
+// but digits, ':' and ',' is allowed.
+TEST(NumericRangeTest, RejectsMalformedRanges) {
+  for (const std::string_view text :
+       {"", "1:1", "2:1", "1:", ":1", "1,", "-1", " 1", "1:2:3", "a",
+        "99999999999"}) {
+    EXPECT_EQ(NumericRange::Parse(text).status().code(),
+              StatusCode::Bad_IndexRangeInvalid)
+        << text;
+  }
+}
+
+TEST(NumericRangeTest, SlicesAnArrayAndClampsToItsEnd) {
+  Variant value{std::vector<Int32>{10, 11, 12, 13}};
+  EXPECT_EQ(Apply("1:2", value), StatusCode::Good);
+  EXPECT_EQ(value, Variant{(std::vector<Int32>{11, 12})});
+
+  value = std::vector<Int32>{10, 11, 12, 13};
+  EXPECT_EQ(Apply("3:100", value), StatusCode::Good);
+  EXPECT_EQ(value, Variant{(std::vector<Int32>{13})});
+
+  value = std::vector<Int32>{10, 11, 12, 13};
+  EXPECT_EQ(Apply("4", value), StatusCode::Bad_IndexRangeNoData);
+}
+
+TEST(NumericRangeTest, TreatsStringsAndByteStringsAsArraysOfBytes) {
+  Variant text{String{"waveform"}};
+  EXPECT_EQ(Apply("0:3", text), StatusCode::Good);
+  EXPECT_EQ(text, Variant{String{"wave"}});
+
+  Variant bytes{ByteString{'a', 'b', 'c'}};
+  EXPECT_EQ(Apply("2", bytes), StatusCode::Good);
+  EXPECT_EQ(bytes, Variant{ByteString{'c'}});
+}
+
+TEST(NumericRangeTest, AppliesLaterDimensionsToEachElement) {
+  Variant strings{std::vector<String>{"alpha", "beta", "gamma"}};
+  EXPECT_EQ(Apply("1:2,0:1", strings), StatusCode::Good);
+  EXPECT_EQ(strings, Variant{(std::vector<String>{"be", "ga"})});
+
+  Variant rows{std::vector<Variant>{Variant{std::vector<Int32>{1, 2, 3}},
+                                    Variant{std::vector<Int32>{4, 5, 6}}}};
+  EXPECT_EQ(Apply("1,1:2", rows), StatusCode::Good);
+  EXPECT_EQ(rows, Variant{(std::vector<Variant>{
+                      Variant{std::vector<Int32>{5, 6}}})});
+}
+
+TEST(NumericRangeTest, ReportsNoDataForDimensionsTheValueDoesNotHave) {
+  Variant scalar{Int32{7}};
+  EXPECT_EQ(Apply("0", scalar), StatusCode::Bad_IndexRangeNoData);
+
+  Variant numbers{std::vector<Int32>{1, 2}};
+  EXPECT_EQ(Apply("0,0", numbers), StatusCode::Bad_IndexRangeNoData);
+
+  Variant text{String{"ab"}};
+  EXPECT_EQ(Apply("0,0", text), StatusCode::Bad_IndexRangeNoData);
+
+  // An element too short for the inner dimension fails the whole value.
+  Variant strings{std::vector<String>{"abc", "d"}};
+  EXPECT_EQ(Apply("0:1,2", strings), StatusCode::Bad_IndexRangeNoData);
+}
+
+}  // namespace
+}  // namespace opcua
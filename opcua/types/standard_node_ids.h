@@ -91,6 +91,8 @@ constexpr NumericId Server_ServerCapabilities_LocaleIdArray = 2271;
 constexpr NumericId Server_ServerCapabilities_MinSupportedSampleRate = 2272;
 constexpr NumericId Server_ServerCapabilities_MaxBrowseContinuationPoints =
     2735;
+constexpr NumericId Server_ServerCapabilities_MaxHistoryContinuationPoints =
+    2737;
 constexpr NumericId Server_ServerCapabilities_OperationLimits = 11704;
 constexpr NumericId OperationLimits_MaxNodesPerRead = 11705;
 constexpr NumericId OperationLimits_MaxNodesPerWrite = 11707;
@@ -124,6 +124,16 @@ const Entry kEntries[] = {
      L"Операция не поддерживается"},
     {opcua::StatusCode::Bad_WaitingForInitialData, "Bad_WaitingForInitialData",
      L"Значение от источника данных ещё не получено"},
+    {opcua::StatusCode::Bad_DeadbandFilterInvalid, "Bad_DeadbandFilterInvalid",
+     L"Неправильный фильтр зоны нечувствительности"},
+    {opcua::StatusCode::Bad_RequestTooLarge, "Bad_RequestTooLarge",
+     L"Запрос превышает допустимый размер"},
+    {opcua::StatusCode::Bad_ResponseTooLarge, "Bad_ResponseTooLarge",
+     L"Ответ превышает допустимый размер"},
+    {opcua::StatusCode::Bad_IndexRangeInvalid, "Bad_IndexRangeInvalid",
+     L"Неправильный диапазон индексов"},
+    {opcua::StatusCode::Bad_IndexRangeNoData, "Bad_IndexRangeNoData",
+     L"В диапазоне индексов нет данных"},
 };
 
 const Entry* FindEntry(opcua::StatusCode status_code) {
@@ -154,6 +154,24 @@ enum class StatusCode : unsigned {
   // StatusCodes,
   // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.38.2
   Bad_WaitingForInitialData = Bad | 0x32,
+  // The DataChangeFilter deadband cannot be applied: a PercentDeadband outside
+  // 0..100, or on a Variable with no EURange (BadDeadbandFilterInvalid, wire
+  // 0x808E0000) — OPC UA Part 4 §7.22.2 DataChangeFilter,
+  // https://reference.opcfoundation.org/Core/Part4/v105/docs/7.22.2
+  Bad_DeadbandFilterInvalid = Bad | 0x8E,
+  // A message does not fit the MaxMessageSize / MaxChunkCount its receiver
+  // announced in Hello/Acknowledge, so it is not sent (BadRequestTooLarge,
+  // wire 0x80B80000; BadResponseTooLarge, wire 0x80B90000) — OPC UA Part 6
+  // §6.7.2, https://reference.opcfoundation.org/Core/Part6/v105/docs/6.7.2
+  Bad_RequestTooLarge = Bad | 0xB8,
+  Bad_ResponseTooLarge = Bad | 0xB9,
+  // An IndexRange that does not parse, or names an empty range
+  // (BadIndexRangeInvalid, wire 0x80360000); and one that selects nothing from
+  // the value, because it starts past the end or the value is not an array
+  // (BadIndexRangeNoData, wire 0x80370000) — OPC UA Part 4 §7.27
+  // NumericRange, https://reference.opcfoundation.org/Core/Part4/v105/docs/7.27
+  Bad_IndexRangeInvalid = Bad | 0x36,
+  Bad_IndexRangeNoData = Bad | 0x37,
 };
 
 // Limit bits of a StatusCode, indicating whether the value is at a low/high
@@ -140,6 +140,61 @@ TEST(UaBinaryCodecTest, RoundTripsStructuredValuesThroughAnExtensionObject) {
   EXPECT_FALSE(FromExtensionObject(ToExtensionObject(other), decoded));
 }
 
+// EncodedSize is what a message is reserved at before it is encoded, so it
+// has to agree with Encode for every kind of field.
+TEST(UaBinaryCodecTest, EncodedSizeMatchesTheEncodedBytes) {
+  ReadRequest request;
+  request.request_header.authentication_token = NodeId{String{"token"}, 1};
+  request.request_header.audit_entry_id = "audit";
+  request.timestamps_to_return = TimestampsToReturn::Both;
+  request.nodes_to_read.push_back({.node_id = NodeId{99, 4},
+                                   .attribute_id = 13,
+                                   .index_range = "1:3"});
+  request.nodes_to_read.push_back({.node_id = NodeId{70000, 0}});
+
+  ByteString bytes;
+  Encoder encoder{bytes};
+  Encode(encoder, request);
+  EXPECT_EQ(EncodedSize(request), bytes.size());
+}
+
+// An in-place ExtensionObject is encoded only with the message holding it, and
+// decodes to the same value as one built by ToExtensionObject.
+TEST(UaBinaryCodecTest, EncodesInPlaceExtensionObjectsLikeEncodedOnes) {
+  DataChangeNotification notification;
+  notification.monitored_items.push_back(
+      {.client_handle = 5,
+       .value = DataValue{Variant{Double{1.5}}, {},
+                          DateTime::FromInternalValue(10),
+                          DateTime::FromInternalValue(20)}});
+
+  const ExtensionObject in_place = ToInPlaceExtensionObject(notification);
+  EXPECT_EQ(in_place.binary_body(), nullptr);
+
+  ByteString bytes;
+  Encoder{bytes}.Encode(in_place);
+  ByteString expected;
+  Encoder{expected}.Encode(ToExtensionObject(notification));
+  EXPECT_EQ(bytes, expected);
+
+  // Both the unencoded value and its decoded wire form read back.
+  DataChangeNotification direct;
+  ASSERT_TRUE(FromExtensionObject(in_place, direct));
+  EXPECT_EQ(direct.monitored_items[0].client_handle, 5u);
+
+  Decoder decoder{bytes};
+  ExtensionObject decoded;
+  ASSERT_TRUE(decoder.Decode(decoded));
+  DataChangeNotification round_tripped;
+  ASSERT_TRUE(FromExtensionObject(decoded, round_tripped));
+  ASSERT_EQ(round_tripped.monitored_items.size(), 1u);
+  EXPECT_EQ(round_tripped.monitored_items[0].value.value.get<Double>(), 1.5);
+
+  // An in-place body of some other type is rejected rather than misread.
+  ElementOperand other;
+  EXPECT_FALSE(FromExtensionObject(in_place, other));
+}
+
 // An ExtensionObject whose type id this stack does not know keeps its body and
 // round-trips unchanged, so a message carrying one is still forwardable.
 TEST(UaBinaryCodecTest, PreservesUnknownExtensionObjectBodies) {
@@ -3,12 +3,16 @@
 #include "opcua/base/base64.h"
 #include "opcua/base/time_utils.h"
 #include "opcua/base/utf_convert.h"
+#include "opcua/transport/binary/codec_utils.h"
+#include "opcua/ua/ua_json_writer.h"
 
 #include <boost/json.hpp>
 
 #include <charconv>
 #include <format>
+#include <iterator>
 #include <limits>
+#include <memory>
 
 namespace opcua::ua::json {
 namespace {
@@ -84,6 +88,76 @@ T NarrowUnsigned(const value& json) {
   return static_cast<T>(raw);
 }
 
+// The text forms several built-ins take, shared by Encode and Write so the two
+// cannot drift apart.
+
+std::string DateTimeText(DateTime value) {
+  // OPC UA Part 6 §5.4.2.6 DateTime: ISO 8601 UTC,
+  // https://reference.opcfoundation.org/Core/Part6/v105/docs/5.4.2.6
+  if (value.is_null())
+    return "0001-01-01T00:00:00Z";
+  DateTime::Exploded exploded = {};
+  value.UTCExplode(&exploded);
+  auto text = std::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}", exploded.year,
+                          exploded.month, exploded.day_of_month, exploded.hour,
+                          exploded.minute, exploded.second);
+  if (exploded.millisecond != 0)
+    text += std::format(".{:03}", exploded.millisecond);
+  text += 'Z';
+  return text;
+}
+
+std::string Base64Text(const ByteString& value) {
+  std::string encoded;
+  opcua::base::Base64Encode(std::string_view{value.data(), value.size()},
+                            &encoded);
+  return encoded;
+}
+
+std::string ExpandedNodeIdText(const ExpandedNodeId& value) {
+  // OPC UA Part 6 §5.4.2.11 ExpandedNodeId: the NodeId text optionally
+  // prefixed with `svr=<index>;` and/or `nsu=<uri>;`.
+  std::string text;
+  if (value.server_index() != 0)
+    text += "svr=" + std::to_string(value.server_index()) + ";";
+  if (!value.namespace_uri().empty())
+    text += "nsu=" + value.namespace_uri() + ";";
+  text += value.node_id().ToString();
+  return text;
+}
+
+std::string QualifiedNameText(const QualifiedName& value) {
+  // OPC UA Part 6 §5.4.2.14 QualifiedName: the text form "<ns>:<name>", with
+  // the namespace index omitted when zero,
+  // https://reference.opcfoundation.org/Core/Part6/v105/docs/5.4.2.14
+  if (value.namespace_index() == 0)
+    return value.name();
+  return std::to_string(value.namespace_index()) + ":" + value.name();
+}
+
+const binary::ExtensionObjectBody* InPlaceBinaryBody(
+    const ExtensionObject& value) {
+  const auto* body =
+      std::any_cast<std::shared_ptr<const binary::ExtensionObjectBody>>(
+          &value.value());
+  return body != nullptr ? body->get() : nullptr;
+}
+
+const ExtensionObjectBody* InPlaceJsonBody(const ExtensionObject& value) {
+  const auto* body =
+      std::any_cast<std::shared_ptr<const ExtensionObjectBody>>(&value.value());
+  return body != nullptr ? body->get() : nullptr;
+}
+
+// An in-place binary body encoded to the ByteString a UaEncoding=1 body
+// carries.
+ByteString EncodeBinaryBody(const binary::ExtensionObjectBody& body) {
+  ByteString bytes;
+  binary::Encoder encoder{bytes, body.EncodedSize()};
+  body.Encode(encoder);
+  return bytes;
+}
+
 }  // namespace
 
 void ThrowError(std::string_view message) {
@@ -139,6 +213,47 @@ value Encode(const String& value) {
   return string(value);
 }
 
+void Write(Writer& writer, Boolean value) {
+  writer.Bool(value);
+}
+void Write(Writer& writer, Int8 value) {
+  writer.Int64(value);
+}
+void Write(Writer& writer, UInt8 value) {
+  writer.UInt64(value);
+}
+void Write(Writer& writer, Int16 value) {
+  writer.Int64(value);
+}
+void Write(Writer& writer, UInt16 value) {
+  writer.UInt64(value);
+}
+void Write(Writer& writer, Int32 value) {
+  writer.Int64(value);
+}
+void Write(Writer& writer, UInt32 value) {
+  writer.UInt64(value);
+}
+void Write(Writer& writer, Int64 value) {
+  char text[24];
+  const auto result = std::to_chars(std::begin(text), std::end(text), value);
+  writer.String(std::string_view{text, result.ptr});
+}
+void Write(Writer& writer, UInt64 value) {
+  char text[24];
+  const auto result = std::to_chars(std::begin(text), std::end(text), value);
+  writer.String(std::string_view{text, result.ptr});
+}
+void Write(Writer& writer, Float value) {
+  writer.Double(static_cast<double>(value));
+}
+void Write(Writer& writer, Double value) {
+  writer.Double(value);
+}
+void Write(Writer& writer, const String& value) {
+  writer.String(value);
+}
+
 void Decode(const value& json, Boolean& value) {
   if (!json.is_bool())
     ThrowError("expected a JSON boolean");
@@ -207,19 +322,11 @@ void Decode(const value& json, String& value) {
 // -- Temporal, binary and identifier types ----------------------------------
 
 value Encode(DateTime value) {
-  // OPC UA Part 6 §5.4.2.6 DateTime: ISO 8601 UTC,
-  // https://reference.opcfoundation.org/Core/Part6/v105/docs/5.4.2.6
-  if (value.is_null())
-    return "0001-01-01T00:00:00Z";
-  DateTime::Exploded exploded = {};
-  value.UTCExplode(&exploded);
-  auto text = std::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}", exploded.year,
-                          exploded.month, exploded.day_of_month, exploded.hour,
-                          exploded.minute, exploded.second);
-  if (exploded.millisecond != 0)
-    text += std::format(".{:03}", exploded.millisecond);
-  text += 'Z';
-  return string(std::move(text));
+  return string(DateTimeText(value));
+}
+
+void Write(Writer& writer, DateTime value) {
+  writer.String(DateTimeText(value));
 }
 
 void Decode(const value& json, DateTime& value) {
@@ -241,6 +348,10 @@ value Encode(const Guid& value) {
   return string(value.ToString());
 }
 
+void Write(Writer& writer, const Guid& value) {
+  writer.String(value.ToString());
+}
+
 void Decode(const value& json, Guid& value) {
   const std::optional<Guid> guid = Guid::FromString(RequireString(json));
   if (!guid.has_value())
@@ -252,10 +363,11 @@ value Encode(const ByteString& value) {
   // OPC UA Part 6 §5.4.2.7 ByteString: base64. (The pre-generation websocket
   // codec emitted an array of byte values instead, which no conforming peer
   // accepts.)
-  std::string encoded;
-  opcua::base::Base64Encode(std::string_view{value.data(), value.size()},
-                            &encoded);
-  return string(std::move(encoded));
+  return string(Base64Text(value));
+}
+
+void Write(Writer& writer, const ByteString& value) {
+  writer.String(Base64Text(value));
 }
 
 void Decode(const value& json, ByteString& value) {
@@ -274,6 +386,10 @@ value Encode(const XmlElement& value) {
   return string(value.value);
 }
 
+void Write(Writer& writer, const XmlElement& value) {
+  writer.String(value.value);
+}
+
 void Decode(const value& json, XmlElement& value) {
   if (json.is_null()) {
     value.value.clear();
@@ -288,6 +404,10 @@ value Encode(const NodeId& value) {
   return string(value.ToString());
 }
 
+void Write(Writer& writer, const NodeId& value) {
+  writer.String(value.ToString());
+}
+
 void Decode(const value& json, NodeId& value) {
   const std::string_view text = RequireString(json);
   value = NodeId::FromString(text);
@@ -296,15 +416,11 @@ void Decode(const value& json, NodeId& value) {
 }
 
 value Encode(const ExpandedNodeId& value) {
-  // OPC UA Part 6 §5.4.2.11 ExpandedNodeId: the NodeId text optionally
-  // prefixed with `svr=<index>;` and/or `nsu=<uri>;`.
-  std::string text;
-  if (value.server_index() != 0)
-    text += "svr=" + std::to_string(value.server_index()) + ";";
-  if (!value.namespace_uri().empty())
-    text += "nsu=" + value.namespace_uri() + ";";
-  text += value.node_id().ToString();
-  return string(std::move(text));
+  return string(ExpandedNodeIdText(value));
+}
+
+void Write(Writer& writer, const ExpandedNodeId& value) {
+  writer.String(ExpandedNodeIdText(value));
 }
 
 void Decode(const value& json, ExpandedNodeId& value) {
@@ -350,6 +466,17 @@ value Encode(Status value) {
   return json;
 }
 
+void Write(Writer& writer, Status value) {
+  writer.BeginObject();
+  if (value.full_code() != 0) {
+    writer.Key("Code");
+    writer.UInt64(value.full_code());
+    writer.Key("Symbol");
+    writer.String(ToString(value.code()));
+  }
+  writer.EndObject();
+}
+
 void Decode(const value& json, Status& value) {
   // Tolerates a bare number as well as the object form.
   if (json.is_int64() || json.is_uint64()) {
@@ -365,12 +492,14 @@ void Decode(const value& json, Status& value) {
 }
 
 value Encode(const QualifiedName& value) {
-  // OPC UA Part 6 §5.4.2.14 QualifiedName: the text form "<ns>:<name>", with
-  // the namespace index omitted when zero,
-  // https://reference.opcfoundation.org/Core/Part6/v105/docs/5.4.2.14
+  return string(QualifiedNameText(value));
+}
+
+void Write(Writer& writer, const QualifiedName& value) {
   if (value.namespace_index() == 0)
-    return string(value.name());
-  return string(std::to_string(value.namespace_index()) + ":" + value.name());
+    writer.String(value.name());
+  else
+    writer.String(QualifiedNameText(value));
 }
 
 void Decode(const value& json, QualifiedName& value) {
@@ -420,6 +549,20 @@ value Encode(const LocalizedText& value) {
   return json;
 }
 
+void Write(Writer& writer, const LocalizedText& value) {
+  writer.BeginObject();
+  if (!value.locale.empty()) {
+    writer.Key("Locale");
+    writer.String(value.locale);
+  }
+  const std::string text = UtfConvert<char>(value.text);
+  if (!text.empty()) {
+    writer.Key("Text");
+    writer.String(text);
+  }
+  writer.EndObject();
+}
+
 void Decode(const value& json, LocalizedText& value) {
   if (json.is_null()) {
     value = LocalizedText{};
@@ -437,12 +580,17 @@ value Encode(const ExtensionObject& value) {
   // OPC UA Part 6 §5.4.2.16 ExtensionObject: `{UaTypeId, UaEncoding, UaBody}`,
   // where UaEncoding 1 means the body is a base64 ByteString holding the
   // Binary encoding. A body this stack could not decode is passed through
-  // verbatim.
+  // verbatim, and a body held unencoded is encoded here.
   object json;
   json["UaTypeId"] = Encode(value.data_type_id());
-  if (const ByteString* body = value.binary_body()) {
+  if (const auto* in_place = InPlaceBinaryBody(value)) {
+    json["UaEncoding"] = 1;
+    json["UaBody"] = Encode(EncodeBinaryBody(*in_place));
+  } else if (const ByteString* body = value.binary_body()) {
     json["UaEncoding"] = 1;
     json["UaBody"] = Encode(*body);
+  } else if (const auto* in_place_json = InPlaceJsonBody(value)) {
+    json["UaBody"] = in_place_json->ToJson();
   } else if (const auto* body =
                  std::any_cast<boost::json::value>(&value.value())) {
     json["UaBody"] = *body;
@@ -450,6 +598,31 @@ value Encode(const ExtensionObject& value) {
   return json;
 }
 
+void Write(Writer& writer, const ExtensionObject& value) {
+  writer.BeginObject();
+  writer.Key("UaTypeId");
+  Write(writer, value.data_type_id());
+  if (const auto* in_place = InPlaceBinaryBody(value)) {
+    writer.Key("UaEncoding");
+    writer.Int64(1);
+    writer.Key("UaBody");
+    Write(writer, EncodeBinaryBody(*in_place));
+  } else if (const ByteString* body = value.binary_body()) {
+    writer.Key("UaEncoding");
+    writer.Int64(1);
+    writer.Key("UaBody");
+    Write(writer, *body);
+  } else if (const auto* in_place_json = InPlaceJsonBody(value)) {
+    writer.Key("UaBody");
+    in_place_json->Write(writer);
+  } else if (const auto* body =
+                 std::any_cast<boost::json::value>(&value.value())) {
+    writer.Key("UaBody");
+    writer.Value(*body);
+  }
+  writer.EndObject();
+}
+
 void Decode(const value& json, ExtensionObject& value) {
   const object& obj = RequireObject(json);
   ExpandedNodeId data_type_id;
@@ -466,7 +639,12 @@ void Decode(const value& json, ExtensionObject& value) {
     value = ExtensionObject{std::move(data_type_id), std::move(bytes)};
     return;
   }
-  value = ExtensionObject{std::move(data_type_id), *body};
+  // The body outlives the DOM it came from, which may sit in a per-message
+  // arena (ws::RequestDecoder); a plain copy would share that arena's storage,
+  // so copy it into the default resource.
+  value = ExtensionObject{
+      std::move(data_type_id),
+      boost::json::value(*body, boost::json::storage_ptr{})};
 }
 
 // -- Variant, DataValue and DiagnosticInfo ----------------------------------
@@ -554,6 +732,45 @@ value EncodeVariantPayload(const Variant& variant) {
   ThrowError("unsupported Variant type");
 }
 
+template <class T>
+void WriteScalarList(Writer& writer, const std::vector<T>& values) {
+  writer.BeginArray();
+  for (const T& item : values)
+    Write(writer, item);
+  writer.EndArray();
+}
+
+// The streaming counterpart of EncodeVariantPayload.
+void WriteVariantPayload(Writer& writer, const Variant& variant) {
+  switch (variant.type()) {
+    case Variant::EMPTY:
+      writer.Null();
+      return;
+#define OPCUA_WRITE_VARIANT_PAYLOAD(NAME, SCALAR, ELEMENT)               \
+  case Variant::NAME:                                                  \
+    if (variant.is_array())                                            \
+      WriteScalarList(writer, variant.get<std::vector<ELEMENT>>());    \
+    else                                                               \
+      Write(writer, variant.get<SCALAR>());                            \
+    return;
+      OPCUA_JSON_VARIANT_TYPES(OPCUA_WRITE_VARIANT_PAYLOAD)
+#undef OPCUA_WRITE_VARIANT_PAYLOAD
+    case Variant::DATA_VALUE: {
+      const auto& nested = variant.get<std::shared_ptr<const DataValue>>();
+      Write(writer, nested ? *nested : DataValue{});
+      return;
+    }
+    case Variant::VARIANT: {
+      const auto& nested = variant.get<std::shared_ptr<const Variant>>();
+      Write(writer, nested ? *nested : Variant{});
+      return;
+    }
+    case Variant::COUNT:
+      break;
+  }
+  ThrowError("unsupported Variant type");
+}
+
 void DecodeVariantPayload(Variant::Type type,
                           const value& json,
                           Variant& variant) {
@@ -606,6 +823,19 @@ value Encode(const Variant& value) {
   return json;
 }
 
+void Write(Writer& writer, const Variant& value) {
+  if (value.type() == Variant::EMPTY && !value.is_array()) {
+    writer.Null();
+    return;
+  }
+  writer.BeginObject();
+  writer.Key("UaType");
+  writer.UInt64(static_cast<std::uint64_t>(value.type()));
+  writer.Key("Value");
+  WriteVariantPayload(writer, value);
+  writer.EndObject();
+}
+
 void Decode(const value& json, Variant& value) {
   if (json.is_null()) {
     value = Variant{};
@@ -646,6 +876,29 @@ value Encode(const DataValue& value) {
   return json;
 }
 
+void Write(Writer& writer, const DataValue& value) {
+  writer.BeginObject();
+  if (!value.value.is_null()) {
+    writer.Key("UaType");
+    writer.UInt64(static_cast<std::uint64_t>(value.value.type()));
+    writer.Key("Value");
+    WriteVariantPayload(writer, value.value);
+  }
+  if (!IsGood(value.status_code)) {
+    writer.Key("StatusCode");
+    Write(writer, Status{value.status_code});
+  }
+  if (!value.source_timestamp.is_null()) {
+    writer.Key("SourceTimestamp");
+    Write(writer, value.source_timestamp);
+  }
+  if (!value.server_timestamp.is_null()) {
+    writer.Key("ServerTimestamp");
+    Write(writer, value.server_timestamp);
+  }
+  writer.EndObject();
+}
+
 void Decode(const value& json, DataValue& value) {
   const object& obj = RequireObject(json);
   value = DataValue{};
@@ -692,6 +945,39 @@ value Encode(const DiagnosticInfo& value) {
   return json;
 }
 
+void Write(Writer& writer, const DiagnosticInfo& value) {
+  writer.BeginObject();
+  if (value.symbolic_id.has_value()) {
+    writer.Key("SymbolicId");
+    writer.Int64(*value.symbolic_id);
+  }
+  if (value.namespace_uri.has_value()) {
+    writer.Key("NamespaceUri");
+    writer.Int64(*value.namespace_uri);
+  }
+  if (value.locale.has_value()) {
+    writer.Key("Locale");
+    writer.Int64(*value.locale);
+  }
+  if (value.localized_text.has_value()) {
+    writer.Key("LocalizedText");
+    writer.Int64(*value.localized_text);
+  }
+  if (value.additional_info.has_value()) {
+    writer.Key("AdditionalInfo");
+    writer.String(*value.additional_info);
+  }
+  if (value.inner_status_code.has_value()) {
+    writer.Key("InnerStatusCode");
+    Write(writer, *value.inner_status_code);
+  }
+  if (value.inner_diagnostic_info != nullptr) {
+    writer.Key("InnerDiagnosticInfo");
+    Write(writer, *value.inner_diagnostic_info);
+  }
+  writer.EndObject();
+}
+
 void Decode(const value& json, DiagnosticInfo& value) {
   const object& obj = RequireObject(json);
   value = DiagnosticInfo{};
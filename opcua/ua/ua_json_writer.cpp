@@ -0,0 +1,123 @@
+#include "opcua/ua/ua_json_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+
+namespace opcua::ua::json {
+namespace {
+
+// The characters boost::json escapes in a string: the quote, the backslash and
+// the C0 controls. Anything else, multi-byte UTF-8 included, is copied as is.
+bool NeedsEscaping(std::string_view value) {
+  return std::ranges::any_of(value, [](char c) {
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+  });
+}
+
+template <class T>
+void AppendInteger(std::string& output, T value) {
+  char buffer[24];
+  const auto result =
+      std::to_chars(std::begin(buffer), std::end(buffer), value);
+  output.append(buffer, result.ptr);
+}
+
+}  // namespace
+
+void Writer::BeginObject() {
+  Separate();
+  output_ += '{';
+  needs_separator_ = false;
+}
+
+void Writer::EndObject() {
+  output_ += '}';
+  needs_separator_ = true;
+}
+
+void Writer::BeginArray() {
+  Separate();
+  output_ += '[';
+  needs_separator_ = false;
+}
+
+void Writer::EndArray() {
+  output_ += ']';
+  needs_separator_ = true;
+}
+
+void Writer::Key(std::string_view name) {
+  Separate();
+  output_ += '"';
+  output_ += name;
+  output_ += "\":";
+  needs_separator_ = false;
+}
+
+void Writer::Null() {
+  Separate();
+  output_ += "null";
+  needs_separator_ = true;
+}
+
+void Writer::Bool(bool value) {
+  Separate();
+  output_ += value ? "true" : "false";
+  needs_separator_ = true;
+}
+
+void Writer::Int64(std::int64_t value) {
+  Separate();
+  AppendInteger(output_, value);
+  needs_separator_ = true;
+}
+
+void Writer::UInt64(std::uint64_t value) {
+  Separate();
+  AppendInteger(output_, value);
+  needs_separator_ = true;
+}
+
+void Writer::Double(double value) {
+  Separate();
+  const boost::json::value number = value;
+  serializer_.reset(&number);
+  Drain();
+  needs_separator_ = true;
+}
+
+void Writer::String(std::string_view value) {
+  Separate();
+  if (NeedsEscaping(value)) {
+    serializer_.reset(boost::json::string_view{value.data(), value.size()});
+    Drain();
+  } else {
+    output_ += '"';
+    output_ += value;
+    output_ += '"';
+  }
+  needs_separator_ = true;
+}
+
+void Writer::Value(const boost::json::value& value) {
+  Separate();
+  serializer_.reset(&value);
+  Drain();
+  needs_separator_ = true;
+}
+
+void Writer::Separate() {
+  if (needs_separator_)
+    output_ += ',';
+}
+
+void Writer::Drain() {
+  char buffer[256];
+  while (!serializer_.done()) {
+    const auto chunk = serializer_.read(buffer);
+    output_.append(chunk.data(), chunk.size());
+  }
+}
+
+}  // namespace opcua::ua::json
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "opcua/ua/ua_json_builtins.h"
+
+#include <boost/json/serializer.hpp>
+#include <boost/json/value.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// The OPC UA JSON encoding written straight into a text buffer, for the
+// transport's outbound path. ua_json_builtins.h and the generated
+// ua_json_codec.h build a boost::json DOM and leave it to the caller to
+// serialize; a large response (a Publish with a thousand data changes) spends
+// most of its time allocating and freeing that tree. The writers here emit the
+// same bytes `boost::json::serialize(Encode(value))` would, field for field, so
+// either path can answer any peer.
+namespace opcua::ua::json {
+
+// Appends compact JSON text to a string. Objects and arrays are opened and
+// closed explicitly and the writer supplies the separators; the caller is
+// responsible for the nesting being well-formed.
+class Writer {
+ public:
+  explicit Writer(std::string& output) : output_{output} {}
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  // Starts an object member. `name` is written verbatim, so it must need no
+  // escaping; the generated writers only pass schema field names.
+  void Key(std::string_view name);
+
+  void Null();
+  void Bool(bool value);
+  void Int64(std::int64_t value);
+  void UInt64(std::uint64_t value);
+  void Double(double value);
+  void String(std::string_view value);
+
+  // A value already built as a DOM, such as an ExtensionObject body received
+  // as JSON.
+  void Value(const boost::json::value& value);
+
+  std::string& output() { return output_; }
+
+ private:
+  // Writes the comma owed to the previous member or element, if any.
+  void Separate();
+
+  // Drains `serializer_` into the output. Strings that need escaping and
+  // doubles go through boost::json's own serializer so that they come out
+  // exactly as the DOM path writes them.
+  void Drain();
+
+  std::string& output_;
+  bool needs_separator_ = false;
+  boost::json::serializer serializer_;
+};
+
+// A structured value an ExtensionObject carries unencoded on the JSON
+// transport, held in its body as a `std::shared_ptr<const
+// json::ExtensionObjectBody>`. A Writer streams it inside the enclosing
+// message; Encode still renders it as a DOM for a caller that wants one. See
+// ToInPlaceJsonExtensionObject in opcua/ua/ua_json_codec.h.
+class ExtensionObjectBody {
+ public:
+  virtual ~ExtensionObjectBody() = default;
+
+  virtual boost::json::value ToJson() const = 0;
+  virtual void Write(Writer& writer) const = 0;
+};
+
+// The built-ins, written as the matching `Encode` in ua_json_builtins.h
+// encodes them.
+void Write(Writer& writer, Boolean value);
+void Write(Writer& writer, Int8 value);
+void Write(Writer& writer, UInt8 value);
+void Write(Writer& writer, Int16 value);
+void Write(Writer& writer, UInt16 value);
+void Write(Writer& writer, Int32 value);
+void Write(Writer& writer, UInt32 value);
+void Write(Writer& writer, Int64 value);
+void Write(Writer& writer, UInt64 value);
+void Write(Writer& writer, Float value);
+void Write(Writer& writer, Double value);
+void Write(Writer& writer, const String& value);
+void Write(Writer& writer, DateTime value);
+void Write(Writer& writer, const Guid& value);
+void Write(Writer& writer, const ByteString& value);
+void Write(Writer& writer, const XmlElement& value);
+void Write(Writer& writer, const NodeId& value);
+void Write(Writer& writer, const ExpandedNodeId& value);
+void Write(Writer& writer, Status value);
+void Write(Writer& writer, const QualifiedName& value);
+void Write(Writer& writer, const LocalizedText& value);
+void Write(Writer& writer, const ExtensionObject& value);
+void Write(Writer& writer, const Variant& value);
+void Write(Writer& writer, const DataValue& value);
+void Write(Writer& writer, const DiagnosticInfo& value);
+
+}  // namespace opcua::ua::json
@@ -0,0 +1,155 @@
+#include "opcua/ua/ua_json_writer.h"
+
+#include "opcua/ua/ua_binary_codec.h"
+#include "opcua/ua/ua_json_codec.h"
+
+#include <boost/json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace opcua::ua {
+namespace {
+
+// What a json::Writer makes of a built-in, next to the text of its DOM.
+template <class T>
+void ExpectWritesLikeEncode(const T& value) {
+  std::string written;
+  json::Writer writer{written};
+  json::Write(writer, value);
+  EXPECT_EQ(written, boost::json::serialize(json::Encode(value)));
+}
+
+// The same for a generated type.
+template <class T>
+void ExpectWritesLikeEncodeJson(const T& value) {
+  std::string written;
+  json::Writer writer{written};
+  WriteJson(writer, value);
+  EXPECT_EQ(written, boost::json::serialize(EncodeJson(value)));
+}
+
+TEST(UaJsonWriterTest, WritesNumbersAndStringsLikeTheDom) {
+  ExpectWritesLikeEncode(Boolean{true});
+  ExpectWritesLikeEncode(Int8{-8});
+  ExpectWritesLikeEncode(UInt16{65535});
+  ExpectWritesLikeEncode(std::numeric_limits<Int32>::min());
+  ExpectWritesLikeEncode(std::numeric_limits<Int64>::min());
+  ExpectWritesLikeEncode(std::numeric_limits<UInt64>::max());
+  ExpectWritesLikeEncode(Float{0.1f});
+  ExpectWritesLikeEncode(Double{-1234.5678e-90});
+  ExpectWritesLikeEncode(Double{0});
+  ExpectWritesLikeEncode(String{"plain"});
+  // Quotes, backslashes and control characters take the escaping path; UTF-8
+  // passes through.
+  ExpectWritesLikeEncode(String{"a\"b\\c\nd\te\x01 \xc3\xa9"});
+}
+
+TEST(UaJsonWriterTest, WritesTextFormsAndObjectsLikeTheDom) {
+  ExpectWritesLikeEncode(DateTime{});
+  ExpectWritesLikeEncode(DateTime::FromInternalValue(133'000'000'001'230'000));
+  ExpectWritesLikeEncode(ByteString{'\x00', '\xff', 'a'});
+  ExpectWritesLikeEncode(NodeId{String{"name"}, 3});
+  ExpectWritesLikeEncode(ExpandedNodeId{NodeId{5, 1}, "urn:ns", 2});
+  ExpectWritesLikeEncode(Status{StatusCode::Good});
+  ExpectWritesLikeEncode(Status{StatusCode::Bad_NodeIdUnknown});
+  ExpectWritesLikeEncode(QualifiedName{"Name", 0});
+  ExpectWritesLikeEncode(QualifiedName{"Na\"me", 4});
+  ExpectWritesLikeEncode(LocalizedText{});
+  ExpectWritesLikeEncode(LocalizedText{u"text"});
+
+  DiagnosticInfo info;
+  info.symbolic_id = -1;
+  info.additional_info = "why";
+  info.inner_status_code = Status{StatusCode::Bad};
+  info.inner_diagnostic_info = std::make_shared<const DiagnosticInfo>();
+  ExpectWritesLikeEncode(info);
+}
+
+TEST(UaJsonWriterTest, WritesVariantsAndDataValuesLikeTheDom) {
+  ExpectWritesLikeEncode(Variant{});
+  ExpectWritesLikeEncode(Variant{Int32{7}});
+  ExpectWritesLikeEncode(Variant{std::vector<Double>{1.5, -2, 1e300}});
+  ExpectWritesLikeEncode(Variant{std::vector<String>{"a", "", "c\"d"}});
+  ExpectWritesLikeEncode(Variant{std::vector<bool>{true, false}});
+  ExpectWritesLikeEncode(
+      Variant{std::make_shared<const Variant>(Variant{String{"nested"}})});
+
+  ExpectWritesLikeEncode(DataValue{});
+  DataValue value{Variant{Double{21.5}}, {},
+                  DateTime::FromInternalValue(133'000'000'000'000'000),
+                  DateTime::FromInternalValue(133'000'000'010'000'000)};
+  ExpectWritesLikeEncode(value);
+  value.status_code = StatusCode::Uncertain;
+  ExpectWritesLikeEncode(value);
+}
+
+TEST(UaJsonWriterTest, WritesEveryExtensionObjectBodyLikeTheDom) {
+  ElementOperand operand;
+  operand.index = 3;
+
+  ExpectWritesLikeEncode(ExtensionObject{});
+  ExpectWritesLikeEncode(ToExtensionObject(operand));
+  ExpectWritesLikeEncode(ToInPlaceExtensionObject(operand));
+  ExpectWritesLikeEncode(ToJsonExtensionObject(operand));
+  ExpectWritesLikeEncode(ToInPlaceJsonExtensionObject(operand));
+
+  // A binary body is the same text whether or not it was encoded up front.
+  std::string encoded;
+  json::Writer encoded_writer{encoded};
+  json::Write(encoded_writer, ToExtensionObject(operand));
+  std::string in_place;
+  json::Writer in_place_writer{in_place};
+  json::Write(in_place_writer, ToInPlaceExtensionObject(operand));
+  EXPECT_EQ(in_place, encoded);
+}
+
+TEST(UaJsonWriterTest, WritesGeneratedMessagesLikeTheDom) {
+  ReadRequest request;
+  request.request_header.authentication_token = NodeId{String{"token"}, 1};
+  request.request_header.request_handle = 77;
+  request.max_age = 250.5;
+  request.timestamps_to_return = TimestampsToReturn::Source;
+  request.nodes_to_read.push_back({.node_id = NodeId{2253, 0},
+                                   .attribute_id = 13,
+                                   .index_range = "0:4"});
+  request.nodes_to_read.push_back({.node_id = NodeId{2254, 0}});
+  ExpectWritesLikeEncodeJson(request);
+
+  DataChangeNotification data_change;
+  data_change.monitored_items.push_back(
+      {.client_handle = 1, .value = DataValue{Variant{Int32{5}}, {}, {}, {}}});
+  data_change.monitored_items.push_back({.client_handle = 2});
+  PublishResponse response;
+  response.subscription_id = 9;
+  response.available_sequence_numbers = {1, 2};
+  response.notification_message.sequence_number = 2;
+  response.notification_message.notification_data = {
+      ToInPlaceJsonExtensionObject(data_change),
+      ToJsonExtensionObject(data_change)};
+  ExpectWritesLikeEncodeJson(response);
+
+  ExpectWritesLikeEncodeJson(ServiceFault{});
+}
+
+// An in-place JSON body still reads back, and only as its own type.
+TEST(UaJsonWriterTest, ReadsBackInPlaceJsonBodies) {
+  ElementOperand operand;
+  operand.index = 3;
+  const ExtensionObject wrapped = ToInPlaceJsonExtensionObject(operand);
+  EXPECT_EQ(wrapped.data_type_id().node_id(),
+            NodeId{JsonEncodingId<ElementOperand>::value});
+
+  ElementOperand decoded;
+  ASSERT_TRUE(FromJsonExtensionObject(wrapped, decoded));
+  EXPECT_EQ(decoded.index, 3u);
+  LiteralOperand other;
+  EXPECT_FALSE(FromJsonExtensionObject(wrapped, other));
+}
+
+}  // namespace
+}  // namespace opcua::ua
@@ -410,7 +410,11 @@ CODEC_HEADER_PRELUDE = '''#pragma once
 #include "opcua/ua/ua_encoding_ids.h"
 #include "opcua/ua/ua_types.h"
 
+#include <any>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -421,6 +425,9 @@ CODEC_HEADER_PRELUDE = '''#pragma once
 // followed by the elements — the schema pins the field order, so nothing here
 // is a judgement call. The built-in types these bottom out in are hand-written
 // (opcua/transport/binary/codec_utils.cpp).
+//
+// EncodedSize gives the number of bytes Encode writes, so a message can be
+// encoded into a buffer reserved once at its final size.
 namespace opcua::ua {
 
 // The DefaultBinary encoding id of a generated type, i.e. the NodeId that
@@ -460,6 +467,14 @@ inline bool DecodeValue(binary::Decoder& decoder, Int16& value) {
   value = static_cast<Int16>(raw);
   return true;
 }
+
+inline std::size_t EncodedSizeOf(Int8 value) {
+  return binary::EncodedSize(value);
+}
+
+inline std::size_t EncodedSizeOf(Int16 value) {
+  return binary::EncodedSize(value);
+}
 '''
 
 CODEC_HEADER_HELPERS = '''
@@ -473,14 +488,35 @@ bool DecodeValue(binary::Decoder& decoder, T& value) {
   return Decode(decoder, value);
 }
 
+template <class T>
+std::size_t EncodedSizeOf(const T& value) {
+  return EncodedSize(value);
+}
+
+template <class T>
+std::size_t EncodedArraySize(const std::vector<T>& values) {
+  std::size_t size = sizeof(Int32);
+  if constexpr (binary::BulkEncodable<T> || std::is_same_v<T, bool>) {
+    size += values.size() * sizeof(T);
+  } else {
+    for (const T& value : values)
+      size += EncodedSizeOf(value);
+  }
+  return size;
+}
+
 // OPC UA Part 6 §5.2.5 Arrays: an Int32 element count followed by the
 // elements. A count of -1 means a null array, which is indistinguishable from
 // an empty one here and decodes to an empty vector.
 template <class T>
 void EncodeArray(binary::Encoder& encoder, const std::vector<T>& values) {
-  encoder.Encode(static_cast<Int32>(values.size()));
-  for (const T& value : values)
-    EncodeValue(encoder, value);
+  if constexpr (binary::BulkEncodable<T>) {
+    encoder.EncodeArray(std::span<const T>{values});
+  } else {
+    encoder.Encode(static_cast<Int32>(values.size()));
+    for (const T& value : values)
+      EncodeValue(encoder, value);
+  }
 }
 
 template <class T>
@@ -512,20 +548,52 @@ bool DecodeArray(binary::Decoder& decoder, std::vector<T>& values) {
 
 }  // namespace detail
 
+// The body of an ExtensionObject built by ToInPlaceExtensionObject: the value
+// itself, encoded only when the message holding it is.
+template <class T>
+class InPlaceExtensionObjectBody final : public binary::ExtensionObjectBody {
+ public:
+  explicit InPlaceExtensionObjectBody(T value) : value_{std::move(value)} {}
+
+  const T& value() const { return value_; }
+
+  std::size_t EncodedSize() const override { return ua::EncodedSize(value_); }
+  void Encode(binary::Encoder& encoder) const override {
+    ua::Encode(encoder, value_);
+  }
+
+ private:
+  T value_;
+};
+
 // Wraps a value as an ExtensionObject carrying its DefaultBinary encoding, the
 // form structured values take inside a Variant or an `ua:ExtensionObject`
 // field.
 template <class T>
 ExtensionObject ToExtensionObject(const T& value) {
   ByteString body;
-  binary::Encoder encoder{body};
+  binary::Encoder encoder{body, EncodedSize(value)};
   Encode(encoder, value);
   return ExtensionObject{ExpandedNodeId{NodeId{BinaryEncodingId<T>::value}},
                          std::move(body)};
 }
 
-// The inverse. Returns false when the ExtensionObject carries a different type
-// id, has no binary body, or the body does not decode cleanly.
+// The same, but the value is kept and the Binary encoder writes it straight
+// into the enclosing message, with no ByteString of its own and no copy. For
+// bodies that are only ever encoded, such as the notifications of a Publish
+// response: binary_body() is null for it, though FromExtensionObject still
+// reads it back.
+template <class T>
+ExtensionObject ToInPlaceExtensionObject(T value) {
+  return ExtensionObject{
+      ExpandedNodeId{NodeId{BinaryEncodingId<T>::value}},
+      std::shared_ptr<const binary::ExtensionObjectBody>{
+          std::make_shared<const InPlaceExtensionObjectBody<T>>(
+              std::move(value))}};
+}
+
+// The inverse of both. Returns false when the ExtensionObject carries a
+// different type id, has no binary body, or the body does not decode cleanly.
 template <class T>
 bool FromExtensionObject(const ExtensionObject& extension_object, T& value) {
   const ExpandedNodeId& id = extension_object.data_type_id();
@@ -533,6 +601,16 @@ bool FromExtensionObject(const ExtensionObject& extension_object, T& value) {
       id.node_id().numeric_id() != BinaryEncodingId<T>::value) {
     return false;
   }
+  if (const auto* in_place =
+          std::any_cast<std::shared_ptr<const binary::ExtensionObjectBody>>(
+              &extension_object.value())) {
+    const auto* typed =
+        dynamic_cast<const InPlaceExtensionObjectBody<T>*>(in_place->get());
+    if (typed == nullptr)
+      return false;
+    value = typed->value();
+    return true;
+  }
   const ByteString* body = extension_object.binary_body();
   if (body == nullptr)
     return false;
@@ -558,7 +636,11 @@ inline void EncodeValue(binary::Encoder& encoder, const %s& value) {
 
 inline bool DecodeValue(binary::Decoder& decoder, %s& value) {
   return decoder.Decode(value);
-}""" % (name, name))
+}
+
+inline std::size_t EncodedSizeOf(const %s& value) {
+  return binary::EncodedSize(value);
+}""" % (name, name, name))
     out.append("\n}  // namespace detail\n")
     out.append("// Enumerations travel as their underlying integer.")
     for enum in enums:
@@ -566,12 +648,14 @@ inline bool DecodeValue(binary::Decoder& decoder, %s& value) {
                    enum.name)
         out.append("bool Decode(binary::Decoder& decoder, %s& value);" %
                    enum.name)
+        out.append("std::size_t EncodedSize(%s value);" % enum.name)
     out.append("")
     for struct in structs:
         out.append("void Encode(binary::Encoder& encoder, const %s& value);" %
                    struct.name)
         out.append("bool Decode(binary::Decoder& decoder, %s& value);" %
                    struct.name)
+        out.append("std::size_t EncodedSize(const %s& value);" % struct.name)
     out.append("")
     out.append("namespace detail {")
     out.append(CODEC_HEADER_HELPERS.strip())
@@ -601,9 +685,14 @@ inline bool DecodeValue(binary::Decoder& decoder, %s& value) {
                     "  value = static_cast<%s>(raw);\n"
                     "  return true;\n"
                     "}\n" % (enum.name, enum.underlying, enum.name))
+                source.append(
+                    "std::size_t EncodedSize(%s) {\n"
+                    "  return sizeof(%s);\n"
+                    "}\n" % (enum.name, enum.underlying))
         for struct in shard:
             source.append(encode_definition(struct))
             source.append(decode_definition(struct))
+            source.append(encoded_size_definition(struct))
         source.append("}  // namespace opcua::ua")
         write(path, "\n".join(source) + "\n")
 
@@ -625,6 +714,21 @@ def encode_definition(struct):
     return "\n".join(lines)
 
 
+def encoded_size_definition(struct):
+    lines = ["std::size_t EncodedSize(const %s& value) {" % struct.name]
+    if not struct.fields:
+        lines.append("  (void)value;")
+        lines.append("  return 0;")
+    else:
+        terms = []
+        for field in struct.fields:
+            helper = "EncodedArraySize" if field.is_array else "EncodedSizeOf"
+            terms.append("detail::%s(value.%s)" % (helper, field.member))
+        lines.append("  return " + " +\n         ".join(terms) + ";")
+    lines.append("}\n")
+    return "\n".join(lines)
+
+
 def decode_definition(struct):
     lines = ["bool Decode(binary::Decoder& decoder, %s& value) {" % struct.name]
     if not struct.fields:
@@ -643,6 +747,7 @@ def decode_definition(struct):
 JSON_HEADER_PRELUDE = '''#pragma once
 
 #include "opcua/ua/ua_json_builtins.h"
+#include "opcua/ua/ua_json_writer.h"
 #include "opcua/ua/ua_types.h"
 
 #include <boost/json/array.hpp>
@@ -651,6 +756,7 @@ JSON_HEADER_PRELUDE = '''#pragma once
 
 #include <any>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 // The OPC UA JSON encoding of every generated type, in the compact form the
@@ -663,6 +769,11 @@ JSON_HEADER_PRELUDE = '''#pragma once
 // A field is omitted when it holds its default. Nested structures are always
 // emitted, since "default" is not a question this layer can answer for them
 // cheaply; a decoder treats an absent field as its default either way.
+//
+// Every type is written two ways: EncodeJson builds a boost::json DOM, and
+// WriteJson streams the same text through a json::Writer (ua_json_writer.h)
+// without building one. The two are emitted from the same field walk below and
+// must stay byte-identical.
 namespace opcua::ua {
 
 namespace detail {
@@ -677,6 +788,14 @@ boost::json::value EncodeJsonValue(const T& value) {
     return EncodeJson(value);
 }
 
+template <class T>
+void WriteJsonValue(json::Writer& writer, const T& value) {
+  if constexpr (requires { json::Write(writer, value); })
+    json::Write(writer, value);
+  else
+    WriteJson(writer, value);
+}
+
 template <class T>
 void DecodeJsonValue(const boost::json::value& source, T& value) {
   if constexpr (requires { json::Decode(source, value); })
@@ -694,6 +813,14 @@ boost::json::value EncodeJsonArray(const std::vector<T>& values) {
   return result;
 }
 
+template <class T>
+void WriteJsonArray(json::Writer& writer, const std::vector<T>& values) {
+  writer.BeginArray();
+  for (const T& value : values)
+    WriteJsonValue(writer, value);
+  writer.EndArray();
+}
+
 template <class T>
 void DecodeJsonArray(const boost::json::value& source,
                      std::vector<T>& values) {
@@ -736,6 +863,22 @@ struct JsonEncodingId {
   static constexpr std::uint32_t value = T::kJsonEncodingId;
 };
 
+// The body of an ExtensionObject built by ToInPlaceJsonExtensionObject: the
+// value itself, rendered only when the message holding it is.
+template <class T>
+class InPlaceJsonExtensionObjectBody final : public json::ExtensionObjectBody {
+ public:
+  explicit InPlaceJsonExtensionObjectBody(T value) : value_{std::move(value)} {}
+
+  const T& value() const { return value_; }
+
+  boost::json::value ToJson() const override { return EncodeJson(value_); }
+  void Write(json::Writer& writer) const override { WriteJson(writer, value_); }
+
+ private:
+  T value_;
+};
+
 // Wrap `value` in an ExtensionObject carrying its JSON encoding.
 template <class T>
 ExtensionObject ToJsonExtensionObject(const T& value) {
@@ -743,8 +886,20 @@ ExtensionObject ToJsonExtensionObject(const T& value) {
                          EncodeJson(value)};
 }
 
-// The inverse. Returns false when the ExtensionObject names a different type,
-// carries no JSON body, or the body does not decode cleanly.
+// The same, but the value is kept and a json::Writer streams it straight into
+// the message, so a large body (a Publish's notifications) never exists as a
+// DOM. Encode still renders it, for the DOM path.
+template <class T>
+ExtensionObject ToInPlaceJsonExtensionObject(T value) {
+  return ExtensionObject{
+      ExpandedNodeId{NodeId{JsonEncodingId<T>::value}},
+      std::shared_ptr<const json::ExtensionObjectBody>{
+          std::make_shared<const InPlaceJsonExtensionObjectBody<T>>(
+              std::move(value))}};
+}
+
+// The inverse of both. Returns false when the ExtensionObject names a
+// different type, carries no JSON body, or the body does not decode cleanly.
 //
 // The DefaultBinary id is accepted alongside the DefaultJson one: a peer that
 // names a JSON-bodied structure by its binary encoding id is still unambiguous
@@ -763,6 +918,16 @@ bool FromJsonExtensionObject(const ExtensionObject& extension_object,
     id_matches = id_matches || numeric_id == T::kBinaryEncodingId;
   if (!id_matches)
     return false;
+  if (const auto* in_place =
+          std::any_cast<std::shared_ptr<const json::ExtensionObjectBody>>(
+              &extension_object.value())) {
+    const auto* typed =
+        dynamic_cast<const InPlaceJsonExtensionObjectBody<T>*>(in_place->get());
+    if (typed == nullptr)
+      return false;
+    value = typed->value();
+    return true;
+  }
   const auto* body =
       std::any_cast<boost::json::value>(&extension_object.value());
   if (body == nullptr)
@@ -785,12 +950,16 @@ def write_json_codec(header_path, source_paths, enums, structs):
     out.append("// Enumerations are JSON integers.")
     for enum in enums:
         out.append("boost::json::value EncodeJson(%s value);" % enum.name)
+        out.append("void WriteJson(json::Writer& writer, %s value);" %
+                   enum.name)
         out.append("void DecodeJson(const boost::json::value& source, "
                    "%s& value);" % enum.name)
     out.append("")
     for struct in structs:
         out.append("boost::json::value EncodeJson(const %s& value);" %
                    struct.name)
+        out.append("void WriteJson(json::Writer& writer, const %s& value);" %
+                   struct.name)
         out.append("void DecodeJson(const boost::json::value& source, "
                    "%s& value);" % struct.name)
     out.append("")
@@ -812,6 +981,10 @@ def write_json_codec(header_path, source_paths, enums, structs):
                     "boost::json::value EncodeJson(%s value) {\n"
                     "  return json::Encode(static_cast<%s>(value));\n"
                     "}\n" % (enum.name, enum.underlying))
+                source.append(
+                    "void WriteJson(json::Writer& writer, %s value) {\n"
+                    "  json::Write(writer, static_cast<%s>(value));\n"
+                    "}\n" % (enum.name, enum.underlying))
                 source.append(
                     "void DecodeJson(const boost::json::value& source, "
                     "%s& value) {\n"
@@ -821,6 +994,7 @@ def write_json_codec(header_path, source_paths, enums, structs):
                     "}\n" % (enum.name, enum.underlying, enum.name))
         for struct in shard:
             source.append(encode_json_definition(struct))
+            source.append(write_json_definition(struct))
             source.append(decode_json_definition(struct))
         source.append("}  // namespace opcua::ua")
         write(path, "\n".join(source) + "\n")
@@ -848,6 +1022,35 @@ def encode_json_definition(struct):
     return "\n".join(lines)
 
 
+def write_json_definition(struct):
+    """The streaming twin of encode_json_definition: the same fields, the same
+    omissions, in the same order."""
+    lines = ["void WriteJson(json::Writer& writer, const %s& value) {" %
+             struct.name]
+    if not struct.fields:
+        lines.append("  (void)value;")
+    lines.append("  writer.BeginObject();")
+    for field in struct.fields:
+        if field.is_array:
+            lines.append("  if (!value.%s.empty()) {" % field.member)
+            lines.append("    writer.Key(\"%s\");" % field.name)
+            lines.append("    detail::WriteJsonArray(writer, value.%s);"
+                         % field.member)
+            lines.append("  }")
+        elif field.type_name in BUILT_IN_TYPE_MAP.values():
+            lines.append("  if (!json::IsDefault(value.%s)) {" % field.member)
+            lines.append("    writer.Key(\"%s\");" % field.name)
+            lines.append("    json::Write(writer, value.%s);" % field.member)
+            lines.append("  }")
+        else:
+            lines.append("  writer.Key(\"%s\");" % field.name)
+            lines.append("  detail::WriteJsonValue(writer, value.%s);"
+                         % field.member)
+    lines.append("  writer.EndObject();")
+    lines.append("}\n")
+    return "\n".join(lines)
+
+
 def decode_json_definition(struct):
     lines = ["void DecodeJson(const boost::json::value& source, %s& value) {" %
              struct.name]